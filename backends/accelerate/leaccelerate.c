@@ -7,16 +7,15 @@
 #include <le/tensors/letensor-imp.h>
 #include <Accelerate/Accelerate.h>
 
-LeTensor *
-le_accelerate_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+void
+le_accelerate_matrix_product_into(LeTensor *c, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
 {
-    /// @todo: Take stride into account
     assert(a->element_type == LE_TYPE_FLOAT32);
     assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(c->element_type == LE_TYPE_FLOAT32);
     assert(a->shape->num_dimensions == 2);
     assert(b->shape->num_dimensions == 2);
-    // assert(le_tensor_contiguous(a));
-    // assert(le_tensor_contiguous(b));
+    assert(c->shape->num_dimensions == 2);
     
     unsigned size_a = transpose_a ? a->shape->sizes[0] : a->shape->sizes[1];
     unsigned size_b = transpose_b ? b->shape->sizes[1] : b->shape->sizes[0];
@@ -24,27 +23,34 @@ le_accelerate_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTe
     
     unsigned c_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
     unsigned c_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
+    assert(c->shape->sizes[0] == c_height);
+    assert(c->shape->sizes[1] == c_width);
     
-    LeTensor *c = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, c_height, c_width);
-    
+    /// @note: lematrix copies views which can not be described by leading dimension
+    bool layout_transpose_a, layout_transpose_b, layout_transpose_c;
+    size_t lda, ldb, ldc;
+    bool packed = le_matrix_get_gemm_layout(a, transpose_a, &layout_transpose_a, &lda) &&
+                  le_matrix_get_gemm_layout(b, transpose_b, &layout_transpose_b, &ldb) &&
+                  le_matrix_get_gemm_layout(c, false, &layout_transpose_c, &ldc);
+    assert(packed && !layout_transpose_c);
+    (void)packed;
+
     cblas_sgemm(CblasRowMajor,
-                transpose_a ? CblasTrans : CblasNoTrans,
-                transpose_b ? CblasTrans : CblasNoTrans,
+                layout_transpose_a ? CblasTrans : CblasNoTrans,
+                layout_transpose_b ? CblasTrans : CblasNoTrans,
                 c_height, c_width, size_a,
                 1.0f,
-                a->data, a->stride,
-                b->data, b->stride,
+                a->data, lda,
+                b->data, ldb,
                 0.0f,
-                c->data, c->stride);
-    
-    return c;
+                c->data, ldc);
 }
 
 void
 le_accelerate_tensor_apply_sigmoid(LeTensor *tensor)
 {
-    /// @todo: Take stride into account
     assert(tensor);
+    assert(le_tensor_contiguous(tensor));
     assert(tensor->element_type == LE_TYPE_FLOAT32);
         
     int n = le_shape_get_elements_count(tensor->shape);
@@ -58,8 +64,8 @@ le_accelerate_tensor_apply_sigmoid(LeTensor *tensor)
 void
 le_accelerate_tensor_apply_sigmoid_prime(LeTensor *tensor)
 {
-    /// @todo: Take stride into account
     assert(tensor);
+    assert(le_tensor_contiguous(tensor));
     assert(tensor->element_type == LE_TYPE_FLOAT32);
         
     /// @note: I do not want to compute n twice so I will not call le_accelerate_tensor_apply_sigmoid
@@ -93,7 +99,7 @@ le_accelerate_rbf(const LeTensor *a, const LeTensor *b, float sigma)
     float *c = malloc(sizeof(float) * a->shape->sizes[0]);
     
     float result;
-    vDSP_vsub(a->data, a->stride, b->data, b->stride, c, 1, a->shape->sizes[0]);
+    vDSP_vsub(a->data, a->strides[0], b->data, b->strides[0], c, 1, a->shape->sizes[0]);
     vDSP_svesq(c, 1, &result, a->shape->sizes[0]);
 
     free(c);
@@ -113,5 +119,5 @@ le_accelerate_dot_product(const LeTensor *a, const LeTensor *b)
     assert(a->shape->sizes[1] == 1);
     assert(b->shape->sizes[1] == 1);
     
-    return cblas_sdot(a->shape->sizes[0], a->data, a->stride, b->data, b->stride);
+    return cblas_sdot(a->shape->sizes[0], a->data, a->strides[0], b->data, b->strides[0]);
 }
@@ -8,7 +8,8 @@
 
 LE_BEGIN_DECLS
 
-LeTensor * le_accelerate_matrix_new_product         (const LeTensor *a,
+void       le_accelerate_matrix_product_into        (LeTensor       *c,
+                                                     const LeTensor *a,
                                                      bool            transpose_a,
                                                      const LeTensor *b,
                                                      bool            transpose_b);
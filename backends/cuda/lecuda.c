@@ -28,13 +28,15 @@ le_cuda_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor *
     unsigned c_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
     unsigned c_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
 
-    LeTensor *c = malloc(sizeof(struct LeTensor));
+    LeTensor *c = le_alloc(sizeof(struct LeTensor));
     c->device_type = LE_DEVICE_TYPE_CUDA;
     c->element_type = a->element_type;
     c->shape = le_shape_new(2, c_height, c_width);
-    c->stride = le_shape_get_size(c->shape, -1);
+    le_tensor_init_strides(c);
     c->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(c->shape) * le_type_size(c->element_type);
+    c->mapping = LE_TENSOR_MAPPING_NONE;
+    c->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(c);
     
     cudaError_t cuda_res;
     cuda_res = cudaMalloc((void**)&c->data, data_size);
@@ -116,13 +118,15 @@ le_tensor_to_cuda(const LeTensor *cpu_tensor)
     assert(le_tensor_contiguous(cpu_tensor));
     assert(cpu_tensor->device_type == LE_DEVICE_TYPE_CPU);
     
-    LeTensor *tensor = malloc(sizeof(struct LeTensor));
+    LeTensor *tensor = le_alloc(sizeof(struct LeTensor));
     tensor->device_type = LE_DEVICE_TYPE_CUDA;
     tensor->element_type = cpu_tensor->element_type;
     tensor->shape = le_shape_copy(cpu_tensor->shape);
-    tensor->stride = le_shape_get_size(cpu_tensor->shape, -1);
+    le_tensor_init_strides(tensor);
     tensor->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(tensor->shape) * le_type_size(tensor->element_type);
+    tensor->mapping = LE_TENSOR_MAPPING_NONE;
+    tensor->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(tensor);
     
     cudaError_t cuda_res;
     cuda_res = cudaMalloc((void**)&tensor->data, data_size);
@@ -141,15 +145,17 @@ le_cuda_tensor_to_cpu(const LeTensor *cuda_tensor)
     assert(le_tensor_contiguous(cuda_tensor));
     assert(cuda_tensor->device_type == LE_DEVICE_TYPE_CUDA);
     
-    LeTensor *tensor = malloc(sizeof(struct LeTensor));
+    LeTensor *tensor = le_alloc(sizeof(struct LeTensor));
     tensor->device_type = LE_DEVICE_TYPE_CPU;
     tensor->element_type = cuda_tensor->element_type;
     tensor->shape = le_shape_copy(cuda_tensor->shape);
-    tensor->stride = le_shape_get_size(cuda_tensor->shape, -1);
+    le_tensor_init_strides(tensor);
     tensor->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(tensor->shape) * le_type_size(tensor->element_type);
+    tensor->mapping = LE_TENSOR_MAPPING_NONE;
+    tensor->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(tensor);
 
-    tensor->data = malloc(data_size);
+    tensor->data = le_alloc(data_size);
     cublasStatus_t cublas_status;
     cublas_status = cublasGetMatrix(cuda_tensor->shape->sizes[1], cuda_tensor->shape->sizes[0], sizeof(float), cuda_tensor->data, cuda_tensor->shape->sizes[1], tensor->data, tensor->shape->sizes[1]);
     assert(cublas_status == CUBLAS_STATUS_SUCCESS);
@@ -50,13 +50,15 @@ le_metal_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor
     unsigned c_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
     unsigned c_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
         
-    LeTensor *c = malloc(sizeof(struct LeTensor));
+    LeTensor *c = le_alloc(sizeof(struct LeTensor));
     c->device_type = LE_DEVICE_TYPE_METAL;
     c->element_type = LE_TYPE_FLOAT32;
     c->shape = le_shape_new(2, c_height, c_width);
-    c->stride = le_shape_get_size(c->shape, -1);
+    le_tensor_init_strides(c);
     c->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(c->shape) * le_type_size(c->element_type);
+    c->mapping = LE_TENSOR_MAPPING_NONE;
+    c->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(c);
     
     id<MTLCommandBuffer> commandBuffer = [commandQueue commandBuffer];
     
@@ -64,7 +66,7 @@ le_metal_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor
     MPSMatrixDescriptor *desc_a =
         [MPSMatrixDescriptor matrixDescriptorWithRows: c_height
                                               columns: size_a
-                                             rowBytes: a->stride * le_type_size(a->element_type)
+                                             rowBytes: a->strides[0] * le_type_size(a->element_type)
                                              dataType: MPSDataTypeFloat32];
     MPSMatrix *mxa = [[MPSMatrix alloc] initWithBuffer: buff_a
                                             descriptor: desc_a];
@@ -73,7 +75,7 @@ le_metal_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor
     MPSMatrixDescriptor *desc_b =
         [MPSMatrixDescriptor matrixDescriptorWithRows: size_b
                                               columns: c_width
-                                             rowBytes: b->stride * le_type_size(b->element_type)
+                                             rowBytes: b->strides[0] * le_type_size(b->element_type)
                                              dataType: MPSDataTypeFloat32];
     MPSMatrix *mxb = [[MPSMatrix alloc] initWithBuffer: buff_b
                                             descriptor: desc_b];
@@ -82,7 +84,7 @@ le_metal_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor
     MPSMatrixDescriptor *desc_c =
         [MPSMatrixDescriptor matrixDescriptorWithRows: c_height
                                               columns: c_width
-                                             rowBytes: c->stride * le_type_size(c->element_type)
+                                             rowBytes: c->strides[0] * le_type_size(c->element_type)
                                              dataType: MPSDataTypeFloat32];
     MPSMatrix *mxc = [[MPSMatrix alloc] initWithBuffer: buff_c
                                             descriptor: desc_c];
@@ -118,13 +120,15 @@ le_tensor_to_metal(const LeTensor *another)
     assert(le_tensor_contiguous(another));
     assert(another->device_type == LE_DEVICE_TYPE_CPU);
     
-    LeTensor *tensor = malloc(sizeof(struct LeTensor));
+    LeTensor *tensor = le_alloc(sizeof(struct LeTensor));
     tensor->device_type = LE_DEVICE_TYPE_METAL;
     tensor->element_type = another->element_type;
     tensor->shape = le_shape_copy(another->shape);
-    tensor->stride = le_shape_get_size(tensor->shape, -1);
+    le_tensor_init_strides(tensor);
     tensor->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(tensor->shape) * le_type_size(tensor->element_type);
+    tensor->mapping = LE_TENSOR_MAPPING_NONE;
+    tensor->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(tensor);
 
     tensor->data = (void *)CFBridgingRetain([device newBufferWithBytes:another->data length:data_size options:MTLResourceStorageModeManaged]);
     
@@ -138,16 +142,18 @@ le_tensor_to_cpu(const LeTensor *another)
     assert(le_tensor_contiguous(another));
     assert(another->device_type == LE_DEVICE_TYPE_METAL);
     
-    LeTensor *tensor = malloc(sizeof(struct LeTensor));
+    LeTensor *tensor = le_alloc(sizeof(struct LeTensor));
     tensor->device_type = LE_DEVICE_TYPE_CPU;
     tensor->element_type = another->element_type;
     tensor->shape = le_shape_copy(another->shape);
-    tensor->stride = le_shape_get_size(tensor->shape, -1);
+    le_tensor_init_strides(tensor);
     tensor->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(tensor->shape) * le_type_size(tensor->element_type);
+    tensor->mapping = LE_TENSOR_MAPPING_NONE;
+    tensor->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(tensor);
 
     id<MTLBuffer> buffer = (__bridge id<MTLBuffer>)(another->data);
-    tensor->data = malloc(data_size);
+    tensor->data = le_alloc(data_size);
     memcpy(tensor->data, [buffer contents], data_size);
     
     return tensor;
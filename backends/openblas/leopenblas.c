@@ -5,18 +5,18 @@
 #include <assert.h>
 #include <le/le.h>
 #include <le/tensors/letensor-imp.h>
+#include <le/lemem.h>
 #include <cblas.h>
 
-LeTensor *
-le_openblas_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+void
+le_openblas_matrix_product_into(LeTensor *c, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
 {
-    /// @todo: Take stride into account
     assert(a->element_type == LE_TYPE_FLOAT32);
     assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(c->element_type == LE_TYPE_FLOAT32);
     assert(a->shape->num_dimensions == 2);
     assert(b->shape->num_dimensions == 2);
-    assert(le_tensor_contiguous(a));
-    assert(le_tensor_contiguous(b));
+    assert(c->shape->num_dimensions == 2);
     
     unsigned size_a = transpose_a ? a->shape->sizes[0] : a->shape->sizes[1];
     unsigned size_b = transpose_b ? b->shape->sizes[1] : b->shape->sizes[0];
@@ -24,20 +24,93 @@ le_openblas_matrix_new_product(const LeTensor *a, bool transpose_a, const LeTens
     
     unsigned c_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
     unsigned c_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
+    assert(c->shape->sizes[0] == c_height);
+    assert(c->shape->sizes[1] == c_width);
     
-    LeTensor *c = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, c_height, c_width);
-    
+    /// @note: Views packed in one of dimensions are passed with their row stride as lda and ldb
+    bool layout_transpose_a, layout_transpose_b, layout_transpose_c;
+    size_t lda, ldb, ldc;
+    bool packed = le_matrix_get_gemm_layout(a, transpose_a, &layout_transpose_a, &lda) &&
+                  le_matrix_get_gemm_layout(b, transpose_b, &layout_transpose_b, &ldb) &&
+                  le_matrix_get_gemm_layout(c, false, &layout_transpose_c, &ldc);
+    assert(packed && !layout_transpose_c);
+    (void)packed;
+
     cblas_sgemm(CblasRowMajor,
-                transpose_a ? CblasTrans : CblasNoTrans,
-                transpose_b ? CblasTrans : CblasNoTrans,
+                layout_transpose_a ? CblasTrans : CblasNoTrans,
+                layout_transpose_b ? CblasTrans : CblasNoTrans,
                 c_height, c_width, size_a,
                 1.0f,
-                a->data, a->shape->sizes[1],
-                b->data, b->shape->sizes[1],
+                a->data, lda,
+                b->data, ldb,
                 0.0f,
-                c->data, c->shape->sizes[1]);
-    
-    return c;
+                c->data, ldc);
+}
+
+/// @note: Matrix of operand used for given batch, see le_tensor_new_batched_product
+static LeTensor *
+le_openblas_view_init_batch(LeTensorView *view, const LeTensor *tensor, unsigned batch)
+{
+    if (tensor->shape->num_dimensions == 2)
+        return le_tensor_view_init(view, tensor);
+    return le_tensor_view_init_pick(view, tensor, (tensor->shape->sizes[0] == 1) ? 0 : batch);
+}
+
+void
+le_openblas_batched_product_into(LeTensor *c, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+{
+    assert(a->element_type == LE_TYPE_FLOAT32);
+    assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(c->element_type == LE_TYPE_FLOAT32);
+    assert(c->shape->num_dimensions == 3);
+
+    unsigned batch_size = c->shape->sizes[0];
+#ifdef HAVE_CBLAS_SGEMM_BATCH
+    /// @note: Matrices of every operand share strides, so all products form single group
+    LeTensorView a_view, b_view, c_view;
+    bool layout_transpose_a, layout_transpose_b, layout_transpose_c;
+    size_t lda, ldb, ldc;
+    bool packed = le_matrix_get_gemm_layout(le_openblas_view_init_batch(&a_view, a, 0), transpose_a, &layout_transpose_a, &lda) &&
+                  le_matrix_get_gemm_layout(le_openblas_view_init_batch(&b_view, b, 0), transpose_b, &layout_transpose_b, &ldb) &&
+                  le_matrix_get_gemm_layout(le_tensor_view_init_pick(&c_view, c, 0), false, &layout_transpose_c, &ldc);
+    assert(packed && !layout_transpose_c);
+    (void)packed;
+
+    const float **a_array = le_alloc(batch_size * sizeof(float *));
+    const float **b_array = le_alloc(batch_size * sizeof(float *));
+    float **c_array = le_alloc(batch_size * sizeof(float *));
+    for (unsigned batch = 0; batch < batch_size; batch++)
+    {
+        a_array[batch] = le_openblas_view_init_batch(&a_view, a, batch)->data;
+        b_array[batch] = le_openblas_view_init_batch(&b_view, b, batch)->data;
+        c_array[batch] = le_tensor_view_init_pick(&c_view, c, batch)->data;
+    }
+
+    CBLAS_TRANSPOSE trans_a = layout_transpose_a ? CblasTrans : CblasNoTrans;
+    CBLAS_TRANSPOSE trans_b = layout_transpose_b ? CblasTrans : CblasNoTrans;
+    blasint m = c->shape->sizes[1];
+    blasint n = c->shape->sizes[2];
+    blasint k = transpose_a ? a->shape->sizes[a->shape->num_dimensions - 2] : a->shape->sizes[a->shape->num_dimensions - 1];
+    blasint lda_int = lda, ldb_int = ldb, ldc_int = ldc;
+    blasint group_size = batch_size;
+    float alpha = 1.0f, beta = 0.0f;
+    cblas_sgemm_batch(CblasRowMajor, &trans_a, &trans_b, &m, &n, &k,
+                      &alpha, a_array, &lda_int, b_array, &ldb_int,
+                      &beta, c_array, &ldc_int, 1, &group_size);
+
+    le_free(c_array);
+    le_free(b_array);
+    le_free(a_array);
+#else
+    /// @note: Products are computed one by one, each by all threads of OpenBLAS
+    for (unsigned batch = 0; batch < batch_size; batch++)
+    {
+        LeTensorView a_view, b_view, c_view;
+        le_openblas_matrix_product_into(le_tensor_view_init_pick(&c_view, c, batch),
+                                        le_openblas_view_init_batch(&a_view, a, batch), transpose_a,
+                                        le_openblas_view_init_batch(&b_view, b, batch), transpose_b);
+    }
+#endif
 }
 
 float
@@ -52,5 +125,5 @@ le_openblas_dot_product(const LeTensor *a, const LeTensor *b)
     assert(a->shape->sizes[1] == 1);
     assert(b->shape->sizes[1] == 1);
     
-    return cblas_sdot(a->shape->sizes[0], a->data, a->stride, b->data, b->stride);
+    return cblas_sdot(a->shape->sizes[0], a->data, a->strides[0], b->data, b->strides[0]);
 }
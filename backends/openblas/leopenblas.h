@@ -8,7 +8,16 @@
 
 LE_BEGIN_DECLS
 
-LeTensor * le_openblas_matrix_new_product         (const LeTensor *a,
+void       le_openblas_matrix_product_into        (LeTensor       *c,
+                                                   const LeTensor *a,
+                                                   bool            transpose_a,
+                                                   const LeTensor *b,
+                                                   bool            transpose_b);
+
+/// @note: a and b are single precision with matrices packed in one of dimensions,
+/// batch of size 1 and rank 2 operand are broadcast
+void       le_openblas_batched_product_into       (LeTensor       *c,
+                                                   const LeTensor *a,
                                                    bool            transpose_a,
                                                    const LeTensor *b,
                                                    bool            transpose_b);
@@ -0,0 +1,92 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <le/le.h>
+
+#define BATCH_SIZE 64
+#define MIN_BENCHMARK_SECONDS 0.5
+
+static double
+get_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// @note: Convolutional layers of LeNet-5 and 3×3 layers computed by every applicable algorithm,
+/// NHWC input of given size
+typedef struct LeBenchmarkLayer
+{
+    const char       *name;
+    unsigned          size;
+    unsigned          channels;
+    unsigned          filter_size;
+    unsigned          filters;
+    unsigned          padding;
+    LeConv2DAlgorithm algorithm;
+} LeBenchmarkLayer;
+
+static const LeBenchmarkLayer layers[] = {
+    { "C1 32x32x1 -> 28x28x6", 32, 1, 5, 6, 0, LE_CONV2D_ALGORITHM_AUTO },
+    { "C3 14x14x6 -> 10x10x16", 14, 6, 5, 16, 0, LE_CONV2D_ALGORITHM_AUTO },
+    { "C5 5x5x16 -> 1x1x120", 5, 16, 5, 120, 0, LE_CONV2D_ALGORITHM_AUTO },
+    { "3x3 16x16x32 im2col", 16, 32, 3, 32, 1, LE_CONV2D_ALGORITHM_IM2COL },
+    { "3x3 16x16x32 F(2,3)", 16, 32, 3, 32, 1, LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3 },
+    { "3x3 16x16x32 F(4,3)", 16, 32, 3, 32, 1, LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3 },
+    { "1x1 16x16x32 im2col", 16, 32, 1, 64, 0, LE_CONV2D_ALGORITHM_IM2COL },
+    { "1x1 16x16x32 pointwise", 16, 32, 1, 64, 0, LE_CONV2D_ALGORITHM_POINTWISE }
+};
+
+static double
+measure_images_per_second(LeConv2D *conv, LeTensor *input, bool backward)
+{
+    LeTensor *output = le_layer_forward_prop(LE_LAYER(conv), input);
+    unsigned iterations = 0;
+    double start = get_seconds();
+    double elapsed = 0.0;
+
+    do
+    {
+        if (backward)
+        {
+            LeList *gradients = NULL;
+            le_tensor_free(le_layer_backward_prop(LE_LAYER(conv), input, output, output, &gradients));
+            le_list_free(gradients, LE_FUNCTION(le_tensor_free));
+        }
+        else
+        {
+            le_layer_forward_prop_into(LE_LAYER(conv), output, input);
+        }
+        iterations++;
+        elapsed = get_seconds() - start;
+    }
+    while (elapsed < MIN_BENCHMARK_SECONDS);
+
+    le_tensor_free(output);
+
+    return (double)BATCH_SIZE * iterations / elapsed;
+}
+
+int
+main()
+{
+    printf("%-24s %16s %16s\n", "layer", "forward img/s", "backward img/s");
+    for (unsigned i = 0; i < sizeof(layers) / sizeof(layers[0]); i++)
+    {
+        const LeBenchmarkLayer *layer = &layers[i];
+        LeConv2D *conv = le_conv2d_new(layer->name, layer->filter_size, layer->channels, layer->filters,
+                                       layer->padding, 1);
+        le_conv2d_set_algorithm(conv, layer->algorithm);
+        LeTensor *input = le_tensor_new_rand_f32(le_shape_new(4, BATCH_SIZE, layer->size, layer->size, layer->channels));
+        double forward = measure_images_per_second(conv, input, false);
+        double backward = measure_images_per_second(conv, input, true);
+        printf("%-24s %16.0f %16.0f\n", layer->name, forward, backward);
+        le_tensor_free(input);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -2,28 +2,92 @@
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
 #include <le/tensors/lematrix.h>
+#include <le/tensors/letensor-imp.h>
 
 #define MIN_DIMENSION 16
 #define MAX_DIMENSION 48
 
+#define MIN_GFLOPS_DIMENSION 64
+#define MAX_GFLOPS_DIMENSION 512
+#define MIN_BENCHMARK_SECONDS 0.2
+
+static double
+get_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// @note: Triple loop previously used as fallback when no BLAS backend is available.
+/// Kept here as a reference point for GFLOP/s figures.
+static LeTensor *
+reference_product(const LeTensor *a, const LeTensor *b)
+{
+    unsigned height = le_matrix_get_height(a);
+    unsigned width = le_matrix_get_width(b);
+    unsigned inner = le_matrix_get_width(a);
+    LeTensor *c = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, height, width);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+        for (unsigned x = 0; x < width; x++)
+        {
+            float sum = 0.0f;
+            for (unsigned i = 0; i < inner; i++)
+            {
+                sum += ((float *)a->data)[le_matrix_offset(a, y, i)] * ((float *)b->data)[le_matrix_offset(b, i, x)];
+            }
+            ((float *)c->data)[le_matrix_offset(c, y, x)] = sum;
+        }
+    }
+
+    return c;
+}
+
+static double
+measure_gflops(LeTensor *(*product)(const LeTensor *, const LeTensor *), unsigned size)
+{
+    LeTensor *a = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, size, size);
+    LeTensor *b = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, size, size);
+    unsigned iterations = 0;
+    double start = get_seconds();
+    double elapsed = 0.0;
+
+    do
+    {
+        le_tensor_free(product(a, b));
+        iterations++;
+        elapsed = get_seconds() - start;
+    }
+    while (elapsed < MIN_BENCHMARK_SECONDS);
+
+    le_tensor_free(b);
+    le_tensor_free(a);
+
+    return 2.0 * size * size * size * iterations / elapsed * 1e-9;
+}
+
 int
 main()
 {
     unsigned width;
     unsigned height;
     unsigned second_width;
-    
+
     LeTensor *a;
     LeTensor *b;
     LeTensor *c;
-    
+
     for (height = MIN_DIMENSION; height <= MAX_DIMENSION; height++)
     {
         for (width = MIN_DIMENSION; width <= MAX_DIMENSION; width++)
         {
             a = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, height, width);
-            
+
             for (second_width = MIN_DIMENSION; second_width <= MAX_DIMENSION; second_width++)
             {
                 b = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, width, second_width);
@@ -31,9 +95,18 @@ main()
                 le_tensor_free(c);
                 le_tensor_free(b);
             }
-            
+
             le_tensor_free(a);
         }
     }
+
+    printf("%8s %16s %16s\n", "size", "loop GFLOP/s", "le GFLOP/s");
+    for (unsigned size = MIN_GFLOPS_DIMENSION; size <= MAX_GFLOPS_DIMENSION; size *= 2)
+    {
+        double reference_gflops = measure_gflops(reference_product, size);
+        double gflops = measure_gflops(le_matrix_new_product, size);
+        printf("%8u %16.2f %16.2f\n", size, reference_gflops, gflops);
+    }
+
     return EXIT_SUCCESS;
 }
@@ -24,7 +24,7 @@ Tensor::Tensor(Type t, unsigned num_dimensions, ...):
 Tensor::Tensor(Type t, Shape s):
     priv(std::make_shared<Private>())
 {
-    priv->tensor = le_tensor_new_uninitialized((LeType)t, s.c_shape());
+    priv->tensor = le_tensor_new_uninitialized((LeType)t, le_shape_copy(s.c_shape()));
 }
 
 Tensor::Tensor(const Tensor &tensor):
@@ -56,9 +56,14 @@ const LeTensor *Tensor::c_tensor() const
     return priv->tensor;
 }
 
-void * Tensor::data() const
+const void * Tensor::data() const
 {
-    return priv->tensor->data;
+    return le_tensor_get_data(priv->tensor);
+}
+
+void * Tensor::data()
+{
+    return le_tensor_get_data_mut(priv->tensor);
 }
 
 #define TENSOR_PRINT_MAX_SIZE 10
@@ -18,7 +18,9 @@ public:
     ~Tensor();
 
     const LeTensor * c_tensor() const;
-    void * data() const;
+    const void * data() const;
+    /// @note: Elements shared with copies are copied first, so they can be written
+    void * data();
 
     friend std::ostream & operator << (std::ostream &out, const Tensor &tensor);
 
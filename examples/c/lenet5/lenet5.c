@@ -1,18 +1,36 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdio.h>
 #include <stdlib.h>
 #include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define BATCH_SIZE 16
 
-int main(int argc, char *argv[])
+int
+main(int argc, char *argv[])
 {
     LeSequential *nn = le_sequential_new();
-    
-    le_sequential_add(nn, LE_LAYER(le_conv2d_new ("L1", 5,
-                          unsigned    num_channels,
-                          unsigned    num_filters,
-                          unsigned    padding,
-                          unsigned    stride);("L1", 5, 3, 1)));
-    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP1", 2)));
-    le_sequential_add(nn, LE_LAYER(le_conv2d_layer_new("L2", 5, 3, 1)));
-    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP2", 2)));
+
+    /// @note: Convolutional part of LeNet-5 for 28×28 images padded to 32×32,
+    /// subsampling layers average 2×2 windows
+    le_sequential_add(nn, LE_LAYER(le_conv2d_new("C1", 5, 1, 6, 2, 1)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_TANH)));
+    le_sequential_add(nn, LE_LAYER(le_avgpool_layer_new("S2", 2, 2, 0)));
+    le_sequential_add(nn, LE_LAYER(le_conv2d_new("C3", 5, 6, 16, 0, 1)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A3", LE_ACTIVATION_TANH)));
+    le_sequential_add(nn, LE_LAYER(le_avgpool_layer_new("S4", 2, 2, 0)));
+    le_sequential_add(nn, LE_LAYER(le_conv2d_new("C5", 5, 16, 120, 0, 1)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A5", LE_ACTIVATION_TANH)));
+
+    LeTensor *images = le_tensor_new_rand_f32(le_shape_new(4, BATCH_SIZE, 28, 28, 1));
+    LeTensor *features = le_model_predict(LE_MODEL(nn), images);
+    printf("Features: %s\n", le_shape_to_cstr(features->shape));
+
+    le_tensor_free(features);
+    le_tensor_free(images);
+    le_sequential_free(nn);
 
     return EXIT_SUCCESS;
 }
@@ -51,18 +51,14 @@ main()
     LeTensor *train_images = le_data_set_get_input(mnist->train);
     assert(le_tensor_reshape(train_images, 2, 60000, 28 * 28));
     LeTensor *train_input = le_matrix_new_transpose(train_images);
-    LeTensor *train_input_f32 = le_tensor_new_cast(train_input, LE_TYPE_FLOAT32);
-    le_tensor_mul(train_input_f32, 2.0f / 255.0f);
-    le_tensor_sub(train_input_f32, 1.0f);
+    LeTensor *train_input_f32 = le_tensor_new_cast_scaled(train_input, LE_TYPE_FLOAT32, 2.0f / 255.0f, -1.0f);
     LeTensor *train_labels = le_data_set_get_output(mnist->train);
     assert(le_tensor_reshape(train_labels, 2, 1, 60000));
     LeTensor *train_output = le_matrix_new_one_hot(LE_TYPE_FLOAT32, train_labels, 10);
     LeTensor *test_images = le_data_set_get_input(mnist->test);
     assert(le_tensor_reshape(test_images, 2, 10000, 28 * 28));
     LeTensor *test_input = le_matrix_new_transpose(test_images);
-    LeTensor *test_input_f32 = le_tensor_new_cast(test_input, LE_TYPE_FLOAT32);
-    le_tensor_mul(test_input_f32, 2.0f / 255.0f);
-    le_tensor_sub(test_input_f32, 1.0f);
+    LeTensor *test_input_f32 = le_tensor_new_cast_scaled(test_input, LE_TYPE_FLOAT32, 2.0f / 255.0f, -1.0f);
     LeTensor *test_labels = le_data_set_get_output(mnist->test);
     assert(le_tensor_reshape(test_labels, 2, 1, 10000));
     LeTensor *test_output = le_matrix_new_one_hot(LE_TYPE_FLOAT32, test_labels, 10);
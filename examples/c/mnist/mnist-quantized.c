@@ -0,0 +1,115 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Trains small network on MNIST, quantizes it to 8-bit integers and
+   reports accuracy and speed of inference compared to single precision */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+#include <ext/mnist/lemnist.h>
+
+#define CALIBRATION_EXAMPLES_COUNT 1000
+#define MIN_BENCHMARK_SECONDS 0.5
+
+static double
+get_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// @note: Predicts whole test set until enough time passes, returns seconds per prediction
+static double
+measure_prediction(LeModel *model, LeTensor *prediction, const LeTensor *input)
+{
+    unsigned runs = 0;
+    double start = get_seconds(), elapsed;
+    do
+    {
+        le_model_predict_into(model, prediction, input);
+        runs++;
+        elapsed = get_seconds() - start;
+    } while (elapsed < MIN_BENCHMARK_SECONDS);
+    return elapsed / runs;
+}
+
+static LeTensor *
+new_input(LeTensor *images, unsigned count)
+{
+    le_tensor_reshape(images, 2, count, 28 * 28);
+    LeTensor *transposed = le_matrix_new_transpose(images);
+    LeTensor *input = le_tensor_new_cast_scaled(transposed, LE_TYPE_FLOAT32, 2.0f / 255.0f, -1.0f);
+    le_tensor_free(transposed);
+    return input;
+}
+
+int
+main(int argc, char *argv[])
+{
+    MNIST *mnist = le_mnist_load(NULL);
+
+    LeTensor *train_input = new_input(le_data_set_get_input(mnist->train), 60000);
+    LeTensor *train_labels = le_data_set_get_output(mnist->train);
+    le_tensor_reshape(train_labels, 2, 1, 60000);
+    LeTensor *train_output = le_matrix_new_one_hot(LE_TYPE_FLOAT32, train_labels, 10);
+    LeTensor *test_input = new_input(le_data_set_get_input(mnist->test), 10000);
+    LeTensor *test_labels = le_data_set_get_output(mnist->test);
+    le_tensor_reshape(test_labels, 2, 1, 10000);
+    LeTensor *test_output = le_matrix_new_one_hot(LE_TYPE_FLOAT32, test_labels, 10);
+
+    LeSequential *neural_network = le_sequential_new();
+    le_sequential_add(neural_network, LE_LAYER(le_dense_layer_new("D1", 28 * 28, 256)));
+    le_sequential_add(neural_network, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_RELU)));
+    le_sequential_add(neural_network, LE_LAYER(le_dense_layer_new("D2", 256, 10)));
+    le_sequential_add(neural_network, LE_LAYER(le_activation_layer_new("Softmax", LE_ACTIVATION_SOFTMAX)));
+    le_sequential_set_loss(neural_network, LE_LOSS_CROSS_ENTROPY);
+
+    unsigned num_epochs = (argc >= 2) ? (unsigned)atoi(argv[1]) : 2;
+    LeOptimizer *optimizer = LE_OPTIMIZER(le_sgd_new(LE_MODEL(neural_network), train_input, train_output, 64, 0.03f, 0.9f));
+    for (unsigned i = 0; i < num_epochs; i++)
+    {
+        le_optimizer_epoch(optimizer);
+        printf("Epoch %u done\n", i + 1);
+    }
+    le_sgd_free(LE_SGD(optimizer));
+
+    LeTensor *prediction = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, 10, 10000);
+    double seconds = measure_prediction(LE_MODEL(neural_network), prediction, test_input);
+    float accuracy = 1.0f - le_one_hot_misclassification(prediction, test_output);
+    LeTensor *classes = le_tensor_new_reduce(prediction, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(0), false);
+
+    /// @note: Training examples are used for calibration, test ones are never seen before evaluation
+    LeTensor *calibration_input = le_matrix_get_columns_copy(train_input, 0, CALIBRATION_EXAMPLES_COUNT);
+    le_sequential_quantize(neural_network, calibration_input);
+    LeTensor *quantized_prediction = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, 10, 10000);
+    double quantized_seconds = measure_prediction(LE_MODEL(neural_network), quantized_prediction, test_input);
+    float quantized_accuracy = 1.0f - le_one_hot_misclassification(quantized_prediction, test_output);
+    LeTensor *quantized_classes = le_tensor_new_reduce(quantized_prediction, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(0), false);
+    unsigned agreements = 0;
+    for (unsigned i = 0; i < 10000; i++)
+        agreements += le_tensor_at_u32(classes, i) == le_tensor_at_u32(quantized_classes, i);
+
+    printf("          %10s %14s\n", "Accuracy", "Test Set Time");
+    printf("FLOAT32   %9.2f%% %11.2f ms\n", accuracy * 100.0f, seconds * 1e3);
+    printf("INT8      %9.2f%% %11.2f ms\n", quantized_accuracy * 100.0f, quantized_seconds * 1e3);
+    printf("Same class predicted for %.2f%% of test examples, speed-up %.2fx\n",
+           agreements * 100.0 / 10000, seconds / quantized_seconds);
+
+    le_tensor_free(quantized_classes);
+    le_tensor_free(quantized_prediction);
+    le_tensor_free(calibration_input);
+    le_tensor_free(classes);
+    le_tensor_free(prediction);
+    le_sequential_free(neural_network);
+    le_tensor_free(test_output);
+    le_tensor_free(test_input);
+    le_tensor_free(train_output);
+    le_tensor_free(train_input);
+    le_mnist_free(mnist);
+
+    return EXIT_SUCCESS;
+}
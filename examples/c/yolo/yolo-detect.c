@@ -1,14 +1,33 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdio.h>
 #include <stdlib.h>
 #include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define IMAGE_SIZE 416
 
-int main(int argc, char *argv[])
+int
+main(int argc, char *argv[])
 {
     LeSequential *nn = le_sequential_new();
-    
-    le_sequential_add(nn, LE_LAYER(le_conv2d_layer_new("L1", 16, 3, 1)));
-    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP1", 2)));
-    le_sequential_add(nn, LE_LAYER(le_conv2d_layer_new("L2", 32, 3, 1)));
-    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP2", 2)));
+
+    /// @note: First blocks of Tiny YOLO backbone, each halves resolution of RGB image
+    le_sequential_add(nn, LE_LAYER(le_conv2d_new("L1", 3, 3, 16, 1, 1)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_RELU)));
+    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP1", 2, 2, 0)));
+    le_sequential_add(nn, LE_LAYER(le_conv2d_new("L2", 3, 16, 32, 1, 1)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A2", LE_ACTIVATION_RELU)));
+    le_sequential_add(nn, LE_LAYER(le_maxpool_layer_new("MP2", 2, 2, 0)));
+
+    LeTensor *image = le_tensor_new_rand_f32(le_shape_new(4, 1, IMAGE_SIZE, IMAGE_SIZE, 3));
+    LeTensor *features = le_model_predict(LE_MODEL(nn), image);
+    printf("Features: %s\n", le_shape_to_cstr(features->shape));
+
+    le_tensor_free(features);
+    le_tensor_free(image);
+    le_sequential_free(nn);
 
     return EXIT_SUCCESS;
 }
@@ -13,6 +13,8 @@
 #endif
 #include <zlib.h>
 
+#define LE_IDX_GZ_CHUNK_SIZE (1u << 30)
+
 struct IDXHeader
 {
     uint16_t zeros;
@@ -74,8 +76,9 @@ le_idx_read(const char *filename)
                 le_shape_set_size(shape, i, bswap_32(shape_bytes[i]));
             }
 
+            size_t elements_count = le_shape_get_elements_count(shape);
             tensor = le_tensor_new_uninitialized(type, shape);
-            fread(le_tensor_get_data(tensor), le_type_size(type), le_shape_get_elements_count(shape), fin);
+            fread(le_tensor_get_data_mut(tensor), le_type_size(type), elements_count, fin);
         }
         else
         {
@@ -88,6 +91,22 @@ le_idx_read(const char *filename)
     return tensor;
 }
 
+/// @note: gzread takes unsigned length and returns int, so data is read in chunks
+static void
+le_idx_gz_read_data(struct gzFile_s *fin, void *data, size_t size)
+{
+    uint8_t *bytes = data;
+    while (size > 0)
+    {
+        unsigned chunk = (size > LE_IDX_GZ_CHUNK_SIZE) ? LE_IDX_GZ_CHUNK_SIZE : (unsigned)size;
+        int read = gzread(fin, bytes, chunk);
+        if (read <= 0)
+            break;
+        bytes += read;
+        size -= (size_t)read;
+    }
+}
+
 LeTensor *
 le_idx_gz_read(const char *filename)
 {
@@ -142,8 +161,9 @@ le_idx_gz_read(const char *filename)
                 le_shape_set_size(shape, i, bswap_32(shape_bytes[i]));
             }
             
+            size_t elements_count = le_shape_get_elements_count(shape);
             tensor = le_tensor_new_uninitialized(type, shape);
-            gzread(fin, le_tensor_get_data(tensor), (unsigned)(le_type_size(type) * le_shape_get_elements_count(shape)));
+            le_idx_gz_read_data(fin, le_tensor_get_data_mut(tensor), le_type_size(type) * elements_count);
         }
         else
         {
@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <le/tensors/letensor-imp.h>
+#include <le/lemem.h>
 
 static void
 le_tensor_serialize(LeTensor *tensor, FILE *fout)
@@ -20,8 +21,11 @@ le_tensor_serialize(LeTensor *tensor, FILE *fout)
     fwrite((uint8_t *)&tensor->element_type, sizeof(uint8_t), 1, fout);
     fwrite((uint8_t *)&tensor->shape->num_dimensions, sizeof(uint8_t), 1, fout);
     fwrite(tensor->shape->sizes, sizeof(uint32_t), tensor->shape->num_dimensions, fout);
-    unsigned elements_count = le_shape_get_elements_count(tensor->shape);
-    fwrite(tensor->data, le_type_size(tensor->element_type), elements_count, fout);
+    size_t elements_count = le_shape_get_elements_count(tensor->shape);
+    /// @note: Views are stored densely packed
+    LeTensor *packed = le_tensor_contiguous(tensor) ? NULL : le_tensor_new_copy(tensor);
+    fwrite(packed ? packed->data : tensor->data, le_type_size(tensor->element_type), elements_count, fout);
+    le_tensor_free(packed);
 }
 
 void
@@ -50,22 +54,24 @@ le_tensor_deserialize(FILE *fin)
 {
     assert(fin);
 
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    fread((uint8_t *)&self->element_type, sizeof(uint8_t), 1, fin);
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
+    uint8_t element_type = 0;
+    fread(&element_type, sizeof(uint8_t), 1, fin);
+    self->element_type = (LeType)element_type;
 
-    self->shape = malloc(sizeof(LeShape));
-    fread((uint8_t *)&self->shape->num_dimensions, sizeof(uint8_t), 1, fin);
-    self->shape->sizes = malloc(self->shape->num_dimensions * sizeof(uint32_t));
-    fread(self->shape->sizes, sizeof(uint32_t), self->shape->num_dimensions, fin);
+    uint8_t num_dimensions = 0;
+    fread(&num_dimensions, sizeof(uint8_t), 1, fin);
+    le_tensor_init_shape(self, num_dimensions, NULL);
+    fread(self->shape->sizes, sizeof(uint32_t), num_dimensions, fin);
+    le_shape_update(self->shape);
 
-    if (self->shape->num_dimensions > 0)
-        self->stride = le_shape_get_size(self->shape, -1);
-    else
-        self->stride = 0;
+    le_tensor_init_strides(self);
     self->owns_data = true;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
     self->device_type = LE_DEVICE_TYPE_CPU;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    self->data = malloc(elements_count * le_type_size(self->element_type));
+    size_t elements_count = le_shape_get_elements_count(self->shape);
+    self->data = le_alloc(elements_count * le_type_size(self->element_type));
     fread(self->data, le_type_size(self->element_type), elements_count, fin);
     
     return self;
@@ -9,8 +9,13 @@
 #include "math/lerand.h"
 #include "math/lepolynomia.h"
 #include "tensors/letensor.h"
+#include "tensors/letensor-mmap.h"
 #include "tensors/lescalar.h"
 #include "tensors/lematrix.h"
+#include "tensors/leexpr.h"
+#include "tensors/lereduce.h"
+#include "tensors/lequant.h"
+#include "tensors/lekernels.h"
 #include "leobject.h"
 #include "ledataset.h"
 #include "models/lelogistic.h"
@@ -21,12 +26,15 @@
 #include "models/layers/ledenselayer.h"
 #include "models/layers/leactivationlayer.h"
 #include "models/layers/leconv2d.h"
+#include "models/layers/lepoollayer.h"
 #include "models/leknn.h"
 #include "lelist.h"
 #include "optimization/lebgd.h"
 #include "optimization/lesgd.h"
 #include "leloss.h"
 #include "lemem.h"
+#include "lecpu.h"
+#include "leparallel.h"
 #include "lelog.h"
 
 #endif
@@ -0,0 +1,37 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "lecpu.h"
+#include <stdbool.h>
+
+unsigned
+le_cpu_get_features(void)
+{
+    static bool initialized = false;
+    static unsigned features = 0;
+
+    if (!initialized)
+    {
+        /// @note: Result is same on every call, so racing first calls from several threads is harmless
+        unsigned detected = 0;
+#ifdef LE_CPU_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2"))
+            detected |= LE_CPU_FEATURE_SSE4_2;
+        if (__builtin_cpu_supports("avx2"))
+            detected |= LE_CPU_FEATURE_AVX2;
+        if (__builtin_cpu_supports("fma"))
+            detected |= LE_CPU_FEATURE_FMA;
+        if (__builtin_cpu_supports("avx512f"))
+            detected |= LE_CPU_FEATURE_AVX512F;
+        if (__builtin_cpu_supports("f16c"))
+            detected |= LE_CPU_FEATURE_F16C;
+        if (__builtin_cpu_supports("avx512vnni"))
+            detected |= LE_CPU_FEATURE_AVX512VNNI;
+#endif
+        features = detected;
+        initialized = true;
+    }
+
+    return features;
+}
@@ -0,0 +1,32 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#ifndef __LECPU_H__
+#define __LECPU_H__
+
+#include "lemacros.h"
+
+LE_BEGIN_DECLS
+
+/// @note: Defined when per-function target attributes and x86 intrinsics are available,
+/// so SIMD kernels can be compiled regardless of global compiler flags
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#   define LE_CPU_X86 1
+#endif
+
+typedef enum LeCpuFeature
+{
+    LE_CPU_FEATURE_AVX2        = 1 << 0,
+    LE_CPU_FEATURE_FMA         = 1 << 1,
+    LE_CPU_FEATURE_AVX512F     = 1 << 2,
+    LE_CPU_FEATURE_SSE4_2      = 1 << 3,
+    LE_CPU_FEATURE_F16C        = 1 << 4,
+    LE_CPU_FEATURE_AVX512VNNI  = 1 << 5
+} LeCpuFeature;
+
+/// @note: Bitmask of LeCpuFeature detected on the host, queried once
+unsigned           le_cpu_get_features                     (void);
+
+LE_END_DECLS
+
+#endif
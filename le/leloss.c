@@ -5,11 +5,67 @@
 #include <le/math/leclamp.h>
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 #include <stdbool.h>
 #include "tensors/letensor-imp.h"
+#include "tensors/lereduce.h"
+#include "tensors/lekernels.h"
+#include "leparallel.h"
 
 #define EPSILON 1e-5f
 
+/// @note: Losses are split between threads in parts of at least this many elements
+#define LE_LOSS_PARALLEL_GRAIN 16384
+
+/// @note: Logarithms of predictions are taken with vector kernel in blocks of this many examples
+#define LE_LOSS_BLOCK 256
+
+typedef struct LeLossTask
+{
+    LeTensor       *h;
+    const LeTensor *y;
+} LeLossTask;
+
+static size_t
+le_loss_parallel_grain(size_t work_per_item)
+{
+    return work_per_item >= LE_LOSS_PARALLEL_GRAIN ? 1 : LE_LOSS_PARALLEL_GRAIN / (work_per_item ? work_per_item : 1);
+}
+
+/// @note: Loads row of predictions clamped to [EPSILON, 1 - EPSILON]
+static void
+le_loss_load_clamped_row(const LeTensor *h, unsigned y, size_t x, size_t count, float *buffer)
+{
+    le_matrix_load_row(h, y, x, count, buffer);
+    for (size_t i = 0; i < count; i++)
+        buffer[i] = le_clamp_f32(buffer[i], EPSILON, 1.0f - EPSILON);
+}
+
+/// @note: -y log(h) - (1 - y) log(1 - h) is summed as -y (log(h) - log(1 - h)) - log(1 - h)
+static float
+le_logistic_loss_part(void *data, size_t begin, size_t end)
+{
+    const LeLossTask *task = data;
+    const LeKernels *kernels = le_kernels_get();
+    float log_h[LE_LOSS_BLOCK], log_1_minus_h[LE_LOSS_BLOCK], y[LE_LOSS_BLOCK];
+    float result = 0.0f;
+
+    for (size_t x = begin; x < end; x += LE_LOSS_BLOCK)
+    {
+        size_t count = end - x < LE_LOSS_BLOCK ? end - x : LE_LOSS_BLOCK;
+        le_loss_load_clamped_row(task->h, 0, x, count, log_h);
+        memcpy(log_1_minus_h, log_h, count * sizeof(float));
+        kernels->one_minus_f32(log_1_minus_h, count);
+        kernels->log_f32(log_h, count);
+        kernels->log_f32(log_1_minus_h, count);
+        kernels->sub_f32(log_h, log_1_minus_h, count);
+        le_matrix_load_row(task->y, 0, x, count, y);
+        result -= kernels->dot_f32(y, log_h, count) + kernels->sum_f32(log_1_minus_h, count);
+    }
+
+    return result;
+}
+
 float
 le_logistic_loss(const LeTensor *h, const LeTensor *y)
 {
@@ -17,22 +73,39 @@ le_logistic_loss(const LeTensor *h, const LeTensor *y)
     assert(y->shape->num_dimensions == 2);
     assert(le_shape_equal(h->shape, y->shape));
     assert(h->shape->sizes[0] == 1);
+    assert(h->element_type == LE_TYPE_FLOAT32);
+    assert(y->element_type == LE_TYPE_FLOAT32);
     
-    float result = 0.0f;
-    unsigned i;
+    LeLossTask task = { (LeTensor *)h, y };
+    size_t elements_count = le_shape_get_elements_count(h->shape);
+    float result = le_parallel_sum_f32(elements_count, LE_LOSS_PARALLEL_GRAIN, le_logistic_loss_part, &task);
     
-    unsigned elements_count = le_shape_get_elements_count(h->shape);
-    for (i = 0; i < elements_count; i++)
+    return result / elements_count;
+}
+
+/// @note: Sums losses of examples [begin, end), class by class in blocks of examples
+static float
+le_cross_entropy_loss_part(void *data, size_t begin, size_t end)
+{
+    const LeLossTask *task = data;
+    const LeKernels *kernels = le_kernels_get();
+    unsigned num_classes = task->y->shape->sizes[0];
+    float log_h[LE_LOSS_BLOCK], y[LE_LOSS_BLOCK];
+
+    float cost = 0.0f;
+    for (size_t x = begin; x < end; x += LE_LOSS_BLOCK)
     {
-        float yi = le_tensor_at_f32(y, i);
-        float hi = le_clamp_f32(le_tensor_at_f32(h, i), EPSILON, 1.0f - EPSILON);
-        if (yi > 0)
-            result -= yi * logf(hi);
-        if (yi < 1)
-            result -= (1.0f - yi) * logf(1.0f - hi);
+        size_t count = end - x < LE_LOSS_BLOCK ? end - x : LE_LOSS_BLOCK;
+        for (unsigned j = 0; j < num_classes; j++)
+        {
+            le_loss_load_clamped_row(task->h, j, x, count, log_h);
+            kernels->log_f32(log_h, count);
+            le_matrix_load_row(task->y, j, x, count, y);
+            cost -= kernels->dot_f32(y, log_h, count);
+        }
     }
-    
-    return result / elements_count;
+
+    return cost;
 }
 
 float
@@ -48,23 +121,28 @@ le_cross_entropy_loss(const LeTensor *h, const LeTensor *y)
     unsigned num_classes = y->shape->sizes[0];
     unsigned num_examples = y->shape->sizes[1];
     
-    float cost = 0.0f;
-    for (unsigned i = 0; i < num_examples; i++)
-    {
-        float loss = 0.0f;
-        for (unsigned j = 0; j < num_classes; j++)
-        {
-            float y_ji = le_matrix_at_f32(y, j, i);
-            float h_ji = le_clamp_f32(le_matrix_at_f32(h, j, i), EPSILON, 1.0f - EPSILON);
-            if (y_ji != 0.0f)
-                loss -= y_ji * logf(h_ji);
-        }
-        cost += loss;
-    }
+    LeLossTask task = { (LeTensor *)h, y };
+    float cost = le_parallel_sum_f32(num_examples, le_loss_parallel_grain(num_classes),
+                                     le_cross_entropy_loss_part, &task);
     
     return cost / num_examples;
 }
 
+static float
+le_mse_loss_part(void *data, size_t begin, size_t end)
+{
+    const LeLossTask *task = data;
+
+    float mse = 0.0f;
+    for (size_t i = begin; i < end; i++)
+    {
+        float d = le_tensor_at_f32(task->h, i) - le_tensor_at_f32(task->y, i);
+        mse += d * d;
+    }
+
+    return mse;
+}
+
 float
 le_mse_loss(const LeTensor *h, const LeTensor *y)
 {
@@ -74,14 +152,9 @@ le_mse_loss(const LeTensor *h, const LeTensor *y)
     assert(h->element_type == LE_TYPE_FLOAT32);
     assert(y->element_type == LE_TYPE_FLOAT32);
 
-    float mse = 0.0;
-    unsigned elements_count = le_shape_get_elements_count(h->shape);
-    /// @todo: Speed up this
-    for (unsigned i = 0; i < elements_count; i++)
-    {
-        float d = le_tensor_at_f32(h, i) - le_tensor_at_f32(y, i);
-        mse += d * d;
-    }
+    LeLossTask task = { (LeTensor *)h, y };
+    size_t elements_count = le_shape_get_elements_count(h->shape);
+    float mse = le_parallel_sum_f32(elements_count, LE_LOSS_PARALLEL_GRAIN, le_mse_loss_part, &task);
     
     return mse / elements_count;
 }
@@ -96,40 +169,41 @@ le_one_hot_misclassification(const LeTensor *h, const LeTensor *y)
     assert(h->element_type == LE_TYPE_FLOAT32);
     assert(y->element_type == LE_TYPE_FLOAT32);
     
-    unsigned i, j;
-    
-    unsigned classes_count = y->shape->sizes[0];
     unsigned examples_count = y->shape->sizes[1];
-    unsigned misclassified_count = 0;
     
-    for (i = 0; i < examples_count; i++)
+    /// @note: Classes are along first dimension, one per row
+    LeTensor *predicted_classes = le_tensor_new_reduce(h, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(0), false);
+    LeTensor *labeled_classes = le_tensor_new_reduce(y, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(0), false);
+    
+    unsigned misclassified_count = 0;
+    for (unsigned i = 0; i < examples_count; i++)
     {
-        int predicted_class = -2;
-        float predicted_class_probability = 0.0f;
-        int labeled_class = -1;
-        float labeled_class_probability = 0.0f;
-        for (j = 0; j < classes_count; j++)
-        {
-            float predicted_probability = le_matrix_at_f32(h, j, i);
-            if (predicted_probability > predicted_class_probability)
-            {
-                predicted_class_probability = predicted_probability;
-                predicted_class = j;
-            }
-            float labeled_probability = le_matrix_at_f32(y, j, i);
-            if (labeled_probability > labeled_class_probability)
-            {
-                labeled_class_probability = labeled_probability;
-                labeled_class = j;
-            }
-        }
-        if (predicted_class != labeled_class)
+        if (((uint32_t *)predicted_classes->data)[i] != ((uint32_t *)labeled_classes->data)[i])
         {
             misclassified_count++;
         }
     }
     
-    return ((float)misclassified_count) / ((float)examples_count);
+    le_tensor_free(labeled_classes);
+    le_tensor_free(predicted_classes);
+    
+    return misclassified_count / ((float)examples_count);
+}
+
+static void
+le_apply_cross_entropy_loss_derivative_part(void *data, size_t begin, size_t end)
+{
+    const LeLossTask *task = data;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        float yi = le_tensor_at_f32(task->y, i);
+        float hi = le_tensor_at_f32(task->h, i); /// @note: hi ∈ (0, 1)
+        if (hi < EPSILON)
+            hi = EPSILON;
+        float dJ_dh = (yi == 0.0f) ? 0.0f : (-yi / hi);
+        le_tensor_set_f32(task->h, i, dJ_dh);
+    }
 }
 
 void
@@ -139,18 +213,91 @@ le_apply_cross_entropy_loss_derivative(LeTensor *h, const LeTensor *y)
     assert(y->shape->num_dimensions == 2);
     assert(le_shape_equal(h->shape, y->shape));
 
-    unsigned i;
-    
-    unsigned elements_count = le_shape_get_elements_count(h->shape);
-    for (i = 0; i < elements_count; i++)
+    /// @note: Elements shared with copies of h are copied once, before threads write them
+    le_tensor_make_writable(h);
+    LeLossTask task = { h, y };
+    le_parallel_for(le_shape_get_elements_count(h->shape), LE_LOSS_PARALLEL_GRAIN,
+                    le_apply_cross_entropy_loss_derivative_part, &task);
+}
+
+/// @note: Replaces logits z of examples [begin, end) by softmax(z) Σ y - y and returns their losses
+/// -Σ y (z - max - log Σ exp(z - max)). Each block of examples is read three times: for maxima,
+/// for sums of exponents, which are stored in place of logits, and for normalization.
+static float
+le_softmax_cross_entropy_part(void *data, size_t begin, size_t end)
+{
+    const LeLossTask *task = data;
+    const LeKernels *kernels = le_kernels_get();
+    unsigned num_classes = task->y->shape->sizes[0];
+    float max[LE_LOSS_BLOCK], sum[LE_LOSS_BLOCK], labels_sum[LE_LOSS_BLOCK];
+    float z[LE_LOSS_BLOCK], y[LE_LOSS_BLOCK];
+
+    float cost = 0.0f;
+    for (size_t x = begin; x < end; x += LE_LOSS_BLOCK)
     {
-        float yi = le_tensor_at_f32(y, i);
-        float hi = le_tensor_at_f32(h, i); /// @note: hi ∈ (0, 1)
-        if (hi < EPSILON)
-            hi = EPSILON;
-        float dJ_dh = (yi == 0.0f) ? 0.0f : (-yi / hi);
-        le_tensor_set_f32(h, i, dJ_dh);
+        size_t count = end - x < LE_LOSS_BLOCK ? end - x : LE_LOSS_BLOCK;
+
+        le_matrix_load_row(task->h, 0, x, count, max);
+        for (unsigned j = 1; j < num_classes; j++)
+        {
+            le_matrix_load_row(task->h, j, x, count, z);
+            kernels->max_f32(max, z, count);
+        }
+
+        memset(sum, 0, count * sizeof(float));
+        memset(labels_sum, 0, count * sizeof(float));
+        for (unsigned j = 0; j < num_classes; j++)
+        {
+            le_matrix_load_row(task->h, j, x, count, z);
+            le_matrix_load_row(task->y, j, x, count, y);
+            kernels->sub_f32(z, max, count);
+            cost -= kernels->dot_f32(y, z, count);
+            kernels->add_f32(labels_sum, y, count);
+            kernels->exp_f32(z, count);
+            kernels->add_f32(sum, z, count);
+            le_matrix_store_row(task->h, j, x, count, z);
+        }
+
+        /// @note: Labels need not sum to 1, each one takes its share of log Σ exp
+        for (size_t i = 0; i < count; i++)
+            sum[i] = 1.0f / sum[i];
+        memcpy(max, sum, count * sizeof(float));
+        kernels->log_f32(max, count);
+        cost -= kernels->dot_f32(labels_sum, max, count);
+        kernels->mul_f32(sum, labels_sum, count);
+
+        for (unsigned j = 0; j < num_classes; j++)
+        {
+            le_matrix_load_row(task->h, j, x, count, z);
+            le_matrix_load_row(task->y, j, x, count, y);
+            kernels->mul_f32(z, sum, count);
+            kernels->sub_f32(z, y, count);
+            le_matrix_store_row(task->h, j, x, count, z);
+        }
     }
+
+    return cost;
+}
+
+float
+le_apply_softmax_cross_entropy_loss_derivative(LeTensor *z, const LeTensor *y)
+{
+    assert(z->shape->num_dimensions == 2);
+    assert(y->shape->num_dimensions == 2);
+    assert(le_shape_equal(z->shape, y->shape));
+    assert(z->shape->sizes[0] >= 2);
+    assert(z->element_type == LE_TYPE_FLOAT32);
+    assert(y->element_type == LE_TYPE_FLOAT32);
+
+    unsigned num_classes = y->shape->sizes[0];
+    unsigned num_examples = y->shape->sizes[1];
+
+    le_tensor_make_writable(z);
+    LeLossTask task = { z, y };
+    float cost = le_parallel_sum_f32(num_examples, le_loss_parallel_grain(3 * (size_t)num_classes),
+                                     le_softmax_cross_entropy_part, &task);
+
+    return cost / num_examples;
 }
 
 void
@@ -159,28 +306,36 @@ le_apply_mse_loss_derivative(LeTensor *h, const LeTensor *y)
     le_tensor_sub(h, y);
 }
 
-void
-le_apply_logistic_loss_derivative(LeTensor *h, const LeTensor *y)
+static void
+le_apply_logistic_loss_derivative_part(void *data, size_t begin, size_t end)
 {
-    assert(h->shape->num_dimensions == 2);
-    assert(y->shape->num_dimensions == 2);
-    assert(le_shape_equal(h->shape, y->shape));
+    const LeLossTask *task = data;
 
-    unsigned i;
-    
-    unsigned elements_count = le_shape_get_elements_count(h->shape);
-    for (i = 0; i < elements_count; i++)
+    for (size_t i = begin; i < end; i++)
     {
-        float yi = le_tensor_at_f32(y, i);
-        float hi = le_tensor_at_f32(h, i); /// @note: hi ∈ (0, 1)
+        float yi = le_tensor_at_f32(task->y, i);
+        float hi = le_tensor_at_f32(task->h, i); /// @note: hi ∈ (0, 1)
         float denom = hi * (1.0f - hi);
         if (denom < EPSILON)
             denom = EPSILON;
         float dJ_dh = (hi == yi) ? 0 : ((hi - yi) / denom);
-        le_tensor_set_f32(h, i, dJ_dh);
+        le_tensor_set_f32(task->h, i, dJ_dh);
     }
 }
 
+void
+le_apply_logistic_loss_derivative(LeTensor *h, const LeTensor *y)
+{
+    assert(h->shape->num_dimensions == 2);
+    assert(y->shape->num_dimensions == 2);
+    assert(le_shape_equal(h->shape, y->shape));
+
+    le_tensor_make_writable(h);
+    LeLossTask task = { h, y };
+    le_parallel_for(le_shape_get_elements_count(h->shape), LE_LOSS_PARALLEL_GRAIN,
+                    le_apply_logistic_loss_derivative_part, &task);
+}
+
 float 
 le_loss(LeLoss loss, const LeTensor *predictions, const LeTensor *labels)
 {
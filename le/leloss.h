@@ -23,6 +23,13 @@ float le_one_hot_misclassification           (const LeTensor *predictions,
 void  le_apply_cross_entropy_loss_derivative (LeTensor       *predictions,
                                               const LeTensor *labels);
 
+/// @note: Cross-entropy loss of softmax of logits and its partial derivative with respect
+/// to logits, computed together from log-softmax: logits <- softmax(logits) - labels for labels
+/// summing to 1 in each example. Returns loss averaged over examples, columns of logits.
+float le_apply_softmax_cross_entropy_loss_derivative
+                                             (LeTensor       *logits,
+                                              const LeTensor *labels);
+
 /// @note: Partial derivative with respect to predictions
 /// predictions <- ∂J(predictions, labels) / ∂predictions
 void  le_apply_mse_loss_derivative           (LeTensor       *predictions,
@@ -1,20 +1,628 @@
 /* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
+/// @note: For MAP_ANONYMOUS and madvise when compiled in strict C11 mode
+#define _DEFAULT_SOURCE
+
 #include "lemem.h"
+#include <assert.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   define LE_MEM_HAVE_MMAP 1
+#endif
+
+/// @note: Blocks up to 1 KiB are spaced by LE_MEM_ALIGNMENT. Larger blocks have
+/// four classes per power of two, so at most 25% of block is unused.
+#define LE_MEM_SMALL_CLASSES 16
+#define LE_MEM_SMALL_LIMIT_LOG2 10
+#define LE_MEM_SMALL_LIMIT ((size_t)1 << LE_MEM_SMALL_LIMIT_LOG2)
+#define LE_MEM_CLASSES_PER_DOUBLING 4
+
+/// @note: Blocks larger than 256 MiB are not cached
+#define LE_MEM_MAX_CACHED_LOG2 28
+#define LE_MEM_NUM_CLASSES (LE_MEM_SMALL_CLASSES + (LE_MEM_MAX_CACHED_LOG2 - LE_MEM_SMALL_LIMIT_LOG2) * LE_MEM_CLASSES_PER_DOUBLING)
+#define LE_MEM_UNCACHED LE_MEM_NUM_CLASSES
+
+/// @note: Blocks up to 256 KiB are cached per thread, larger ones only in global cache
+#define LE_MEM_THREAD_CACHE_MAX_LOG2 18
+#define LE_MEM_THREAD_CACHE_CLASSES (LE_MEM_SMALL_CLASSES + (LE_MEM_THREAD_CACHE_MAX_LOG2 - LE_MEM_SMALL_LIMIT_LOG2) * LE_MEM_CLASSES_PER_DOUBLING)
+
+/// @note: Bytes kept per size class. Each cache holds between min and max blocks of a class.
+#define LE_MEM_THREAD_CACHE_CLASS_BYTES ((size_t)1 << 20)
+#define LE_MEM_THREAD_CACHE_MIN_BLOCKS 4
+#define LE_MEM_THREAD_CACHE_MAX_BLOCKS 256
+#define LE_MEM_GLOBAL_CACHE_CLASS_BYTES ((size_t)64 << 20)
+#define LE_MEM_GLOBAL_CACHE_MIN_BLOCKS 1
+#define LE_MEM_GLOBAL_CACHE_MAX_BLOCKS 4096
+
+/// @note: Blocks of at least this size are mapped directly, aligned and advised to use huge pages
+#define LE_MEM_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+#define LE_MEM_MAGIC 0x4C454D4Du
+#define LE_MEM_ARENA_MAGIC 0x4C454152u
+
+/// @note: Smallest arena chunk, arena grows by doubling
+#define LE_ARENA_CHUNK_SIZE ((size_t)1 << 20)
+#define LE_ARENA_MAX_DEPTH 16
+
+/// @note: Stored in front of every block, block itself starts LE_MEM_ALIGNMENT bytes later
+typedef struct LeMemHeader
+{
+    uint32_t magic;
+    uint32_t size_class;
+    /// @note: For arena blocks, bytes of arena taken by block including header
+    size_t   size;
+    /// @note: Zero for blocks from aligned_alloc
+    size_t   mapped_size;
+    /// @note: Block is released by le_free dropping last reference
+    atomic_uint references;
+    /// @note: References taken by views, they are counted in references too
+    atomic_uint views;
+} LeMemHeader;
+
+_Static_assert(sizeof(LeMemHeader) <= LE_MEM_ALIGNMENT, "Block header must fit into alignment");
+
+/// @note: Cached blocks are linked through their first bytes
+typedef struct LeMemFreeBlock
+{
+    struct LeMemFreeBlock *next;
+} LeMemFreeBlock;
+
+typedef struct LeMemThreadCache
+{
+    LeMemFreeBlock *blocks[LE_MEM_THREAD_CACHE_CLASSES];
+    unsigned        counts[LE_MEM_THREAD_CACHE_CLASSES];
+    bool            registered;
+} LeMemThreadCache;
+
+typedef struct LeMemGlobalCache
+{
+    pthread_mutex_t mutex;
+    LeMemFreeBlock *blocks[LE_MEM_NUM_CLASSES];
+    unsigned        counts[LE_MEM_NUM_CLASSES];
+} LeMemGlobalCache;
+
+/// @note: Placed in first LE_MEM_ALIGNMENT bytes of chunk memory
+typedef struct LeArenaChunk
+{
+    struct LeArenaChunk *next;
+    size_t               capacity;
+} LeArenaChunk;
+
+_Static_assert(sizeof(LeArenaChunk) <= LE_MEM_ALIGNMENT, "Arena chunk header must fit into alignment");
+
+typedef struct LeArenaMark
+{
+    LeArenaChunk *chunk;
+    size_t        offset;
+} LeArenaMark;
+
+/// @note: Blocks are taken from current chunk at offset. Chunks are kept between scopes.
+typedef struct LeArena
+{
+    LeArenaChunk *chunks;
+    LeArenaChunk *current;
+    size_t        offset;
+    size_t        capacity;
+    unsigned      depth;
+    LeArenaMark   marks[LE_ARENA_MAX_DEPTH];
+} LeArena;
+
+static _Thread_local LeMemThreadCache thread_cache;
+
+static _Thread_local LeArena thread_arena;
+
+static LeMemGlobalCache global_cache = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+/// @note: Destructor returns blocks of exiting thread to global cache and frees its arena
+static pthread_key_t thread_cache_key;
+static pthread_once_t thread_cache_key_once = PTHREAD_ONCE_INIT;
+
+static atomic_size_t bytes_in_use;
+static atomic_size_t peak_bytes_in_use;
+static _Atomic uint64_t cache_hits;
+static _Atomic uint64_t cache_misses;
+
+static unsigned
+le_mem_floor_log2(size_t value)
+{
+    unsigned log2 = 0;
+    while (value >>= 1)
+        log2++;
+    return log2;
+}
+
+static unsigned
+le_mem_get_size_class(size_t size)
+{
+    if (size <= LE_MEM_SMALL_LIMIT)
+        return (size > 0) ? (unsigned)((size - 1) / LE_MEM_ALIGNMENT) : 0;
+
+    unsigned log2 = le_mem_floor_log2(size - 1);
+    if (log2 >= LE_MEM_MAX_CACHED_LOG2)
+        return LE_MEM_UNCACHED;
+
+    size_t step = (size_t)1 << (log2 - 2);
+    unsigned sub_class = (unsigned)((size - 1 - ((size_t)1 << log2)) / step);
+    return LE_MEM_SMALL_CLASSES + (log2 - LE_MEM_SMALL_LIMIT_LOG2) * LE_MEM_CLASSES_PER_DOUBLING + sub_class;
+}
+
+static size_t
+le_mem_get_class_size(unsigned size_class)
+{
+    if (size_class < LE_MEM_SMALL_CLASSES)
+        return (size_class + 1) * (size_t)LE_MEM_ALIGNMENT;
+
+    unsigned index = size_class - LE_MEM_SMALL_CLASSES;
+    unsigned log2 = LE_MEM_SMALL_LIMIT_LOG2 + index / LE_MEM_CLASSES_PER_DOUBLING;
+    return ((size_t)1 << log2) + (index % LE_MEM_CLASSES_PER_DOUBLING + 1) * ((size_t)1 << (log2 - 2));
+}
+
+static unsigned
+le_mem_get_cache_limit(unsigned size_class, size_t class_bytes, unsigned min_blocks, unsigned max_blocks)
+{
+    size_t blocks = class_bytes / le_mem_get_class_size(size_class);
+    if (blocks < min_blocks)
+        return min_blocks;
+    if (blocks > max_blocks)
+        return max_blocks;
+    return (unsigned)blocks;
+}
+
+static LeMemHeader *
+le_mem_get_header(void *block)
+{
+    LeMemHeader *header = (LeMemHeader *)((uint8_t *)block - LE_MEM_ALIGNMENT);
+    assert((header->magic == LE_MEM_MAGIC) || (header->magic == LE_MEM_ARENA_MAGIC));
+    return header;
+}
+
+#ifdef LE_MEM_HAVE_MMAP
+static void *
+le_mem_map(size_t size, size_t *mapped_size)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size = (size + page_size - 1) / page_size * page_size;
+
+    /// @note: Extra huge page is mapped so start of block can be aligned to it.
+    /// Unused head and tail are returned right away.
+    size_t length = size + LE_MEM_HUGE_PAGE_SIZE;
+    uint8_t *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        return NULL;
+
+    uint8_t *start = (uint8_t *)(((uintptr_t)mapping + LE_MEM_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(LE_MEM_HUGE_PAGE_SIZE - 1));
+    if (start > mapping)
+        munmap(mapping, start - mapping);
+    if (mapping + length > start + size)
+        munmap(start + size, (mapping + length) - (start + size));
+
+#ifdef MADV_HUGEPAGE
+    madvise(start, size, MADV_HUGEPAGE);
+#endif
+
+    *mapped_size = size;
+    return start;
+}
+#endif
+
+static void *
+le_mem_system_alloc(size_t size, unsigned size_class)
+{
+    size_t total_size = LE_MEM_ALIGNMENT + size;
+    size_t mapped_size = 0;
+    LeMemHeader *header;
+
+#ifdef LE_MEM_HAVE_MMAP
+    if (total_size >= LE_MEM_HUGE_PAGE_SIZE)
+        header = le_mem_map(total_size, &mapped_size);
+    else
+#endif
+        header = aligned_alloc(LE_MEM_ALIGNMENT, total_size);
+
+    if (header == NULL)
+        return NULL;
+
+    header->magic = LE_MEM_MAGIC;
+    header->size_class = size_class;
+    header->size = size;
+    header->mapped_size = mapped_size;
+
+    return (uint8_t *)header + LE_MEM_ALIGNMENT;
+}
+
+static void
+le_mem_system_free(void *block)
+{
+    LeMemHeader *header = le_mem_get_header(block);
+    header->magic = 0;
+
+#ifdef LE_MEM_HAVE_MMAP
+    if (header->mapped_size)
+    {
+        munmap(header, header->mapped_size);
+        return;
+    }
+#endif
+
+    free(header);
+}
+
+static void
+le_mem_system_free_list(LeMemFreeBlock *blocks)
+{
+    while (blocks)
+    {
+        LeMemFreeBlock *next = blocks->next;
+        le_mem_system_free(blocks);
+        blocks = next;
+    }
+}
+
+/// @note: Moves count blocks from thread cache to global cache. Blocks which do not fit
+/// into global cache are returned to system.
+static void
+le_mem_thread_cache_flush(LeMemThreadCache *cache, unsigned size_class, unsigned count)
+{
+    LeMemFreeBlock *released = NULL;
+    unsigned limit = le_mem_get_cache_limit(size_class, LE_MEM_GLOBAL_CACHE_CLASS_BYTES,
+                                            LE_MEM_GLOBAL_CACHE_MIN_BLOCKS, LE_MEM_GLOBAL_CACHE_MAX_BLOCKS);
+
+    pthread_mutex_lock(&global_cache.mutex);
+    for (unsigned i = 0; i < count; i++)
+    {
+        LeMemFreeBlock *block = cache->blocks[size_class];
+        cache->blocks[size_class] = block->next;
+        cache->counts[size_class]--;
+
+        if (global_cache.counts[size_class] < limit)
+        {
+            block->next = global_cache.blocks[size_class];
+            global_cache.blocks[size_class] = block;
+            global_cache.counts[size_class]++;
+        }
+        else
+        {
+            block->next = released;
+            released = block;
+        }
+    }
+    pthread_mutex_unlock(&global_cache.mutex);
+
+    le_mem_system_free_list(released);
+}
+
+static void
+le_arena_release_chunks(LeArena *arena)
+{
+    LeArenaChunk *chunk = arena->chunks;
+    while (chunk)
+    {
+        LeArenaChunk *next = chunk->next;
+        le_mem_system_free(chunk);
+        chunk = next;
+    }
+
+    arena->chunks = NULL;
+    arena->current = NULL;
+    arena->offset = 0;
+    arena->capacity = 0;
+}
+
+static void
+le_mem_thread_cache_destroy(void *data)
+{
+    LeMemThreadCache *cache = data;
+
+    for (unsigned size_class = 0; size_class < LE_MEM_THREAD_CACHE_CLASSES; size_class++)
+    {
+        if (cache->counts[size_class] > 0)
+            le_mem_thread_cache_flush(cache, size_class, cache->counts[size_class]);
+    }
+    cache->registered = false;
+
+    le_arena_release_chunks(&thread_arena);
+    thread_arena.depth = 0;
+}
+
+static void
+le_mem_create_thread_cache_key(void)
+{
+    pthread_key_create(&thread_cache_key, le_mem_thread_cache_destroy);
+}
+
+static void
+le_mem_thread_cache_register(LeMemThreadCache *cache)
+{
+    if (!cache->registered)
+    {
+        pthread_once(&thread_cache_key_once, le_mem_create_thread_cache_key);
+        pthread_setspecific(thread_cache_key, cache);
+        cache->registered = true;
+    }
+}
+
+/// @note: Takes up to half of thread cache limit from global cache at once
+static void
+le_mem_thread_cache_refill(LeMemThreadCache *cache, unsigned size_class)
+{
+    unsigned count = le_mem_get_cache_limit(size_class, LE_MEM_THREAD_CACHE_CLASS_BYTES,
+                                            LE_MEM_THREAD_CACHE_MIN_BLOCKS, LE_MEM_THREAD_CACHE_MAX_BLOCKS) / 2;
+
+    pthread_mutex_lock(&global_cache.mutex);
+    for (unsigned i = 0; (i < count) && global_cache.blocks[size_class]; i++)
+    {
+        LeMemFreeBlock *block = global_cache.blocks[size_class];
+        global_cache.blocks[size_class] = block->next;
+        global_cache.counts[size_class]--;
+
+        block->next = cache->blocks[size_class];
+        cache->blocks[size_class] = block;
+        cache->counts[size_class]++;
+    }
+    pthread_mutex_unlock(&global_cache.mutex);
+}
+
+static LeMemFreeBlock *
+le_mem_cache_pop(unsigned size_class)
+{
+    LeMemFreeBlock *block;
+
+    if (size_class < LE_MEM_THREAD_CACHE_CLASSES)
+    {
+        LeMemThreadCache *cache = &thread_cache;
+        if (cache->blocks[size_class] == NULL)
+            le_mem_thread_cache_refill(cache, size_class);
+
+        block = cache->blocks[size_class];
+        if (block)
+        {
+            cache->blocks[size_class] = block->next;
+            cache->counts[size_class]--;
+        }
+        return block;
+    }
+
+    pthread_mutex_lock(&global_cache.mutex);
+    block = global_cache.blocks[size_class];
+    if (block)
+    {
+        global_cache.blocks[size_class] = block->next;
+        global_cache.counts[size_class]--;
+    }
+    pthread_mutex_unlock(&global_cache.mutex);
+
+    return block;
+}
+
+static void
+le_mem_cache_push(LeMemFreeBlock *block, unsigned size_class)
+{
+    if (size_class < LE_MEM_THREAD_CACHE_CLASSES)
+    {
+        LeMemThreadCache *cache = &thread_cache;
+        le_mem_thread_cache_register(cache);
+
+        unsigned limit = le_mem_get_cache_limit(size_class, LE_MEM_THREAD_CACHE_CLASS_BYTES,
+                                                LE_MEM_THREAD_CACHE_MIN_BLOCKS, LE_MEM_THREAD_CACHE_MAX_BLOCKS);
+        if (cache->counts[size_class] >= limit)
+            le_mem_thread_cache_flush(cache, size_class, limit / 2);
+
+        block->next = cache->blocks[size_class];
+        cache->blocks[size_class] = block;
+        cache->counts[size_class]++;
+        return;
+    }
+
+    unsigned limit = le_mem_get_cache_limit(size_class, LE_MEM_GLOBAL_CACHE_CLASS_BYTES,
+                                            LE_MEM_GLOBAL_CACHE_MIN_BLOCKS, LE_MEM_GLOBAL_CACHE_MAX_BLOCKS);
+    bool cached = false;
+
+    pthread_mutex_lock(&global_cache.mutex);
+    if (global_cache.counts[size_class] < limit)
+    {
+        block->next = global_cache.blocks[size_class];
+        global_cache.blocks[size_class] = block;
+        global_cache.counts[size_class]++;
+        cached = true;
+    }
+    pthread_mutex_unlock(&global_cache.mutex);
+
+    if (!cached)
+        le_mem_system_free(block);
+}
+
+static LeArenaChunk *
+le_arena_new_chunk(size_t capacity)
+{
+    LeArenaChunk *chunk = le_mem_system_alloc(LE_MEM_ALIGNMENT + capacity, LE_MEM_UNCACHED);
+    if (chunk)
+    {
+        chunk->next = NULL;
+        chunk->capacity = capacity;
+    }
+    return chunk;
+}
+
+static void *
+le_arena_bump(LeArena *arena, size_t size)
+{
+    size_t needed = LE_MEM_ALIGNMENT + (size + LE_MEM_ALIGNMENT - 1) / LE_MEM_ALIGNMENT * LE_MEM_ALIGNMENT;
+
+    /// @note: Chunks after current one are left from previous scopes and reused first
+    while ((arena->current == NULL) || (arena->offset + needed > arena->current->capacity))
+    {
+        LeArenaChunk *next = arena->current ? arena->current->next : arena->chunks;
+        if (next == NULL)
+        {
+            size_t capacity = (arena->capacity > LE_ARENA_CHUNK_SIZE) ? arena->capacity : LE_ARENA_CHUNK_SIZE;
+            if (capacity < needed)
+                capacity = needed;
+
+            next = le_arena_new_chunk(capacity);
+            if (next == NULL)
+                return NULL;
+
+            if (arena->current)
+                arena->current->next = next;
+            else
+                arena->chunks = next;
+            arena->capacity += capacity;
+        }
+        arena->current = next;
+        arena->offset = 0;
+    }
+
+    uint8_t *chunk_data = (uint8_t *)arena->current + LE_MEM_ALIGNMENT;
+    LeMemHeader *header = (LeMemHeader *)(chunk_data + arena->offset);
+    header->magic = LE_MEM_ARENA_MAGIC;
+    header->size_class = LE_MEM_UNCACHED;
+    header->size = needed;
+    header->mapped_size = 0;
+    atomic_init(&header->references, 1);
+    atomic_init(&header->views, 0);
+    arena->offset += needed;
+
+    return (uint8_t *)header + LE_MEM_ALIGNMENT;
+}
+
+/// @note: Only most recent block is given back, so temporaries freed in reverse order
+/// of allocation do not grow arena
+static void
+le_arena_free(LeArena *arena, LeMemHeader *header)
+{
+    if (arena->current &&
+        ((uint8_t *)header + header->size == (uint8_t *)arena->current + LE_MEM_ALIGNMENT + arena->offset))
+    {
+        arena->offset -= header->size;
+    }
+}
 
 void *
 le_alloc(size_t size)
 {
-    return malloc(size);
+    /// @note: Leaves room for header and huge page alignment
+    if (size > SIZE_MAX - 2 * LE_MEM_HUGE_PAGE_SIZE)
+        return NULL;
+
+    unsigned size_class = le_mem_get_size_class(size);
+    size_t block_size;
+    void *block = NULL;
+
+    if (size_class == LE_MEM_UNCACHED)
+    {
+        block_size = (size + LE_MEM_ALIGNMENT - 1) / LE_MEM_ALIGNMENT * LE_MEM_ALIGNMENT;
+    }
+    else
+    {
+        block_size = le_mem_get_class_size(size_class);
+        block = le_mem_cache_pop(size_class);
+    }
+
+    if (block)
+    {
+        atomic_fetch_add_explicit(&cache_hits, 1, memory_order_relaxed);
+    }
+    else
+    {
+        atomic_fetch_add_explicit(&cache_misses, 1, memory_order_relaxed);
+        block = le_mem_system_alloc(block_size, size_class);
+        if (block == NULL)
+            return NULL;
+    }
+    atomic_init(&le_mem_get_header(block)->references, 1);
+    atomic_init(&le_mem_get_header(block)->views, 0);
+
+    size_t in_use = atomic_fetch_add_explicit(&bytes_in_use, block_size, memory_order_relaxed) + block_size;
+    size_t peak = atomic_load_explicit(&peak_bytes_in_use, memory_order_relaxed);
+    while ((in_use > peak) &&
+           !atomic_compare_exchange_weak_explicit(&peak_bytes_in_use, &peak, in_use,
+                                                  memory_order_relaxed, memory_order_relaxed));
+
+    return block;
 }
 
 void
 le_free(void *block)
 {
-    free(block);
+    if (block == NULL)
+        return;
+
+    LeMemHeader *header = le_mem_get_header(block);
+    /// @note: Sole owner does not need atomic read-modify-write
+    if ((atomic_load_explicit(&header->references, memory_order_acquire) != 1) &&
+        (atomic_fetch_sub_explicit(&header->references, 1, memory_order_acq_rel) != 1))
+        return;
+
+    if (header->magic == LE_MEM_ARENA_MAGIC)
+    {
+        le_arena_free(&thread_arena, header);
+        return;
+    }
+
+    atomic_fetch_sub_explicit(&bytes_in_use, header->size, memory_order_relaxed);
+
+    if (header->size_class == LE_MEM_UNCACHED)
+        le_mem_system_free(block);
+    else
+        le_mem_cache_push(block, header->size_class);
+}
+
+void *
+le_retain(void *block)
+{
+    if (block)
+        atomic_fetch_add_explicit(&le_mem_get_header(block)->references, 1, memory_order_relaxed);
+    return block;
+}
+
+bool
+le_mem_is_shared(const void *block)
+{
+    LeMemHeader *header = le_mem_get_header((void *)block);
+    unsigned views = atomic_load_explicit(&header->views, memory_order_acquire);
+    return atomic_load_explicit(&header->references, memory_order_acquire) > views + 1;
+}
+
+void *
+le_mem_retain_view(void *block)
+{
+    /// @note: Reference is added first, so that block never looks owned by views only
+    le_retain(block);
+    if (block)
+        atomic_fetch_add_explicit(&le_mem_get_header(block)->views, 1, memory_order_release);
+    return block;
+}
+
+void
+le_mem_release_view(void *block)
+{
+    if (block == NULL)
+        return;
+
+    atomic_fetch_sub_explicit(&le_mem_get_header(block)->views, 1, memory_order_release);
+    le_free(block);
+}
+
+bool
+le_mem_has_views(const void *block)
+{
+    LeMemHeader *header = le_mem_get_header((void *)block);
+    return atomic_load_explicit(&header->views, memory_order_acquire) > 0;
+}
+
+bool
+le_mem_is_scratch(const void *block)
+{
+    return le_mem_get_header((void *)block)->magic == LE_MEM_ARENA_MAGIC;
 }
 
 char *
@@ -27,4 +635,94 @@ le_strdup(const char *str)
         memcpy(copy, str, size);
     }
     return copy;
-}
\ No newline at end of file
+}
+
+LeMemStats
+le_mem_get_stats(void)
+{
+    LeMemStats stats;
+    stats.bytes_in_use = atomic_load_explicit(&bytes_in_use, memory_order_relaxed);
+    stats.peak_bytes_in_use = atomic_load_explicit(&peak_bytes_in_use, memory_order_relaxed);
+    stats.cache_hits = atomic_load_explicit(&cache_hits, memory_order_relaxed);
+    stats.cache_misses = atomic_load_explicit(&cache_misses, memory_order_relaxed);
+
+    uint64_t allocations = stats.cache_hits + stats.cache_misses;
+    stats.cache_hit_rate = allocations ? (float)((double)stats.cache_hits / allocations) : 0.0f;
+
+    return stats;
+}
+
+void
+le_arena_push(void)
+{
+    LeArena *arena = &thread_arena;
+    assert(arena->depth < LE_ARENA_MAX_DEPTH);
+
+    le_mem_thread_cache_register(&thread_cache);
+    arena->marks[arena->depth].chunk = arena->current;
+    arena->marks[arena->depth].offset = arena->offset;
+    arena->depth++;
+}
+
+void *
+le_arena_alloc(size_t size)
+{
+    if (thread_arena.depth == 0)
+        return le_alloc(size);
+
+    if (size > SIZE_MAX - 2 * LE_MEM_ALIGNMENT)
+        return NULL;
+
+    return le_arena_bump(&thread_arena, size);
+}
+
+void
+le_arena_pop(void)
+{
+    LeArena *arena = &thread_arena;
+    assert(arena->depth > 0);
+
+    arena->depth--;
+    arena->current = arena->marks[arena->depth].chunk;
+    arena->offset = arena->marks[arena->depth].offset;
+
+    /// @note: Arena which needed several chunks is replaced by single chunk
+    /// of same capacity, so next scopes fit into it
+    if ((arena->depth == 0) && arena->chunks && arena->chunks->next)
+    {
+        size_t capacity = arena->capacity;
+        le_arena_release_chunks(arena);
+        arena->chunks = le_arena_new_chunk(capacity);
+        if (arena->chunks)
+            arena->capacity = capacity;
+    }
+}
+
+void
+le_mem_trim(void)
+{
+    LeMemThreadCache *cache = &thread_cache;
+    for (unsigned size_class = 0; size_class < LE_MEM_THREAD_CACHE_CLASSES; size_class++)
+    {
+        le_mem_system_free_list(cache->blocks[size_class]);
+        cache->blocks[size_class] = NULL;
+        cache->counts[size_class] = 0;
+    }
+
+    LeMemFreeBlock *blocks[LE_MEM_NUM_CLASSES];
+
+    pthread_mutex_lock(&global_cache.mutex);
+    for (unsigned size_class = 0; size_class < LE_MEM_NUM_CLASSES; size_class++)
+    {
+        blocks[size_class] = global_cache.blocks[size_class];
+        global_cache.blocks[size_class] = NULL;
+        global_cache.counts[size_class] = 0;
+    }
+    pthread_mutex_unlock(&global_cache.mutex);
+
+    for (unsigned size_class = 0; size_class < LE_MEM_NUM_CLASSES; size_class++)
+        le_mem_system_free_list(blocks[size_class]);
+
+    if (thread_arena.depth == 0)
+        le_arena_release_chunks(&thread_arena);
+}
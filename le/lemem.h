@@ -1,20 +1,80 @@
 /* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
+/* Memory allocator used for tensors and library objects. Blocks are pooled in size
+   classes and cached per thread, so repeated allocations of same size are cheap. */
+
 #ifndef __LEMEM_H__
 #define __LEMEM_H__
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "lemacros.h"
 
 LE_BEGIN_DECLS
 
-void *             le_malloc                               (size_t                  size);
+/// @note: Alignment of every block returned by le_alloc, wide enough for any SIMD load
+#define LE_MEM_ALIGNMENT 64
+
+typedef struct LeMemStats
+{
+    /// @note: Bytes of size classes handed out and not freed yet
+    size_t   bytes_in_use;
+    size_t   peak_bytes_in_use;
+    /// @note: Allocations served from thread or global cache
+    uint64_t cache_hits;
+    /// @note: Allocations which had to request memory from system
+    uint64_t cache_misses;
+    float    cache_hit_rate;
+} LeMemStats;
 
+/// @note: Returns LE_MEM_ALIGNMENT-aligned block which must be freed with le_free.
+/// Large blocks are mapped directly and advised to use huge pages.
+void *             le_alloc                                (size_t                  size);
+
+/// @note: Drops reference to block, block is released when no references are left
 void               le_free                                 (void *                  ptr);
 
+/// @note: Adds reference to block returned by le_alloc and returns it. Every reference,
+/// including the one taken by le_alloc, is dropped by le_free.
+void *             le_retain                               (void *                  ptr);
+
+/// @note: Whether block has more than one reference not taken by views
+bool               le_mem_is_shared                        (const void *            ptr);
+
+/// @note: Adds reference to block taken by view of its elements and returns block.
+/// Dropped by le_mem_release_view.
+void *             le_mem_retain_view                      (void *                  ptr);
+
+void               le_mem_release_view                     (void *                  ptr);
+
+/// @note: Whether views of elements of block are alive
+bool               le_mem_has_views                        (const void *            ptr);
+
+/// @note: Whether block was returned by le_arena_alloc from scratch scope
+bool               le_mem_is_scratch                       (const void *            ptr);
+
 char *             le_strdup                               (const char *            str);
 
+LeMemStats         le_mem_get_stats                        (void);
+
+/// @note: Returns cached blocks of calling thread and global cache to system
+void               le_mem_trim                             (void);
+
+/// @note: Starts scratch scope on calling thread, see le_arena_alloc. Scopes can be nested.
+/// le_alloc is not affected by scopes, so objects created inside scope may outlive it.
+void               le_arena_push                           (void);
+
+/// @note: Releases all blocks taken by le_arena_alloc on calling thread since matching
+/// le_arena_push. Arena memory is kept for next scopes.
+void               le_arena_pop                            (void);
+
+/// @note: Block for temporary which is not used after end of innermost scratch scope of calling
+/// thread. Inside scope it bumps pointer in thread arena, outside of scopes it is le_alloc.
+/// le_free of arena block gives memory back only if it is the most recent block.
+void *             le_arena_alloc                          (size_t                  size);
+
 LE_END_DECLS
 
 #endif
@@ -0,0 +1,306 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#define DEFAULT_LOG_CATEGORY "parallel"
+
+#include "leparallel.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <le/lelog.h>
+
+/// @note: Task is split into at most one part per thread
+typedef void (*LeParallelTask)(void *data, unsigned part, unsigned parts_count);
+
+typedef struct LeThreadPool
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  work_available;
+    pthread_cond_t  work_done;
+    pthread_t      *threads;
+    unsigned        threads_count;
+    unsigned long   generation;
+    bool            stop;
+
+    LeParallelTask  task;
+    void           *data;
+    unsigned        parts_count;
+    unsigned        next_part;
+    unsigned        pending_parts;
+} LeThreadPool;
+
+static LeThreadPool pool = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .work_available = PTHREAD_COND_INITIALIZER,
+    .work_done = PTHREAD_COND_INITIALIZER
+};
+
+/// @note: Held by thread submitting work to pool. Other threads run their work serially.
+static pthread_mutex_t dispatch_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned num_threads = 0;
+
+/// @note: Set on pool threads and on submitting thread while it takes part in work
+static _Thread_local bool in_parallel_region = false;
+
+static unsigned
+le_parallel_get_default_num_threads(void)
+{
+    const char *env = getenv("LE_NUM_THREADS");
+    if (env)
+    {
+        int value = atoi(env);
+        if (value > 0)
+            return value;
+        LE_WARNING("Ignoring LE_NUM_THREADS=%s", env);
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cpus > 0) ? (unsigned)cpus : 1;
+}
+
+/// @note: Must be called with pool mutex locked. Runs parts until none left.
+static void
+le_thread_pool_process(void)
+{
+    while (pool.next_part < pool.parts_count)
+    {
+        unsigned part = pool.next_part++;
+        LeParallelTask task = pool.task;
+        void *data = pool.data;
+        unsigned parts_count = pool.parts_count;
+
+        pthread_mutex_unlock(&pool.mutex);
+        task(data, part, parts_count);
+        pthread_mutex_lock(&pool.mutex);
+
+        if (--pool.pending_parts == 0)
+            pthread_cond_signal(&pool.work_done);
+    }
+}
+
+/// @note: Argument is generation of pool at the moment thread was started,
+/// so work submitted before thread gets to run is not missed
+static void *
+le_thread_pool_worker(void *start_generation)
+{
+    unsigned long seen_generation = (uintptr_t)start_generation;
+    in_parallel_region = true;
+
+    pthread_mutex_lock(&pool.mutex);
+    while (true)
+    {
+        while ((pool.generation == seen_generation) && !pool.stop)
+            pthread_cond_wait(&pool.work_available, &pool.mutex);
+
+        if (pool.stop)
+            break;
+
+        seen_generation = pool.generation;
+        le_thread_pool_process();
+    }
+    pthread_mutex_unlock(&pool.mutex);
+
+    return NULL;
+}
+
+/// @note: Must be called with dispatch mutex locked
+static void
+le_thread_pool_stop(void)
+{
+    if (pool.threads_count == 0)
+        return;
+
+    pthread_mutex_lock(&pool.mutex);
+    pool.stop = true;
+    pthread_cond_broadcast(&pool.work_available);
+    pthread_mutex_unlock(&pool.mutex);
+
+    for (unsigned i = 0; i < pool.threads_count; i++)
+        pthread_join(pool.threads[i], NULL);
+
+    free(pool.threads);
+    pool.threads = NULL;
+    pool.threads_count = 0;
+    pool.stop = false;
+}
+
+/// @note: Must be called with dispatch mutex locked. Calling thread is not counted.
+static void
+le_thread_pool_start(unsigned threads_count)
+{
+    pool.threads = malloc(threads_count * sizeof(pthread_t));
+    pool.threads_count = 0;
+    for (unsigned i = 0; i < threads_count; i++)
+    {
+        if (pthread_create(&pool.threads[pool.threads_count], NULL, le_thread_pool_worker,
+                           (void *)(uintptr_t)pool.generation) != 0)
+        {
+            LE_WARNING("Failed to start worker thread, using %u threads", pool.threads_count + 1);
+            break;
+        }
+        pool.threads_count++;
+    }
+
+    if (pool.threads_count == 0)
+    {
+        free(pool.threads);
+        pool.threads = NULL;
+    }
+}
+
+void
+le_set_num_threads(unsigned count)
+{
+    if (count == 0)
+        count = le_parallel_get_default_num_threads();
+    if (count > LE_MAX_THREADS)
+        count = LE_MAX_THREADS;
+
+    pthread_mutex_lock(&dispatch_mutex);
+    if (count != num_threads)
+    {
+        le_thread_pool_stop();
+        num_threads = count;
+    }
+    pthread_mutex_unlock(&dispatch_mutex);
+}
+
+unsigned
+le_get_num_threads(void)
+{
+    if (num_threads == 0)
+        le_set_num_threads(0);
+
+    return num_threads;
+}
+
+/// @note: Runs task split into parts_count parts, calling thread takes part too
+static void
+le_parallel_run(unsigned parts_count, LeParallelTask task, void *data)
+{
+    if ((parts_count > 1) && !in_parallel_region && (pthread_mutex_trylock(&dispatch_mutex) == 0))
+    {
+        if (pool.threads_count == 0)
+            le_thread_pool_start(num_threads - 1);
+
+        if (pool.threads_count > 0)
+        {
+            in_parallel_region = true;
+
+            pthread_mutex_lock(&pool.mutex);
+            pool.task = task;
+            pool.data = data;
+            pool.parts_count = parts_count;
+            pool.next_part = 0;
+            pool.pending_parts = parts_count;
+            pool.generation++;
+            pthread_cond_broadcast(&pool.work_available);
+
+            le_thread_pool_process();
+            while (pool.pending_parts > 0)
+                pthread_cond_wait(&pool.work_done, &pool.mutex);
+            pthread_mutex_unlock(&pool.mutex);
+
+            in_parallel_region = false;
+            pthread_mutex_unlock(&dispatch_mutex);
+            return;
+        }
+
+        pthread_mutex_unlock(&dispatch_mutex);
+    }
+
+    for (unsigned part = 0; part < parts_count; part++)
+        task(data, part, parts_count);
+}
+
+static unsigned
+le_parallel_get_parts_count(size_t count, size_t grain)
+{
+    if (grain == 0)
+        grain = 1;
+
+    size_t parts_count = count / grain;
+    unsigned threads = le_get_num_threads();
+
+    if (parts_count > threads)
+        parts_count = threads;
+
+    return (parts_count > 0) ? (unsigned)parts_count : 1;
+}
+
+typedef struct LeParallelForContext
+{
+    size_t                count;
+    LeParallelFunction    function;
+    LeParallelSumFunction sum_function;
+    void                 *data;
+    float                 partial_sums[LE_MAX_THREADS];
+} LeParallelForContext;
+
+static void
+le_parallel_for_task(void *data, unsigned part, unsigned parts_count)
+{
+    LeParallelForContext *context = data;
+    size_t begin = context->count * part / parts_count;
+    size_t end = context->count * (part + 1) / parts_count;
+
+    if (context->sum_function)
+        context->partial_sums[part] = context->sum_function(context->data, begin, end);
+    else
+        context->function(context->data, begin, end);
+}
+
+void
+le_parallel_for(size_t count, size_t grain, LeParallelFunction function, void *data)
+{
+    assert(function);
+
+    if (count == 0)
+        return;
+
+    unsigned parts_count = le_parallel_get_parts_count(count, grain);
+    if (parts_count == 1)
+    {
+        function(data, 0, count);
+        return;
+    }
+
+    LeParallelForContext context = {
+        .count = count,
+        .function = function,
+        .sum_function = NULL,
+        .data = data
+    };
+    le_parallel_run(parts_count, le_parallel_for_task, &context);
+}
+
+float
+le_parallel_sum_f32(size_t count, size_t grain, LeParallelSumFunction function, void *data)
+{
+    assert(function);
+
+    if (count == 0)
+        return 0.0f;
+
+    unsigned parts_count = le_parallel_get_parts_count(count, grain);
+    if (parts_count == 1)
+        return function(data, 0, count);
+
+    LeParallelForContext context = {
+        .count = count,
+        .function = NULL,
+        .sum_function = function,
+        .data = data
+    };
+    le_parallel_run(parts_count, le_parallel_for_task, &context);
+
+    float sum = 0.0f;
+    for (unsigned part = 0; part < parts_count; part++)
+        sum += context.partial_sums[part];
+
+    return sum;
+}
@@ -0,0 +1,50 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Intra-operation parallelism. Library kernels split large ranges between threads
+   of a persistent pool. */
+
+#ifndef __LEPARALLEL_H__
+#define __LEPARALLEL_H__
+
+#include <stddef.h>
+#include "lemacros.h"
+
+LE_BEGIN_DECLS
+
+#define LE_MAX_THREADS 256
+
+/// @note: Sets number of threads used by library kernels, including calling thread.
+/// Zero restores default: LE_NUM_THREADS environment variable if set, number of online CPUs otherwise.
+/// Must not be called while other threads run library functions.
+void               le_set_num_threads                      (unsigned                num_threads);
+
+unsigned           le_get_num_threads                      (void);
+
+/// @note: Processes elements [begin, end) of range
+typedef void     (*LeParallelFunction)                     (void *                  data,
+                                                            size_t                  begin,
+                                                            size_t                  end);
+
+/// @note: Returns partial sum over elements [begin, end) of range
+typedef float    (*LeParallelSumFunction)                  (void *                  data,
+                                                            size_t                  begin,
+                                                            size_t                  end);
+
+/// @note: Splits [0, count) into contiguous parts of at least grain elements and calls function
+/// for each part, on pool threads and calling thread. Returns when all parts are done.
+/// Nested calls and calls made while pool is busy with another thread run serially.
+void               le_parallel_for                         (size_t                  count,
+                                                            size_t                  grain,
+                                                            LeParallelFunction      function,
+                                                            void *                  data);
+
+/// @note: Same as le_parallel_for, partial sums are added in order of parts
+float              le_parallel_sum_f32                     (size_t                  count,
+                                                            size_t                  grain,
+                                                            LeParallelSumFunction   function,
+                                                            void *                  data);
+
+LE_END_DECLS
+
+#endif
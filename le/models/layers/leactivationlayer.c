@@ -2,10 +2,10 @@
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
 #include "leactivationlayer.h"
-#include <math.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <le/lelog.h>
+#include <le/lemem.h>
 #include <le/tensors/lematrix.h>
 #include <le/tensors/letensor-imp.h>
 
@@ -17,57 +17,9 @@ typedef struct LeActivationLayerClass
     
 } LeActivationLayerClass;
 
-#define EPSILON 1e-3f
-
-static LeTensor *
-le_tensor_new_softmax_jacobians_stacked(LeTensor *softmax_output)
-{  
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    self->element_type = LE_TYPE_FLOAT32;
-    unsigned num_classes = le_matrix_get_height(softmax_output);
-    unsigned num_examples = le_matrix_get_width(softmax_output);
-    self->shape = le_shape_new(3, num_examples, num_classes, num_classes);
-    self->stride = le_shape_get_size(self->shape, -1);
-    self->owns_data = true;
-    self->data = malloc(le_shape_get_elements_count(self->shape) * sizeof(float));
-    
-    unsigned num_classes_squared = num_classes * num_classes;
-    for (unsigned example = 0; example < num_examples; example++)
-    {
-        for (unsigned i = 0; i < num_classes; i++)
-        {
-            float si = le_matrix_at_f32(softmax_output, i, example);
-            for (unsigned j = 0; j < num_classes; j++)
-            {
-                float sj = le_matrix_at_f32(softmax_output, j, example);
-                float dJ_daij = (i == j) ? si * (1.0f - si) : -si * sj;
-                if (signbit(dJ_daij))
-                {
-                    if (dJ_daij > -EPSILON)
-                        dJ_daij = -EPSILON;
-                }
-                else
-                {
-                    if (dJ_daij < EPSILON)
-                        dJ_daij = EPSILON;
-                }
-                ((float *)self->data)[example * num_classes_squared + i * num_classes + j] = dJ_daij;
-            }
-        }
-    }
-    
-    return self;
-}
-
-LeTensor *
-le_activation_layer_forward_prop(LeLayer *layer, LeTensor *input)
+static void
+le_activation_layer_apply(LeActivationLayer *self, LeTensor *output)
 {
-    assert(layer);
-    assert(input);
-    
-    LeActivationLayer *self = LE_ACTIVATION_LAYER(layer);
-    
-    LeTensor *output = le_tensor_new_copy(input);
     switch (self->activation) {
     case LE_ACTIVATION_SIGMOID:
         /// @note: Sigmoid activation function: g'(x) = 1 / (1 + exp(-x))
@@ -92,9 +44,34 @@ le_activation_layer_forward_prop(LeLayer *layer, LeTensor *input)
         /// @note: Linear activation function: g(x) = x
         break;
     }
+}
+
+LeTensor *
+le_activation_layer_forward_prop(LeLayer *layer, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+    
+    LeTensor *output = le_tensor_new_copy(input);
+    le_activation_layer_apply(LE_ACTIVATION_LAYER(layer), output);
     return output;
 }
 
+/// @note: Output may be input itself, then activation is applied in place
+void
+le_activation_layer_forward_prop_into(LeLayer *layer, LeTensor *output, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+    assert(output);
+
+    if (output != input)
+    {
+        le_tensor_assign(output, input);
+    }
+    le_activation_layer_apply(LE_ACTIVATION_LAYER(layer), output);
+}
+
 LeTensor *
 le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *cached_output, LeTensor *output_gradient, LeList **parameters_gradient)
 {
@@ -107,10 +84,9 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
     /// @note: Diagonals of Jacobians of activation function at cached_input, stacked.
     /// Rank 2 Tensor. For element-wise activations where a0 depends only from z0.
     LeTensor *activation_primes = NULL;
-    /// @note: Jacobians of activation function at cached_input, stacked. Rank 3 Tensor.
-    /// For activations where a0 may depend from z0, z1 and other inputs.
-    LeTensor *activation_jacobians = NULL;
-    /// @note: If both activation_primes and activation_jacobians is NULL, output gradient
+    /// @note: Computed directly for activations where a0 may depend from z0, z1 and other inputs.
+    LeTensor *input_gradient = NULL;
+    /// @note: If both activation_primes and input_gradient is NULL, output gradient
     /// will propagade backward unchanged. This is the case for linear activation function.
 
     switch (self->activation) {
@@ -118,12 +94,12 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
         /// @note: Derivative of sigmoid activation function: g'(x) = g(x)(1 - g(x))
         if (cached_output)
         {
-            activation_primes = le_tensor_new_copy(cached_output);
+            activation_primes = le_tensor_new_scratch_copy(cached_output);
             le_tensor_apply_x_minus_sqr_x(activation_primes);
         }
         else
         {
-            activation_primes = le_tensor_new_copy(cached_input);
+            activation_primes = le_tensor_new_scratch_copy(cached_input);
             le_tensor_apply_sigmoid_prime(activation_primes);
         }
         break;
@@ -132,13 +108,13 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
         /// @note: Derivative of hyperbolic tangent activation function: g'(x) = 1 - g(x)^2
         if (cached_output)
         {
-            activation_primes = le_tensor_new_copy(cached_output);
+            activation_primes = le_tensor_new_scratch_copy(cached_output);
             le_tensor_apply_sqr(activation_primes);
             le_tensor_apply_1_minus(activation_primes);
         }
         else
         {
-            activation_primes = le_tensor_new_copy(cached_input);
+            activation_primes = le_tensor_new_scratch_copy(cached_input);
             le_tensor_apply_tanh(activation_primes);
             le_tensor_apply_sqr(activation_primes);
             le_tensor_apply_1_minus(activation_primes);
@@ -146,20 +122,22 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
         break;
 
     case LE_ACTIVATION_RELU:
-        activation_primes = le_tensor_new_copy(cached_input);
+        activation_primes = le_tensor_new_scratch_copy(cached_input);
         le_tensor_apply_gt(activation_primes, 0.0f);
         break;
         
     case LE_ACTIVATION_SOFTMAX:
+        /// @note: Product of transposed Jacobian diag(s) - s sᵀ and output gradient g
+        /// is s ⊙ (g - ⟨s, g⟩), linear in number of classes
         if (cached_output)
         {
-            activation_jacobians = le_tensor_new_softmax_jacobians_stacked(cached_output);
+            input_gradient = le_matrix_new_softmax_gradient(cached_output, output_gradient);
         }
         else
         {
-            LeTensor *computed_output = le_tensor_new_copy(cached_input);
+            LeTensor *computed_output = le_tensor_new_scratch_copy(cached_input);
             le_matrix_apply_softmax(computed_output);
-            activation_jacobians = le_tensor_new_softmax_jacobians_stacked(computed_output);
+            input_gradient = le_matrix_new_softmax_gradient(computed_output, output_gradient);
             le_tensor_free(computed_output);
         }
         break;
@@ -170,10 +148,9 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
         break;
     }
 
-    LeTensor *input_gradient = NULL;
     if (activation_primes)
     {
-        assert(activation_jacobians == NULL);
+        assert(input_gradient == NULL);
         /// @note: Diagonal of Jacobian of activation function.
         /// Non-diagonal partial derivatives will be discarded.
         /// Hadamard is used for chain rule.
@@ -181,38 +158,9 @@ le_activation_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTens
         le_tensor_mul(input_gradient, activation_primes);
         le_tensor_free(activation_primes);
     } 
-    else if (activation_jacobians)
-    {
-        assert(activation_jacobians->shape->num_dimensions == 3);
-
-        unsigned examples_count = activation_jacobians->shape->sizes[0];
-        /// @todo: Optimize, just allocate, do not copy.
-        input_gradient = le_tensor_new_copy(output_gradient);
-        for (unsigned example = 0; example < examples_count; example++)
-        {
-            LeTensor *jacobian = le_tensor_pick(activation_jacobians, example);
-            LE_INFO("jacobian =\n%s", le_tensor_to_cstr(jacobian));
-            unsigned classes_count = le_matrix_get_height(jacobian);
-            for (unsigned input = 0; input < classes_count; input++)
-            {
-                float dJ_dz = 0.0f;
-                
-                for (unsigned output = 0; output < classes_count; output++)
-                {
-                    float dJ_da = le_matrix_at_f32(output_gradient, output, example);
-                    float da_dz = le_matrix_at_f32(jacobian, output, input);
-                    dJ_dz += dJ_da * da_dz;
-                }
-            
-                le_matrix_set_f32(input_gradient, input, example, dJ_dz);
-            }
-            le_tensor_free(jacobian);
-        }
-        le_tensor_free(activation_jacobians);
-    }
-    else
+    else if (input_gradient == NULL)
     {
-        /// @note: Both activation_primes and activation_jacobians is NULL.
+        /// @note: Both activation_primes and input_gradient is NULL.
         /// It means we have identity activation function with derivative equal to 1.
         /// We will just pass output gradient backward.
         input_gradient = le_tensor_new_copy(output_gradient);
@@ -277,6 +225,7 @@ le_activation_layer_class_ensure_init()
     if (!initialized)
     {
         klass.parent.forward_prop = le_activation_layer_forward_prop;
+        klass.parent.forward_prop_into = le_activation_layer_forward_prop_into;
         klass.parent.backward_prop = le_activation_layer_backward_prop;
         klass.parent.get_output_shape = le_activation_layer_get_output_shape;
         klass.parent.get_description = le_activation_layer_get_description;
@@ -294,3 +243,21 @@ le_activation_layer_new(const char *name, LeActivation activation)
     self->activation = activation;
     return self;
 }
+
+void
+le_activation_layer_free(LeActivationLayer *self)
+{
+    assert(self);
+
+    le_free((void *)LE_LAYER(self)->name);
+    free(self);
+}
+
+bool
+le_layer_is_activation(LeLayer *layer, LeActivation activation)
+{
+    assert(layer);
+
+    return (LE_OBJECT_GET_CLASS(layer) == LE_CLASS(&klass)) &&
+        (LE_ACTIVATION_LAYER(layer)->activation == activation);
+}
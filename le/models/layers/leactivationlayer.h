@@ -5,19 +5,11 @@
 #define __LEACTIVATIONLAYER_H__
 
 #include <le/lemacros.h>
+#include <le/tensors/leactivation.h>
 #include "lelayer.h"
 
 LE_BEGIN_DECLS
 
-typedef enum LeActivation
-{
-    LE_ACTIVATION_LINEAR,
-    LE_ACTIVATION_SIGMOID,
-    LE_ACTIVATION_TANH,
-    LE_ACTIVATION_RELU,
-    LE_ACTIVATION_SOFTMAX
-} LeActivation;
-
 typedef struct LeActivationLayer
 {
     LeLayer parent;
@@ -30,6 +22,12 @@ typedef struct LeActivationLayer
 LeActivationLayer *     le_activation_layer_new            (const char *            name,
                                                             LeActivation            activation);
 
+void                    le_activation_layer_free           (LeActivationLayer *     self);
+
+/// @note: Whether layer is activation layer with given activation function
+bool                    le_layer_is_activation             (LeLayer *               layer,
+                                                            LeActivation            activation);
+
 LE_END_DECLS
 
 #endif
@@ -5,57 +5,917 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <le/lemem.h>
+#include <le/leparallel.h>
+#include <le/tensors/lekernels.h>
 #include <le/tensors/lematrix.h>
 #include <le/tensors/letensor-imp.h>
 
+/// @note: Output positions are lowered to rows of columns matrix in blocks of about this many
+/// elements, so that block is still in cache when it is multiplied by filters
+#define LE_CONV2D_BLOCK_ELEMENTS (1 << 18)
+/// @note: Lower bound of rows in block, so that GEMM has enough rows to split between threads
+#define LE_CONV2D_MIN_BLOCK_ROWS 128
+/// @note: Rows of columns matrix filled by each thread
+#define LE_CONV2D_IM2COL_GRAIN 64
+/// @note: Lower bound of tiles transformed at once by Winograd algorithms
+#define LE_CONV2D_WINOGRAD_MIN_BLOCK_TILES 32
+/// @note: Winograd algorithms are selected for layers with at least this many channels and filters
+#define LE_CONV2D_WINOGRAD_MIN_CHANNELS 16
+/// @note: Output sizes from which 4×4 tiles waste little on borders of output
+#define LE_CONV2D_WINOGRAD_4X4_MIN_OUTPUT 8
+
 typedef struct LeConv2DClass
 {
     LeLayerClass parent;
-    
+
 } LeConv2DClass;
 
 static LeConv2DClass klass;
 
-LeTensor *
-le_conv2d_forward_prop(LeLayer *layer, LeTensor *input)
+/// @note: Sizes of NHWC input, filters stored as (height, width, channels, filters) and NHWC output.
+/// Depthwise layer has as many filters as channels.
+typedef struct LeConv2DGeometry
+{
+    unsigned batch_size;
+    unsigned input_h;
+    unsigned input_w;
+    unsigned channels;
+    unsigned filter_h;
+    unsigned filter_w;
+    unsigned filters;
+    unsigned output_h;
+    unsigned output_w;
+    unsigned padding;
+    unsigned stride;
+    /// @note: Columns matrix has row per output position and column per element of filter
+    size_t   rows;
+    size_t   width;
+} LeConv2DGeometry;
+
+static void
+le_conv2d_get_geometry(const LeConv2D *self, const LeShape *input_shape, LeConv2DGeometry *geometry)
+{
+    assert(self->w);
+    assert(self->w->shape->num_dimensions == 4);
+    assert(input_shape->num_dimensions == 4);
+    assert(self->stride > 0);
+
+    geometry->batch_size = input_shape->sizes[0];
+    geometry->input_h = input_shape->sizes[1];
+    geometry->input_w = input_shape->sizes[2];
+    geometry->channels = input_shape->sizes[3];
+    geometry->filter_h = self->w->shape->sizes[0];
+    geometry->filter_w = self->w->shape->sizes[1];
+    geometry->filters = self->w->shape->sizes[3];
+    geometry->padding = self->padding;
+    geometry->stride = self->stride;
+    if (self->depthwise)
+        assert((self->w->shape->sizes[2] == 1) && (geometry->filters == geometry->channels));
+    else
+        assert(geometry->channels == self->w->shape->sizes[2]);
+    assert(geometry->input_h + 2 * geometry->padding >= geometry->filter_h);
+    assert(geometry->input_w + 2 * geometry->padding >= geometry->filter_w);
+
+    geometry->output_h = (geometry->input_h + 2 * geometry->padding - geometry->filter_h) / geometry->stride + 1;
+    geometry->output_w = (geometry->input_w + 2 * geometry->padding - geometry->filter_w) / geometry->stride + 1;
+    geometry->rows = (size_t)geometry->batch_size * geometry->output_h * geometry->output_w;
+    geometry->width = (size_t)geometry->filter_h * geometry->filter_w * geometry->channels;
+    /// @note: Blocks of rows are sliced as matrices with 32-bit sizes
+    assert(geometry->rows <= UINT32_MAX);
+}
+
+static size_t
+le_conv2d_get_block_rows(const LeConv2DGeometry *geometry)
+{
+    size_t block_rows = LE_CONV2D_BLOCK_ELEMENTS / geometry->width;
+    if (block_rows < LE_CONV2D_MIN_BLOCK_ROWS)
+        block_rows = LE_CONV2D_MIN_BLOCK_ROWS;
+    return (block_rows < geometry->rows) ? block_rows : geometry->rows;
+}
+
+/// @note: Position in NHWC input of top left element of patch seen by given output position,
+/// which may fall into padding
+typedef struct LeConv2DPatch
+{
+    size_t  image;
+    int64_t y;
+    int64_t x;
+} LeConv2DPatch;
+
+static LeConv2DPatch
+le_conv2d_get_patch(const LeConv2DGeometry *geometry, size_t position)
+{
+    size_t ox = position % geometry->output_w;
+    size_t oy = (position / geometry->output_w) % geometry->output_h;
+    LeConv2DPatch patch = {
+        .image = position / ((size_t)geometry->output_w * geometry->output_h),
+        .y = (int64_t)(oy * geometry->stride) - geometry->padding,
+        .x = (int64_t)(ox * geometry->stride) - geometry->padding
+    };
+    return patch;
+}
+
+/// @note: Offset of first channel of pixel of patch at given element of filter, or -1 if pixel is padding
+static inline int64_t
+le_conv2d_get_pixel(const LeConv2DGeometry *geometry, const LeConv2DPatch *patch, unsigned ky, unsigned kx)
+{
+    int64_t iy = patch->y + ky;
+    int64_t ix = patch->x + kx;
+    if ((iy < 0) || (iy >= geometry->input_h) || (ix < 0) || (ix >= geometry->input_w))
+        return -1;
+    return (((int64_t)patch->image * geometry->input_h + iy) * geometry->input_w + ix) * geometry->channels;
+}
+
+typedef struct LeConv2DIm2ColTask
+{
+    const LeConv2DGeometry *geometry;
+    const float            *input;
+    float                  *columns;
+    size_t                  first_row;
+} LeConv2DIm2ColTask;
+
+/// @note: Row of columns matrix holds patch of input seen by one output position, ordered as
+/// elements of filter: by filter row, filter column and channel. NHWC input keeps channels
+/// of pixel together, so patch is copied pixel by pixel. Padding is filled with zeros.
+static void
+le_conv2d_im2col_range(void *data, size_t begin, size_t end)
+{
+    const LeConv2DIm2ColTask *task = data;
+    const LeConv2DGeometry *geometry = task->geometry;
+    const unsigned channels = geometry->channels;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        LeConv2DPatch patch = le_conv2d_get_patch(geometry, task->first_row + row);
+        float *column = task->columns + row * geometry->width;
+        for (unsigned ky = 0; ky < geometry->filter_h; ky++)
+        {
+            for (unsigned kx = 0; kx < geometry->filter_w; kx++, column += channels)
+            {
+                int64_t pixel = le_conv2d_get_pixel(geometry, &patch, ky, kx);
+                if (pixel < 0)
+                {
+                    for (unsigned c = 0; c < channels; c++)
+                        column[c] = 0.0f;
+                }
+                else
+                {
+                    const float *source = task->input + pixel;
+                    for (unsigned c = 0; c < channels; c++)
+                        column[c] = source[c];
+                }
+            }
+        }
+    }
+}
+
+static void
+le_conv2d_im2col(const LeConv2DGeometry *geometry, const float *input, size_t first_row, size_t rows, float *columns)
+{
+    LeConv2DIm2ColTask task = {
+        .geometry = geometry,
+        .input = input,
+        .columns = columns,
+        .first_row = first_row
+    };
+    le_parallel_for(rows, LE_CONV2D_IM2COL_GRAIN, le_conv2d_im2col_range, &task);
+}
+
+/// @note: Reverse of im2col, adds gradients of patches to pixels they were copied from.
+/// Patches of neighbouring positions overlap, so rows are accumulated one by one.
+static void
+le_conv2d_col2im(const LeConv2DGeometry *geometry, const float *columns, size_t first_row, size_t rows, float *input)
+{
+    const unsigned channels = geometry->channels;
+
+    for (size_t row = 0; row < rows; row++)
+    {
+        LeConv2DPatch patch = le_conv2d_get_patch(geometry, first_row + row);
+        const float *column = columns + row * geometry->width;
+        for (unsigned ky = 0; ky < geometry->filter_h; ky++)
+        {
+            for (unsigned kx = 0; kx < geometry->filter_w; kx++, column += channels)
+            {
+                int64_t pixel = le_conv2d_get_pixel(geometry, &patch, ky, kx);
+                if (pixel < 0)
+                    continue;
+                for (unsigned c = 0; c < channels; c++)
+                    input[pixel + c] += column[c];
+            }
+        }
+    }
+}
+
+static void
+le_conv2d_activate(const LeKernels *kernels, LeActivation activation, float *a, size_t n)
+{
+    switch (activation)
+    {
+    case LE_ACTIVATION_SIGMOID:
+        kernels->sigmoid_f32(a, n);
+        break;
+    case LE_ACTIVATION_TANH:
+        kernels->tanh_f32(a, n);
+        break;
+    case LE_ACTIVATION_RELU:
+        kernels->relu_f32(a, n);
+        break;
+    case LE_ACTIVATION_LINEAR:
+    default:
+        break;
+    }
+}
+
+/// @note: NHWC output is product of columns matrix and filters, viewed as matrices
+/// with row per output position and row per element of filter respectively
+static void
+le_conv2d_forward_im2col(const LeConv2DGeometry *geometry, LeTensor *output, const LeTensor *input,
+                         const LeTensor *w, const LeTensor *b, LeActivation activation)
+{
+    LeTensorView w_view, b_view, output_view;
+    le_tensor_view_init(&w_view, w);
+    le_tensor_reshape(&w_view, 2, (int)geometry->width, (int)geometry->filters);
+    le_tensor_view_init(&output_view, output);
+    le_tensor_reshape(&output_view, 2, (int)geometry->rows, (int)geometry->filters);
+    /// @note: Biases are added to every row of product while its tiles are computed
+    if (b)
+    {
+        le_tensor_view_init(&b_view, b);
+        le_tensor_reshape(&b_view, 2, 1, (int)geometry->filters);
+    }
+
+    size_t block_rows = le_conv2d_get_block_rows(geometry);
+    LeTensor *columns = le_tensor_new_scratch(LE_TYPE_FLOAT32, le_shape_new(2, block_rows, geometry->width));
+    for (size_t first_row = 0; first_row < geometry->rows; first_row += block_rows)
+    {
+        size_t rows = (geometry->rows - first_row < block_rows) ? geometry->rows - first_row : block_rows;
+        le_conv2d_im2col(geometry, input->data, first_row, rows, columns->data);
+        LeTensorView columns_block, output_block;
+        le_tensor_view_init_slice(&columns_block, columns, 0, 0, rows);
+        le_tensor_view_init_slice(&output_block, &output_view, 0, first_row, rows);
+        le_matrix_product_activation_into(&output_block, &columns_block, false, &w_view, false,
+                                          b ? &b_view : NULL, activation);
+    }
+
+    le_tensor_free(columns);
+}
+
+/// @note: Pixels of NHWC input are rows of patches of 1×1 filters, so input is multiplied as is
+static void
+le_conv2d_forward_pointwise(const LeConv2DGeometry *geometry, LeTensor *output, const LeTensor *input,
+                            const LeTensor *w, const LeTensor *b, LeActivation activation)
+{
+    LeTensorView input_view, w_view, b_view, output_view;
+    le_tensor_view_init(&input_view, input);
+    le_tensor_reshape(&input_view, 2, (int)geometry->rows, (int)geometry->channels);
+    le_tensor_view_init(&w_view, w);
+    le_tensor_reshape(&w_view, 2, (int)geometry->channels, (int)geometry->filters);
+    le_tensor_view_init(&output_view, output);
+    le_tensor_reshape(&output_view, 2, (int)geometry->rows, (int)geometry->filters);
+    if (b)
+    {
+        le_tensor_view_init(&b_view, b);
+        le_tensor_reshape(&b_view, 2, 1, (int)geometry->filters);
+    }
+
+    le_matrix_product_activation_into(&output_view, &input_view, false, &w_view, false, b ? &b_view : NULL, activation);
+}
+
+typedef struct LeConv2DDirectTask
+{
+    const LeConv2DGeometry *geometry;
+    const float            *input;
+    const float            *w;
+    const float            *b;
+    float                  *output;
+    LeActivation            activation;
+} LeConv2DDirectTask;
+
+/// @note: Computes rows [begin, end) of NHWC output of depthwise convolution, one row per image
+/// and output row. Filters of all channels at same tap are contiguous, as are channels of pixel,
+/// so every tap is one multiply-add of vectors of channels.
+static void
+le_conv2d_depthwise_rows(void *data, size_t begin, size_t end)
+{
+    const LeConv2DDirectTask *task = data;
+    const LeConv2DGeometry *geometry = task->geometry;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned channels = geometry->channels;
+    const size_t row_size = (size_t)geometry->output_w * channels;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        float *output_row = task->output + row * row_size;
+        for (unsigned ox = 0; ox < geometry->output_w; ox++)
+        {
+            float *pixel_output = output_row + (size_t)ox * channels;
+            if (task->b)
+                memcpy(pixel_output, task->b, channels * sizeof(float));
+            else
+                memset(pixel_output, 0, channels * sizeof(float));
+            LeConv2DPatch patch = le_conv2d_get_patch(geometry, row * geometry->output_w + ox);
+            for (unsigned ky = 0; ky < geometry->filter_h; ky++)
+            {
+                for (unsigned kx = 0; kx < geometry->filter_w; kx++)
+                {
+                    int64_t pixel = le_conv2d_get_pixel(geometry, &patch, ky, kx);
+                    if (pixel >= 0)
+                        kernels->mul_add_f32(pixel_output, task->w + ((size_t)ky * geometry->filter_w + kx) * channels,
+                                             task->input + pixel, channels);
+                }
+            }
+        }
+        le_conv2d_activate(kernels, task->activation, output_row, row_size);
+    }
+}
+
+static void
+le_conv2d_forward_depthwise(const LeConv2DGeometry *geometry, LeTensor *output, const LeTensor *input,
+                            const LeTensor *w, const LeTensor *b, LeActivation activation)
+{
+    LeConv2DDirectTask task = {
+        .geometry = geometry,
+        .input = input->data,
+        .w = w->data,
+        .b = b ? b->data : NULL,
+        .output = output->data,
+        .activation = activation
+    };
+    size_t rows = (size_t)geometry->batch_size * geometry->output_h;
+    size_t row_work = (size_t)geometry->output_w * geometry->channels * geometry->filter_h * geometry->filter_w;
+    le_parallel_for(rows, (row_work < LE_CONV2D_BLOCK_ELEMENTS) ? LE_CONV2D_BLOCK_ELEMENTS / row_work : 1,
+                    le_conv2d_depthwise_rows, &task);
+}
+
+/// @note: Transform matrices of F(m×m, 3×3) from Lavin and Gray, "Fast Algorithms for
+/// Convolutional Neural Networks": tile of α×α input pixels, α = m + 2, is transformed as
+/// Bᵀ d B, filter as G g Gᵀ, and their element-wise product back to m×m outputs as Aᵀ M A.
+typedef struct LeConv2DWinograd
+{
+    unsigned     m;
+    unsigned     alpha;
+    const float *bt;
+    const float *g;
+    const float *at;
+} LeConv2DWinograd;
+
+static const float le_conv2d_winograd_2x2_bt[] = {
+    1.0f,  0.0f, -1.0f,  0.0f,
+    0.0f,  1.0f,  1.0f,  0.0f,
+    0.0f, -1.0f,  1.0f,  0.0f,
+    0.0f,  1.0f,  0.0f, -1.0f
+};
+
+static const float le_conv2d_winograd_2x2_g[] = {
+    1.0f,  0.0f, 0.0f,
+    0.5f,  0.5f, 0.5f,
+    0.5f, -0.5f, 0.5f,
+    0.0f,  0.0f, 1.0f
+};
+
+static const float le_conv2d_winograd_2x2_at[] = {
+    1.0f, 1.0f,  1.0f,  0.0f,
+    0.0f, 1.0f, -1.0f, -1.0f
+};
+
+static const float le_conv2d_winograd_4x4_bt[] = {
+    4.0f,  0.0f, -5.0f,  0.0f, 1.0f, 0.0f,
+    0.0f, -4.0f, -4.0f,  1.0f, 1.0f, 0.0f,
+    0.0f,  4.0f, -4.0f, -1.0f, 1.0f, 0.0f,
+    0.0f, -2.0f, -1.0f,  2.0f, 1.0f, 0.0f,
+    0.0f,  2.0f, -1.0f, -2.0f, 1.0f, 0.0f,
+    0.0f,  4.0f,  0.0f, -5.0f, 0.0f, 1.0f
+};
+
+static const float le_conv2d_winograd_4x4_g[] = {
+    1.0f / 4.0f,   0.0f,          0.0f,
+    -1.0f / 6.0f,  -1.0f / 6.0f,  -1.0f / 6.0f,
+    -1.0f / 6.0f,  1.0f / 6.0f,   -1.0f / 6.0f,
+    1.0f / 24.0f,  1.0f / 12.0f,  1.0f / 6.0f,
+    1.0f / 24.0f,  -1.0f / 12.0f, 1.0f / 6.0f,
+    0.0f,          0.0f,          1.0f
+};
+
+static const float le_conv2d_winograd_4x4_at[] = {
+    1.0f, 1.0f,  1.0f, 1.0f,  1.0f, 0.0f,
+    0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f,
+    0.0f, 1.0f,  1.0f, 4.0f,  4.0f, 0.0f,
+    0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f
+};
+
+static const LeConv2DWinograd le_conv2d_winograd_2x2 = {
+    2, 4, le_conv2d_winograd_2x2_bt, le_conv2d_winograd_2x2_g, le_conv2d_winograd_2x2_at
+};
+
+static const LeConv2DWinograd le_conv2d_winograd_4x4 = {
+    4, 6, le_conv2d_winograd_4x4_bt, le_conv2d_winograd_4x4_g, le_conv2d_winograd_4x4_at
+};
+
+/// @note: destination = left × source × rightᵀ for rows×cols matrix source of vectors of n floats.
+/// left has out_rows×rows coefficients, right has out_cols×cols. Vectors of source and destination
+/// are stored at given strides, temporary holds out_rows×cols vectors.
+static void
+le_conv2d_winograd_transform(const LeKernels *kernels, const float *left, unsigned out_rows,
+                             const float *right, unsigned out_cols, unsigned rows, unsigned cols,
+                             const float *source, size_t source_stride, float *temporary,
+                             float *destination, size_t destination_stride, size_t n)
+{
+    /// @note: Scaled vectors are accumulated by subtracting them with negated coefficients
+    for (unsigned i = 0; i < out_rows; i++)
+    {
+        for (unsigned l = 0; l < cols; l++)
+        {
+            float *t = temporary + ((size_t)i * cols + l) * n;
+            memset(t, 0, n * sizeof(float));
+            for (unsigned k = 0; k < rows; k++)
+            {
+                float coefficient = left[i * rows + k];
+                if (coefficient != 0.0f)
+                    kernels->sub_scaled_f32(t, -coefficient, source + ((size_t)k * cols + l) * source_stride, n);
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < out_rows; i++)
+    {
+        for (unsigned j = 0; j < out_cols; j++)
+        {
+            float *d = destination + ((size_t)i * out_cols + j) * destination_stride;
+            memset(d, 0, n * sizeof(float));
+            for (unsigned l = 0; l < cols; l++)
+            {
+                float coefficient = right[j * cols + l];
+                if (coefficient != 0.0f)
+                    kernels->sub_scaled_f32(d, -coefficient, temporary + ((size_t)i * cols + l) * n, n);
+            }
+        }
+    }
+}
+
+typedef struct LeConv2DWinogradTask
+{
+    const LeConv2DGeometry *geometry;
+    const LeConv2DWinograd *winograd;
+    unsigned                tiles_h;
+    unsigned                tiles_w;
+    size_t                  first_tile;
+    /// @note: Tiles in block, stride between transformed matrices of tiles
+    size_t                  block_tiles;
+    const float            *input;
+    const float            *b;
+    float                  *transformed_input;
+    float                  *products;
+    float                  *output;
+    LeActivation            activation;
+} LeConv2DWinogradTask;
+
+/// @note: Position in NHWC input or output of top left pixel of tile
+static void
+le_conv2d_winograd_get_tile(const LeConv2DWinogradTask *task, size_t tile, size_t *image, unsigned *y, unsigned *x)
+{
+    size_t tiles_per_image = (size_t)task->tiles_h * task->tiles_w;
+    *image = tile / tiles_per_image;
+    *y = (unsigned)(tile % tiles_per_image / task->tiles_w) * task->winograd->m;
+    *x = (unsigned)(tile % task->tiles_w) * task->winograd->m;
+}
+
+/// @note: Transforms input tiles [begin, end) of block. Transformed tile is spread over α×α
+/// matrices of block, one row of channels in each, so that they are multiplied by filters at once.
+static void
+le_conv2d_winograd_input_range(void *data, size_t begin, size_t end)
+{
+    const LeConv2DWinogradTask *task = data;
+    const LeConv2DGeometry *geometry = task->geometry;
+    const LeConv2DWinograd *winograd = task->winograd;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned alpha = winograd->alpha;
+    const unsigned channels = geometry->channels;
+    float *tile_input = le_arena_alloc((size_t)alpha * alpha * channels * sizeof(float));
+    float *temporary = le_arena_alloc((size_t)alpha * alpha * channels * sizeof(float));
+
+    for (size_t t = begin; t < end; t++)
+    {
+        size_t image;
+        unsigned y, x;
+        le_conv2d_winograd_get_tile(task, task->first_tile + t, &image, &y, &x);
+        for (unsigned i = 0; i < alpha; i++)
+        {
+            for (unsigned j = 0; j < alpha; j++)
+            {
+                float *pixel = tile_input + ((size_t)i * alpha + j) * channels;
+                int64_t iy = (int64_t)y + i - geometry->padding;
+                int64_t ix = (int64_t)x + j - geometry->padding;
+                if ((iy < 0) || (iy >= geometry->input_h) || (ix < 0) || (ix >= geometry->input_w))
+                    memset(pixel, 0, channels * sizeof(float));
+                else
+                    memcpy(pixel, task->input + (((int64_t)image * geometry->input_h + iy) * geometry->input_w + ix) * channels,
+                           channels * sizeof(float));
+            }
+        }
+        le_conv2d_winograd_transform(kernels, winograd->bt, alpha, winograd->bt, alpha, alpha, alpha,
+                                     tile_input, channels, temporary,
+                                     task->transformed_input + t * channels, task->block_tiles * channels, channels);
+    }
+
+    le_free(temporary);
+    le_free(tile_input);
+}
+
+/// @note: Transforms products of tiles [begin, end) of block back to m×m pixels of output,
+/// adds biases and applies activation to pixels within output
+static void
+le_conv2d_winograd_output_range(void *data, size_t begin, size_t end)
+{
+    const LeConv2DWinogradTask *task = data;
+    const LeConv2DGeometry *geometry = task->geometry;
+    const LeConv2DWinograd *winograd = task->winograd;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned m = winograd->m;
+    const unsigned alpha = winograd->alpha;
+    const unsigned filters = geometry->filters;
+    float *tile_output = le_arena_alloc((size_t)m * m * filters * sizeof(float));
+    float *temporary = le_arena_alloc((size_t)m * alpha * filters * sizeof(float));
+
+    for (size_t t = begin; t < end; t++)
+    {
+        le_conv2d_winograd_transform(kernels, winograd->at, m, winograd->at, m, alpha, alpha,
+                                     task->products + t * filters, task->block_tiles * filters, temporary,
+                                     tile_output, filters, filters);
+        size_t image;
+        unsigned y, x;
+        le_conv2d_winograd_get_tile(task, task->first_tile + t, &image, &y, &x);
+        for (unsigned i = 0; (i < m) && (y + i < geometry->output_h); i++)
+        {
+            for (unsigned j = 0; (j < m) && (x + j < geometry->output_w); j++)
+            {
+                float *pixel = task->output + ((image * geometry->output_h + y + i) * geometry->output_w + x + j) * filters;
+                memcpy(pixel, tile_output + ((size_t)i * m + j) * filters, filters * sizeof(float));
+                if (task->b)
+                    kernels->add_f32(pixel, task->b, filters);
+                le_conv2d_activate(kernels, task->activation, pixel, filters);
+            }
+        }
+    }
+
+    le_free(temporary);
+    le_free(tile_output);
+}
+
+/// @note: Input tiles overlap by 2 pixels, each tile gives m×m outputs. Transformed tiles of
+/// block are multiplied by transformed filters as α×α batched matrix products, which replace
+/// 9 multiplications per output by (α / m)² ones.
+static void
+le_conv2d_forward_winograd(const LeConv2DGeometry *geometry, const LeConv2DWinograd *winograd, LeTensor *output,
+                           const LeTensor *input, const LeTensor *w, const LeTensor *b, LeActivation activation)
+{
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned alpha = winograd->alpha;
+    const size_t matrix_size = (size_t)geometry->channels * geometry->filters;
+
+    /// @note: Filters (3, 3, C, F) transformed to α×α matrices C×F
+    LeTensor *transformed_w = le_tensor_new_scratch(LE_TYPE_FLOAT32,
+        le_shape_new(3, alpha * alpha, geometry->channels, geometry->filters));
+    float *temporary = le_arena_alloc((size_t)alpha * 3 * matrix_size * sizeof(float));
+    le_conv2d_winograd_transform(kernels, winograd->g, alpha, winograd->g, alpha, 3, 3,
+                                 w->data, matrix_size, temporary, transformed_w->data, matrix_size, matrix_size);
+    le_free(temporary);
+
+    LeConv2DWinogradTask task = {
+        .geometry = geometry,
+        .winograd = winograd,
+        .tiles_h = (geometry->output_h + winograd->m - 1) / winograd->m,
+        .tiles_w = (geometry->output_w + winograd->m - 1) / winograd->m,
+        .input = input->data,
+        .b = b ? b->data : NULL,
+        .output = output->data,
+        .activation = activation
+    };
+    size_t tiles = (size_t)geometry->batch_size * task.tiles_h * task.tiles_w;
+    size_t vector_size = (geometry->channels > geometry->filters) ? geometry->channels : geometry->filters;
+    size_t block_tiles = LE_CONV2D_BLOCK_ELEMENTS / (alpha * alpha * vector_size);
+    if (block_tiles < LE_CONV2D_WINOGRAD_MIN_BLOCK_TILES)
+        block_tiles = LE_CONV2D_WINOGRAD_MIN_BLOCK_TILES;
+    if (block_tiles > tiles)
+        block_tiles = tiles;
+    task.block_tiles = block_tiles;
+
+    LeTensor *transformed_input = le_tensor_new_scratch(LE_TYPE_FLOAT32,
+        le_shape_new(3, alpha * alpha, block_tiles, geometry->channels));
+    LeTensor *products = le_tensor_new_scratch(LE_TYPE_FLOAT32,
+        le_shape_new(3, alpha * alpha, block_tiles, geometry->filters));
+    task.transformed_input = transformed_input->data;
+    task.products = products->data;
+
+    for (size_t first_tile = 0; first_tile < tiles; first_tile += block_tiles)
+    {
+        size_t count = (tiles - first_tile < block_tiles) ? tiles - first_tile : block_tiles;
+        task.first_tile = first_tile;
+        le_parallel_for(count, 1, le_conv2d_winograd_input_range, &task);
+        LeTensorView transformed_input_block, products_block;
+        le_tensor_view_init_slice(&transformed_input_block, transformed_input, 1, 0, count);
+        le_tensor_view_init_slice(&products_block, products, 1, 0, count);
+        le_tensor_batched_product_into(&products_block, &transformed_input_block, false, transformed_w, false);
+        le_parallel_for(count, 1, le_conv2d_winograd_output_range, &task);
+    }
+
+    le_tensor_free(products);
+    le_tensor_free(transformed_input);
+    le_tensor_free(transformed_w);
+}
+
+static bool
+le_conv2d_supports_algorithm(const LeConv2D *self, const LeConv2DGeometry *geometry, LeConv2DAlgorithm algorithm)
+{
+    bool filter_3x3 = (geometry->filter_h == 3) && (geometry->filter_w == 3);
+
+    switch (algorithm)
+    {
+    case LE_CONV2D_ALGORITHM_IM2COL:
+        return !self->depthwise;
+    case LE_CONV2D_ALGORITHM_POINTWISE:
+        return !self->depthwise && (geometry->filter_h == 1) && (geometry->filter_w == 1) &&
+            (geometry->stride == 1) && (geometry->padding == 0);
+    case LE_CONV2D_ALGORITHM_DEPTHWISE:
+        return self->depthwise;
+    case LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3:
+    case LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3:
+        return !self->depthwise && filter_3x3 && (geometry->stride == 1);
+    case LE_CONV2D_ALGORITHM_AUTO:
+    default:
+        return false;
+    }
+}
+
+static LeConv2DAlgorithm
+le_conv2d_select_algorithm(const LeConv2D *self, const LeConv2DGeometry *geometry)
+{
+    if (self->depthwise)
+        return LE_CONV2D_ALGORITHM_DEPTHWISE;
+
+    if (le_conv2d_supports_algorithm(self, geometry, LE_CONV2D_ALGORITHM_POINTWISE))
+        return LE_CONV2D_ALGORITHM_POINTWISE;
+
+    /// @note: Transforms are paid back only when they are shared by enough channels and filters
+    if (le_conv2d_supports_algorithm(self, geometry, LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3) &&
+        (geometry->channels >= LE_CONV2D_WINOGRAD_MIN_CHANNELS) &&
+        (geometry->filters >= LE_CONV2D_WINOGRAD_MIN_CHANNELS))
+    {
+        bool large_output = (geometry->output_h >= LE_CONV2D_WINOGRAD_4X4_MIN_OUTPUT) &&
+            (geometry->output_w >= LE_CONV2D_WINOGRAD_4X4_MIN_OUTPUT);
+        return large_output ? LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3 : LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3;
+    }
+
+    return LE_CONV2D_ALGORITHM_IM2COL;
+}
+
+LeConv2DAlgorithm
+le_conv2d_get_algorithm(LeConv2D *self, const LeShape *input_shape)
+{
+    assert(self);
+    assert(input_shape);
+
+    LeConv2DGeometry geometry;
+    le_conv2d_get_geometry(self, input_shape, &geometry);
+
+    if (self->algorithm != LE_CONV2D_ALGORITHM_AUTO)
+    {
+        assert(le_conv2d_supports_algorithm(self, &geometry, self->algorithm));
+        return self->algorithm;
+    }
+
+    if ((self->selected_algorithm == LE_CONV2D_ALGORITHM_AUTO) ||
+        (memcmp(self->selected_input_sizes, input_shape->sizes, sizeof(self->selected_input_sizes)) != 0))
+    {
+        self->selected_algorithm = le_conv2d_select_algorithm(self, &geometry);
+        memcpy(self->selected_input_sizes, input_shape->sizes, sizeof(self->selected_input_sizes));
+    }
+
+    return self->selected_algorithm;
+}
+
+void
+le_conv2d_set_algorithm(LeConv2D *self, LeConv2DAlgorithm algorithm)
+{
+    assert(self);
+
+    self->algorithm = algorithm;
+}
+
+static void
+le_conv2d_forward_prop_activation_into(LeLayer *layer, LeTensor *output, LeTensor *input, LeActivation activation)
 {
     assert(layer);
     assert(input);
+    assert(output);
 
     LeConv2D *self = LE_CONV2D(layer);
+    LeConv2DGeometry geometry;
+    le_conv2d_get_geometry(self, input->shape, &geometry);
 
-    assert(self->w);
-    assert(self->w->shape);
-    assert(self->w->shape->num_dimensions == 4);
+    assert(output->element_type == LE_TYPE_FLOAT32);
+    assert(output->shape->num_dimensions == 4);
+    assert(output->shape->sizes[0] == geometry.batch_size);
+    assert(output->shape->sizes[1] == geometry.output_h);
+    assert(output->shape->sizes[2] == geometry.output_w);
+    assert(output->shape->sizes[3] == geometry.filters);
+    assert(le_tensor_contiguous(output));
+    if (geometry.rows == 0)
+        return;
+    le_tensor_make_writable(output);
+
+    LeTensor *input_packed, *w_packed, *b_packed = NULL;
+    const LeTensor *packed_input = le_tensor_pack_f32(input, &input_packed);
+    const LeTensor *w = le_tensor_pack_f32(self->w, &w_packed);
+    const LeTensor *b = self->b ? le_tensor_pack_f32(self->b, &b_packed) : NULL;
 
-    unsigned int filter_size_h = self->w->shape->sizes[0];
-    unsigned int filter_size_w = self->w->shape->sizes[1];
-    unsigned int num_channels = self->w->shape->sizes[2];
-    unsigned int num_filters = self->w->shape->sizes[3];
+    switch (le_conv2d_get_algorithm(self, input->shape))
+    {
+    case LE_CONV2D_ALGORITHM_POINTWISE:
+        le_conv2d_forward_pointwise(&geometry, output, packed_input, w, b, activation);
+        break;
+    case LE_CONV2D_ALGORITHM_DEPTHWISE:
+        le_conv2d_forward_depthwise(&geometry, output, packed_input, w, b, activation);
+        break;
+    case LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3:
+        le_conv2d_forward_winograd(&geometry, &le_conv2d_winograd_2x2, output, packed_input, w, b, activation);
+        break;
+    case LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3:
+        le_conv2d_forward_winograd(&geometry, &le_conv2d_winograd_4x4, output, packed_input, w, b, activation);
+        break;
+    case LE_CONV2D_ALGORITHM_IM2COL:
+    default:
+        le_conv2d_forward_im2col(&geometry, output, packed_input, w, b, activation);
+        break;
+    }
 
-    assert(input->shape);
-    assert(input->shape->num_dimensions == 4);
+    le_tensor_free(b_packed);
+    le_tensor_free(w_packed);
+    le_tensor_free(input_packed);
+}
 
-    unsigned int batch_size = input->shape->sizes[0];
-    unsigned int input_h = input->shape->sizes[1];
-    unsigned int input_w = input->shape->sizes[2];
-    unsigned int input_channels_count = input->shape->sizes[3];
-    assert(num_channels == input_channels_count);
+static LeTensor *
+le_conv2d_forward_prop_activation(LeLayer *layer, LeTensor *input, LeActivation activation)
+{
+    assert(layer);
+    assert(input);
 
-    unsigned int output_h = (input_h + 2 * self->padding - filter_size_h) / self->stride + 1;
-    unsigned int output_w = (input_w + 2 * self->padding - filter_size_w) / self->stride + 1;
+    LeConv2DGeometry geometry;
+    le_conv2d_get_geometry(LE_CONV2D(layer), input->shape, &geometry);
 
-    LeShape *output_shape = le_shape_new(4, batch_size, output_h, output_w, num_filters);
-    LeTensor *output = le_tensor_new_rand_f32(output_shape);
+    LeTensor *output = le_tensor_new_uninitialized(LE_TYPE_FLOAT32,
+        le_shape_new(4, geometry.batch_size, geometry.output_h, geometry.output_w, geometry.filters));
+    le_conv2d_forward_prop_activation_into(layer, output, input, activation);
 
     return output;
 }
 
+static void
+le_conv2d_forward_prop_into(LeLayer *layer, LeTensor *output, LeTensor *input)
+{
+    le_conv2d_forward_prop_activation_into(layer, output, input, LE_ACTIVATION_LINEAR);
+}
+
+LeTensor *
+le_conv2d_forward_prop(LeLayer *layer, LeTensor *input)
+{
+    return le_conv2d_forward_prop_activation(layer, input, LE_ACTIVATION_LINEAR);
+}
+
+/// @note: Accumulates gradients of input and, unless dw is NULL, of filters as (width, filters) matrix
+static void
+le_conv2d_backward_im2col(const LeConv2DGeometry *geometry, const LeTensor *input, const LeTensor *w,
+                          const LeTensor *output_gradient, LeTensor *input_gradient, LeTensor *dw)
+{
+    LeTensorView w_view;
+    le_tensor_view_init(&w_view, w);
+    le_tensor_reshape(&w_view, 2, (int)geometry->width, (int)geometry->filters);
+
+    LeTensor *dw_block = dw ? le_tensor_new_scratch(LE_TYPE_FLOAT32, le_shape_new(2, geometry->width, geometry->filters)) : NULL;
+    size_t block_rows = le_conv2d_get_block_rows(geometry);
+    LeTensor *columns = le_tensor_new_scratch(LE_TYPE_FLOAT32, le_shape_new(2, block_rows, geometry->width));
+    for (size_t first_row = 0; first_row < geometry->rows; first_row += block_rows)
+    {
+        size_t rows = (geometry->rows - first_row < block_rows) ? geometry->rows - first_row : block_rows;
+        LeTensorView columns_block, output_gradient_block;
+        le_tensor_view_init_slice(&columns_block, columns, 0, 0, rows);
+        le_tensor_view_init_slice(&output_gradient_block, output_gradient, 0, first_row, rows);
+        if (dw)
+        {
+            /// @note: Filters gradient is sum of products of patches and gradients of their outputs
+            le_conv2d_im2col(geometry, input->data, first_row, rows, columns->data);
+            le_matrix_product_full_into(dw_block, &columns_block, true, &output_gradient_block, false);
+            le_tensor_add(dw, dw_block);
+        }
+        /// @note: Gradients of patches are scattered back to pixels of input
+        le_matrix_product_full_into(&columns_block, &output_gradient_block, false, &w_view, true);
+        le_conv2d_col2im(geometry, columns->data, first_row, rows, input_gradient->data);
+    }
+
+    le_tensor_free(columns);
+    le_tensor_free(dw_block);
+}
+
+/// @note: Each tap of depthwise filter multiplies channels of one pixel, so its gradients are
+/// accumulated with same multiply-adds of vectors of channels as forward pass
+static void
+le_conv2d_backward_depthwise(const LeConv2DGeometry *geometry, const LeTensor *input, const LeTensor *w,
+                             const LeTensor *output_gradient, LeTensor *input_gradient, LeTensor *dw)
+{
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned channels = geometry->channels;
+    const float *w_data = w->data;
+    const float *input_data = input->data;
+    float *input_gradient_data = input_gradient->data;
+
+    for (size_t position = 0; position < geometry->rows; position++)
+    {
+        const float *pixel_gradient = (const float *)output_gradient->data + position * channels;
+        LeConv2DPatch patch = le_conv2d_get_patch(geometry, position);
+        for (unsigned ky = 0; ky < geometry->filter_h; ky++)
+        {
+            for (unsigned kx = 0; kx < geometry->filter_w; kx++)
+            {
+                int64_t pixel = le_conv2d_get_pixel(geometry, &patch, ky, kx);
+                if (pixel < 0)
+                    continue;
+                size_t tap = ((size_t)ky * geometry->filter_w + kx) * channels;
+                kernels->mul_add_f32(input_gradient_data + pixel, w_data + tap, pixel_gradient, channels);
+                if (dw)
+                    kernels->mul_add_f32((float *)dw->data + tap, input_data + pixel, pixel_gradient, channels);
+            }
+        }
+    }
+}
+
 LeTensor *
 le_conv2d_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *cached_output,
                         LeTensor *output_gradient, LeList **parameters_gradient)
 {
-    return NULL;
+    assert(layer);
+    assert(cached_input);
+    assert(output_gradient);
+
+    LeConv2D *self = LE_CONV2D(layer);
+    LeConv2DGeometry geometry;
+    le_conv2d_get_geometry(self, cached_input->shape, &geometry);
+    assert(le_shape_get_elements_count(output_gradient->shape) == geometry.rows * geometry.filters);
+
+    LeTensor *input_gradient = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_copy(cached_input->shape));
+    if (geometry.rows == 0)
+        return input_gradient;
+
+    LeTensor *input_packed, *w_packed, *output_gradient_packed;
+    const LeTensor *input = le_tensor_pack_f32(cached_input, &input_packed);
+    const LeTensor *w = le_tensor_pack_f32(self->w, &w_packed);
+    output_gradient = (LeTensor *)le_tensor_pack_f32(output_gradient, &output_gradient_packed);
+
+    LeTensorView output_gradient_view;
+    le_tensor_view_init(&output_gradient_view, output_gradient);
+    le_tensor_reshape(&output_gradient_view, 2, (int)geometry.rows, (int)geometry.filters);
+
+    LeTensor *dw = NULL;
+    if (parameters_gradient)
+    {
+        size_t dw_height = self->depthwise ? (size_t)geometry.filter_h * geometry.filter_w : geometry.width;
+        dw = le_matrix_new_zeros(LE_TYPE_FLOAT32, dw_height, geometry.filters);
+    }
+
+    if (self->depthwise)
+        le_conv2d_backward_depthwise(&geometry, input, w, output_gradient, input_gradient, dw);
+    else
+        le_conv2d_backward_im2col(&geometry, input, w, &output_gradient_view, input_gradient, dw);
+
+    if (parameters_gradient)
+    {
+        /// @note: Like gradients of dense layer, gradients of parameters are averaged over batch
+        le_tensor_mul(dw, 1.0f / geometry.batch_size);
+        le_tensor_reshape(dw, 4, self->w->shape->sizes[0], self->w->shape->sizes[1],
+                          self->w->shape->sizes[2], self->w->shape->sizes[3]);
+        LeTensor *db = le_matrix_new_sum(&output_gradient_view, 0);
+        le_tensor_mul(db, 1.0f / geometry.batch_size);
+        le_tensor_reshape(db, 4, 1, 1, 1, geometry.filters);
+        *parameters_gradient = le_list_append(*parameters_gradient, db);
+        *parameters_gradient = le_list_append(*parameters_gradient, dw);
+    }
+
+    le_tensor_free(output_gradient_packed);
+    le_tensor_free(w_packed);
+    le_tensor_free(input_packed);
+
+    return input_gradient;
+}
+
+LeShape *
+le_conv2d_get_output_shape(LeLayer *layer)
+{
+    LeConv2D *self = LE_CONV2D(layer);
+
+    /// @note: Spatial sizes depend on input
+    return le_shape_new(4, 0, 0, 0, self->w->shape->sizes[3]);
 }
 
 const char *
@@ -69,31 +929,67 @@ static void
 le_conv2d_class_ensure_init()
 {
     static bool initialized = false;
-    
+
     if (!initialized)
     {
         klass.parent.forward_prop = le_conv2d_forward_prop;
+        klass.parent.forward_prop_into = le_conv2d_forward_prop_into;
+        klass.parent.forward_prop_activation = le_conv2d_forward_prop_activation;
+        klass.parent.forward_prop_activation_into = le_conv2d_forward_prop_activation_into;
         klass.parent.backward_prop = le_conv2d_backward_prop;
-        klass.parent.get_output_shape = NULL;
+        klass.parent.get_output_shape = le_conv2d_get_output_shape;
         klass.parent.get_description = le_conv2d_get_description;
         initialized = true;
     }
 }
 
 LeConv2D *
-le_conv2d_new(const char *name, unsigned filter_size, unsigned num_channels, 
+le_conv2d_new(const char *name, unsigned filter_size, unsigned num_channels,
               unsigned num_filters, unsigned padding, unsigned stride)
 {
+    assert(stride > 0);
+
+    LeConv2D *self = malloc(sizeof(LeConv2D));
+    le_layer_construct(LE_LAYER(self), name);
+    le_conv2d_class_ensure_init();
+    LE_OBJECT_GET_CLASS(self) = LE_CLASS(&klass);
+    self->padding = padding;
+    self->stride = stride;
+    self->depthwise = false;
+    self->algorithm = LE_CONV2D_ALGORITHM_AUTO;
+    self->selected_algorithm = LE_CONV2D_ALGORITHM_AUTO;
+    /// @note: Same initialization as of dense layer with inputs of one patch
+    unsigned inputs = filter_size * filter_size * num_channels;
+    self->w = le_matrix_new_rand_f32(LE_DISTRIBUTION_NORMAL, inputs, num_filters);
+    le_tensor_reshape(self->w, 4, filter_size, filter_size, num_channels, num_filters);
+    le_tensor_mul(self->w, sqrtf(1.0f / inputs));
+    self->b = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(4, 1, 1, 1, num_filters));
+    le_layer_append_parameter(LE_LAYER(self), self->w);
+    le_layer_append_parameter(LE_LAYER(self), self->b);
+    return self;
+}
+
+LeConv2D *
+le_conv2d_new_depthwise(const char *name, unsigned filter_size, unsigned num_channels,
+                        unsigned padding, unsigned stride)
+{
+    assert(stride > 0);
+
     LeConv2D *self = malloc(sizeof(LeConv2D));
     le_layer_construct(LE_LAYER(self), name);
     le_conv2d_class_ensure_init();
     LE_OBJECT_GET_CLASS(self) = LE_CLASS(&klass);
     self->padding = padding;
     self->stride = stride;
-    LeShape *weights_shape = le_shape_new(4, filter_size, filter_size, num_channels, num_filters);
-    self->w = le_tensor_new_rand_f32(weights_shape);
-    LeShape *biases_shape = le_shape_new(4, 1, 1, 1, num_filters);
-    self->b = le_tensor_new_rand_f32(biases_shape);
+    self->depthwise = true;
+    self->algorithm = LE_CONV2D_ALGORITHM_AUTO;
+    self->selected_algorithm = LE_CONV2D_ALGORITHM_AUTO;
+    /// @note: Each output sees filter_size² pixels of one channel
+    unsigned inputs = filter_size * filter_size;
+    self->w = le_matrix_new_rand_f32(LE_DISTRIBUTION_NORMAL, inputs, num_channels);
+    le_tensor_reshape(self->w, 4, filter_size, filter_size, 1, num_channels);
+    le_tensor_mul(self->w, sqrtf(1.0f / inputs));
+    self->b = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(4, 1, 1, 1, num_channels));
     le_layer_append_parameter(LE_LAYER(self), self->w);
     le_layer_append_parameter(LE_LAYER(self), self->b);
     return self;
@@ -4,11 +4,30 @@
 #ifndef __LECONV2D_H__
 #define __LECONV2D_H__
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "lelayer.h"
 #include <le/lemacros.h>
 
 LE_BEGIN_DECLS
 
+/// @note: Ways of computing forward pass. Every algorithm gives same result up to rounding.
+typedef enum LeConv2DAlgorithm
+{
+    /// @note: Selected by shapes of filters and input
+    LE_CONV2D_ALGORITHM_AUTO,
+    /// @note: Patches of input are copied to rows of matrix multiplied by filters, works for any layer
+    LE_CONV2D_ALGORITHM_IM2COL,
+    /// @note: 1×1 filters with stride 1 and no padding, NHWC input is multiplied by filters as is
+    LE_CONV2D_ALGORITHM_POINTWISE,
+    /// @note: Each channel convolved with its own filter, accumulated along channels in vector registers
+    LE_CONV2D_ALGORITHM_DEPTHWISE,
+    /// @note: 3×3 filters with stride 1, output tiles of 2×2 or 4×4 computed from
+    /// Winograd transforms of input and filters with fewer multiplications
+    LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3,
+    LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3
+} LeConv2DAlgorithm;
+
 typedef struct LeConv2D
 {
     LeLayer parent;
@@ -16,8 +35,17 @@ typedef struct LeConv2D
     unsigned int padding;
     unsigned int stride;
 
+    /// @note: Filters of shape (height, width, channels, filters). Filters of depthwise
+    /// layer see one channel each, so their shape is (height, width, 1, channels).
     LeTensor *w;
     LeTensor *b;
+    bool depthwise;
+
+    /// @note: Algorithm requested by le_conv2d_set_algorithm, and one selected for last
+    /// input shape, which is reused while input shape stays the same
+    LeConv2DAlgorithm algorithm;
+    LeConv2DAlgorithm selected_algorithm;
+    uint32_t selected_input_sizes[4];
 } LeConv2D;
 
 #define LE_CONV2D(a) ((LeConv2D *)(a))
@@ -29,6 +57,23 @@ LeConv2D * le_conv2d_new (const char *name,
                           unsigned    padding,
                           unsigned    stride);
 
+/// @note: Layer convolving each of num_channels channels with its own filter,
+/// output has as many channels as input
+LeConv2D * le_conv2d_new_depthwise (const char *name,
+                                    unsigned    filter_size,
+                                    unsigned    num_channels,
+                                    unsigned    padding,
+                                    unsigned    stride);
+
+/// @note: Forces algorithm of forward pass, LE_CONV2D_ALGORITHM_AUTO restores selection.
+/// Algorithm must support layer, e.g. Winograd algorithms need 3×3 filters with stride 1.
+void       le_conv2d_set_algorithm (LeConv2D         *layer,
+                                    LeConv2DAlgorithm algorithm);
+
+/// @note: Algorithm used for input of given NHWC shape
+LeConv2DAlgorithm le_conv2d_get_algorithm (LeConv2D      *layer,
+                                           const LeShape *input_shape);
+
 LE_END_DECLS
 
 #endif
@@ -6,6 +6,8 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <le/tensors/lematrix.h>
+#include <le/tensors/lereduce.h>
+#include <le/tensors/letensor-imp.h>
 
 typedef struct LeDenseLayerClass
 {
@@ -13,8 +15,8 @@ typedef struct LeDenseLayerClass
     
 } LeDenseLayerClass;
 
-LeTensor *
-le_dense_layer_forward_prop(LeLayer *layer, LeTensor *input)
+static void
+le_dense_layer_forward_prop_activation_into(LeLayer *layer, LeTensor *output, LeTensor *input, LeActivation activation)
 {
     assert(layer);
     assert(input);
@@ -23,16 +25,51 @@ le_dense_layer_forward_prop(LeLayer *layer, LeTensor *input)
     
     assert(self->w);
 
-    LeTensor *output = le_matrix_new_product(self->w, input);
-    
-    if (self->b)
+    if (self->w->element_type == LE_TYPE_INT8)
     {
-        le_matrix_add(output, self->b);
+        /// @note: Bias and ReLU are applied while integer products are dequantized
+        le_matrix_quantized_product_into(output, self->w, self->w_scales, self->w_zero_points, input,
+                                         (self->x_quantization.scale > 0.0f) ? &self->x_quantization : NULL,
+                                         self->b, self->relu || (activation == LE_ACTIVATION_RELU));
+        if (activation == LE_ACTIVATION_SIGMOID)
+            le_tensor_apply_sigmoid(output);
+        else if (activation == LE_ACTIVATION_TANH)
+            le_tensor_apply_tanh(output);
+        return;
     }
+
+    /// @note: Bias and activation are applied to tiles of output right after they are computed
+    le_matrix_product_activation_into(output, self->w, false, input, false, self->b, activation);
+}
+
+static LeTensor *
+le_dense_layer_forward_prop_activation(LeLayer *layer, LeTensor *input, LeActivation activation)
+{
+    assert(layer);
+    assert(input);
+    
+    LeDenseLayer *self = LE_DENSE_LAYER(layer);
+    
+    assert(self->w);
+
+    LeTensor *output = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, le_matrix_get_height(self->w), le_matrix_get_width(input));
+    le_dense_layer_forward_prop_activation_into(layer, output, input, activation);
     
     return output;
 }
 
+void
+le_dense_layer_forward_prop_into(LeLayer *layer, LeTensor *output, LeTensor *input)
+{
+    le_dense_layer_forward_prop_activation_into(layer, output, input, LE_ACTIVATION_LINEAR);
+}
+
+LeTensor *
+le_dense_layer_forward_prop(LeLayer *layer, LeTensor *input)
+{
+    return le_dense_layer_forward_prop_activation(layer, input, LE_ACTIVATION_LINEAR);
+}
+
 LeTensor *
 le_dense_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *cached_output, LeTensor *output_gradient, LeList **parameters_gradient)
 {
@@ -42,6 +79,7 @@ le_dense_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *c
     LeDenseLayer *self = LE_DENSE_LAYER(layer);
 
     assert(self->w);
+    assert(self->w->element_type != LE_TYPE_INT8);
 
     LeTensor *input_gradient = le_matrix_new_product_full(self->w, true, output_gradient, false);
 
@@ -49,7 +87,7 @@ le_dense_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *c
     {
         assert(cached_input);
 
-        LeTensor *h = le_tensor_new_copy(output_gradient);
+        LeTensor *h = le_tensor_new_scratch_copy(output_gradient);
         unsigned examples_count = le_matrix_get_width(h);
         le_tensor_mul(h, 1.0f / examples_count);
         LeTensor *dw = le_matrix_new_product_full(h, false, cached_input, true);
@@ -77,6 +115,51 @@ le_dense_layer_get_description(LeLayer *self)
     return description;
 }
 
+void
+le_dense_layer_quantize(LeDenseLayer *self, const LeTensor *calibration_input, bool relu)
+{
+    assert(self);
+    assert(self->w);
+    assert(self->w->element_type != LE_TYPE_INT8);
+
+    LeTensor *w_scales = NULL, *w_zero_points = NULL;
+    LeTensor *w_quantized = le_matrix_new_quantized_rows(self->w, &w_scales, &w_zero_points);
+    /// @note: Elements are swapped, so that w stays valid as parameter of model.
+    /// Both tensors are densely packed and share shape, so strides stay the same.
+    assert(le_tensor_contiguous(self->w));
+    void *data = self->w->data;
+    LeType type = self->w->element_type;
+    LeTensorMapping mapping = self->w->mapping;
+    self->w->data = w_quantized->data;
+    self->w->element_type = LE_TYPE_INT8;
+    self->w->mapping = LE_TENSOR_MAPPING_NONE;
+    w_quantized->data = data;
+    w_quantized->element_type = type;
+    w_quantized->mapping = mapping;
+    le_tensor_free(w_quantized);
+    self->w_scales = w_scales;
+    self->w_zero_points = w_zero_points;
+
+    if (self->b)
+        le_tensor_convert(self->b, LE_TYPE_FLOAT32);
+
+    self->x_quantization.scale = 0.0f;
+    self->x_quantization.zero_point = 0;
+    if (calibration_input)
+    {
+        self->x_quantization = le_quantization_from_range(le_tensor_reduce_f32(calibration_input, LE_REDUCE_OP_MIN),
+                                                          le_tensor_reduce_f32(calibration_input, LE_REDUCE_OP_MAX),
+                                                          0, UINT8_MAX);
+    }
+    self->relu = relu;
+}
+
+static void
+le_dense_layer_quantize_layer(LeLayer *layer, const LeTensor *calibration_input, bool relu)
+{
+    le_dense_layer_quantize(LE_DENSE_LAYER(layer), calibration_input, relu);
+}
+
 static LeDenseLayerClass klass;
 
 static void
@@ -87,9 +170,13 @@ le_dense_layer_class_ensure_init()
     if (!initialized)
     {
         klass.parent.forward_prop = le_dense_layer_forward_prop;
+        klass.parent.forward_prop_into = le_dense_layer_forward_prop_into;
+        klass.parent.forward_prop_activation = le_dense_layer_forward_prop_activation;
+        klass.parent.forward_prop_activation_into = le_dense_layer_forward_prop_activation_into;
         klass.parent.backward_prop = le_dense_layer_backward_prop;
         klass.parent.get_output_shape = le_dense_layer_get_output_shape;
         klass.parent.get_description = le_dense_layer_get_description;
+        klass.parent.quantize = le_dense_layer_quantize_layer;
         initialized = true;
     }
 }
@@ -106,6 +193,11 @@ le_dense_layer_new(const char *name, unsigned inputs, unsigned units)
     float variance = sqrtf(1.0f / inputs);
     le_tensor_mul(self->w, variance);
     self->b = le_matrix_new_zeros(LE_TYPE_FLOAT32, units, 1);
+    self->w_scales = NULL;
+    self->w_zero_points = NULL;
+    self->x_quantization.scale = 0.0f;
+    self->x_quantization.zero_point = 0;
+    self->relu = false;
     le_layer_append_parameter(LE_LAYER(self), self->w);
     le_layer_append_parameter(LE_LAYER(self), self->b);
     return self;
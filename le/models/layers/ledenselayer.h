@@ -5,6 +5,7 @@
 #define __LEDENSELAYER_H__
 
 #include <le/lemacros.h>
+#include <le/tensors/lequant.h>
 #include "lelayer.h"
 
 LE_BEGIN_DECLS
@@ -17,6 +18,15 @@ typedef struct LeDenseLayer
     
     LeTensor *w;
     LeTensor *b;
+
+    /// @note: Scales and zero points of rows of w quantized to LE_TYPE_INT8, NULL otherwise
+    LeTensor *w_scales;
+    LeTensor *w_zero_points;
+    /// @note: Quantization of inputs found by calibration. Inputs are quantized
+    /// with range of each batch when scale is zero.
+    LeQuantization x_quantization;
+    /// @note: ReLU is applied to output of quantized product
+    bool relu;
 } LeDenseLayer;
 
 #define LE_DENSE_LAYER(a) ((LeDenseLayer *)(a))
@@ -25,6 +35,13 @@ LeDenseLayer * le_dense_layer_new (const char *name,
                                    unsigned    inputs,
                                    unsigned    units);
 
+/// @note: Quantizes w for inference. Inputs are quantized to 8 bits dynamically per batch,
+/// or with range of calibration_input, e.g. inputs of layer for sample batch, if it is not NULL.
+/// Quantized layer can not be trained.
+void           le_dense_layer_quantize (LeDenseLayer   *layer,
+                                        const LeTensor *calibration_input,
+                                        bool            relu);
+
 LE_END_DECLS
 
 #endif
@@ -29,6 +29,65 @@ le_layer_forward_prop(LeLayer *self, LeTensor *input)
     return klass->forward_prop(self, input);
 }
 
+void
+le_layer_forward_prop_into(LeLayer *self, LeTensor *output, LeTensor *input)
+{
+    assert(self);
+    assert(output);
+    LeLayerClass *klass = LE_LAYER_GET_CLASS(self);
+    assert(klass);
+
+    if (klass->forward_prop_into)
+    {
+        klass->forward_prop_into(self, output, input);
+    }
+    else
+    {
+        assert(klass->forward_prop);
+        LeTensor *result = klass->forward_prop(self, input);
+        le_tensor_assign(output, result);
+        le_tensor_free(result);
+    }
+}
+
+bool
+le_layer_fuses_activation(LeLayer *self, LeActivation activation)
+{
+    assert(self);
+    LeLayerClass *klass = LE_LAYER_GET_CLASS(self);
+    assert(klass);
+
+    return (klass->forward_prop_activation != NULL) && (activation != LE_ACTIVATION_SOFTMAX);
+}
+
+LeTensor *
+le_layer_forward_prop_activation(LeLayer *self, LeTensor *input, LeActivation activation)
+{
+    assert(le_layer_fuses_activation(self, activation));
+    LeLayerClass *klass = LE_LAYER_GET_CLASS(self);
+
+    return klass->forward_prop_activation(self, input, activation);
+}
+
+void
+le_layer_forward_prop_activation_into(LeLayer *self, LeTensor *output, LeTensor *input, LeActivation activation)
+{
+    assert(output);
+    assert(le_layer_fuses_activation(self, activation));
+    LeLayerClass *klass = LE_LAYER_GET_CLASS(self);
+
+    if (klass->forward_prop_activation_into)
+    {
+        klass->forward_prop_activation_into(self, output, input, activation);
+    }
+    else
+    {
+        LeTensor *result = klass->forward_prop_activation(self, input, activation);
+        le_tensor_assign(output, result);
+        le_tensor_free(result);
+    }
+}
+
 LeList *
 le_layer_get_parameters(LeLayer *self)
 {
@@ -37,10 +96,10 @@ le_layer_get_parameters(LeLayer *self)
     return self->parameters;
 }
 
-unsigned     
+size_t
 le_layer_get_parameters_count(LeLayer *layer)
 {
-    unsigned count = 0;
+    size_t count = 0;
     for (LeList *current = layer->parameters; current != NULL; current = current->next)
     {
         count += le_shape_get_elements_count(LE_TENSOR(current->data)->shape);
@@ -90,3 +149,17 @@ le_layer_get_description(LeLayer *self)
 
     return klass->get_description(self);
 }
+
+bool
+le_layer_quantize(LeLayer *self, const LeTensor *calibration_input, bool relu)
+{
+    assert(self);
+    LeLayerClass *klass = LE_LAYER_GET_CLASS(self);
+    assert(klass);
+
+    if (klass->quantize == NULL)
+        return false;
+
+    klass->quantize(self, calibration_input, relu);
+    return true;
+}
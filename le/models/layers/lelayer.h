@@ -6,6 +6,7 @@
 
 #include <le/leobject.h>
 #include <le/tensors/letensor.h>
+#include <le/tensors/leactivation.h>
 #include <le/lelist.h>
 #include <le/lemacros.h>
 
@@ -28,9 +29,18 @@ typedef struct LeLayerClass
     LeClass parent;
     
     LeTensor * (*forward_prop)(LeLayer *self, LeTensor *x);
+    /// @note: Optional, writes output into preallocated y
+    void (*forward_prop_into)(LeLayer *self, LeTensor *y, LeTensor *x);
+    /// @note: Optional, same as forward_prop followed by element-wise activation,
+    /// which is applied while output is computed
+    LeTensor * (*forward_prop_activation)(LeLayer *self, LeTensor *x, LeActivation activation);
+    /// @note: Optional, writes output of forward_prop_activation into preallocated y
+    void (*forward_prop_activation_into)(LeLayer *self, LeTensor *y, LeTensor *x, LeActivation activation);
     LeTensor * (*backward_prop)(LeLayer *self, LeTensor *x, LeTensor *y, LeTensor *dJ_dy, LeList **dJ_dw);
     LeShape * (*get_output_shape)(LeLayer *self);
     const char * (*get_description)(LeLayer *self);
+    /// @note: Optional, converts parameters to 8-bit integers for inference
+    void (*quantize)(LeLayer *self, const LeTensor *calibration_x, bool relu);
 } LeLayerClass;
 
 #define LE_LAYER_CLASS(a) ((LeLayerClass *)(a))
@@ -42,9 +52,32 @@ void         le_layer_construct            (LeLayer     *layer,
 LeTensor *   le_layer_forward_prop         (LeLayer     *layer,
                                             LeTensor    *input);
 
+/// @note: Output must have shape of forward_prop result. Layers which do not implement
+/// forward_prop_into fall back to forward_prop and copy.
+void         le_layer_forward_prop_into    (LeLayer     *layer,
+                                            LeTensor    *output,
+                                            LeTensor    *input);
+
+/// @note: Whether layer applies given activation to its output itself, so that following
+/// activation layer can be skipped during inference
+bool         le_layer_fuses_activation     (LeLayer     *layer,
+                                            LeActivation activation);
+
+/// @note: Same as le_layer_forward_prop followed by activation, which layer must fuse
+LeTensor *   le_layer_forward_prop_activation
+                                           (LeLayer     *layer,
+                                            LeTensor    *input,
+                                            LeActivation activation);
+
+void         le_layer_forward_prop_activation_into
+                                           (LeLayer     *layer,
+                                            LeTensor    *output,
+                                            LeTensor    *input,
+                                            LeActivation activation);
+
 LeList *     le_layer_get_parameters       (LeLayer     *layer);
 
-unsigned     le_layer_get_parameters_count (LeLayer     *layer);
+size_t       le_layer_get_parameters_count (LeLayer     *layer);
 
 void         le_layer_append_parameter     (LeLayer     *layer,
                                             LeTensor    *parameter);
@@ -59,6 +92,13 @@ LeShape *    le_layer_get_output_shape     (LeLayer     *layer);
 
 const char * le_layer_get_description      (LeLayer     *layer);
 
+/// @note: Quantizes layer if it supports quantization, in which case returns true.
+/// Calibration input, if not NULL, is typical input of layer used to fix quantization of inputs.
+/// If relu is set, ReLU is applied to output of quantized layer.
+bool         le_layer_quantize             (LeLayer     *layer,
+                                            const LeTensor *calibration_input,
+                                            bool         relu);
+
 LE_END_DECLS
 
 #endif
@@ -0,0 +1,520 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "lepoollayer.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <le/lemem.h>
+#include <le/leparallel.h>
+#include <le/tensors/lekernels.h>
+#include <le/tensors/letensor-imp.h>
+
+/// @note: Window elements visited by each thread, about
+#define LE_POOL_GRAIN (1 << 16)
+/// @note: Argmax of window is stored in one byte
+#define LE_POOL_MAX_WINDOW_SIZE 16
+
+typedef struct LeMaxPoolLayerClass
+{
+    LeLayerClass parent;
+
+} LeMaxPoolLayerClass;
+
+static LeMaxPoolLayerClass max_klass;
+
+typedef struct LeAvgPoolLayerClass
+{
+    LeLayerClass parent;
+
+} LeAvgPoolLayerClass;
+
+static LeAvgPoolLayerClass avg_klass;
+
+/// @note: Sizes of NHWC input and output, window taps are numbered row by row
+typedef struct LePoolGeometry
+{
+    unsigned batch_size;
+    unsigned input_h;
+    unsigned input_w;
+    unsigned channels;
+    unsigned window_size;
+    unsigned stride;
+    unsigned padding;
+    unsigned output_h;
+    unsigned output_w;
+} LePoolGeometry;
+
+static void
+le_pool_get_geometry(unsigned window_size, unsigned stride, unsigned padding,
+                     const LeShape *input_shape, LePoolGeometry *geometry)
+{
+    assert(input_shape->num_dimensions == 4);
+
+    geometry->batch_size = input_shape->sizes[0];
+    geometry->input_h = input_shape->sizes[1];
+    geometry->input_w = input_shape->sizes[2];
+    geometry->channels = input_shape->sizes[3];
+    geometry->window_size = window_size;
+    geometry->stride = stride;
+    geometry->padding = padding;
+    assert(geometry->input_h + 2 * padding >= window_size);
+    assert(geometry->input_w + 2 * padding >= window_size);
+
+    geometry->output_h = (geometry->input_h + 2 * padding - window_size) / stride + 1;
+    geometry->output_w = (geometry->input_w + 2 * padding - window_size) / stride + 1;
+}
+
+static LeShape *
+le_pool_new_output_shape(const LePoolGeometry *geometry)
+{
+    return le_shape_new(4, geometry->batch_size, geometry->output_h, geometry->output_w, geometry->channels);
+}
+
+/// @note: Offset in NHWC input of first channel of pixel under tap of window of output pixel,
+/// -1 for padding
+static inline int64_t
+le_pool_get_pixel(const LePoolGeometry *geometry, size_t image, unsigned oy, unsigned ox, unsigned tap)
+{
+    int64_t y = (int64_t)oy * geometry->stride + tap / geometry->window_size - geometry->padding;
+    int64_t x = (int64_t)ox * geometry->stride + tap % geometry->window_size - geometry->padding;
+    if ((y < 0) || (y >= geometry->input_h) || (x < 0) || (x >= geometry->input_w))
+        return -1;
+    return (((int64_t)image * geometry->input_h + y) * geometry->input_w + x) * geometry->channels;
+}
+
+/// @note: Rows of output, one per image and output row, pooled by each thread
+static size_t
+le_pool_get_grain(const LePoolGeometry *geometry)
+{
+    size_t row_work = (size_t)geometry->output_w * geometry->channels * geometry->window_size * geometry->window_size;
+    return (row_work < LE_POOL_GRAIN) ? LE_POOL_GRAIN / row_work : 1;
+}
+
+typedef struct LePoolTask
+{
+    const LePoolGeometry *geometry;
+    const float          *input;
+    float                *output;
+    /// @note: Max pooling only, NULL when argmax is not cached or does not match input
+    uint8_t              *argmax;
+    const float          *cached_output;
+    const float          *output_gradient;
+    float                *input_gradient;
+} LePoolTask;
+
+/// @note: Pools rows [begin, end) of output. Channels of pixel are contiguous in NHWC,
+/// so every tap of window is one vector operation over channels.
+static void
+le_maxpool_forward_rows(void *data, size_t begin, size_t end)
+{
+    const LePoolTask *task = data;
+    const LePoolGeometry *geometry = task->geometry;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned channels = geometry->channels;
+    const unsigned taps = geometry->window_size * geometry->window_size;
+    float *index = le_arena_alloc(channels * sizeof(float));
+
+    for (size_t row = begin; row < end; row++)
+    {
+        size_t image = row / geometry->output_h;
+        unsigned oy = row % geometry->output_h;
+        for (unsigned ox = 0; ox < geometry->output_w; ox++)
+        {
+            size_t position = row * geometry->output_w + ox;
+            float *pixel_output = task->output + position * channels;
+            bool first = true;
+            for (unsigned tap = 0; tap < taps; tap++)
+            {
+                int64_t pixel = le_pool_get_pixel(geometry, image, oy, ox, tap);
+                if (pixel < 0)
+                    continue;
+                if (first)
+                {
+                    memcpy(pixel_output, task->input + pixel, channels * sizeof(float));
+                    for (unsigned c = 0; c < channels; c++)
+                        index[c] = (float)tap;
+                    first = false;
+                }
+                else
+                {
+                    kernels->max_index_f32(pixel_output, index, task->input + pixel, (float)tap, channels);
+                }
+            }
+            if (task->argmax)
+            {
+                uint8_t *pixel_argmax = task->argmax + position * channels;
+                for (unsigned c = 0; c < channels; c++)
+                    pixel_argmax[c] = (uint8_t)index[c];
+            }
+        }
+    }
+
+    le_free(index);
+}
+
+/// @note: Offset of input element holding maximum of window of channel c, first one on ties
+static int64_t
+le_maxpool_find_max(const LePoolGeometry *geometry, const float *input,
+                    size_t image, unsigned oy, unsigned ox, unsigned c)
+{
+    int64_t max_pixel = -1;
+    const unsigned taps = geometry->window_size * geometry->window_size;
+
+    for (unsigned tap = 0; tap < taps; tap++)
+    {
+        int64_t pixel = le_pool_get_pixel(geometry, image, oy, ox, tap);
+        if ((pixel >= 0) && ((max_pixel < 0) || (input[max_pixel + c] < input[pixel + c])))
+            max_pixel = pixel;
+    }
+
+    return max_pixel;
+}
+
+/// @note: Gradient of each output goes to element which was maximum of its window.
+/// Windows of different images do not overlap, so images are processed in parallel.
+static void
+le_maxpool_backward_images(void *data, size_t begin, size_t end)
+{
+    const LePoolTask *task = data;
+    const LePoolGeometry *geometry = task->geometry;
+    const unsigned channels = geometry->channels;
+
+    for (size_t image = begin; image < end; image++)
+    {
+        for (unsigned oy = 0; oy < geometry->output_h; oy++)
+        {
+            for (unsigned ox = 0; ox < geometry->output_w; ox++)
+            {
+                size_t position = (image * geometry->output_h + oy) * geometry->output_w + ox;
+                const float *pixel_gradient = task->output_gradient + position * channels;
+                for (unsigned c = 0; c < channels; c++)
+                {
+                    int64_t pixel = -1;
+                    if (task->argmax)
+                    {
+                        pixel = le_pool_get_pixel(geometry, image, oy, ox, task->argmax[position * channels + c]);
+                        /// @note: Cached position is trusted only while it holds output of window
+                        if ((pixel >= 0) && (task->input[pixel + c] != task->cached_output[position * channels + c]))
+                            pixel = -1;
+                    }
+                    if (pixel < 0)
+                        pixel = le_maxpool_find_max(geometry, task->input, image, oy, ox, c);
+                    task->input_gradient[pixel + c] += pixel_gradient[c];
+                }
+            }
+        }
+    }
+}
+
+static void
+le_avgpool_forward_rows(void *data, size_t begin, size_t end)
+{
+    const LePoolTask *task = data;
+    const LePoolGeometry *geometry = task->geometry;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned channels = geometry->channels;
+    const unsigned taps = geometry->window_size * geometry->window_size;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        size_t image = row / geometry->output_h;
+        unsigned oy = row % geometry->output_h;
+        for (unsigned ox = 0; ox < geometry->output_w; ox++)
+        {
+            float *pixel_output = task->output + (row * geometry->output_w + ox) * channels;
+            unsigned count = 0;
+            memset(pixel_output, 0, channels * sizeof(float));
+            for (unsigned tap = 0; tap < taps; tap++)
+            {
+                int64_t pixel = le_pool_get_pixel(geometry, image, oy, ox, tap);
+                if (pixel < 0)
+                    continue;
+                kernels->add_f32(pixel_output, task->input + pixel, channels);
+                count++;
+            }
+            kernels->mul_scalar_f32(pixel_output, 1.0f / count, channels);
+        }
+    }
+}
+
+/// @note: Gradient of each output is spread evenly over input pixels of its window
+static void
+le_avgpool_backward_images(void *data, size_t begin, size_t end)
+{
+    const LePoolTask *task = data;
+    const LePoolGeometry *geometry = task->geometry;
+    const LeKernels *kernels = le_kernels_get();
+    const unsigned channels = geometry->channels;
+    const unsigned taps = geometry->window_size * geometry->window_size;
+
+    for (size_t image = begin; image < end; image++)
+    {
+        for (unsigned oy = 0; oy < geometry->output_h; oy++)
+        {
+            for (unsigned ox = 0; ox < geometry->output_w; ox++)
+            {
+                size_t position = (image * geometry->output_h + oy) * geometry->output_w + ox;
+                const float *pixel_gradient = task->output_gradient + position * channels;
+                unsigned count = 0;
+                for (unsigned tap = 0; tap < taps; tap++)
+                    count += le_pool_get_pixel(geometry, image, oy, ox, tap) >= 0;
+                for (unsigned tap = 0; tap < taps; tap++)
+                {
+                    int64_t pixel = le_pool_get_pixel(geometry, image, oy, ox, tap);
+                    if (pixel >= 0)
+                        kernels->sub_scaled_f32(task->input_gradient + pixel, -1.0f / count, pixel_gradient, channels);
+                }
+            }
+        }
+    }
+}
+
+/// @note: Runs forward kernel on output of shape given by geometry
+static void
+le_pool_forward(const LePoolGeometry *geometry, LeTensor *output, const LeTensor *input,
+                LeParallelFunction function, uint8_t *argmax)
+{
+    assert(output->element_type == LE_TYPE_FLOAT32);
+    assert(output->shape->num_dimensions == 4);
+    assert(output->shape->sizes[0] == geometry->batch_size);
+    assert(output->shape->sizes[1] == geometry->output_h);
+    assert(output->shape->sizes[2] == geometry->output_w);
+    assert(output->shape->sizes[3] == geometry->channels);
+    assert(le_tensor_contiguous(output));
+
+    size_t rows = (size_t)geometry->batch_size * geometry->output_h;
+    if ((rows == 0) || (geometry->output_w == 0) || (geometry->channels == 0))
+        return;
+    le_tensor_make_writable(output);
+
+    LeTensor *input_packed;
+    LePoolTask task = {
+        .geometry = geometry,
+        .input = le_tensor_pack_f32(input, &input_packed)->data,
+        .output = output->data,
+        .argmax = argmax
+    };
+    le_parallel_for(rows, le_pool_get_grain(geometry), function, &task);
+    le_tensor_free(input_packed);
+}
+
+/// @note: Runs backward kernel and returns input gradient
+static LeTensor *
+le_pool_backward(const LePoolGeometry *geometry, const LeTensor *cached_input, const LeTensor *cached_output,
+                 LeTensor *output_gradient, LeParallelFunction function, uint8_t *argmax)
+{
+    size_t outputs_count = (size_t)geometry->batch_size * geometry->output_h * geometry->output_w * geometry->channels;
+    assert(le_shape_get_elements_count(output_gradient->shape) == outputs_count);
+
+    LeTensor *input_gradient = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_copy(cached_input->shape));
+    if (outputs_count == 0)
+        return input_gradient;
+
+    LeTensor *input_packed, *output_gradient_packed, *cached_output_packed = NULL;
+    LePoolTask task = {
+        .geometry = geometry,
+        .input = le_tensor_pack_f32(cached_input, &input_packed)->data,
+        .argmax = argmax,
+        .cached_output = argmax ? le_tensor_pack_f32(cached_output, &cached_output_packed)->data : NULL,
+        .output_gradient = le_tensor_pack_f32(output_gradient, &output_gradient_packed)->data,
+        .input_gradient = input_gradient->data
+    };
+    le_parallel_for(geometry->batch_size, 1, function, &task);
+
+    le_tensor_free(cached_output_packed);
+    le_tensor_free(output_gradient_packed);
+    le_tensor_free(input_packed);
+
+    return input_gradient;
+}
+
+LeTensor *
+le_maxpool_layer_forward_prop(LeLayer *layer, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+
+    LeMaxPoolLayer *self = LE_MAXPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, input->shape, &geometry);
+    LeTensor *output = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_pool_new_output_shape(&geometry));
+
+    /// @note: Positions of maxima are kept for backward pass of training. Cache lives as long
+    /// as layer, so it is never scratch of training step.
+    if ((self->argmax == NULL) || !le_shape_equal(self->argmax->shape, output->shape))
+    {
+        le_tensor_free(self->argmax);
+        self->argmax = le_tensor_new_uninitialized(LE_TYPE_UINT8, le_shape_copy(output->shape));
+    }
+    le_pool_forward(&geometry, output, input, le_maxpool_forward_rows, self->argmax->data);
+
+    return output;
+}
+
+void
+le_maxpool_layer_forward_prop_into(LeLayer *layer, LeTensor *output, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+    assert(output);
+
+    LeMaxPoolLayer *self = LE_MAXPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, input->shape, &geometry);
+    le_pool_forward(&geometry, output, input, le_maxpool_forward_rows, NULL);
+}
+
+LeTensor *
+le_maxpool_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *cached_output,
+                               LeTensor *output_gradient, LeList **parameters_gradient)
+{
+    assert(layer);
+    assert(cached_input);
+    assert(output_gradient);
+
+    LeMaxPoolLayer *self = LE_MAXPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, cached_input->shape, &geometry);
+
+    /// @note: Cached argmax is checked against cached output, so it needs one of matching shape
+    uint8_t *argmax = NULL;
+    if (self->argmax && cached_output && le_shape_equal(self->argmax->shape, cached_output->shape))
+        argmax = self->argmax->data;
+
+    return le_pool_backward(&geometry, cached_input, cached_output, output_gradient, le_maxpool_backward_images, argmax);
+}
+
+LeTensor *
+le_avgpool_layer_forward_prop(LeLayer *layer, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+
+    LeAvgPoolLayer *self = LE_AVGPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, input->shape, &geometry);
+    LeTensor *output = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_pool_new_output_shape(&geometry));
+    le_pool_forward(&geometry, output, input, le_avgpool_forward_rows, NULL);
+
+    return output;
+}
+
+void
+le_avgpool_layer_forward_prop_into(LeLayer *layer, LeTensor *output, LeTensor *input)
+{
+    assert(layer);
+    assert(input);
+    assert(output);
+
+    LeAvgPoolLayer *self = LE_AVGPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, input->shape, &geometry);
+    le_pool_forward(&geometry, output, input, le_avgpool_forward_rows, NULL);
+}
+
+LeTensor *
+le_avgpool_layer_backward_prop(LeLayer *layer, LeTensor *cached_input, LeTensor *cached_output,
+                               LeTensor *output_gradient, LeList **parameters_gradient)
+{
+    assert(layer);
+    assert(cached_input);
+    assert(output_gradient);
+
+    LeAvgPoolLayer *self = LE_AVGPOOL_LAYER(layer);
+    LePoolGeometry geometry;
+    le_pool_get_geometry(self->window_size, self->stride, self->padding, cached_input->shape, &geometry);
+
+    return le_pool_backward(&geometry, cached_input, NULL, output_gradient, le_avgpool_backward_images, NULL);
+}
+
+LeShape *
+le_pool_layer_get_output_shape(LeLayer *layer)
+{
+    /// @note: Output has as many channels as input, all sizes depend on input
+    return le_shape_new(4, 0, 0, 0, 0);
+}
+
+const char *
+le_maxpool_layer_get_description(LeLayer *self)
+{
+    static const char *description = "Max Pooling Layer";
+    return description;
+}
+
+const char *
+le_avgpool_layer_get_description(LeLayer *self)
+{
+    static const char *description = "Average Pooling Layer";
+    return description;
+}
+
+static void
+le_maxpool_layer_class_ensure_init()
+{
+    static bool initialized = false;
+
+    if (!initialized)
+    {
+        max_klass.parent.forward_prop = le_maxpool_layer_forward_prop;
+        max_klass.parent.forward_prop_into = le_maxpool_layer_forward_prop_into;
+        max_klass.parent.backward_prop = le_maxpool_layer_backward_prop;
+        max_klass.parent.get_output_shape = le_pool_layer_get_output_shape;
+        max_klass.parent.get_description = le_maxpool_layer_get_description;
+        initialized = true;
+    }
+}
+
+static void
+le_avgpool_layer_class_ensure_init()
+{
+    static bool initialized = false;
+
+    if (!initialized)
+    {
+        avg_klass.parent.forward_prop = le_avgpool_layer_forward_prop;
+        avg_klass.parent.forward_prop_into = le_avgpool_layer_forward_prop_into;
+        avg_klass.parent.backward_prop = le_avgpool_layer_backward_prop;
+        avg_klass.parent.get_output_shape = le_pool_layer_get_output_shape;
+        avg_klass.parent.get_description = le_avgpool_layer_get_description;
+        initialized = true;
+    }
+}
+
+LeMaxPoolLayer *
+le_maxpool_layer_new(const char *name, unsigned window_size, unsigned stride, unsigned padding)
+{
+    assert(window_size > 0);
+    assert(window_size <= LE_POOL_MAX_WINDOW_SIZE);
+    assert(stride > 0);
+    assert(padding < window_size);
+
+    LeMaxPoolLayer *self = malloc(sizeof(LeMaxPoolLayer));
+    le_layer_construct(LE_LAYER(self), name);
+    le_maxpool_layer_class_ensure_init();
+    LE_OBJECT_GET_CLASS(self) = LE_CLASS(&max_klass);
+    self->window_size = window_size;
+    self->stride = stride;
+    self->padding = padding;
+    self->argmax = NULL;
+    return self;
+}
+
+LeAvgPoolLayer *
+le_avgpool_layer_new(const char *name, unsigned window_size, unsigned stride, unsigned padding)
+{
+    assert(window_size > 0);
+    assert(stride > 0);
+    assert(padding < window_size);
+
+    LeAvgPoolLayer *self = malloc(sizeof(LeAvgPoolLayer));
+    le_layer_construct(LE_LAYER(self), name);
+    le_avgpool_layer_class_ensure_init();
+    LE_OBJECT_GET_CLASS(self) = LE_CLASS(&avg_klass);
+    self->window_size = window_size;
+    self->stride = stride;
+    self->padding = padding;
+    return self;
+}
@@ -0,0 +1,54 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#ifndef __LEPOOLLAYER_H__
+#define __LEPOOLLAYER_H__
+
+#include "lelayer.h"
+#include <le/lemacros.h>
+
+LE_BEGIN_DECLS
+
+/// @note: Pooling of NHWC input over square windows, each channel separately.
+/// Padding is ignored: it never wins max and is not counted in average.
+typedef struct LeMaxPoolLayer
+{
+    LeLayer parent;
+
+    unsigned int window_size;
+    unsigned int stride;
+    unsigned int padding;
+
+    /// @note: Position within window of maximum of every output element of last
+    /// forward_prop, LE_TYPE_UINT8 tensor of output shape. Used by backward_prop
+    /// where it matches cached input and output, windows are rescanned otherwise.
+    LeTensor *argmax;
+} LeMaxPoolLayer;
+
+#define LE_MAXPOOL_LAYER(a) ((LeMaxPoolLayer *)(a))
+
+typedef struct LeAvgPoolLayer
+{
+    LeLayer parent;
+
+    unsigned int window_size;
+    unsigned int stride;
+    unsigned int padding;
+} LeAvgPoolLayer;
+
+#define LE_AVGPOOL_LAYER(a) ((LeAvgPoolLayer *)(a))
+
+/// @note: Padding must be smaller than window, so that every window covers input
+LeMaxPoolLayer * le_maxpool_layer_new (const char *name,
+                                       unsigned    window_size,
+                                       unsigned    stride,
+                                       unsigned    padding);
+
+LeAvgPoolLayer * le_avgpool_layer_new (const char *name,
+                                       unsigned    window_size,
+                                       unsigned    stride,
+                                       unsigned    padding);
+
+LE_END_DECLS
+
+#endif
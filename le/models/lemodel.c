@@ -4,6 +4,7 @@
 #include "lemodel.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <math.h>
 #include "lelog.h"
 
 #define DEFAULT_LOG_CATEGORY "model"
@@ -33,6 +34,26 @@ le_model_predict(LeModel *self, const LeTensor *x)
     return LE_MODEL_GET_CLASS(self)->predict(self, x);
 }
 
+void
+le_model_predict_into(LeModel *self, LeTensor *prediction, const LeTensor *x)
+{
+    assert(self);
+    assert(prediction);
+    assert(LE_OBJECT_GET_CLASS(self));
+
+    if (LE_MODEL_GET_CLASS(self)->predict_into)
+    {
+        LE_MODEL_GET_CLASS(self)->predict_into(self, prediction, x);
+    }
+    else
+    {
+        assert(LE_MODEL_GET_CLASS(self)->predict);
+        LeTensor *result = LE_MODEL_GET_CLASS(self)->predict(self, x);
+        le_tensor_assign(prediction, result);
+        le_tensor_free(result);
+    }
+}
+
 LeList *
 le_model_get_gradients(LeModel *self, const LeTensor *x, const LeTensor *y)
 {
@@ -48,6 +69,20 @@ le_model_get_gradients(LeModel *self, const LeTensor *x, const LeTensor *y)
     return LE_MODEL_GET_CLASS(self)->get_gradients(self, x, y);
 }
 
+LeList *
+le_model_get_gradients_with_loss(LeModel *self, const LeTensor *x, const LeTensor *y, float *loss)
+{
+    assert(self);
+    assert(LE_OBJECT_GET_CLASS(self));
+    assert(loss);
+
+    if (LE_MODEL_GET_CLASS(self)->get_gradients_with_loss)
+        return LE_MODEL_GET_CLASS(self)->get_gradients_with_loss(self, x, y, loss);
+
+    *loss = NAN;
+    return le_model_get_gradients(self, x, y);
+}
+
 float
 le_model_train_iteration(LeModel *self)
 {
@@ -23,7 +23,12 @@ typedef struct LeModelClass
 {
     LeClass parent;
     LeTensor * (*predict)         (LeModel *model, const LeTensor *x);
+    /// @note: Optional, writes prediction into preallocated y
+    void       (*predict_into)    (LeModel *model, LeTensor *y, const LeTensor *x);
     LeList *   (*get_gradients)   (LeModel *model, const LeTensor *x, const LeTensor *y);
+    /// @note: Optional, same as get_gradients and stores loss of x computed on the way
+    LeList *   (*get_gradients_with_loss)
+                                  (LeModel *model, const LeTensor *x, const LeTensor *y, float *loss);
     float      (*train_iteration) (LeModel *model);
 } LeModelClass;
 
@@ -40,10 +45,22 @@ void                    le_model_append_parameter          (LeModel *
 LeTensor *              le_model_predict                   (LeModel *               model,
                                                             const LeTensor *        x);
 
+/// @note: Prediction must have shape of le_model_predict result. Models which do not
+/// implement predict_into fall back to predict and copy.
+void                    le_model_predict_into              (LeModel *               model,
+                                                            LeTensor *              prediction,
+                                                            const LeTensor *        x);
+
 LeList *                le_model_get_gradients             (LeModel *               model,
                                                             const LeTensor *        x,
                                                             const LeTensor *        y);
 
+/// @note: Gradients and loss of x, which is NAN if model does not compute it with gradients
+LeList *                le_model_get_gradients_with_loss   (LeModel *               model,
+                                                            const LeTensor *        x,
+                                                            const LeTensor *        y,
+                                                            float *                 loss);
+
 float                   le_model_train_iteration           (LeModel *               model);
 
 LeList *                le_model_get_parameters            (LeModel *               model);
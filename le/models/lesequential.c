@@ -18,6 +18,11 @@ struct LeSequential
     LeModel parent;
     LeList *layers;
     LeLoss loss;
+
+    /// @note: Outputs of all layers but last one, reused by predict_into
+    /// while input shape stays the same
+    LeList *buffers;
+    LeShape *buffers_input_shape;
 };
 
 typedef struct LeSequentialClass
@@ -28,9 +33,15 @@ typedef struct LeSequentialClass
 LeTensor *
 le_sequential_predict(LeSequential *self, const LeTensor *x);
 
+void
+le_sequential_predict_into(LeSequential *self, LeTensor *prediction, const LeTensor *x);
+
 LeList *
 le_sequential_get_gradients(LeSequential *self, const LeTensor *x, const LeTensor *y);
 
+LeList *
+le_sequential_get_gradients_with_loss(LeSequential *self, const LeTensor *x, const LeTensor *y, float *loss);
+
 LeSequentialClass *
 le_sequential_class_ensure_init()
 {
@@ -41,8 +52,12 @@ le_sequential_class_ensure_init()
     {
         klass.parent.predict =
             (LeTensor *(*)(LeModel *, const LeTensor *))le_sequential_predict;
+        klass.parent.predict_into =
+            (void (*)(LeModel *, LeTensor *, const LeTensor *))le_sequential_predict_into;
         klass.parent.get_gradients =
             (LeList *(*)(LeModel *, const LeTensor *, const LeTensor *))le_sequential_get_gradients;
+        klass.parent.get_gradients_with_loss =
+            (LeList *(*)(LeModel *, const LeTensor *, const LeTensor *, float *))le_sequential_get_gradients_with_loss;
         initialized = 1;
     }
 
@@ -57,6 +72,17 @@ le_sequential_construct(LeSequential *self)
     
     self->layers = NULL;
     self->loss = LE_LOSS_MSE;
+    self->buffers = NULL;
+    self->buffers_input_shape = NULL;
+}
+
+static void
+le_sequential_free_buffers(LeSequential *self)
+{
+    le_list_free(self->buffers, LE_FUNCTION(le_tensor_free));
+    self->buffers = NULL;
+    le_shape_free(self->buffers_input_shape);
+    self->buffers_input_shape = NULL;
 }
 
 LeSequential *
@@ -72,6 +98,7 @@ le_sequential_add(LeSequential *self, LeLayer *layer)
 {
     LE_INFO("Adding New Layer: %s", layer->name);
 
+    le_sequential_free_buffers(self);
     self->layers = le_list_append(self->layers, layer);
     LeList *parameters = le_layer_get_parameters(layer);
     
@@ -82,17 +109,90 @@ le_sequential_add(LeSequential *self, LeLayer *layer)
     }
 }
 
+void
+le_sequential_convert_parameters(LeSequential *self, LeType type)
+{
+    assert(self);
+
+    for (LeList *current = le_model_get_parameters(LE_MODEL(self)); current != NULL; current = current->next)
+    {
+        le_tensor_convert(LE_TENSOR(current->data), type);
+    }
+}
+
+void
+le_sequential_quantize(LeSequential *self, const LeTensor *calibration_x)
+{
+    assert(self);
+
+    le_sequential_free_buffers(self);
+
+    /// @note: Layers are calibrated with outputs of preceding layers before they are quantized
+    LeTensor *signal = calibration_x ? le_tensor_new_copy(calibration_x) : NULL;
+    LeList *current = self->layers;
+    while (current)
+    {
+        LeLayer *current_layer = LE_LAYER(current->data);
+        LeList *next = current->next;
+        LeTensor *output = signal ? le_layer_forward_prop(current_layer, signal) : NULL;
+        bool relu = next && le_layer_is_activation(LE_LAYER(next->data), LE_ACTIVATION_RELU);
+        if (le_layer_quantize(current_layer, signal, relu) && relu)
+        {
+            LE_INFO("Merging %s into %s", LE_LAYER(next->data)->name, current_layer->name);
+            if (output)
+                le_tensor_apply_relu(output);
+            current->next = next->next;
+            if (next->next)
+                next->next->prev = current;
+            le_activation_layer_free(LE_ACTIVATION_LAYER(next->data));
+            free(next);
+            next = current->next;
+        }
+        le_tensor_free(signal);
+        signal = output;
+        current = next;
+    }
+    le_tensor_free(signal);
+}
+
 void
 le_sequential_set_loss(LeSequential *self, LeLoss loss)
 {
     self->loss = loss;
 }
 
+/// @note: Whether layer following current one is element-wise activation layer, which current
+/// layer applies to its output itself. Used during inference only, since training needs outputs
+/// of both layers.
+static bool
+le_sequential_get_fused_activation(LeList *current, LeActivation *activation)
+{
+    static const LeActivation element_wise[] = {
+        LE_ACTIVATION_LINEAR, LE_ACTIVATION_SIGMOID, LE_ACTIVATION_TANH, LE_ACTIVATION_RELU
+    };
+
+    if (current->next == NULL)
+        return false;
+
+    LeLayer *layer = LE_LAYER(current->data);
+    LeLayer *next_layer = LE_LAYER(current->next->data);
+    for (unsigned i = 0; i < sizeof(element_wise) / sizeof(element_wise[0]); i++)
+    {
+        if (le_layer_is_activation(next_layer, element_wise[i]) && le_layer_fuses_activation(layer, element_wise[i]))
+        {
+            *activation = element_wise[i];
+            return true;
+        }
+    }
+    return false;
+}
+
 /** @note: Used in both _predict and _get_gradients method, 
  * @param inputs if not null is used to cache input of each layer.
+ * @param stop if not null is layer where propagation stops, its input is cached and returned.
  */
 static LeTensor *
-forward_propagation(LeSequential *self, const LeTensor *x, LeList **inputs)
+forward_propagation(LeSequential *self, const LeTensor *x, LeList **inputs, const LeList *stop)
 {
     assert(self);
     assert(x);
@@ -109,9 +209,23 @@ forward_propagation(LeSequential *self, const LeTensor *x, LeList **inputs)
         {
             *inputs = le_list_append(*inputs, le_tensor_new_copy(signal));
         }
+        if (current == stop)
+        {
+            break;
+        }
         // LE_INFO("signal =\n%s", le_tensor_to_cstr(signal));
         // LE_INFO("Layer %s Forward", current_layer->name);
-        LeTensor *output = le_layer_forward_prop(current_layer, signal);
+        LeActivation activation;
+        LeTensor *output;
+        if ((inputs == NULL) && le_sequential_get_fused_activation(current, &activation))
+        {
+            output = le_layer_forward_prop_activation(current_layer, signal, activation);
+            current = current->next;
+        }
+        else
+        {
+            output = le_layer_forward_prop(current_layer, signal);
+        }
         le_tensor_free(signal);
         signal = output;
     }
@@ -122,14 +236,75 @@ forward_propagation(LeSequential *self, const LeTensor *x, LeList **inputs)
 LeTensor *
 le_sequential_predict(LeSequential *self, const LeTensor *x)
 {
-    return forward_propagation(self, x, NULL);
+    return forward_propagation(self, x, NULL, NULL);
+}
+
+void
+le_sequential_predict_into(LeSequential *self, LeTensor *prediction, const LeTensor *x)
+{
+    assert(self);
+    assert(x);
+    assert(prediction);
+
+    if (self->layers == NULL)
+    {
+        le_tensor_assign(prediction, x);
+        return;
+    }
+
+    bool reuse_buffers = self->buffers_input_shape && le_shape_equal(self->buffers_input_shape, x->shape);
+    if (!reuse_buffers)
+    {
+        le_sequential_free_buffers(self);
+        self->buffers_input_shape = le_shape_copy(x->shape);
+    }
+
+    /// @note: On first call with given input shape, buffers are outputs of forward_prop
+    LeTensor *signal = (LeTensor *)x;
+    LeList *buffers_iterator = self->buffers;
+    for (LeList *current = self->layers;
+         current != NULL;
+         current = current->next)
+    {
+        LeLayer *current_layer = LE_LAYER(current->data);
+        /// @note: Activation layer fused into current layer is skipped, with no buffer of its own
+        LeActivation activation;
+        bool fused = le_sequential_get_fused_activation(current, &activation);
+        if (fused)
+            current = current->next;
+
+        if (current->next == NULL)
+        {
+            if (fused)
+                le_layer_forward_prop_activation_into(current_layer, prediction, signal, activation);
+            else
+                le_layer_forward_prop_into(current_layer, prediction, signal);
+        }
+        else if (reuse_buffers)
+        {
+            LeTensor *output = LE_TENSOR(buffers_iterator->data);
+            if (fused)
+                le_layer_forward_prop_activation_into(current_layer, output, signal, activation);
+            else
+                le_layer_forward_prop_into(current_layer, output, signal);
+            buffers_iterator = buffers_iterator->next;
+            signal = output;
+        }
+        else
+        {
+            LeTensor *output = fused ? le_layer_forward_prop_activation(current_layer, signal, activation) :
+                le_layer_forward_prop(current_layer, signal);
+            self->buffers = le_list_append(self->buffers, output);
+            signal = output;
+        }
+    }
 }
 
 float 
 le_sequential_compute_cost(LeSequential *self, const LeTensor *x, const LeTensor *y)
 {
     /// @todo: Take regularization term into account;
-    LeTensor *h = forward_propagation(self, x, NULL);
+    LeTensor *h = forward_propagation(self, x, NULL, NULL);
     const float j = le_loss(self->loss, h, y);
     le_tensor_free(h);
     return j;
@@ -137,21 +312,11 @@ le_sequential_compute_cost(LeSequential *self, const LeTensor *x, const LeTensor
 
 typedef void(* LeActivationAndLossBackward)(LeTensor *signal, const LeTensor *labels);
 
-static void
-softmax_xent_backward(LeTensor *signal, const LeTensor *labels)
-{
-    le_tensor_mul(signal, labels);
-    le_tensor_sub(signal, labels);
-}
-
 static LeActivationAndLossBackward
-activation_loss_backward_fn(LeActivation activation, LeLoss loss)
+activation_loss_backward_fn(LeLayer *layer, LeLoss loss)
 {
-    if ((activation == LE_ACTIVATION_SOFTMAX) && (loss == LE_LOSS_CROSS_ENTROPY)) {
-        return softmax_xent_backward;
-    }
-    else if (((activation == LE_ACTIVATION_SIGMOID) && (loss == LE_LOSS_LOGISTIC)) ||
-             ((activation == LE_ACTIVATION_LINEAR) && (loss == LE_LOSS_MSE)))
+    if ((le_layer_is_activation(layer, LE_ACTIVATION_SIGMOID) && (loss == LE_LOSS_LOGISTIC)) ||
+        (le_layer_is_activation(layer, LE_ACTIVATION_LINEAR) && (loss == LE_LOSS_MSE)))
     {
         return le_tensor_sub_tensor;
     }
@@ -161,44 +326,70 @@ activation_loss_backward_fn(LeActivation activation, LeLoss loss)
 
 LeList *
 le_sequential_get_gradients(LeSequential *self, const LeTensor *x, const LeTensor *y)
+{
+    return le_sequential_get_gradients_with_loss(self, x, y, NULL);
+}
+
+LeList *
+le_sequential_get_gradients_with_loss(LeSequential *self, const LeTensor *x, const LeTensor *y, float *loss)
 {
     assert(self);
     assert(x);
     assert(y);
-        
+
+    LeList *last_layer_iterator = le_list_last(self->layers);
+    LeLayer *last_layer = last_layer_iterator ? LE_LAYER(last_layer_iterator->data) : NULL;
+    /// @note: Softmax followed by cross-entropy is differentiated as one function of logits,
+    /// so forward propagation stops before softmax
+    bool softmax_cross_entropy = last_layer && (self->loss == LE_LOSS_CROSS_ENTROPY) &&
+        le_layer_is_activation(last_layer, LE_ACTIVATION_SOFTMAX);
+
     /// @note: We cache input of each layer in list of tensors
     /// to ease computation of gradients during backpropagation
     LeList *cached_inputs = NULL;
-    LeTensor *signal = forward_propagation(self, x, &cached_inputs);
+    LeTensor *signal = forward_propagation(self, x, &cached_inputs, softmax_cross_entropy ? last_layer_iterator : NULL);
     // LE_INFO("output =\n%s", le_tensor_to_cstr(signal));
     // LeTensorStats signal_stats = le_tensor_get_stats(signal);
     // LE_INFO("Output stats:\n\tmin: %f\n\tmax: %f\n\tmean: %f\n\tdeviation: %f", signal_stats.min, signal_stats.max, signal_stats.mean, signal_stats.deviation);
 
     LE_INFO("Back Propagation");
-    LeList *current_layer_iterator = le_list_last(self->layers);
+    LeList *current_layer_iterator = last_layer_iterator;
     LeList *cached_inputs_iterator = le_list_last(cached_inputs);
-    LeActivationLayer *last_layer = NULL;
     LeActivationAndLossBackward activation_loss_backward = NULL;
-    if (current_layer_iterator && current_layer_iterator->data)
+    if (softmax_cross_entropy)
     {
-        last_layer = LE_ACTIVATION_LAYER(current_layer_iterator->data);
-        activation_loss_backward = activation_loss_backward_fn(last_layer->activation, self->loss);
-    }
-    if (last_layer && activation_loss_backward)
-    {
-        activation_loss_backward(signal, y);
+        /// @note: Loss is by-product of its derivative
+        float j = le_apply_softmax_cross_entropy_loss_derivative(signal, y);
+        if (loss)
+        {
+            *loss = j;
+        }
         current_layer_iterator = current_layer_iterator->prev;
         cached_inputs_iterator = cached_inputs_iterator->prev;
     }
     else
     {
-        /// @note: Derivative of assumed cost function
-        le_apply_loss_derivative(self->loss, signal, y);
-        LE_INFO("signal =\n%s", le_tensor_to_cstr(signal));
-        // signal_stats = le_tensor_get_stats(signal);
-        // LE_INFO("Loss derivative stats:\n\tmin: %f\n\tmax: %f\n\tmean: %f\n\tdeviation: %f", signal_stats.min, signal_stats.max, signal_stats.mean, signal_stats.deviation);
+        /// @note: Output is at hand, so loss costs one pass over it instead of forward propagation
+        if (loss)
+        {
+            *loss = le_loss(self->loss, signal, y);
+        }
+        activation_loss_backward = last_layer ? activation_loss_backward_fn(last_layer, self->loss) : NULL;
+        if (activation_loss_backward)
+        {
+            activation_loss_backward(signal, y);
+            current_layer_iterator = current_layer_iterator->prev;
+            cached_inputs_iterator = cached_inputs_iterator->prev;
+        }
+        else
+        {
+            /// @note: Derivative of assumed cost function
+            le_apply_loss_derivative(self->loss, signal, y);
+            LE_INFO("signal =\n%s", le_tensor_to_cstr(signal));
+            // signal_stats = le_tensor_get_stats(signal);
+            // LE_INFO("Loss derivative stats:\n\tmin: %f\n\tmax: %f\n\tmean: %f\n\tdeviation: %f", signal_stats.min, signal_stats.max, signal_stats.mean, signal_stats.deviation);
+        }
     }
-
     // LeList *current = NULL;
     LeList *gradients = NULL;
     for (/* current = le_list_last(self->layers), inputs = le_list_last(inputs) */;
@@ -256,8 +447,8 @@ le_sequential_estimate_gradients(LeSequential *self, const LeTensor *x, const Le
     {
         LeTensor *param = LE_TENSOR(params_iterator->data);
         LeTensor *grad_estimate = le_tensor_new_zeros_like(param);
-        unsigned elements_count = le_shape_get_elements_count(param->shape);
-        for (unsigned i = 0; i < elements_count; i++)
+        size_t elements_count = le_shape_get_elements_count(param->shape);
+        for (size_t i = 0; i < elements_count; i++)
         {
             const float element = le_tensor_at_f32(param, i);
             le_tensor_set_f32(param, i, element + epsilon);
@@ -338,7 +529,7 @@ le_sequential_to_dot(LeSequential *self, const char *filename)
     {
         LeLayer *current_layer = LE_LAYER(current->data);
         assert(current_layer);
-        fprintf(fout, "%s [shape=record label=\"{%s|%s|%d Parameters}\"];\n",
+        fprintf(fout, "%s [shape=record label=\"{%s|%s|%zu Parameters}\"];\n",
             current_layer->name, current_layer->name,
             le_layer_get_description(current_layer),
             le_layer_get_parameters_count(current_layer));
@@ -367,5 +558,6 @@ le_sequential_to_dot(LeSequential *self, const char *filename)
 void
 le_sequential_free(LeSequential *self)
 {
+    le_sequential_free_buffers(self);
     free(self);
 }
@@ -28,6 +28,12 @@ void                    le_sequential_set_loss             (LeSequential *
 LeTensor *              le_sequential_predict              (LeSequential *          model,
                                                             const LeTensor *        x);
 
+/// @note: Outputs of intermediate layers are kept in model and reused while shape of x
+/// stays the same, so repeated calls do not allocate. They are allocated on first call.
+void                    le_sequential_predict_into         (LeSequential *          model,
+                                                            LeTensor *              prediction,
+                                                            const LeTensor *        x);
+
 float                   le_sequential_compute_cost         (LeSequential           *model,
                                                             const LeTensor         *x, 
                                                             const LeTensor         *y);
@@ -36,6 +42,14 @@ LeList *                le_sequential_get_gradients        (LeSequential
                                                             const LeTensor         *x, 
                                                             const LeTensor         *y);
 
+/// @note: Same as le_sequential_get_gradients, loss of x is stored to loss if it is not NULL.
+/// It is by-product of backpropagation, so separate le_sequential_compute_cost is not needed.
+LeList *                le_sequential_get_gradients_with_loss
+                                                           (LeSequential           *model,
+                                                            const LeTensor         *x,
+                                                            const LeTensor         *y,
+                                                            float                  *loss);
+
 LeList *                le_sequential_estimate_gradients   (LeSequential           *model,
                                                             const LeTensor         *x, 
                                                             const LeTensor         *y,
@@ -46,6 +60,18 @@ float                   le_sequential_check_gradients      (LeSequential
                                                             const LeTensor         *y,
                                                             float                   epsilon);
 
+/// @note: Converts all parameters, e.g. to LE_TYPE_FLOAT16 to halve memory and bandwidth
+/// of inference with dense and activation layers. Training needs LE_TYPE_FLOAT32 parameters.
+void                    le_sequential_convert_parameters   (LeSequential *          model,
+                                                            LeType                  type);
+
+/// @note: Quantizes weights of dense layers to 8-bit integers for inference. ReLU activation
+/// layers following dense layers are merged into them and removed from model. If calibration_x
+/// is not NULL, inputs of quantized layers for it fix quantization of their inputs,
+/// otherwise inputs are quantized with range of each batch.
+void                    le_sequential_quantize             (LeSequential *          model,
+                                                            const LeTensor *        calibration_x);
+
 void                    le_sequential_to_dot               (LeSequential *          model,
                                                             const char *            filename);
 
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include "lemodel.h"
 #include <le/tensors/lematrix.h>
+#include <le/tensors/letensor-imp.h>
 
 struct LeSVM
 {
@@ -100,27 +101,27 @@ le_svm_margins(LeSVM *self, const LeTensor *x)
         
         unsigned test_examples_count = le_matrix_get_width(x);
         LeTensor *margins = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, 1, test_examples_count);
+        /// @note: Columns are borrowed through views on stack, without allocations per pair
+        LeTensorView example_view, x_train_j_view;
         for (unsigned i = 0; i < test_examples_count; i++)
         {
-            LeTensor *example = le_matrix_get_column(x, i);
+            LeTensor *example = le_matrix_view_init_column(&example_view, x, i);
             
             unsigned j;
             float margin = 0;
             unsigned training_examples_count = le_matrix_get_width(self->x);
             for (j = 0; j < training_examples_count; j++)
             {
-                LeTensor *x_train_j = le_matrix_get_column(self->x, j);
                 float alphaj = le_matrix_at_f32(self->alphas, 0, j);
                 if (alphaj > 1e-4f || alphaj < -1e-4f)
                 {
+                    LeTensor *x_train_j = le_matrix_view_init_column(&x_train_j_view, self->x, j);
                     margin += alphaj * le_matrix_at_f32(self->y, 0, j) * kernel_function(x_train_j, example, self->kernel);
                 }
-                le_tensor_free(x_train_j);
             }
             margin += self->bias;
             
             le_matrix_set(margins, 0, i, margin);
-            le_tensor_free(example);
         }
         return margins;
     }
@@ -158,10 +159,10 @@ le_svm_train(LeSVM *self, const LeTensor *x_train, const LeTensor *y_train, LeSV
     {
         unsigned num_changed_alphas = 0;
         
+        LeTensorView x_train_i_view, x_train_j_view;
         for (int i = 0; i < examples_count; i++)
         {
-            /// @todo: Implement immutable matrix columns
-            LeTensor *x_train_i = le_matrix_get_column(x_train, i);
+            LeTensor *x_train_i = le_matrix_view_init_column(&x_train_i_view, x_train, i);
             /// @note: We will have 1x1 matrix here
             LeTensor *shallow_margin_matrix = le_svm_margins(self, x_train_i);
             float margin = le_matrix_at_f32(shallow_margin_matrix, 0, 0);
@@ -173,8 +174,7 @@ le_svm_train(LeSVM *self, const LeTensor *x_train, const LeTensor *y_train, LeSV
                 int j = i;
                 while (j == i)
                     j = rand() % examples_count;
-                /// @todo: Implement immutable matrix columns
-                LeTensor *x_train_j = le_matrix_get_column(x_train, j);
+                LeTensor *x_train_j = le_matrix_view_init_column(&x_train_j_view, x_train, j);
                 /// @note: We will have 1x1 matrix here
                 LeTensor *shallow_margin_matrix = le_svm_margins(self, x_train_j);
                 float margin = le_matrix_at_f32(shallow_margin_matrix, 0, 0);
@@ -227,9 +227,7 @@ le_svm_train(LeSVM *self, const LeTensor *x_train, const LeTensor *y_train, LeSV
                         }
                     }
                 }
-                le_tensor_free(x_train_j);
             }
-            le_tensor_free(x_train_i);
         }
 
         if (num_changed_alphas == 0)
@@ -10,6 +10,7 @@
 #include <le/tensors/letensor.h>
 #include <le/tensors/letensor-imp.h>
 #include <le/lelog.h>
+#include <le/lemem.h>
 
 struct LeBGD
 {
@@ -43,9 +44,14 @@ le_bgd_step(LeOptimizer *optimizer)
     LeList *gradients = NULL;
     bool own_gradients = false;
 
+    le_optimizer_unshare(optimizer->parameters);
+
+    /// @note: Scratch temporaries of backpropagation are released at once at the end of step
+    le_arena_push();
+
     if (optimizer->model)
     {
-        gradients = le_model_get_gradients(optimizer->model, self->input, self->output);
+        gradients = le_model_get_gradients_with_loss(optimizer->model, self->input, self->output, &optimizer->loss);
         own_gradients = true;
     }
     else if (optimizer->gradients)
@@ -82,6 +88,8 @@ le_bgd_step(LeOptimizer *optimizer)
         le_list_free(gradients, LE_FUNCTION(le_tensor_free));
     }
 
+    le_arena_pop();
+
     LE_OPTIMIZER(self)->step++;
     LE_OPTIMIZER(self)->epoch++;
 }
@@ -4,6 +4,8 @@
 #include "leoptimizer.h"
 #include <stdlib.h>
 #include <assert.h>
+#include <math.h>
+#include <le/tensors/letensor-imp.h>
 
 static LeOptimizerClass klass;
 
@@ -14,6 +16,7 @@ le_optimizer_construct(LeOptimizer *self)
     self->model = NULL;
     self->parameters = NULL;
     self->gradients = NULL;
+    self->loss = NAN;
 }
 
 void
@@ -41,3 +44,10 @@ le_optimizer_free(LeOptimizer *self)
 {
     free(self);
 }
+
+void
+le_optimizer_unshare(LeList *tensors)
+{
+    for (LeList *iterator = tensors; iterator; iterator = iterator->next)
+        le_tensor_make_writable(LE_TENSOR(iterator->data));
+}
@@ -22,6 +22,8 @@ typedef struct LeOptimizer
     float                    learning_rate;
     unsigned                 step;
     unsigned                 epoch;
+    /// @note: Loss of batch of last step before update of parameters, NAN if model does not report it
+    float                    loss;
 } LeOptimizer;
 
 #define LE_OPTIMIZER(obj) ((LeOptimizer *)(obj))
@@ -44,6 +46,10 @@ void               le_optimizer_epoch                      (LeOptimizer *
 
 void               le_optimizer_free                       (LeOptimizer *           optimizer);
 
+/// @note: Gives every tensor of list its own elements, see le_tensor_make_writable. Called
+/// before scratch scope of step, so that parameters are never copied inside scope.
+void               le_optimizer_unshare                    (LeList *                tensors);
+
 LE_END_DECLS
 
 #endif
@@ -9,6 +9,8 @@
 #include <le/tensors/letensor-imp.h>
 #include <le/lelog.h>
 #include <le/tensors/lematrix.h>
+#include <le/tensors/leexpr.h>
+#include <le/lemem.h>
 
 #define DEFAULT_LOG_CATEGORY "sgd"
 
@@ -32,15 +34,16 @@ typedef struct LeSGDClass
 
 static LeSGDClass klass;
 
+/// @note: Momenta have shapes of parameters
 LeList *
-le_sgd_init_momenta(LeList *gradients)
+le_sgd_init_momenta(LeList *parameters)
 {
     LeList *momentum_list = NULL;
-    for (LeList *gradients_iterator = gradients; 
-         gradients_iterator;
-         gradients_iterator = gradients_iterator->next)
+    for (LeList *parameters_iterator = parameters; 
+         parameters_iterator;
+         parameters_iterator = parameters_iterator->next)
     {
-        LeTensor *momentum = le_tensor_new_zeros_like(LE_TENSOR(gradients_iterator->data));
+        LeTensor *momentum = le_tensor_new_zeros_like(LE_TENSOR(parameters_iterator->data));
         momentum_list = le_list_append(momentum_list, momentum);
     }
     return momentum_list;
@@ -60,10 +63,21 @@ le_sgd_step(LeOptimizer *optimizer)
 
     size_t batch_size = self->example_index + self->batch_size < num_examples ? self->batch_size : num_examples - self->example_index;
 
-    LeTensor *input = le_matrix_get_columns_copy(self->input, self->example_index, batch_size);
-    LeTensor *output = le_matrix_get_columns_copy(self->output, self->example_index, batch_size);
+    if (self->momenta == NULL)
+    {
+        self->momenta = le_sgd_init_momenta(optimizer->parameters);
+    }
+    le_optimizer_unshare(optimizer->parameters);
+    le_optimizer_unshare(self->momenta);
+
+    /// @note: Scratch temporaries of backpropagation are released at once at the end of step
+    le_arena_push();
+
+    /// @note: Batch is a view of columns of training set, it is not copied
+    LeTensor *input = le_tensor_slice(self->input, 1, self->example_index, batch_size);
+    LeTensor *output = le_tensor_slice(self->output, 1, self->example_index, batch_size);
 
-    optimizer->gradients = le_model_get_gradients(optimizer->model, input, output);
+    optimizer->gradients = le_model_get_gradients_with_loss(optimizer->model, input, output, &optimizer->loss);
 
     // LE_INFO("Input %s:\n%s", le_shape_to_cstr(input->shape), le_tensor_to_cstr(input));
     // LeTensorStats input_stats = le_tensor_get_stats(input);
@@ -77,11 +91,6 @@ le_sgd_step(LeOptimizer *optimizer)
     //     output_stats.min, output_stats.max, output_stats.mean, output_stats.deviation,
     //     output_stats.nans, output_stats.zeros);
         
-    if (self->momenta == NULL)
-    {
-        self->momenta = le_sgd_init_momenta(optimizer->gradients);
-    }
-
     le_tensor_free(output);
     le_tensor_free(input);
 
@@ -108,10 +117,18 @@ le_sgd_step(LeOptimizer *optimizer)
         //     gradient_stats.min, gradient_stats.max, gradient_stats.mean, gradient_stats.deviation,
         //     gradient_stats.nans, gradient_stats.zeros);
         LeTensor *momentum = LE_TENSOR(momentum_iterator->data);
-        le_tensor_mul(momentum, self->momentum_rate);
-        le_tensor_mul(gradient, 1.0f - self->momentum_rate);
-        le_tensor_add(momentum, gradient);
-        le_tensor_sub_scaled(parameter, optimizer->learning_rate, momentum);
+        /// @note: Momentum and parameter are updated in one pass over memory:
+        /// momentum = momentum * rate + gradient * (1 - rate)
+        /// parameter = parameter - learning_rate * momentum
+        LeExpr *update = le_expr_new(momentum);
+        le_expr_mul_scalar(update, self->momentum_rate);
+        le_expr_add_scaled(update, 1.0f - self->momentum_rate, gradient);
+        le_expr_store(update, momentum);
+        le_expr_mul_scalar(update, -optimizer->learning_rate);
+        le_expr_add_tensor(update, parameter);
+        le_expr_store(update, parameter);
+        le_expr_evaluate(update);
+        le_expr_free(update);
     }
 
     if (parameters_iterator)
@@ -131,6 +148,8 @@ le_sgd_step(LeOptimizer *optimizer)
     
     le_list_free(optimizer->gradients, LE_FUNCTION(le_tensor_free));
     optimizer->gradients = NULL;
+
+    le_arena_pop();
     
     optimizer->step++;
     self->example_index += batch_size;
@@ -0,0 +1,24 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Activation functions shared by layers and fused matrix products */
+
+#ifndef __LEACTIVATION_H__
+#define __LEACTIVATION_H__
+
+#include <le/lemacros.h>
+
+LE_BEGIN_DECLS
+
+typedef enum LeActivation
+{
+    LE_ACTIVATION_LINEAR,
+    LE_ACTIVATION_SIGMOID,
+    LE_ACTIVATION_TANH,
+    LE_ACTIVATION_RELU,
+    LE_ACTIVATION_SOFTMAX
+} LeActivation;
+
+LE_END_DECLS
+
+#endif
@@ -0,0 +1,283 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "leexpr.h"
+#include "letensor-imp.h"
+#include "lekernels.h"
+#include <le/leparallel.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/// @note: Number of elements evaluated at once. Block of value together with blocks
+/// of operands fits into L1 data cache.
+#define LE_EXPR_BLOCK_SIZE 1024
+
+/// @note: Expressions are split between threads in parts of at least this many elements
+#define LE_EXPR_PARALLEL_GRAIN 32768
+
+typedef enum LeExprOpType
+{
+    LE_EXPR_OP_ADD_SCALAR,
+    LE_EXPR_OP_MUL_SCALAR,
+    LE_EXPR_OP_ADD_TENSOR,
+    LE_EXPR_OP_SUB_TENSOR,
+    LE_EXPR_OP_MUL_TENSOR,
+    LE_EXPR_OP_ADD_SCALED,
+    LE_EXPR_OP_APPLY,
+    LE_EXPR_OP_APPLY_GT,
+    LE_EXPR_OP_STORE
+} LeExprOpType;
+
+/// @note: Elements of tensors are resolved when expression is evaluated, since destinations
+/// made writable then may get own copy of elements shared with their operands
+typedef struct LeExprOp
+{
+    LeExprOpType    type;
+    float           scalar;
+    LeExprFunction  function;
+    const LeTensor *tensor;
+    LeTensor *      destination;
+    float *         data;
+} LeExprOp;
+
+struct LeExpr
+{
+    const LeKernels *kernels;
+    const LeTensor  *source_tensor;
+    const float     *source;
+    size_t           elements_count;
+    unsigned         num_ops;
+    unsigned         capacity;
+    LeExprOp        *ops;
+};
+
+static size_t
+le_expr_check_tensor(const LeTensor *tensor)
+{
+    assert(tensor);
+    assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
+    assert(tensor->element_type == LE_TYPE_FLOAT32);
+    assert(le_tensor_contiguous(tensor));
+
+    return le_shape_get_elements_count(tensor->shape);
+}
+
+static LeExprOp *
+le_expr_push(LeExpr *self, LeExprOpType type, const LeTensor *tensor)
+{
+    assert(self);
+
+    if (self->num_ops == self->capacity)
+    {
+        self->capacity = self->capacity ? self->capacity * 2 : 8;
+        self->ops = realloc(self->ops, self->capacity * sizeof(LeExprOp));
+    }
+
+    LeExprOp *op = &self->ops[self->num_ops++];
+    op->type = type;
+    op->scalar = 0.0f;
+    op->function = LE_EXPR_FUNCTION_SIGMOID;
+    op->tensor = tensor;
+    op->destination = NULL;
+    op->data = NULL;
+
+    if (tensor)
+    {
+        size_t elements_count = le_expr_check_tensor(tensor);
+        assert(elements_count == self->elements_count);
+        (void)elements_count;
+    }
+
+    return op;
+}
+
+LeExpr *
+le_expr_new(const LeTensor *source)
+{
+    LeExpr *self = malloc(sizeof(LeExpr));
+    self->kernels = NULL;
+    self->elements_count = le_expr_check_tensor(source);
+    self->source_tensor = source;
+    self->source = NULL;
+    self->num_ops = 0;
+    self->capacity = 0;
+    self->ops = NULL;
+    return self;
+}
+
+void
+le_expr_add_scalar(LeExpr *self, float scalar)
+{
+    le_expr_push(self, LE_EXPR_OP_ADD_SCALAR, NULL)->scalar = scalar;
+}
+
+void
+le_expr_mul_scalar(LeExpr *self, float scalar)
+{
+    le_expr_push(self, LE_EXPR_OP_MUL_SCALAR, NULL)->scalar = scalar;
+}
+
+void
+le_expr_add_tensor(LeExpr *self, const LeTensor *tensor)
+{
+    le_expr_push(self, LE_EXPR_OP_ADD_TENSOR, tensor);
+}
+
+void
+le_expr_sub_tensor(LeExpr *self, const LeTensor *tensor)
+{
+    le_expr_push(self, LE_EXPR_OP_SUB_TENSOR, tensor);
+}
+
+void
+le_expr_mul_tensor(LeExpr *self, const LeTensor *tensor)
+{
+    le_expr_push(self, LE_EXPR_OP_MUL_TENSOR, tensor);
+}
+
+void
+le_expr_add_scaled(LeExpr *self, float scale, const LeTensor *tensor)
+{
+    le_expr_push(self, LE_EXPR_OP_ADD_SCALED, tensor)->scalar = scale;
+}
+
+void
+le_expr_apply(LeExpr *self, LeExprFunction function)
+{
+    le_expr_push(self, LE_EXPR_OP_APPLY, NULL)->function = function;
+}
+
+void
+le_expr_apply_gt(LeExpr *self, float scalar)
+{
+    le_expr_push(self, LE_EXPR_OP_APPLY_GT, NULL)->scalar = scalar;
+}
+
+void
+le_expr_store(LeExpr *self, LeTensor *destination)
+{
+    assert(destination);
+    le_expr_push(self, LE_EXPR_OP_STORE, destination)->destination = destination;
+}
+
+static void
+le_expr_apply_function(const LeKernels *kernels, LeExprFunction function, float *value, size_t n)
+{
+    switch (function)
+    {
+    case LE_EXPR_FUNCTION_SIGMOID:
+        kernels->sigmoid_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_SIGMOID_PRIME:
+        kernels->sigmoid_prime_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_TANH:
+        kernels->tanh_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_RELU:
+        kernels->relu_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_SQR:
+        kernels->sqr_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_1_MINUS:
+        kernels->one_minus_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_X_MINUS_SQR_X:
+        kernels->x_minus_sqr_x_f32(value, n);
+        break;
+    case LE_EXPR_FUNCTION_SGN:
+        kernels->sgn_f32(value, n);
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
+static void
+le_expr_evaluate_range(void *data, size_t begin, size_t end)
+{
+    const LeExpr *self = data;
+    const LeKernels *kernels = self->kernels;
+    float value[LE_EXPR_BLOCK_SIZE];
+
+    for (size_t offset = begin; offset < end; offset += LE_EXPR_BLOCK_SIZE)
+    {
+        size_t n = end - offset;
+        if (n > LE_EXPR_BLOCK_SIZE)
+            n = LE_EXPR_BLOCK_SIZE;
+
+        memcpy(value, self->source + offset, n * sizeof(float));
+
+        for (unsigned i = 0; i < self->num_ops; i++)
+        {
+            const LeExprOp *op = &self->ops[i];
+            switch (op->type)
+            {
+            case LE_EXPR_OP_ADD_SCALAR:
+                kernels->add_scalar_f32(value, op->scalar, n);
+                break;
+            case LE_EXPR_OP_MUL_SCALAR:
+                kernels->mul_scalar_f32(value, op->scalar, n);
+                break;
+            case LE_EXPR_OP_ADD_TENSOR:
+                kernels->add_f32(value, op->data + offset, n);
+                break;
+            case LE_EXPR_OP_SUB_TENSOR:
+                kernels->sub_f32(value, op->data + offset, n);
+                break;
+            case LE_EXPR_OP_MUL_TENSOR:
+                kernels->mul_f32(value, op->data + offset, n);
+                break;
+            case LE_EXPR_OP_ADD_SCALED:
+                kernels->sub_scaled_f32(value, -op->scalar, op->data + offset, n);
+                break;
+            case LE_EXPR_OP_APPLY:
+                le_expr_apply_function(kernels, op->function, value, n);
+                break;
+            case LE_EXPR_OP_APPLY_GT:
+                kernels->gt_f32(value, op->scalar, n);
+                break;
+            case LE_EXPR_OP_STORE:
+                memcpy(op->data + offset, value, n * sizeof(float));
+                break;
+            default:
+                assert(false);
+                break;
+            }
+        }
+    }
+}
+
+void
+le_expr_evaluate(LeExpr *self)
+{
+    assert(self);
+
+    self->kernels = le_kernels_get();
+    for (unsigned i = 0; i < self->num_ops; i++)
+    {
+        if (self->ops[i].destination)
+            le_tensor_make_writable(self->ops[i].destination);
+    }
+    self->source = self->source_tensor->data;
+    for (unsigned i = 0; i < self->num_ops; i++)
+    {
+        if (self->ops[i].tensor)
+            self->ops[i].data = self->ops[i].tensor->data;
+    }
+    le_parallel_for(self->elements_count, LE_EXPR_PARALLEL_GRAIN, le_expr_evaluate_range, self);
+}
+
+void
+le_expr_free(LeExpr *self)
+{
+    if (self == NULL)
+        return;
+
+    free(self->ops);
+    free(self);
+}
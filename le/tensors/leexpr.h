@@ -0,0 +1,89 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information.
+
+   Lazy element-wise expressions. Chain of operations is recorded first and then evaluated
+   in a single pass over memory, small block of elements at a time.
+
+   Example, momentum update:
+       LeExpr *expr = le_expr_new(momentum);
+       le_expr_mul_scalar(expr, rate);
+       le_expr_add_scaled(expr, 1.0f - rate, gradient);
+       le_expr_store(expr, momentum);
+       le_expr_mul_scalar(expr, -learning_rate);
+       le_expr_add_tensor(expr, parameter);
+       le_expr_store(expr, parameter);
+       le_expr_evaluate(expr);
+       le_expr_free(expr);
+
+ */
+
+#ifndef __LEEXPR_H__
+#define __LEEXPR_H__
+
+#include "letensor.h"
+
+LE_BEGIN_DECLS
+
+typedef struct LeExpr LeExpr;
+
+/// @note: Element-wise functions matching le_tensor_apply_* family
+typedef enum LeExprFunction
+{
+    LE_EXPR_FUNCTION_SIGMOID,
+    LE_EXPR_FUNCTION_SIGMOID_PRIME,
+    LE_EXPR_FUNCTION_TANH,
+    LE_EXPR_FUNCTION_RELU,
+    LE_EXPR_FUNCTION_SQR,
+    LE_EXPR_FUNCTION_1_MINUS,
+    LE_EXPR_FUNCTION_X_MINUS_SQR_X,
+    LE_EXPR_FUNCTION_SGN
+} LeExprFunction;
+
+/// @note: Expression value starts as a copy of source.
+/// All tensors used in expression must be contiguous FLOAT32 tensors on CPU
+/// with same number of elements, and must stay alive until evaluation.
+LeExpr *           le_expr_new                             (const LeTensor *        source);
+
+void               le_expr_add_scalar                      (LeExpr *                expr,
+                                                            float                   scalar);
+
+void               le_expr_mul_scalar                      (LeExpr *                expr,
+                                                            float                   scalar);
+
+void               le_expr_add_tensor                      (LeExpr *                expr,
+                                                            const LeTensor *        tensor);
+
+void               le_expr_sub_tensor                      (LeExpr *                expr,
+                                                            const LeTensor *        tensor);
+
+/// @note: Hadamard product
+void               le_expr_mul_tensor                      (LeExpr *                expr,
+                                                            const LeTensor *        tensor);
+
+/// @note: value += scale * tensor
+void               le_expr_add_scaled                      (LeExpr *                expr,
+                                                            float                   scale,
+                                                            const LeTensor *        tensor);
+
+void               le_expr_apply                           (LeExpr *                expr,
+                                                            LeExprFunction          function);
+
+/// @note: value = value > scalar ? 1 : 0
+void               le_expr_apply_gt                        (LeExpr *                expr,
+                                                            float                   scalar);
+
+/// @note: Writes current value to destination. Evaluation continues after store,
+/// so one expression can update several tensors. Destination may be source itself
+/// or any tensor read by the expression.
+void               le_expr_store                           (LeExpr *                expr,
+                                                            LeTensor *              destination);
+
+/// @note: Runs recorded operations. Expression may be evaluated again. Elements of tensors
+/// are taken at evaluation, after destinations get own copies of shared or mapped elements.
+void               le_expr_evaluate                        (LeExpr *                expr);
+
+void               le_expr_free                            (LeExpr *                expr);
+
+LE_END_DECLS
+
+#endif
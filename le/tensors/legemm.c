@@ -0,0 +1,788 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "legemm.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <le/lecpu.h>
+#include <le/leparallel.h>
+#include <le/lemem.h>
+#include "lekernels.h"
+#ifdef LE_CPU_X86
+#   include <immintrin.h>
+#endif
+
+/// @note: Blocking parameters. KC × NR micro-panel of B is meant to stay in L1,
+/// MC × KC block of A in L2, and KC × NC block of B in L3.
+#define LE_GEMM_KC 256
+#define LE_GEMM_MC 144
+#define LE_GEMM_NC 4096
+
+#define LE_GEMM_MAX_MR 8
+/// @note: Products with fewer multiply-adds are computed on calling thread only
+#define LE_GEMM_PARALLEL_MIN_WORK (1 << 18)
+#define LE_GEMM_MAX_NR 32
+/// @note: Rows of C given to each thread by le_gemm_apply_epilogue hold at least this many elements
+#define LE_GEMM_EPILOGUE_GRAIN (1 << 14)
+
+/// @note: Computes full MR×NR tile of C from packed micro-panels of A and B
+typedef void (*LeGemmMicroKernel)(size_t       kc,
+                                  const float *a,
+                                  const float *b,
+                                  float       *c,
+                                  size_t       ldc,
+                                  float        alpha,
+                                  float        beta);
+
+typedef struct LeGemmKernel
+{
+    unsigned          mr;
+    unsigned          nr;
+    LeGemmMicroKernel micro_kernel;
+} LeGemmKernel;
+
+static void
+le_sgemm_kernel_4x8(size_t kc, const float *a, const float *b, float *c, size_t ldc, float alpha, float beta)
+{
+    float acc[4][8] = {{0.0f}};
+
+    for (size_t p = 0; p < kc; p++, a += 4, b += 8)
+    {
+        for (unsigned i = 0; i < 4; i++)
+        {
+            for (unsigned j = 0; j < 8; j++)
+            {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < 4; i++)
+    {
+        for (unsigned j = 0; j < 8; j++)
+        {
+            float *cij = c + i * ldc + j;
+            *cij = (beta == 0.0f) ? alpha * acc[i][j] : alpha * acc[i][j] + beta * *cij;
+        }
+    }
+}
+
+#ifdef LE_CPU_X86
+
+__attribute__((target("avx2,fma")))
+static void
+le_sgemm_kernel_6x16_avx2(size_t kc, const float *a, const float *b, float *c, size_t ldc, float alpha, float beta)
+{
+    __m256 acc[6][2];
+
+    for (unsigned i = 0; i < 6; i++)
+    {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+
+    for (size_t p = 0; p < kc; p++, a += 6, b += 16)
+    {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        for (unsigned i = 0; i < 6; i++)
+        {
+            __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+    }
+
+    __m256 alpha_v = _mm256_set1_ps(alpha);
+    __m256 beta_v = _mm256_set1_ps(beta);
+    for (unsigned i = 0; i < 6; i++)
+    {
+        for (unsigned h = 0; h < 2; h++)
+        {
+            float *cij = c + i * ldc + h * 8;
+            __m256 result = _mm256_mul_ps(alpha_v, acc[i][h]);
+            if (beta != 0.0f)
+                result = _mm256_fmadd_ps(beta_v, _mm256_loadu_ps(cij), result);
+            _mm256_storeu_ps(cij, result);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+le_sgemm_kernel_8x32_avx512(size_t kc, const float *a, const float *b, float *c, size_t ldc, float alpha, float beta)
+{
+    __m512 acc[8][2];
+
+    for (unsigned i = 0; i < 8; i++)
+    {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+
+    for (size_t p = 0; p < kc; p++, a += 8, b += 32)
+    {
+        __m512 b0 = _mm512_loadu_ps(b);
+        __m512 b1 = _mm512_loadu_ps(b + 16);
+        for (unsigned i = 0; i < 8; i++)
+        {
+            __m512 ai = _mm512_set1_ps(a[i]);
+            acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+        }
+    }
+
+    __m512 alpha_v = _mm512_set1_ps(alpha);
+    __m512 beta_v = _mm512_set1_ps(beta);
+    for (unsigned i = 0; i < 8; i++)
+    {
+        for (unsigned h = 0; h < 2; h++)
+        {
+            float *cij = c + i * ldc + h * 16;
+            __m512 result = _mm512_mul_ps(alpha_v, acc[i][h]);
+            if (beta != 0.0f)
+                result = _mm512_fmadd_ps(beta_v, _mm512_loadu_ps(cij), result);
+            _mm512_storeu_ps(cij, result);
+        }
+    }
+}
+
+#endif
+
+static const LeGemmKernel *
+le_gemm_get_kernel(void)
+{
+    static const LeGemmKernel scalar_kernel = { 4, 8, le_sgemm_kernel_4x8 };
+#ifdef LE_CPU_X86
+    static const LeGemmKernel avx2_kernel = { 6, 16, le_sgemm_kernel_6x16_avx2 };
+    static const LeGemmKernel avx512_kernel = { 8, 32, le_sgemm_kernel_8x32_avx512 };
+#endif
+    static const LeGemmKernel *kernel = NULL;
+
+    if (kernel == NULL)
+    {
+        const LeGemmKernel *selected = &scalar_kernel;
+#ifdef LE_CPU_X86
+        unsigned features = le_cpu_get_features();
+        if (features & LE_CPU_FEATURE_AVX512F)
+            selected = &avx512_kernel;
+        else if ((features & LE_CPU_FEATURE_AVX2) && (features & LE_CPU_FEATURE_FMA))
+            selected = &avx2_kernel;
+#endif
+        assert(selected->mr <= LE_GEMM_MAX_MR);
+        assert(selected->nr <= LE_GEMM_MAX_NR);
+        kernel = selected;
+    }
+
+    return kernel;
+}
+
+/// @note: Packs mc×kc block of A into micro-panels of mr rows, k-major within panel.
+/// Rows past mc are padded with zeros. Half precision A is converted while packed.
+static void
+le_gemm_pack_a(unsigned mc, unsigned kc, const void *a, bool a_half, size_t rs, size_t cs, unsigned mr, float *packed)
+{
+    float row[LE_GEMM_KC];
+
+    for (unsigned i = 0; i < mc; i += mr, packed += mr * kc)
+    {
+        unsigned rows = (mc - i < mr) ? mc - i : mr;
+        if (cs == 1)
+        {
+            for (unsigned r = 0; r < rows; r++)
+            {
+                const float *src = (const float *)a + (i + r) * rs;
+                if (a_half)
+                {
+                    le_kernels_get()->f16_to_f32(row, (const lehalf *)a + (i + r) * rs, kc);
+                    src = row;
+                }
+                for (unsigned p = 0; p < kc; p++)
+                {
+                    packed[p * mr + r] = src[p];
+                }
+            }
+        }
+        else if (a_half)
+        {
+            for (unsigned p = 0; p < kc; p++)
+            {
+                const lehalf *src = (const lehalf *)a + i * rs + p * cs;
+                for (unsigned r = 0; r < rows; r++)
+                {
+                    packed[p * mr + r] = le_f16_to_f32(src[r * rs]);
+                }
+            }
+        }
+        else
+        {
+            for (unsigned p = 0; p < kc; p++)
+            {
+                const float *src = (const float *)a + i * rs + p * cs;
+                for (unsigned r = 0; r < rows; r++)
+                {
+                    packed[p * mr + r] = src[r * rs];
+                }
+            }
+        }
+        for (unsigned p = 0; p < kc; p++)
+        {
+            for (unsigned r = rows; r < mr; r++)
+            {
+                packed[p * mr + r] = 0.0f;
+            }
+        }
+    }
+}
+
+/// @note: Packs kc×nc block of B into micro-panels of nr columns, k-major within panel.
+/// Columns past nc are padded with zeros.
+static void
+le_gemm_pack_b(unsigned kc, unsigned nc, const float *b, size_t rs, size_t cs, unsigned nr, float *packed)
+{
+    for (unsigned j = 0; j < nc; j += nr, packed += nr * kc)
+    {
+        unsigned cols = (nc - j < nr) ? nc - j : nr;
+        if (cs == 1)
+        {
+            for (unsigned p = 0; p < kc; p++)
+            {
+                memcpy(packed + p * nr, b + p * rs + j, cols * sizeof(float));
+            }
+        }
+        else
+        {
+            for (unsigned col = 0; col < cols; col++)
+            {
+                const float *src = b + (j + col) * cs;
+                for (unsigned p = 0; p < kc; p++)
+                {
+                    packed[p * nr + col] = src[p * rs];
+                }
+            }
+        }
+        if (cols < nr)
+        {
+            for (unsigned p = 0; p < kc; p++)
+            {
+                memset(packed + p * nr + cols, 0, (nr - cols) * sizeof(float));
+            }
+        }
+    }
+}
+
+/// @note: Applies epilogue to block of C starting at given row and column of whole C, c points to its first element
+static void
+le_gemm_epilogue_rows(const LeGemmEpilogue *epilogue, unsigned row, unsigned column, unsigned rows, unsigned cols,
+                      float *c, size_t ldc)
+{
+    const LeKernels *kernels = le_kernels_get();
+
+    for (unsigned i = 0; i < rows; i++)
+    {
+        float *c_row = c + i * ldc;
+        if (epilogue->row_bias)
+            kernels->add_scalar_f32(c_row, epilogue->row_bias[row + i], cols);
+        if (epilogue->column_bias)
+            kernels->add_f32(c_row, epilogue->column_bias + column, cols);
+        switch (epilogue->activation)
+        {
+        case LE_ACTIVATION_SIGMOID:
+            kernels->sigmoid_f32(c_row, cols);
+            break;
+        case LE_ACTIVATION_TANH:
+            kernels->tanh_f32(c_row, cols);
+            break;
+        case LE_ACTIVATION_RELU:
+            kernels->relu_f32(c_row, cols);
+            break;
+        case LE_ACTIVATION_LINEAR:
+        default:
+            break;
+        }
+    }
+}
+
+/// @note: row and column locate c in whole C, epilogue is applied to every tile once it is computed
+static void
+le_gemm_macro_kernel(const LeGemmKernel *kernel, unsigned mc, unsigned nc, unsigned kc, float alpha,
+                     const float *a_packed, const float *b_packed, float beta,
+                     const LeGemmEpilogue *epilogue, unsigned row, unsigned column, float *c, size_t ldc)
+{
+    const unsigned mr = kernel->mr;
+    const unsigned nr = kernel->nr;
+
+    for (unsigned jr = 0; jr < nc; jr += nr)
+    {
+        unsigned cols = (nc - jr < nr) ? nc - jr : nr;
+        for (unsigned ir = 0; ir < mc; ir += mr)
+        {
+            unsigned rows = (mc - ir < mr) ? mc - ir : mr;
+            float *c_tile = c + ir * ldc + jr;
+            if ((rows == mr) && (cols == nr))
+            {
+                kernel->micro_kernel(kc, a_packed + ir * kc, b_packed + jr * kc, c_tile, ldc, alpha, beta);
+            }
+            else
+            {
+                /// @note: Edge tile is computed into temporary buffer to avoid writing past C
+                float tile[LE_GEMM_MAX_MR * LE_GEMM_MAX_NR];
+                kernel->micro_kernel(kc, a_packed + ir * kc, b_packed + jr * kc, tile, nr, 1.0f, 0.0f);
+                for (unsigned i = 0; i < rows; i++)
+                {
+                    for (unsigned j = 0; j < cols; j++)
+                    {
+                        float *cij = c_tile + i * ldc + j;
+                        float value = alpha * tile[i * nr + j];
+                        *cij = (beta == 0.0f) ? value : value + beta * *cij;
+                    }
+                }
+            }
+            if (epilogue)
+                le_gemm_epilogue_rows(epilogue, row + ir, column + jr, rows, cols, c_tile, ldc);
+        }
+    }
+}
+
+static void
+le_gemm_scale(unsigned m, unsigned n, float beta, float *c, size_t ldc)
+{
+    for (unsigned i = 0; i < m; i++)
+    {
+        for (unsigned j = 0; j < n; j++)
+        {
+            c[i * ldc + j] = (beta == 0.0f) ? 0.0f : beta * c[i * ldc + j];
+        }
+    }
+}
+
+/// @note: Shared state of one kc×nc block of B, rows of A and C are split between threads
+typedef struct LeGemmTask
+{
+    const LeGemmKernel *kernel;
+    unsigned            m;
+    unsigned            nc;
+    unsigned            kc;
+    unsigned            mc_max;
+    unsigned            kc_max;
+    float               alpha;
+    float               beta;
+    /// @note: Set for last block along k dimension only
+    const LeGemmEpilogue *epilogue;
+    const void         *a;
+    bool                a_half;
+    size_t              a_rs;
+    size_t              a_cs;
+    const float        *b_packed;
+    /// @note: Points to column of C where block of B starts
+    float              *c;
+    unsigned            column;
+    size_t              ldc;
+} LeGemmTask;
+
+/// @note: Multiplies row panels [begin, end) of A, mr rows each, by packed block of B
+static void
+le_gemm_row_panels(void *data, size_t begin, size_t end)
+{
+    const LeGemmTask *task = data;
+    const unsigned mr = task->kernel->mr;
+    unsigned row_begin = begin * mr;
+    unsigned row_end = (end * mr < task->m) ? end * mr : task->m;
+    float *a_packed = le_arena_alloc((size_t)task->mc_max * task->kc_max * sizeof(float));
+
+    for (unsigned ic = row_begin; ic < row_end; ic += task->mc_max)
+    {
+        unsigned mc = (row_end - ic < task->mc_max) ? row_end - ic : task->mc_max;
+        size_t a_offset = ic * task->a_rs * (task->a_half ? sizeof(lehalf) : sizeof(float));
+        le_gemm_pack_a(mc, task->kc, (const uint8_t *)task->a + a_offset, task->a_half, task->a_rs, task->a_cs, mr, a_packed);
+        le_gemm_macro_kernel(task->kernel, mc, task->nc, task->kc, task->alpha, a_packed, task->b_packed,
+                             task->beta, task->epilogue, ic, task->column, task->c + ic * task->ldc, task->ldc);
+    }
+
+    le_free(a_packed);
+}
+
+static void
+le_gemm(bool transpose_a, bool transpose_b, unsigned m, unsigned n, unsigned k,
+        float alpha, const void *a, bool a_half, size_t lda, const float *b, size_t ldb,
+        float beta, const LeGemmEpilogue *epilogue, float *c, size_t ldc)
+{
+    assert((epilogue == NULL) || (epilogue->activation != LE_ACTIVATION_SOFTMAX));
+
+    if ((m == 0) || (n == 0))
+        return;
+
+    if ((k == 0) || (alpha == 0.0f))
+    {
+        le_gemm_scale(m, n, beta, c, ldc);
+        if (epilogue)
+            le_gemm_epilogue_rows(epilogue, 0, 0, m, n, c, ldc);
+        return;
+    }
+
+    /// @note: Transposition is expressed as swapped row and column strides
+    size_t a_rs = transpose_a ? 1 : lda;
+    size_t a_cs = transpose_a ? lda : 1;
+    size_t b_rs = transpose_b ? 1 : ldb;
+    size_t b_cs = transpose_b ? ldb : 1;
+
+    const LeGemmKernel *kernel = le_gemm_get_kernel();
+    const unsigned mr = kernel->mr;
+    const unsigned nr = kernel->nr;
+    const unsigned mc_max = (LE_GEMM_MC / mr) * mr;
+    const unsigned nc_max = (LE_GEMM_NC / nr) * nr;
+    const unsigned kc_max = (k < LE_GEMM_KC) ? k : LE_GEMM_KC;
+    unsigned b_cols = (n < nc_max) ? n : nc_max;
+    b_cols = (b_cols + nr - 1) / nr * nr;
+
+    float *b_packed = le_arena_alloc((size_t)b_cols * kc_max * sizeof(float));
+
+    LeGemmTask task = {
+        .kernel = kernel,
+        .m = m,
+        .mc_max = mc_max,
+        .kc_max = kc_max,
+        .alpha = alpha,
+        .a_half = a_half,
+        .a_rs = a_rs,
+        .a_cs = a_cs,
+        .b_packed = b_packed,
+        .ldc = ldc
+    };
+    size_t panels_count = (m + mr - 1) / mr;
+    bool parallel = (size_t)m * n * k >= LE_GEMM_PARALLEL_MIN_WORK;
+
+    for (unsigned jc = 0; jc < n; jc += nc_max)
+    {
+        unsigned nc = (n - jc < nc_max) ? n - jc : nc_max;
+        for (unsigned pc = 0; pc < k; pc += kc_max)
+        {
+            unsigned kc = (k - pc < kc_max) ? k - pc : kc_max;
+            le_gemm_pack_b(kc, nc, b + pc * b_rs + jc * b_cs, b_rs, b_cs, nr, b_packed);
+            task.nc = nc;
+            task.kc = kc;
+            task.a = (const uint8_t *)a + pc * a_cs * (a_half ? sizeof(lehalf) : sizeof(float));
+            task.c = c + jc;
+            task.column = jc;
+            /// @note: Only first block along k dimension takes existing content of C into account
+            task.beta = (pc == 0) ? beta : 1.0f;
+            task.epilogue = (pc + kc == k) ? epilogue : NULL;
+            le_parallel_for(panels_count, parallel ? 1 : panels_count, le_gemm_row_panels, &task);
+        }
+    }
+
+    le_free(b_packed);
+}
+
+void
+le_sgemm(bool transpose_a, bool transpose_b, unsigned m, unsigned n, unsigned k,
+         float alpha, const float *a, size_t lda, const float *b, size_t ldb,
+         float beta, const LeGemmEpilogue *epilogue, float *c, size_t ldc)
+{
+    le_gemm(transpose_a, transpose_b, m, n, k, alpha, a, false, lda, b, ldb, beta, epilogue, c, ldc);
+}
+
+void
+le_sgemm_a_f16(bool transpose_a, bool transpose_b, unsigned m, unsigned n, unsigned k,
+               float alpha, const lehalf *a, size_t lda, const float *b, size_t ldb,
+               float beta, const LeGemmEpilogue *epilogue, float *c, size_t ldc)
+{
+    le_gemm(transpose_a, transpose_b, m, n, k, alpha, a, true, lda, b, ldb, beta, epilogue, c, ldc);
+}
+
+typedef struct LeGemmEpilogueTask
+{
+    const LeGemmEpilogue *epilogue;
+    unsigned            n;
+    float              *c;
+    size_t              ldc;
+} LeGemmEpilogueTask;
+
+static void
+le_gemm_epilogue_range(void *data, size_t begin, size_t end)
+{
+    const LeGemmEpilogueTask *task = data;
+    le_gemm_epilogue_rows(task->epilogue, begin, 0, end - begin, task->n, task->c + begin * task->ldc, task->ldc);
+}
+
+void
+le_gemm_apply_epilogue(const LeGemmEpilogue *epilogue, unsigned m, unsigned n, float *c, size_t ldc)
+{
+    assert(epilogue);
+    assert(epilogue->activation != LE_ACTIVATION_SOFTMAX);
+
+    if ((m == 0) || (n == 0))
+        return;
+
+    LeGemmEpilogueTask task = {
+        .epilogue = epilogue,
+        .n = n,
+        .c = c,
+        .ldc = ldc
+    };
+    size_t grain = (n < LE_GEMM_EPILOGUE_GRAIN) ? LE_GEMM_EPILOGUE_GRAIN / n : 1;
+    le_parallel_for(m, grain, le_gemm_epilogue_range, &task);
+}
+
+/// @note: Tile of quantized product, rows past m and columns past n are duplicates of last ones
+#define LE_GEMM_U8S8_MR 4
+#define LE_GEMM_U8S8_NR 4
+/// @note: Rows of A reused from L2 by all columns of thread
+#define LE_GEMM_U8S8_MC 64
+
+/// @note: Computes MR×NR sums of products of rows of A and rows of transposed B
+typedef void (*LeGemmU8S8MicroKernel)(size_t                k,
+                                      const int8_t * const *a,
+                                      const uint8_t * const *b,
+                                      int32_t              *c);
+
+static void
+le_gemm_u8s8_kernel_4x4(size_t k, const int8_t * const *a, const uint8_t * const *b, int32_t *c)
+{
+    int32_t acc[4][4] = {{0}};
+
+    for (size_t p = 0; p < k; p++)
+    {
+        for (unsigned i = 0; i < 4; i++)
+        {
+            for (unsigned j = 0; j < 4; j++)
+            {
+                acc[i][j] += (int32_t)a[i][p] * (int32_t)b[j][p];
+            }
+        }
+    }
+
+    memcpy(c, acc, sizeof(acc));
+}
+
+#ifdef LE_CPU_X86
+
+/// @note: Sums of lanes of four vectors, in lanes of result
+__attribute__((target("avx2")))
+static inline __m128i
+le_hsum4_epi32_avx2(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+    __m256i sums = _mm256_hadd_epi32(_mm256_hadd_epi32(a, b), _mm256_hadd_epi32(c, d));
+    return _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+}
+
+/// @note: Copies tails of rows shorter than block of micro-kernel, padded with zeros,
+/// and points rows to them
+static inline void
+le_gemm_u8s8_copy_tails(size_t k, size_t p, size_t block, const int8_t **a, const uint8_t **b,
+                        int8_t *a_tails, uint8_t *b_tails)
+{
+    memset(a_tails, 0, LE_GEMM_U8S8_MR * block);
+    memset(b_tails, 0, LE_GEMM_U8S8_NR * block);
+    for (unsigned i = 0; i < LE_GEMM_U8S8_MR; i++)
+    {
+        memcpy(a_tails + i * block, a[i] + p, k - p);
+        a[i] = a_tails + i * block - p;
+    }
+    for (unsigned j = 0; j < LE_GEMM_U8S8_NR; j++)
+    {
+        memcpy(b_tails + j * block, b[j] + p, k - p);
+        b[j] = b_tails + j * block - p;
+    }
+}
+
+/// @note: Operands are widened to 16 bits, so pairs of products are added without saturation.
+/// Loops are unrolled, so that accumulators stay in registers.
+__attribute__((target("avx2")))
+static void
+le_gemm_u8s8_kernel_4x4_avx2(size_t k, const int8_t * const *a, const uint8_t * const *b, int32_t *c)
+{
+    const int8_t *a_rows[4] = { a[0], a[1], a[2], a[3] };
+    const uint8_t *b_rows[4] = { b[0], b[1], b[2], b[3] };
+    int8_t a_tails[4 * 16];
+    uint8_t b_tails[4 * 16];
+    __m256i acc[4][4];
+#pragma GCC unroll 4
+    for (unsigned i = 0; i < 4; i++)
+#pragma GCC unroll 4
+        for (unsigned j = 0; j < 4; j++)
+            acc[i][j] = _mm256_setzero_si256();
+
+    for (size_t p = 0; p < k; p += 16)
+    {
+        if (p + 16 > k)
+            le_gemm_u8s8_copy_tails(k, p, 16, a_rows, b_rows, a_tails, b_tails);
+        __m256i bv[4];
+#pragma GCC unroll 4
+        for (unsigned j = 0; j < 4; j++)
+            bv[j] = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b_rows[j] + p)));
+#pragma GCC unroll 4
+        for (unsigned i = 0; i < 4; i++)
+        {
+            __m256i av = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a_rows[i] + p)));
+#pragma GCC unroll 4
+            for (unsigned j = 0; j < 4; j++)
+                acc[i][j] = _mm256_add_epi32(acc[i][j], _mm256_madd_epi16(av, bv[j]));
+        }
+    }
+
+#pragma GCC unroll 4
+    for (unsigned i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i *)(c + i * 4), le_hsum4_epi32_avx2(acc[i][0], acc[i][1], acc[i][2], acc[i][3]));
+}
+
+/// @note: vpdpbusd multiplies unsigned bytes of first operand by signed bytes of second
+/// and adds groups of four products to 32-bit lanes
+__attribute__((target("avx512f,avx512vnni")))
+static void
+le_gemm_u8s8_kernel_4x4_avx512vnni(size_t k, const int8_t * const *a, const uint8_t * const *b, int32_t *c)
+{
+    const int8_t *a_rows[4] = { a[0], a[1], a[2], a[3] };
+    const uint8_t *b_rows[4] = { b[0], b[1], b[2], b[3] };
+    int8_t a_tails[4 * 64];
+    uint8_t b_tails[4 * 64];
+    __m512i acc[4][4];
+#pragma GCC unroll 4
+    for (unsigned i = 0; i < 4; i++)
+#pragma GCC unroll 4
+        for (unsigned j = 0; j < 4; j++)
+            acc[i][j] = _mm512_setzero_si512();
+
+    for (size_t p = 0; p < k; p += 64)
+    {
+        if (p + 64 > k)
+            le_gemm_u8s8_copy_tails(k, p, 64, a_rows, b_rows, a_tails, b_tails);
+        __m512i bv[4];
+#pragma GCC unroll 4
+        for (unsigned j = 0; j < 4; j++)
+            bv[j] = _mm512_loadu_si512(b_rows[j] + p);
+#pragma GCC unroll 4
+        for (unsigned i = 0; i < 4; i++)
+        {
+            __m512i av = _mm512_loadu_si512(a_rows[i] + p);
+#pragma GCC unroll 4
+            for (unsigned j = 0; j < 4; j++)
+                acc[i][j] = _mm512_dpbusd_epi32(acc[i][j], bv[j], av);
+        }
+    }
+
+#pragma GCC unroll 4
+    for (unsigned i = 0; i < 4; i++)
+    {
+        __m256i halves[4];
+#pragma GCC unroll 4
+        for (unsigned j = 0; j < 4; j++)
+            halves[j] = _mm256_add_epi32(_mm512_castsi512_si256(acc[i][j]), _mm512_extracti64x4_epi64(acc[i][j], 1));
+        _mm_storeu_si128((__m128i *)(c + i * 4), le_hsum4_epi32_avx2(halves[0], halves[1], halves[2], halves[3]));
+    }
+}
+
+#endif
+
+static LeGemmU8S8MicroKernel
+le_gemm_u8s8_get_kernel(unsigned features)
+{
+#ifdef LE_CPU_X86
+    if ((features & LE_CPU_FEATURE_AVX512F) && (features & LE_CPU_FEATURE_AVX512VNNI))
+        return le_gemm_u8s8_kernel_4x4_avx512vnni;
+    if (features & LE_CPU_FEATURE_AVX2)
+        return le_gemm_u8s8_kernel_4x4_avx2;
+#endif
+    return le_gemm_u8s8_kernel_4x4;
+}
+
+typedef struct LeGemmU8S8Task
+{
+    LeGemmU8S8MicroKernel          kernel;
+    unsigned                       m;
+    unsigned                       n;
+    unsigned                       k;
+    const int8_t                  *a;
+    size_t                         lda;
+    const uint8_t                 *b;
+    size_t                         ldb;
+    const LeGemmQuantizedEpilogue *epilogue;
+    float                         *c;
+    size_t                         ldc;
+} LeGemmU8S8Task;
+
+/// @note: Computes column tiles [begin, end) of C, NR columns each
+static void
+le_gemm_u8s8_column_tiles(void *data, size_t begin, size_t end)
+{
+    const LeGemmU8S8Task *task = data;
+    const LeGemmQuantizedEpilogue *epilogue = task->epilogue;
+
+    for (unsigned ib = 0; ib < task->m; ib += LE_GEMM_U8S8_MC)
+    {
+        unsigned ib_end = (task->m - ib < LE_GEMM_U8S8_MC) ? task->m : ib + LE_GEMM_U8S8_MC;
+        for (size_t tile = begin; tile < end; tile++)
+        {
+            unsigned j0 = tile * LE_GEMM_U8S8_NR;
+            unsigned nr = (task->n - j0 < LE_GEMM_U8S8_NR) ? task->n - j0 : LE_GEMM_U8S8_NR;
+            const uint8_t *b_rows[LE_GEMM_U8S8_NR];
+            for (unsigned j = 0; j < LE_GEMM_U8S8_NR; j++)
+                b_rows[j] = task->b + (j0 + (j < nr ? j : nr - 1)) * task->ldb;
+
+            for (unsigned i0 = ib; i0 < ib_end; i0 += LE_GEMM_U8S8_MR)
+            {
+                unsigned mr = (ib_end - i0 < LE_GEMM_U8S8_MR) ? ib_end - i0 : LE_GEMM_U8S8_MR;
+                const int8_t *a_rows[LE_GEMM_U8S8_MR];
+                for (unsigned i = 0; i < LE_GEMM_U8S8_MR; i++)
+                    a_rows[i] = task->a + (i0 + (i < mr ? i : mr - 1)) * task->lda;
+
+                int32_t tile_sums[LE_GEMM_U8S8_MR * LE_GEMM_U8S8_NR];
+                task->kernel(task->k, a_rows, b_rows, tile_sums);
+
+                for (unsigned i = 0; i < mr; i++)
+                {
+                    unsigned row = i0 + i;
+                    int64_t a_zero_point = epilogue->a_zero_points[row];
+                    int64_t row_term = (int64_t)task->k * a_zero_point * epilogue->b_zero_point -
+                                       (int64_t)epilogue->b_zero_point * epilogue->a_row_sums[row];
+                    float bias = epilogue->bias ? epilogue->bias[row] : 0.0f;
+                    float *c_row = task->c + row * task->ldc + j0;
+                    for (unsigned j = 0; j < nr; j++)
+                    {
+                        int64_t sum = tile_sums[i * LE_GEMM_U8S8_NR + j] + row_term -
+                                      a_zero_point * epilogue->b_column_sums[j0 + j];
+                        float value = epilogue->scales[row] * (float)sum + bias;
+                        c_row[j] = (epilogue->relu && value < 0.0f) ? 0.0f : value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+le_gemm_u8s8_for_features(unsigned features, unsigned m, unsigned n, unsigned k,
+                          const int8_t *a, size_t lda, const uint8_t *b, size_t ldb,
+                          const LeGemmQuantizedEpilogue *epilogue, float *c, size_t ldc)
+{
+    assert(epilogue);
+    assert(k <= 65536);
+
+    if ((m == 0) || (n == 0))
+        return;
+
+    LeGemmU8S8Task task = {
+        .kernel = le_gemm_u8s8_get_kernel(features),
+        .m = m,
+        .n = n,
+        .k = k,
+        .a = a,
+        .lda = lda,
+        .b = b,
+        .ldb = ldb,
+        .epilogue = epilogue,
+        .c = c,
+        .ldc = ldc
+    };
+    size_t tiles_count = (n + LE_GEMM_U8S8_NR - 1) / LE_GEMM_U8S8_NR;
+    bool parallel = (size_t)m * n * k >= LE_GEMM_PARALLEL_MIN_WORK;
+    le_parallel_for(tiles_count, parallel ? 1 : tiles_count, le_gemm_u8s8_column_tiles, &task);
+}
+
+void
+le_gemm_u8s8(unsigned m, unsigned n, unsigned k, const int8_t *a, size_t lda, const uint8_t *b, size_t ldb,
+             const LeGemmQuantizedEpilogue *epilogue, float *c, size_t ldc)
+{
+    le_gemm_u8s8_for_features(le_cpu_get_features(), m, n, k, a, lda, b, ldb, epilogue, c, ldc);
+}
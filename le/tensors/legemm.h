@@ -0,0 +1,116 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Built-in single precision GEMM used when no BLAS backend is available,
+   and 8-bit integer GEMM of quantized inference */
+
+#ifndef __LEGEMM_H__
+#define __LEGEMM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <le/lemacros.h>
+#include "letype.h"
+#include "leactivation.h"
+
+LE_BEGIN_DECLS
+
+/// @note: Biases and element-wise activation applied to tiles of C while they are still in cache,
+/// right after their products are accumulated: C[i][j] = activation(C[i][j] + row_bias[i] + column_bias[j]).
+/// Either bias may be NULL, activation may not be LE_ACTIVATION_SOFTMAX.
+typedef struct LeGemmEpilogue
+{
+    const float *      row_bias;
+    const float *      column_bias;
+    LeActivation       activation;
+} LeGemmEpilogue;
+
+/// @note: Row-major C = alpha * op(A) * op(B) + beta * C, where op(A) is m×k and op(B) is k×n.
+/// lda, ldb and ldc are row strides in elements of matrices as stored, before transposition.
+/// C is not read when beta is zero. epilogue, if not NULL, is applied to result.
+void               le_sgemm                                (bool                    transpose_a,
+                                                            bool                    transpose_b,
+                                                            unsigned                m,
+                                                            unsigned                n,
+                                                            unsigned                k,
+                                                            float                   alpha,
+                                                            const float *           a,
+                                                            size_t                  lda,
+                                                            const float *           b,
+                                                            size_t                  ldb,
+                                                            float                   beta,
+                                                            const LeGemmEpilogue *  epilogue,
+                                                            float *                 c,
+                                                            size_t                  ldc);
+
+/// @note: Same as le_sgemm with half precision A, e.g. weights of layer. A is converted
+/// to single precision while packed, products are accumulated in single precision.
+void               le_sgemm_a_f16                          (bool                    transpose_a,
+                                                            bool                    transpose_b,
+                                                            unsigned                m,
+                                                            unsigned                n,
+                                                            unsigned                k,
+                                                            float                   alpha,
+                                                            const lehalf *          a,
+                                                            size_t                  lda,
+                                                            const float *           b,
+                                                            size_t                  ldb,
+                                                            float                   beta,
+                                                            const LeGemmEpilogue *  epilogue,
+                                                            float *                 c,
+                                                            size_t                  ldc);
+
+/// @note: Applies epilogue to m×n C computed by other GEMM, e.g. of BLAS backend, in one pass
+void               le_gemm_apply_epilogue                  (const LeGemmEpilogue *  epilogue,
+                                                            unsigned                m,
+                                                            unsigned                n,
+                                                            float *                 c,
+                                                            size_t                  ldc);
+
+/// @note: Dequantization, bias and ReLU applied to 32-bit sums of products of 8-bit integers
+/// before they are stored: C[i][j] = scales[i] * Σ (A[i][p] - a_zero_points[i]) * (B[j][p] - b_zero_point)
+/// + bias[i], clamped at zero when relu is set. Sums over rows of A and columns of op(B)
+/// are used to expand the zero point terms. bias may be NULL.
+typedef struct LeGemmQuantizedEpilogue
+{
+    const float *      scales;
+    const int32_t *    a_zero_points;
+    const int32_t *    a_row_sums;
+    int32_t            b_zero_point;
+    const int32_t *    b_column_sums;
+    const float *      bias;
+    bool               relu;
+} LeGemmQuantizedEpilogue;
+
+/// @note: Row-major m×n C from signed 8-bit m×k A and unsigned 8-bit B stored transposed,
+/// n rows of k elements, so both operands are read along k. Products are accumulated exactly
+/// in 32-bit integers, which bounds k to 65536.
+void               le_gemm_u8s8                            (unsigned                m,
+                                                            unsigned                n,
+                                                            unsigned                k,
+                                                            const int8_t *          a,
+                                                            size_t                  lda,
+                                                            const uint8_t *         b,
+                                                            size_t                  ldb,
+                                                            const LeGemmQuantizedEpilogue *epilogue,
+                                                            float *                 c,
+                                                            size_t                  ldc);
+
+/// @note: Same as le_gemm_u8s8 with micro-kernel selected for given LeCpuFeature bitmask
+/// instead of host features, so that every implementation can be tested on one machine
+void               le_gemm_u8s8_for_features               (unsigned                features,
+                                                            unsigned                m,
+                                                            unsigned                n,
+                                                            unsigned                k,
+                                                            const int8_t *          a,
+                                                            size_t                  lda,
+                                                            const uint8_t *         b,
+                                                            size_t                  ldb,
+                                                            const LeGemmQuantizedEpilogue *epilogue,
+                                                            float *                 c,
+                                                            size_t                  ldc);
+
+LE_END_DECLS
+
+#endif
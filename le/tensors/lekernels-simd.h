@@ -0,0 +1,590 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Template of element-wise kernels. Included from lekernels.c once per instruction set with
+   following macros defined:
+   LE_SIMD_SUFFIX     - suffix of generated symbols
+   LE_SIMD_ATTRIBUTES - function attributes enabling instruction set
+   LE_VEC             - vector type holding LE_VEC_WIDTH floats
+   LE_VEC_LOAD(p), LE_VEC_STORE(p, v), LE_VEC_SET1(x), LE_VEC_ZERO(),
+   LE_VEC_ADD(a, b), LE_VEC_SUB(a, b), LE_VEC_MUL(a, b), LE_VEC_DIV(a, b),
+   LE_VEC_MAX(a, b), LE_VEC_MIN(a, b) - a > b ? a : b and a < b ? a : b, LE_VEC_ABS(a),
+   LE_VEC_GT_ONE(a, b) - 1 where a > b, 0 otherwise, LE_VEC_EQ_ONE(a, b) - 1 where a == b,
+   LE_VEC_REDUCE_ADD(v), LE_VEC_REDUCE_MAX(v), LE_VEC_REDUCE_MIN(v) - sum, max and min of all lanes,
+   LE_VEC_ROUND(a) - nearest integer, LE_VEC_POW2(n) - 2^n for integer n in [-126, 127],
+   LE_VEC_EXPONENT(a), LE_VEC_MANTISSA(a) - unbiased exponent and significand in [1, 2) of positive normal a,
+   LE_VEC_SELECT_LT(a, b, x, y) - x where a < b, y otherwise,
+   LE_VEC_LOAD_F16(p), LE_VEC_STORE_F16(p, v) - load and store converting from and to half precision,
+   LE_VEC_LOAD_U8(p) - load of bytes converted to single precision,
+   LE_VEC_STORE_U8(p, v) - store of lanes holding integers in [0, 255] as bytes.
+   Two tables are generated: faithful transcendental functions and fast ones, both sharing the rest. */
+
+#define LE_SIMD_CONCAT_(name, suffix) name ## _ ## suffix
+#define LE_SIMD_CONCAT(name, suffix) LE_SIMD_CONCAT_(name, suffix)
+#define LE_SIMD_NAME(name) LE_SIMD_CONCAT(name, LE_SIMD_SUFFIX)
+#define LE_SIMD_STRING_(suffix) #suffix
+#define LE_SIMD_STRING(suffix) LE_SIMD_STRING_(suffix)
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_add_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_ADD(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] += b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_sub_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_SUB(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] -= b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_mul_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_MUL(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] *= b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_div_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_DIV(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] /= b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_max_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_MAX(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] = a[i] > b[i] ? a[i] : b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_min_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_MIN(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] = a[i] < b[i] ? a[i] : b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_equal_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_EQ_ONE(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] = a[i] == b[i] ? 1.0f : 0.0f;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_greater_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_GT_ONE(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    for (; i < n; i++)
+        a[i] = a[i] > b[i] ? 1.0f : 0.0f;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_less_f32)(float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_GT_ONE(LE_VEC_LOAD(b + i), LE_VEC_LOAD(a + i)));
+    for (; i < n; i++)
+        a[i] = a[i] < b[i] ? 1.0f : 0.0f;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_sub_scaled_f32)(float *a, float scale, const float *b, size_t n)
+{
+    size_t i = 0;
+    LE_VEC s = LE_VEC_SET1(scale);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_SUB(LE_VEC_LOAD(a + i), LE_VEC_MUL(s, LE_VEC_LOAD(b + i))));
+    for (; i < n; i++)
+        a[i] -= scale * b[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_mul_add_f32)(float *a, const float *b, const float *c, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_ADD(LE_VEC_LOAD(a + i), LE_VEC_MUL(LE_VEC_LOAD(b + i), LE_VEC_LOAD(c + i))));
+    for (; i < n; i++)
+        a[i] += b[i] * c[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_max_index_f32)(float *a, float *index, const float *b, float b_index, size_t n)
+{
+    size_t i = 0;
+    LE_VEC bi = LE_VEC_SET1(b_index);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+    {
+        LE_VEC va = LE_VEC_LOAD(a + i);
+        LE_VEC vb = LE_VEC_LOAD(b + i);
+        LE_VEC_STORE(index + i, LE_VEC_SELECT_LT(va, vb, bi, LE_VEC_LOAD(index + i)));
+        LE_VEC_STORE(a + i, LE_VEC_SELECT_LT(va, vb, vb, va));
+    }
+    for (; i < n; i++)
+    {
+        if (a[i] < b[i])
+        {
+            a[i] = b[i];
+            index[i] = b_index;
+        }
+    }
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_add_scalar_f32)(float *a, float scalar, size_t n)
+{
+    size_t i = 0;
+    LE_VEC s = LE_VEC_SET1(scalar);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_ADD(LE_VEC_LOAD(a + i), s));
+    for (; i < n; i++)
+        a[i] += scalar;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_mul_scalar_f32)(float *a, float scalar, size_t n)
+{
+    size_t i = 0;
+    LE_VEC s = LE_VEC_SET1(scalar);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_MUL(LE_VEC_LOAD(a + i), s));
+    for (; i < n; i++)
+        a[i] *= scalar;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_sqr_f32)(float *a, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+    {
+        LE_VEC x = LE_VEC_LOAD(a + i);
+        LE_VEC_STORE(a + i, LE_VEC_MUL(x, x));
+    }
+    for (; i < n; i++)
+        a[i] = a[i] * a[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_one_minus_f32)(float *a, size_t n)
+{
+    size_t i = 0;
+    LE_VEC one = LE_VEC_SET1(1.0f);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_SUB(one, LE_VEC_LOAD(a + i)));
+    for (; i < n; i++)
+        a[i] = 1.0f - a[i];
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_x_minus_sqr_x_f32)(float *a, size_t n)
+{
+    size_t i = 0;
+    LE_VEC one = LE_VEC_SET1(1.0f);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+    {
+        LE_VEC x = LE_VEC_LOAD(a + i);
+        LE_VEC_STORE(a + i, LE_VEC_MUL(x, LE_VEC_SUB(one, x)));
+    }
+    for (; i < n; i++)
+        a[i] = a[i] * (1.0f - a[i]);
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_gt_f32)(float *a, float scalar, size_t n)
+{
+    size_t i = 0;
+    LE_VEC s = LE_VEC_SET1(scalar);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_GT_ONE(LE_VEC_LOAD(a + i), s));
+    for (; i < n; i++)
+        a[i] = a[i] > scalar ? 1.0f : 0.0f;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_sgn_f32)(float *a, size_t n)
+{
+    size_t i = 0;
+    LE_VEC zero = LE_VEC_ZERO();
+    LE_VEC one = LE_VEC_SET1(1.0f);
+    LE_VEC two = LE_VEC_SET1(2.0f);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_SUB(LE_VEC_MUL(two, LE_VEC_GT_ONE(LE_VEC_LOAD(a + i), zero)), one));
+    for (; i < n; i++)
+        a[i] = a[i] > 0.0f ? 1.0f : -1.0f;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_relu_f32)(float *a, size_t n)
+{
+    size_t i = 0;
+    LE_VEC zero = LE_VEC_ZERO();
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(a + i, LE_VEC_MAX(LE_VEC_LOAD(a + i), zero));
+    for (; i < n; i++)
+        a[i] = a[i] > 0.0f ? a[i] : 0.0f;
+}
+
+static LE_SIMD_ATTRIBUTES float
+LE_SIMD_NAME(le_sum_f32)(const float *a, size_t n)
+{
+    size_t i = 0;
+    LE_VEC acc = LE_VEC_ZERO();
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        acc = LE_VEC_ADD(acc, LE_VEC_LOAD(a + i));
+    float sum = LE_VEC_REDUCE_ADD(acc);
+    for (; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+static LE_SIMD_ATTRIBUTES float
+LE_SIMD_NAME(le_reduce_max_f32)(const float *a, size_t n)
+{
+    size_t i = 0;
+    float max = a[0];
+    if (n >= LE_VEC_WIDTH)
+    {
+        LE_VEC acc = LE_VEC_LOAD(a);
+        for (i = LE_VEC_WIDTH; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+            acc = LE_VEC_MAX(acc, LE_VEC_LOAD(a + i));
+        max = LE_VEC_REDUCE_MAX(acc);
+    }
+    for (; i < n; i++)
+        max = a[i] > max ? a[i] : max;
+    return max;
+}
+
+static LE_SIMD_ATTRIBUTES float
+LE_SIMD_NAME(le_reduce_min_f32)(const float *a, size_t n)
+{
+    size_t i = 0;
+    float min = a[0];
+    if (n >= LE_VEC_WIDTH)
+    {
+        LE_VEC acc = LE_VEC_LOAD(a);
+        for (i = LE_VEC_WIDTH; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+            acc = LE_VEC_MIN(acc, LE_VEC_LOAD(a + i));
+        min = LE_VEC_REDUCE_MIN(acc);
+    }
+    for (; i < n; i++)
+        min = a[i] < min ? a[i] : min;
+    return min;
+}
+
+static LE_SIMD_ATTRIBUTES float
+LE_SIMD_NAME(le_dot_f32)(const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    LE_VEC acc = LE_VEC_ZERO();
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        acc = LE_VEC_ADD(acc, LE_VEC_MUL(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i)));
+    float dot = LE_VEC_REDUCE_ADD(acc);
+    for (; i < n; i++)
+        dot += a[i] * b[i];
+    return dot;
+}
+
+static LE_SIMD_ATTRIBUTES float
+LE_SIMD_NAME(le_sad_f32)(const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+    LE_VEC acc = LE_VEC_ZERO();
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        acc = LE_VEC_ADD(acc, LE_VEC_ABS(LE_VEC_SUB(LE_VEC_LOAD(a + i), LE_VEC_LOAD(b + i))));
+    float sad = LE_VEC_REDUCE_ADD(acc);
+    for (; i < n; i++)
+        sad += fabsf(a[i] - b[i]);
+    return sad;
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_f16_to_f32)(float *destination, const lehalf *source, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(destination + i, LE_VEC_LOAD_F16(source + i));
+    for (; i < n; i++)
+        destination[i] = le_f16_to_f32(source[i]);
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_f32_to_f16)(lehalf *destination, const float *source, size_t n)
+{
+    size_t i = 0;
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE_F16(destination + i, LE_VEC_LOAD(source + i));
+    for (; i < n; i++)
+        destination[i] = le_f32_to_f16(source[i]);
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_quantize_u8)(uint8_t *destination, const float *source, float inverse_scale, float zero_point, size_t n)
+{
+    size_t i = 0;
+    LE_VEC scale_vec = LE_VEC_SET1(inverse_scale);
+    LE_VEC zero_point_vec = LE_VEC_SET1(zero_point);
+    LE_VEC max_vec = LE_VEC_SET1(255.0f);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+    {
+        LE_VEC q = LE_VEC_ADD(LE_VEC_ROUND(LE_VEC_MUL(LE_VEC_LOAD(source + i), scale_vec)), zero_point_vec);
+        LE_VEC_STORE_U8(destination + i, LE_VEC_MIN(LE_VEC_MAX(q, LE_VEC_ZERO()), max_vec));
+    }
+    for (; i < n; i++)
+    {
+        float q = nearbyintf(source[i] * inverse_scale) + zero_point;
+        q = (q > 0.0f) ? q : 0.0f;
+        destination[i] = (uint8_t)((q < 255.0f) ? q : 255.0f);
+    }
+}
+
+static LE_SIMD_ATTRIBUTES void
+LE_SIMD_NAME(le_u8_to_f32)(float *destination, const uint8_t *source, float scale, float offset, size_t n)
+{
+    size_t i = 0;
+    LE_VEC scale_vec = LE_VEC_SET1(scale);
+    LE_VEC offset_vec = LE_VEC_SET1(offset);
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)
+        LE_VEC_STORE(destination + i, LE_VEC_ADD(LE_VEC_MUL(LE_VEC_LOAD_U8(source + i), scale_vec), offset_vec));
+    for (; i < n; i++)
+        destination[i] = (float)source[i] * scale + offset;
+}
+
+/// @note: Faithful variant is Cephes single precision exp with two-constant range reduction,
+/// fast one uses degree 4 Taylor polynomial. Input is clamped so that 2^n is split in two scales
+/// which keeps overflow to infinity and underflow to denormals, NaN propagates through MAX and MIN.
+static inline LE_SIMD_ATTRIBUTES LE_VEC
+LE_SIMD_NAME(le_vec_exp)(LE_VEC x, bool faithful)
+{
+    x = LE_VEC_MIN(LE_VEC_SET1(88.8f), LE_VEC_MAX(LE_VEC_SET1(-104.0f), x));
+    LE_VEC n = LE_VEC_ROUND(LE_VEC_MUL(x, LE_VEC_SET1(1.44269504088896341f)));
+    LE_VEC p;
+    if (faithful)
+    {
+        LE_VEC r = LE_VEC_SUB(x, LE_VEC_MUL(n, LE_VEC_SET1(0.693359375f)));
+        r = LE_VEC_SUB(r, LE_VEC_MUL(n, LE_VEC_SET1(-2.12194440e-4f)));
+        p = LE_VEC_SET1(1.9875691500E-4f);
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(1.3981999507E-3f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(8.3334519073E-3f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(4.1665795894E-2f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(1.6666665459E-1f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(5.0000001201E-1f));
+        p = LE_VEC_ADD(LE_VEC_ADD(LE_VEC_MUL(p, LE_VEC_MUL(r, r)), r), LE_VEC_SET1(1.0f));
+    }
+    else
+    {
+        LE_VEC r = LE_VEC_SUB(x, LE_VEC_MUL(n, LE_VEC_SET1(0.693147180559945309f)));
+        p = LE_VEC_SET1(1.0f / 24.0f);
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(1.0f / 6.0f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(0.5f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(1.0f));
+        p = LE_VEC_ADD(LE_VEC_MUL(p, r), LE_VEC_SET1(1.0f));
+    }
+    LE_VEC n1 = LE_VEC_ROUND(LE_VEC_MUL(n, LE_VEC_SET1(0.5f)));
+    LE_VEC n2 = LE_VEC_SUB(n, n1);
+    return LE_VEC_MUL(LE_VEC_MUL(p, LE_VEC_POW2(n1)), LE_VEC_POW2(n2));
+}
+
+/// @note: Natural logarithm, significand is reduced to [sqrt(1/2), sqrt(2)).
+/// Faithful variant is Cephes single precision log, fast one is atanh series of degree 5.
+static inline LE_SIMD_ATTRIBUTES LE_VEC
+LE_SIMD_NAME(le_vec_log)(LE_VEC x, bool faithful)
+{
+    /// Denormals are scaled up to normal range first
+    LE_VEC denormal_x = LE_VEC_MUL(x, LE_VEC_SET1(8388608.0f));
+    LE_VEC normal_x = LE_VEC_SELECT_LT(x, LE_VEC_SET1(1.17549435e-38f), denormal_x, x);
+    LE_VEC e = LE_VEC_EXPONENT(normal_x);
+    e = LE_VEC_SELECT_LT(x, LE_VEC_SET1(1.17549435e-38f), LE_VEC_SUB(e, LE_VEC_SET1(23.0f)), e);
+    LE_VEC m = LE_VEC_MANTISSA(normal_x);
+    LE_VEC sqrt2 = LE_VEC_SET1(1.41421356237f);
+    e = LE_VEC_SELECT_LT(m, sqrt2, e, LE_VEC_ADD(e, LE_VEC_SET1(1.0f)));
+    m = LE_VEC_SELECT_LT(m, sqrt2, m, LE_VEC_MUL(m, LE_VEC_SET1(0.5f)));
+    LE_VEC f = LE_VEC_SUB(m, LE_VEC_SET1(1.0f));
+    LE_VEC result;
+    if (faithful)
+    {
+        LE_VEC z = LE_VEC_MUL(f, f);
+        LE_VEC y = LE_VEC_SET1(7.0376836292E-2f);
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(-1.1514610310E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(1.1676998740E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(-1.2420140846E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(1.4249322787E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(-1.6668057665E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(2.0000714765E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(-2.4999993993E-1f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, f), LE_VEC_SET1(3.3333331174E-1f));
+        y = LE_VEC_MUL(LE_VEC_MUL(y, f), z);
+        y = LE_VEC_ADD(y, LE_VEC_MUL(e, LE_VEC_SET1(-2.12194440e-4f)));
+        y = LE_VEC_SUB(y, LE_VEC_MUL(z, LE_VEC_SET1(0.5f)));
+        result = LE_VEC_ADD(LE_VEC_ADD(f, y), LE_VEC_MUL(e, LE_VEC_SET1(0.693359375f)));
+    }
+    else
+    {
+        LE_VEC s = LE_VEC_DIV(f, LE_VEC_ADD(f, LE_VEC_SET1(2.0f)));
+        LE_VEC z = LE_VEC_MUL(s, s);
+        LE_VEC y = LE_VEC_ADD(LE_VEC_MUL(z, LE_VEC_SET1(0.2f)), LE_VEC_SET1(1.0f / 3.0f));
+        y = LE_VEC_ADD(LE_VEC_MUL(y, z), LE_VEC_SET1(1.0f));
+        y = LE_VEC_MUL(LE_VEC_MUL(y, s), LE_VEC_SET1(2.0f));
+        result = LE_VEC_ADD(y, LE_VEC_MUL(e, LE_VEC_SET1(0.693147180559945309f)));
+    }
+    /// log(0) = -inf, log of negative number is NaN, log(inf) = inf, NaN propagates
+    LE_VEC zero = LE_VEC_ZERO();
+    LE_VEC infinity = LE_VEC_SET1(INFINITY);
+    result = LE_VEC_SELECT_LT(zero, x, result, LE_VEC_SELECT_LT(x, zero, LE_VEC_SET1(NAN), LE_VEC_SUB(zero, infinity)));
+    return LE_VEC_SELECT_LT(x, infinity, result, x);
+}
+
+/// @note: Cephes odd polynomial near zero, 1 - 2 / (exp(2|x|) + 1) with restored sign elsewhere
+static inline LE_SIMD_ATTRIBUTES LE_VEC
+LE_SIMD_NAME(le_vec_tanh)(LE_VEC x, bool faithful)
+{
+    LE_VEC zero = LE_VEC_ZERO();
+    LE_VEC one = LE_VEC_SET1(1.0f);
+    LE_VEC abs_x = LE_VEC_ABS(x);
+    LE_VEC z = LE_VEC_MUL(x, x);
+    LE_VEC y = LE_VEC_SET1(-5.70498872745E-3f);
+    y = LE_VEC_ADD(LE_VEC_MUL(y, z), LE_VEC_SET1(2.06390887954E-2f));
+    y = LE_VEC_ADD(LE_VEC_MUL(y, z), LE_VEC_SET1(-5.37397155531E-2f));
+    y = LE_VEC_ADD(LE_VEC_MUL(y, z), LE_VEC_SET1(1.33314422036E-1f));
+    y = LE_VEC_ADD(LE_VEC_MUL(y, z), LE_VEC_SET1(-3.33332819422E-1f));
+    LE_VEC small = LE_VEC_ADD(LE_VEC_MUL(LE_VEC_MUL(y, z), x), x);
+    LE_VEC e = LE_SIMD_NAME(le_vec_exp)(LE_VEC_ADD(abs_x, abs_x), faithful);
+    LE_VEC large = LE_VEC_SUB(one, LE_VEC_DIV(LE_VEC_SET1(2.0f), LE_VEC_ADD(e, one)));
+    large = LE_VEC_SELECT_LT(x, zero, LE_VEC_SUB(zero, large), large);
+    return LE_VEC_SELECT_LT(abs_x, LE_VEC_SET1(0.625f), small, large);
+}
+
+static inline LE_SIMD_ATTRIBUTES LE_VEC
+LE_SIMD_NAME(le_vec_sigmoid)(LE_VEC x, bool faithful)
+{
+    LE_VEC one = LE_VEC_SET1(1.0f);
+    return LE_VEC_DIV(one, LE_VEC_ADD(one, LE_SIMD_NAME(le_vec_exp)(LE_VEC_SUB(LE_VEC_ZERO(), x), faithful)));
+}
+
+/// @note: Symmetric form e / (1 + e)^2 with e = exp(-|x|) avoids cancellation in 1 - sigmoid(x)
+static inline LE_SIMD_ATTRIBUTES LE_VEC
+LE_SIMD_NAME(le_vec_sigmoid_prime)(LE_VEC x, bool faithful)
+{
+    LE_VEC e = LE_SIMD_NAME(le_vec_exp)(LE_VEC_SUB(LE_VEC_ZERO(), LE_VEC_ABS(x)), faithful);
+    LE_VEC d = LE_VEC_ADD(LE_VEC_SET1(1.0f), e);
+    return LE_VEC_DIV(e, LE_VEC_MUL(d, d));
+}
+
+/// @note: Defines kernel applying vector function in place, tail is padded to full vector
+#define LE_SIMD_DEFINE_MAP(name, function, faithful)                                    \
+static LE_SIMD_ATTRIBUTES void                                                          \
+LE_SIMD_NAME(name)(float *a, size_t n)                                                  \
+{                                                                                       \
+    size_t i = 0;                                                                       \
+    for (; i + LE_VEC_WIDTH <= n; i += LE_VEC_WIDTH)                                    \
+        LE_VEC_STORE(a + i, LE_SIMD_NAME(function)(LE_VEC_LOAD(a + i), faithful));      \
+    if (i < n)                                                                          \
+    {                                                                                   \
+        float tail[LE_VEC_WIDTH] = { 0.0f };                                            \
+        memcpy(tail, a + i, (n - i) * sizeof(float));                                   \
+        LE_VEC_STORE(tail, LE_SIMD_NAME(function)(LE_VEC_LOAD(tail), faithful));        \
+        memcpy(a + i, tail, (n - i) * sizeof(float));                                   \
+    }                                                                                   \
+}
+
+LE_SIMD_DEFINE_MAP(le_exp_f32, le_vec_exp, true)
+LE_SIMD_DEFINE_MAP(le_log_f32, le_vec_log, true)
+LE_SIMD_DEFINE_MAP(le_tanh_f32, le_vec_tanh, true)
+LE_SIMD_DEFINE_MAP(le_sigmoid_f32, le_vec_sigmoid, true)
+LE_SIMD_DEFINE_MAP(le_sigmoid_prime_f32, le_vec_sigmoid_prime, true)
+LE_SIMD_DEFINE_MAP(le_exp_fast_f32, le_vec_exp, false)
+LE_SIMD_DEFINE_MAP(le_log_fast_f32, le_vec_log, false)
+LE_SIMD_DEFINE_MAP(le_tanh_fast_f32, le_vec_tanh, false)
+LE_SIMD_DEFINE_MAP(le_sigmoid_fast_f32, le_vec_sigmoid, false)
+LE_SIMD_DEFINE_MAP(le_sigmoid_prime_fast_f32, le_vec_sigmoid_prime, false)
+
+#undef LE_SIMD_DEFINE_MAP
+
+#define LE_SIMD_COMMON_KERNELS \
+    .add_f32 = LE_SIMD_NAME(le_add_f32), \
+    .sub_f32 = LE_SIMD_NAME(le_sub_f32), \
+    .mul_f32 = LE_SIMD_NAME(le_mul_f32), \
+    .div_f32 = LE_SIMD_NAME(le_div_f32), \
+    .max_f32 = LE_SIMD_NAME(le_max_f32), \
+    .min_f32 = LE_SIMD_NAME(le_min_f32), \
+    .equal_f32 = LE_SIMD_NAME(le_equal_f32), \
+    .greater_f32 = LE_SIMD_NAME(le_greater_f32), \
+    .less_f32 = LE_SIMD_NAME(le_less_f32), \
+    .sub_scaled_f32 = LE_SIMD_NAME(le_sub_scaled_f32), \
+    .mul_add_f32 = LE_SIMD_NAME(le_mul_add_f32), \
+    .max_index_f32 = LE_SIMD_NAME(le_max_index_f32), \
+    .add_scalar_f32 = LE_SIMD_NAME(le_add_scalar_f32), \
+    .mul_scalar_f32 = LE_SIMD_NAME(le_mul_scalar_f32), \
+    .sqr_f32 = LE_SIMD_NAME(le_sqr_f32), \
+    .one_minus_f32 = LE_SIMD_NAME(le_one_minus_f32), \
+    .x_minus_sqr_x_f32 = LE_SIMD_NAME(le_x_minus_sqr_x_f32), \
+    .gt_f32 = LE_SIMD_NAME(le_gt_f32), \
+    .sgn_f32 = LE_SIMD_NAME(le_sgn_f32), \
+    .relu_f32 = LE_SIMD_NAME(le_relu_f32), \
+    .sum_f32 = LE_SIMD_NAME(le_sum_f32), \
+    .reduce_max_f32 = LE_SIMD_NAME(le_reduce_max_f32), \
+    .reduce_min_f32 = LE_SIMD_NAME(le_reduce_min_f32), \
+    .dot_f32 = LE_SIMD_NAME(le_dot_f32), \
+    .sad_f32 = LE_SIMD_NAME(le_sad_f32), \
+    .f16_to_f32 = LE_SIMD_NAME(le_f16_to_f32), \
+    .f32_to_f16 = LE_SIMD_NAME(le_f32_to_f16), \
+    .quantize_u8 = LE_SIMD_NAME(le_quantize_u8), \
+    .u8_to_f32 = LE_SIMD_NAME(le_u8_to_f32)
+
+static const LeKernels LE_SIMD_NAME(le_kernels) =
+{
+    .name = LE_SIMD_STRING(LE_SIMD_SUFFIX),
+    LE_SIMD_COMMON_KERNELS,
+    .exp_f32 = LE_SIMD_NAME(le_exp_f32),
+    .log_f32 = LE_SIMD_NAME(le_log_f32),
+    .tanh_f32 = LE_SIMD_NAME(le_tanh_f32),
+    .sigmoid_f32 = LE_SIMD_NAME(le_sigmoid_f32),
+    .sigmoid_prime_f32 = LE_SIMD_NAME(le_sigmoid_prime_f32)
+};
+
+static const LeKernels LE_SIMD_NAME(le_kernels_fast) =
+{
+    .name = LE_SIMD_STRING(LE_SIMD_SUFFIX) "-fast",
+    LE_SIMD_COMMON_KERNELS,
+    .exp_f32 = LE_SIMD_NAME(le_exp_fast_f32),
+    .log_f32 = LE_SIMD_NAME(le_log_fast_f32),
+    .tanh_f32 = LE_SIMD_NAME(le_tanh_fast_f32),
+    .sigmoid_f32 = LE_SIMD_NAME(le_sigmoid_fast_f32),
+    .sigmoid_prime_f32 = LE_SIMD_NAME(le_sigmoid_prime_fast_f32)
+};
+
+#undef LE_SIMD_COMMON_KERNELS
+
+#undef LE_SIMD_STRING
+#undef LE_SIMD_STRING_
+#undef LE_SIMD_NAME
+#undef LE_SIMD_CONCAT
+#undef LE_SIMD_CONCAT_
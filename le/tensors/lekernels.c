@@ -0,0 +1,437 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "lekernels.h"
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <le/lecpu.h>
+#ifdef LE_CPU_X86
+#   include <immintrin.h>
+#endif
+
+/// @note: Rounds to nearest integer, valid for |a| < 2^22
+static inline float
+le_round_scalar(float a)
+{
+    return (a + 12582912.0f) - 12582912.0f;
+}
+
+/// @note: 2^n for integer n in [-126, 127], NaN gives garbage instead of undefined conversion
+static inline float
+le_pow2_scalar(float n)
+{
+    int32_t exponent = n == n ? (int32_t)n : 0;
+    uint32_t bits = (uint32_t)(exponent + 127) << 23;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/// @note: Unbiased exponent of positive normal number
+static inline float
+le_exponent_scalar(float a)
+{
+    uint32_t bits;
+    memcpy(&bits, &a, sizeof(bits));
+    return (float)((int32_t)(bits >> 23) - 127);
+}
+
+/// @note: Significand of positive normal number, in [1, 2)
+static inline float
+le_mantissa_scalar(float a)
+{
+    uint32_t bits;
+    memcpy(&bits, &a, sizeof(bits));
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/// @note: Portable variant is the same template instantiated with one-lane "vectors".
+/// Compiler is still free to auto-vectorize it for baseline instruction set.
+#define LE_SIMD_SUFFIX scalar
+#define LE_SIMD_ATTRIBUTES
+#define LE_VEC float
+#define LE_VEC_WIDTH 1
+#define LE_VEC_LOAD(p) (*(p))
+#define LE_VEC_STORE(p, v) (*(p) = (v))
+#define LE_VEC_SET1(x) (x)
+#define LE_VEC_ZERO() 0.0f
+#define LE_VEC_ADD(a, b) ((a) + (b))
+#define LE_VEC_SUB(a, b) ((a) - (b))
+#define LE_VEC_MUL(a, b) ((a) * (b))
+#define LE_VEC_DIV(a, b) ((a) / (b))
+#define LE_VEC_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LE_VEC_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define LE_VEC_ABS(a) fabsf(a)
+#define LE_VEC_GT_ONE(a, b) ((a) > (b) ? 1.0f : 0.0f)
+#define LE_VEC_EQ_ONE(a, b) ((a) == (b) ? 1.0f : 0.0f)
+#define LE_VEC_REDUCE_ADD(v) (v)
+#define LE_VEC_REDUCE_MAX(v) (v)
+#define LE_VEC_REDUCE_MIN(v) (v)
+#define LE_VEC_ROUND(a) le_round_scalar(a)
+#define LE_VEC_POW2(n) le_pow2_scalar(n)
+#define LE_VEC_EXPONENT(a) le_exponent_scalar(a)
+#define LE_VEC_MANTISSA(a) le_mantissa_scalar(a)
+#define LE_VEC_SELECT_LT(a, b, x, y) ((a) < (b) ? (x) : (y))
+#define LE_VEC_LOAD_F16(p) le_f16_to_f32(*(p))
+#define LE_VEC_STORE_F16(p, v) (*(p) = le_f32_to_f16(v))
+#define LE_VEC_STORE_U8(p, v) (*(p) = (uint8_t)(v))
+#define LE_VEC_LOAD_U8(p) ((float)*(p))
+#include "lekernels-simd.h"
+#undef LE_SIMD_SUFFIX
+#undef LE_SIMD_ATTRIBUTES
+#undef LE_VEC
+#undef LE_VEC_WIDTH
+#undef LE_VEC_LOAD
+#undef LE_VEC_STORE
+#undef LE_VEC_SET1
+#undef LE_VEC_ZERO
+#undef LE_VEC_ADD
+#undef LE_VEC_SUB
+#undef LE_VEC_MUL
+#undef LE_VEC_DIV
+#undef LE_VEC_MAX
+#undef LE_VEC_MIN
+#undef LE_VEC_ABS
+#undef LE_VEC_GT_ONE
+#undef LE_VEC_EQ_ONE
+#undef LE_VEC_REDUCE_ADD
+#undef LE_VEC_REDUCE_MAX
+#undef LE_VEC_REDUCE_MIN
+#undef LE_VEC_ROUND
+#undef LE_VEC_POW2
+#undef LE_VEC_EXPONENT
+#undef LE_VEC_MANTISSA
+#undef LE_VEC_SELECT_LT
+#undef LE_VEC_LOAD_F16
+#undef LE_VEC_STORE_F16
+#undef LE_VEC_STORE_U8
+#undef LE_VEC_LOAD_U8
+
+#ifdef LE_CPU_X86
+
+__attribute__((target("sse4.2")))
+static inline float
+le_reduce_add_sse42(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse4.2")))
+static inline float
+le_reduce_max_sse42(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse4.2")))
+static inline float
+le_reduce_min_sse42(__m128 v)
+{
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+/// @note: SSE4.2 does not imply F16C, half precision lanes are converted one by one
+__attribute__((target("sse4.2")))
+static inline __m128
+le_load_f16_sse42(const lehalf *p)
+{
+    return _mm_setr_ps(le_f16_to_f32(p[0]), le_f16_to_f32(p[1]), le_f16_to_f32(p[2]), le_f16_to_f32(p[3]));
+}
+
+__attribute__((target("sse4.2")))
+static inline void
+le_store_f16_sse42(lehalf *p, __m128 v)
+{
+    float lanes[4];
+    _mm_storeu_ps(lanes, v);
+    for (unsigned i = 0; i < 4; i++)
+        p[i] = le_f32_to_f16(lanes[i]);
+}
+
+__attribute__((target("sse4.2")))
+static inline void
+le_store_u8_sse42(uint8_t *p, __m128 v)
+{
+    __m128i lanes = _mm_cvtps_epi32(v);
+    lanes = _mm_packus_epi16(_mm_packus_epi32(lanes, lanes), lanes);
+    int32_t bytes = _mm_cvtsi128_si32(lanes);
+    memcpy(p, &bytes, sizeof(bytes));
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128
+le_load_u8_sse42(const uint8_t *p)
+{
+    int32_t bytes;
+    memcpy(&bytes, p, sizeof(bytes));
+    return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+}
+
+#define LE_SIMD_SUFFIX sse42
+#define LE_SIMD_ATTRIBUTES __attribute__((target("sse4.2")))
+#define LE_VEC __m128
+#define LE_VEC_WIDTH 4
+#define LE_VEC_LOAD(p) _mm_loadu_ps(p)
+#define LE_VEC_STORE(p, v) _mm_storeu_ps(p, v)
+#define LE_VEC_SET1(x) _mm_set1_ps(x)
+#define LE_VEC_ZERO() _mm_setzero_ps()
+#define LE_VEC_ADD(a, b) _mm_add_ps(a, b)
+#define LE_VEC_SUB(a, b) _mm_sub_ps(a, b)
+#define LE_VEC_MUL(a, b) _mm_mul_ps(a, b)
+#define LE_VEC_DIV(a, b) _mm_div_ps(a, b)
+#define LE_VEC_MAX(a, b) _mm_max_ps(a, b)
+#define LE_VEC_MIN(a, b) _mm_min_ps(a, b)
+#define LE_VEC_ABS(a) _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)))
+#define LE_VEC_GT_ONE(a, b) _mm_and_ps(_mm_cmpgt_ps(a, b), _mm_set1_ps(1.0f))
+#define LE_VEC_EQ_ONE(a, b) _mm_and_ps(_mm_cmpeq_ps(a, b), _mm_set1_ps(1.0f))
+#define LE_VEC_REDUCE_ADD(v) le_reduce_add_sse42(v)
+#define LE_VEC_REDUCE_MAX(v) le_reduce_max_sse42(v)
+#define LE_VEC_REDUCE_MIN(v) le_reduce_min_sse42(v)
+#define LE_VEC_ROUND(a) _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define LE_VEC_POW2(n) _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23))
+#define LE_VEC_EXPONENT(a) _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(a), 23), _mm_set1_epi32(127)))
+#define LE_VEC_MANTISSA(a) _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(_mm_castps_si128(a), _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)))
+#define LE_VEC_SELECT_LT(a, b, x, y) _mm_blendv_ps(y, x, _mm_cmplt_ps(a, b))
+#define LE_VEC_LOAD_F16(p) le_load_f16_sse42(p)
+#define LE_VEC_STORE_F16(p, v) le_store_f16_sse42(p, v)
+#define LE_VEC_STORE_U8(p, v) le_store_u8_sse42(p, v)
+#define LE_VEC_LOAD_U8(p) le_load_u8_sse42(p)
+#include "lekernels-simd.h"
+#undef LE_SIMD_SUFFIX
+#undef LE_SIMD_ATTRIBUTES
+#undef LE_VEC
+#undef LE_VEC_WIDTH
+#undef LE_VEC_LOAD
+#undef LE_VEC_STORE
+#undef LE_VEC_SET1
+#undef LE_VEC_ZERO
+#undef LE_VEC_ADD
+#undef LE_VEC_SUB
+#undef LE_VEC_MUL
+#undef LE_VEC_DIV
+#undef LE_VEC_MAX
+#undef LE_VEC_MIN
+#undef LE_VEC_ABS
+#undef LE_VEC_GT_ONE
+#undef LE_VEC_EQ_ONE
+#undef LE_VEC_REDUCE_ADD
+#undef LE_VEC_REDUCE_MAX
+#undef LE_VEC_REDUCE_MIN
+#undef LE_VEC_ROUND
+#undef LE_VEC_POW2
+#undef LE_VEC_EXPONENT
+#undef LE_VEC_MANTISSA
+#undef LE_VEC_SELECT_LT
+#undef LE_VEC_LOAD_F16
+#undef LE_VEC_STORE_F16
+#undef LE_VEC_STORE_U8
+#undef LE_VEC_LOAD_U8
+
+__attribute__((target("avx2")))
+static inline float
+le_reduce_add_avx2(__m256 v)
+{
+    __m128 r = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+    r = _mm_add_ss(r, _mm_shuffle_ps(r, r, 1));
+    return _mm_cvtss_f32(r);
+}
+
+__attribute__((target("avx2")))
+static inline float
+le_reduce_max_avx2(__m256 v)
+{
+    return le_reduce_max_sse42(_mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+__attribute__((target("avx2")))
+static inline float
+le_reduce_min_avx2(__m256 v)
+{
+    return le_reduce_min_sse42(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+__attribute__((target("avx2")))
+static inline void
+le_store_u8_avx2(uint8_t *p, __m256 v)
+{
+    __m256i lanes = _mm256_cvtps_epi32(v);
+    __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(words, words));
+}
+
+#define LE_SIMD_SUFFIX avx2
+#define LE_SIMD_ATTRIBUTES __attribute__((target("avx2,f16c")))
+#define LE_VEC __m256
+#define LE_VEC_WIDTH 8
+#define LE_VEC_LOAD(p) _mm256_loadu_ps(p)
+#define LE_VEC_STORE(p, v) _mm256_storeu_ps(p, v)
+#define LE_VEC_SET1(x) _mm256_set1_ps(x)
+#define LE_VEC_ZERO() _mm256_setzero_ps()
+#define LE_VEC_ADD(a, b) _mm256_add_ps(a, b)
+#define LE_VEC_SUB(a, b) _mm256_sub_ps(a, b)
+#define LE_VEC_MUL(a, b) _mm256_mul_ps(a, b)
+#define LE_VEC_DIV(a, b) _mm256_div_ps(a, b)
+#define LE_VEC_MAX(a, b) _mm256_max_ps(a, b)
+#define LE_VEC_MIN(a, b) _mm256_min_ps(a, b)
+#define LE_VEC_ABS(a) _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)))
+#define LE_VEC_GT_ONE(a, b) _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ), _mm256_set1_ps(1.0f))
+#define LE_VEC_EQ_ONE(a, b) _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ), _mm256_set1_ps(1.0f))
+#define LE_VEC_REDUCE_ADD(v) le_reduce_add_avx2(v)
+#define LE_VEC_REDUCE_MAX(v) le_reduce_max_avx2(v)
+#define LE_VEC_REDUCE_MIN(v) le_reduce_min_avx2(v)
+#define LE_VEC_ROUND(a) _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define LE_VEC_POW2(n) _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23))
+#define LE_VEC_EXPONENT(a) _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(a), 23), _mm256_set1_epi32(127)))
+#define LE_VEC_MANTISSA(a) _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(_mm256_castps_si256(a), _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)))
+#define LE_VEC_SELECT_LT(a, b, x, y) _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ))
+#define LE_VEC_LOAD_F16(p) _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(p)))
+#define LE_VEC_STORE_F16(p, v) _mm_storeu_si128((__m128i *)(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT))
+#define LE_VEC_STORE_U8(p, v) le_store_u8_avx2(p, v)
+#define LE_VEC_LOAD_U8(p) _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p))))
+#include "lekernels-simd.h"
+#undef LE_SIMD_SUFFIX
+#undef LE_SIMD_ATTRIBUTES
+#undef LE_VEC
+#undef LE_VEC_WIDTH
+#undef LE_VEC_LOAD
+#undef LE_VEC_STORE
+#undef LE_VEC_SET1
+#undef LE_VEC_ZERO
+#undef LE_VEC_ADD
+#undef LE_VEC_SUB
+#undef LE_VEC_MUL
+#undef LE_VEC_DIV
+#undef LE_VEC_MAX
+#undef LE_VEC_MIN
+#undef LE_VEC_ABS
+#undef LE_VEC_GT_ONE
+#undef LE_VEC_EQ_ONE
+#undef LE_VEC_REDUCE_ADD
+#undef LE_VEC_REDUCE_MAX
+#undef LE_VEC_REDUCE_MIN
+#undef LE_VEC_ROUND
+#undef LE_VEC_POW2
+#undef LE_VEC_EXPONENT
+#undef LE_VEC_MANTISSA
+#undef LE_VEC_SELECT_LT
+#undef LE_VEC_LOAD_F16
+#undef LE_VEC_STORE_F16
+#undef LE_VEC_STORE_U8
+#undef LE_VEC_LOAD_U8
+
+#define LE_SIMD_SUFFIX avx512
+#define LE_SIMD_ATTRIBUTES __attribute__((target("avx512f")))
+#define LE_VEC __m512
+#define LE_VEC_WIDTH 16
+#define LE_VEC_LOAD(p) _mm512_loadu_ps(p)
+#define LE_VEC_STORE(p, v) _mm512_storeu_ps(p, v)
+#define LE_VEC_SET1(x) _mm512_set1_ps(x)
+#define LE_VEC_ZERO() _mm512_setzero_ps()
+#define LE_VEC_ADD(a, b) _mm512_add_ps(a, b)
+#define LE_VEC_SUB(a, b) _mm512_sub_ps(a, b)
+#define LE_VEC_MUL(a, b) _mm512_mul_ps(a, b)
+#define LE_VEC_DIV(a, b) _mm512_div_ps(a, b)
+#define LE_VEC_MAX(a, b) _mm512_max_ps(a, b)
+#define LE_VEC_MIN(a, b) _mm512_min_ps(a, b)
+#define LE_VEC_ABS(a) _mm512_abs_ps(a)
+#define LE_VEC_GT_ONE(a, b) _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), _mm512_set1_ps(1.0f))
+#define LE_VEC_EQ_ONE(a, b) _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ), _mm512_set1_ps(1.0f))
+#define LE_VEC_REDUCE_ADD(v) _mm512_reduce_add_ps(v)
+#define LE_VEC_REDUCE_MAX(v) _mm512_reduce_max_ps(v)
+#define LE_VEC_REDUCE_MIN(v) _mm512_reduce_min_ps(v)
+#define LE_VEC_ROUND(a) _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define LE_VEC_POW2(n) _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23))
+#define LE_VEC_EXPONENT(a) _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(a), 23), _mm512_set1_epi32(127)))
+#define LE_VEC_MANTISSA(a) _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x007fffff)), _mm512_set1_epi32(0x3f800000)))
+#define LE_VEC_SELECT_LT(a, b, x, y) _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x)
+#define LE_VEC_LOAD_F16(p) _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)(p)))
+#define LE_VEC_STORE_F16(p, v) _mm256_storeu_si256((__m256i *)(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT))
+#define LE_VEC_STORE_U8(p, v) _mm_storeu_si128((__m128i *)(p), _mm512_cvtusepi32_epi8(_mm512_cvtps_epi32(v)))
+#define LE_VEC_LOAD_U8(p) _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *)(p))))
+#include "lekernels-simd.h"
+#undef LE_SIMD_SUFFIX
+#undef LE_SIMD_ATTRIBUTES
+#undef LE_VEC
+#undef LE_VEC_WIDTH
+#undef LE_VEC_LOAD
+#undef LE_VEC_STORE
+#undef LE_VEC_SET1
+#undef LE_VEC_ZERO
+#undef LE_VEC_ADD
+#undef LE_VEC_SUB
+#undef LE_VEC_MUL
+#undef LE_VEC_DIV
+#undef LE_VEC_MAX
+#undef LE_VEC_MIN
+#undef LE_VEC_ABS
+#undef LE_VEC_GT_ONE
+#undef LE_VEC_EQ_ONE
+#undef LE_VEC_REDUCE_ADD
+#undef LE_VEC_REDUCE_MAX
+#undef LE_VEC_REDUCE_MIN
+#undef LE_VEC_ROUND
+#undef LE_VEC_POW2
+#undef LE_VEC_EXPONENT
+#undef LE_VEC_MANTISSA
+#undef LE_VEC_SELECT_LT
+#undef LE_VEC_LOAD_F16
+#undef LE_VEC_STORE_F16
+#undef LE_VEC_STORE_U8
+#undef LE_VEC_LOAD_U8
+
+#endif
+
+static LeMathAccuracy le_math_accuracy = LE_MATH_ACCURACY_FAITHFUL;
+
+void
+le_set_math_accuracy(LeMathAccuracy accuracy)
+{
+    le_math_accuracy = accuracy;
+}
+
+LeMathAccuracy
+le_get_math_accuracy(void)
+{
+    return le_math_accuracy;
+}
+
+const LeKernels *
+le_kernels_get_for_features(unsigned features, LeMathAccuracy accuracy)
+{
+    bool fast = accuracy == LE_MATH_ACCURACY_FAST;
+#ifdef LE_CPU_X86
+    if (features & LE_CPU_FEATURE_AVX512F)
+        return fast ? &le_kernels_fast_avx512 : &le_kernels_avx512;
+    if ((features & LE_CPU_FEATURE_AVX2) && (features & LE_CPU_FEATURE_F16C))
+        return fast ? &le_kernels_fast_avx2 : &le_kernels_avx2;
+    if (features & LE_CPU_FEATURE_SSE4_2)
+        return fast ? &le_kernels_fast_sse42 : &le_kernels_sse42;
+#endif
+    return fast ? &le_kernels_fast_scalar : &le_kernels_scalar;
+}
+
+const LeKernels *
+le_kernels_get(void)
+{
+    static const LeKernels *kernels[2] = { NULL, NULL };
+
+    LeMathAccuracy accuracy = le_math_accuracy;
+    if (kernels[accuracy] == NULL)
+    {
+        kernels[accuracy] = le_kernels_get_for_features(le_cpu_get_features(), accuracy);
+    }
+
+    return kernels[accuracy];
+}
@@ -0,0 +1,116 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Element-wise CPU kernels with implementations selected at runtime by CPU features */
+
+#ifndef __LEKERNELS_H__
+#define __LEKERNELS_H__
+
+#include <stddef.h>
+#include <le/lemacros.h>
+#include "letype.h"
+
+LE_BEGIN_DECLS
+
+/// @note: All kernels operate on contiguous arrays of n elements, in place on the first argument.
+/// No alignment is required.
+typedef struct LeKernels
+{
+    const char *name;
+
+    /// a[i] += b[i]
+    void  (*add_f32)            (float *a, const float *b, size_t n);
+    /// a[i] -= b[i]
+    void  (*sub_f32)            (float *a, const float *b, size_t n);
+    /// a[i] *= b[i]
+    void  (*mul_f32)            (float *a, const float *b, size_t n);
+    /// a[i] /= b[i]
+    void  (*div_f32)            (float *a, const float *b, size_t n);
+    /// a[i] = max(a[i], b[i])
+    void  (*max_f32)            (float *a, const float *b, size_t n);
+    /// a[i] = min(a[i], b[i])
+    void  (*min_f32)            (float *a, const float *b, size_t n);
+    /// a[i] = a[i] == b[i] ? 1 : 0
+    void  (*equal_f32)          (float *a, const float *b, size_t n);
+    /// a[i] = a[i] > b[i] ? 1 : 0
+    void  (*greater_f32)        (float *a, const float *b, size_t n);
+    /// a[i] = a[i] < b[i] ? 1 : 0
+    void  (*less_f32)           (float *a, const float *b, size_t n);
+    /// a[i] -= scale * b[i]
+    void  (*sub_scaled_f32)     (float *a, float scale, const float *b, size_t n);
+    /// a[i] += b[i] * c[i]
+    void  (*mul_add_f32)        (float *a, const float *b, const float *c, size_t n);
+    /// where a[i] < b[i]: a[i] = b[i], index[i] = b_index
+    void  (*max_index_f32)      (float *a, float *index, const float *b, float b_index, size_t n);
+    /// a[i] += scalar
+    void  (*add_scalar_f32)     (float *a, float scalar, size_t n);
+    /// a[i] *= scalar
+    void  (*mul_scalar_f32)     (float *a, float scalar, size_t n);
+    /// a[i] = a[i] * a[i]
+    void  (*sqr_f32)            (float *a, size_t n);
+    /// a[i] = 1 - a[i]
+    void  (*one_minus_f32)      (float *a, size_t n);
+    /// a[i] = a[i] * (1 - a[i])
+    void  (*x_minus_sqr_x_f32)  (float *a, size_t n);
+    /// a[i] = a[i] > scalar ? 1 : 0
+    void  (*gt_f32)             (float *a, float scalar, size_t n);
+    /// a[i] = a[i] > 0 ? 1 : -1
+    void  (*sgn_f32)            (float *a, size_t n);
+    /// a[i] = max(a[i], 0)
+    void  (*relu_f32)           (float *a, size_t n);
+    /// a[i] = exp(a[i])
+    void  (*exp_f32)            (float *a, size_t n);
+    /// a[i] = log(a[i])
+    void  (*log_f32)            (float *a, size_t n);
+    /// a[i] = tanh(a[i])
+    void  (*tanh_f32)           (float *a, size_t n);
+    /// a[i] = 1 / (1 + exp(-a[i]))
+    void  (*sigmoid_f32)        (float *a, size_t n);
+    /// a[i] = sigmoid(a[i]) * (1 - sigmoid(a[i]))
+    void  (*sigmoid_prime_f32)  (float *a, size_t n);
+
+    float (*sum_f32)            (const float *a, size_t n);
+    /// max of a[i], n must not be 0
+    float (*reduce_max_f32)     (const float *a, size_t n);
+    /// min of a[i], n must not be 0
+    float (*reduce_min_f32)     (const float *a, size_t n);
+    float (*dot_f32)            (const float *a, const float *b, size_t n);
+    float (*sad_f32)            (const float *a, const float *b, size_t n);
+
+    /// destination[i] = source[i], converted between half and single precision
+    void  (*f16_to_f32)         (float *destination, const lehalf *source, size_t n);
+    void  (*f32_to_f16)         (lehalf *destination, const float *source, size_t n);
+    /// destination[i] = clamp(round(source[i] * inverse_scale) + zero_point, 0, 255), ties to even
+    void  (*quantize_u8)        (uint8_t *destination, const float *source, float inverse_scale,
+                                 float zero_point, size_t n);
+    /// destination[i] = source[i] * scale + offset
+    void  (*u8_to_f32)          (float *destination, const uint8_t *source, float scale,
+                                 float offset, size_t n);
+} LeKernels;
+
+/// @note: Accuracy of exp, log, tanh and sigmoid kernels
+typedef enum LeMathAccuracy
+{
+    /// Within few ulp of correctly rounded result
+    LE_MATH_ACCURACY_FAITHFUL,
+    /// Relative error about 1e-4, enough for training
+    LE_MATH_ACCURACY_FAST
+} LeMathAccuracy;
+
+/// @note: Selects accuracy of kernels returned by le_kernels_get, faithful by default.
+/// Must not be called while other threads use kernels.
+void               le_set_math_accuracy                    (LeMathAccuracy          accuracy);
+
+LeMathAccuracy     le_get_math_accuracy                    (void);
+
+/// @note: Kernels for the host with current math accuracy, chosen once on first use
+const LeKernels *  le_kernels_get                          (void);
+
+/// @note: Best kernels available with given LeCpuFeature bitmask, AVX2 ones also need F16C.
+/// Used to cross-check all implementations supported by the host.
+const LeKernels *  le_kernels_get_for_features             (unsigned                features,
+                                                            LeMathAccuracy          accuracy);
+
+LE_END_DECLS
+
+#endif
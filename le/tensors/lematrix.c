@@ -9,6 +9,11 @@
 #include <string.h>
 #include <math.h>
 #include "letensor-imp.h"
+#include "legemm.h"
+#include "lereduce.h"
+#include "lekernels.h"
+#include <le/leparallel.h>
+#include <le/lemem.h>
 #ifdef __APPLE__
 #   include "../backends/accelerate/leaccelerate.h"
 #elif defined(HAVE_OPENBLAS)
@@ -21,6 +26,36 @@
 #   include "../backends/metal/lemetal.h"
 #endif
 
+/// @note: Matrix operations are split between threads in parts of at least this many elements
+#define LE_MATRIX_PARALLEL_GRAIN 32768
+
+/// @note: Softmax processes this many examples at once, class by class, with vector kernels
+#define LE_MATRIX_SOFTMAX_BLOCK 256
+
+/// @note: Transposition is done in square tiles so both source and destination are accessed
+/// in cache-friendly order
+#define LE_MATRIX_TRANSPOSE_TILE 32
+
+static size_t
+le_matrix_parallel_grain(size_t work_per_item)
+{
+    return work_per_item >= LE_MATRIX_PARALLEL_GRAIN ? 1 : LE_MATRIX_PARALLEL_GRAIN / (work_per_item ? work_per_item : 1);
+}
+
+/// @note: Destination of _into functions must be CPU matrix of expected type and size
+static void
+le_matrix_check_destination(const LeTensor *destination, LeType type, unsigned height, unsigned width)
+{
+    assert(destination);
+    assert(destination->device_type == LE_DEVICE_TYPE_CPU);
+    assert(destination->element_type == type);
+    assert(destination->shape->num_dimensions == 2);
+    assert(destination->shape->sizes[0] == height);
+    assert(destination->shape->sizes[1] == width);
+    /// @note: Rows of destination are written as whole
+    assert(width <= 1 || destination->strides[1] == 1);
+}
+
 unsigned
 le_matrix_get_width(const LeTensor *self)
 {
@@ -46,7 +81,7 @@ le_matrix_at_f32(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((float *)self->data)[y * self->stride + x];
+    return ((float *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 double
@@ -58,7 +93,7 @@ le_matrix_at_f64(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((double *)self->data)[y * self->stride + x];
+    return ((double *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 int8_t
@@ -70,7 +105,7 @@ le_matrix_at_i8(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((int8_t *)self->data)[y * self->stride + x];
+    return ((int8_t *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 int16_t
@@ -82,7 +117,7 @@ le_matrix_at_i16(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((int16_t *)self->data)[y * self->stride + x];
+    return ((int16_t *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 int32_t
@@ -94,7 +129,7 @@ le_matrix_at_i32(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((int32_t *)self->data)[y * self->stride + x];
+    return ((int32_t *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 uint32_t
@@ -106,7 +141,7 @@ le_matrix_at_u32(const LeTensor *self, unsigned y, unsigned x)
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
     
-    return ((uint32_t *)self->data)[y * self->stride + x];
+    return ((uint32_t *)self->data)[le_matrix_offset(self, y, x)];
 }
 
 void
@@ -115,31 +150,10 @@ le_matrix_add(LeTensor *self, const LeTensor *another)
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
     assert(another->device_type == LE_DEVICE_TYPE_CPU);
     assert(self->element_type == LE_TYPE_FLOAT32);
-    assert(self->stride == le_shape_get_size(self->shape, -1));
-    assert(another->stride == le_shape_get_size(another->shape, -1));
     assert(self->shape->num_dimensions == 2);
-    
-    /// @note: Add horizontal broadcasting
-    assert(self->shape->sizes[0] == another->shape->sizes[0]);
 
-    if (le_shape_equal(self->shape, another->shape))
-    {
-        le_tensor_add(self, another);
-    }
-    else if (another->shape->sizes[1] == 1)
-    {
-        for (uint32_t y = 0; y < self->shape->sizes[0]; y++)
-        {
-            for (uint32_t x = 0; x < self->shape->sizes[1]; x++)
-            {
-                ((float *)self->data)[y * self->stride + x] += ((float *)another->data)[y * another->stride];
-            }
-        }
-    }
-    else
-    {
-        assert(false);
-    }
+    /// @note: Column vector is added to every column through zero stride view
+    le_tensor_apply_binary(self, LE_BINARY_OP_ADD, another);
 }
 
 void
@@ -151,10 +165,9 @@ le_matrix_set_i8(LeTensor *self, unsigned y, unsigned x, int8_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((int8_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((int8_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -166,10 +179,9 @@ le_matrix_set_u8(LeTensor *self, unsigned y, unsigned x, uint8_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((uint8_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((uint8_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -181,10 +193,9 @@ le_matrix_set_i16(LeTensor *self, unsigned y, unsigned x, int16_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((int16_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((int16_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -196,10 +207,9 @@ le_matrix_set_u16(LeTensor *self, unsigned y, unsigned x, uint16_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((uint16_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((uint16_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -211,10 +221,9 @@ le_matrix_set_i32(LeTensor *self, unsigned y, unsigned x, int32_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((int32_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((int32_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -226,10 +235,9 @@ le_matrix_set_u32(LeTensor *self, unsigned y, unsigned x, uint32_t value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((uint32_t *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((uint32_t *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -241,10 +249,9 @@ le_matrix_set_f16(LeTensor *self, unsigned y, unsigned x, lehalf value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((lehalf *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((lehalf *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -256,10 +263,9 @@ le_matrix_set_f32(LeTensor *self, unsigned y, unsigned x, float value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((float *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((float *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 void
@@ -271,10 +277,9 @@ le_matrix_set_f64(LeTensor *self, unsigned y, unsigned x, double value)
     
     assert(y < self->shape->sizes[0]);
     assert(x < self->shape->sizes[1]);
-    assert(x < self->stride);
     
-    /// @todo: Take stride into account
-    ((double *)self->data)[y * self->stride + x] = value;
+    le_tensor_make_writable(self);
+    ((double *)self->data)[le_matrix_offset(self, y, x)] = value;
 }
 
 LeTensor *
@@ -284,13 +289,15 @@ le_matrix_new_identity(LeType type, unsigned size)
     unsigned y;
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = LE_TYPE_FLOAT32;
-    self->shape = le_shape_new(2, size, size);
-    self->stride = size;
+    le_tensor_init_shape(self, 2, (uint32_t[]){ size, size });
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(size * size * sizeof(float));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(size * size * sizeof(float));
     
     for (y = 0; y < size; y++)
     {
@@ -340,13 +347,15 @@ le_matrix_new_uninitialized(LeType type, unsigned height, unsigned width)
 {
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = type;
-    self->shape = le_shape_new(2, height, width);
-    self->stride = width;
+    le_tensor_init_shape(self, 2, (uint32_t[]){ height, width });
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(height * width * le_type_size(self->element_type));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(le_tensor_get_data_size(self));
     
     return self;
 }
@@ -354,18 +363,20 @@ le_matrix_new_uninitialized(LeType type, unsigned height, unsigned width)
 LeTensor *
 le_matrix_new_zeros(LeType type, unsigned height, unsigned width)
 {
-    unsigned i;
-    unsigned elements_count;
+    size_t i;
+    size_t elements_count;
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
-    self->shape = le_shape_new(2, height, width);
+    le_tensor_init_shape(self, 2, (uint32_t[]){ height, width });
     self->element_type = LE_TYPE_FLOAT32;
-    self->stride = width;
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(height * width * sizeof(float));
-    elements_count = height * width;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    elements_count = (size_t)height * width;
+    self->data = le_alloc(elements_count * sizeof(float));
     
     for (i = 0; i < elements_count; i++)
     {
@@ -411,18 +422,20 @@ le_matrix_new_zeros(LeType type, unsigned height, unsigned width)
 LeTensor *
 le_matrix_new_rand_f32(LeDistribution distribution, unsigned height, unsigned width)
 {
-    unsigned i;
-    unsigned elements_count;
+    size_t i;
+    size_t elements_count;
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = LE_TYPE_FLOAT32;
-    self->shape = le_shape_new(2, height, width);
-    self->stride = width;
+    le_tensor_init_shape(self, 2, (uint32_t[]){ height, width });
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    elements_count = height * width;
-    self->data = malloc(elements_count * sizeof(float));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    elements_count = (size_t)height * width;
+    self->data = le_alloc(elements_count * sizeof(float));
     
     for (i = 0; i < elements_count; i++)
     {
@@ -432,85 +445,106 @@ le_matrix_new_rand_f32(LeDistribution distribution, unsigned height, unsigned wi
     return self;
 }
 
-#define TRNASPOSE(type) for (y = 0; y < self->shape->sizes[0]; y++) \
+typedef struct LeMatrixTransposeTask
+{
+    const LeTensor *a;
+    LeTensor       *self;
+} LeMatrixTransposeTask;
+
+#define TRANSPOSE(type) for (unsigned x0 = 0; x0 < width; x0 += LE_MATRIX_TRANSPOSE_TILE) \
 { \
-    for (x = 0; x < self->shape->sizes[1]; x++) \
+    unsigned x1 = (x0 + LE_MATRIX_TRANSPOSE_TILE < width) ? x0 + LE_MATRIX_TRANSPOSE_TILE : width; \
+    for (size_t y = begin; y < end; y++) \
     { \
-        ((type *)self->data)[y * self->shape->sizes[1] + x] = ((type *)a->data)[x * a->stride + y]; \
+        for (unsigned x = x0; x < x1; x++) \
+        { \
+            ((type *)self->data)[le_matrix_offset(self, y, x)] = ((type *)a->data)[le_matrix_offset(a, x, y)]; \
+        } \
     } \
 }
 
-LeTensor *
-le_matrix_new_transpose(LeTensor *a)
+/// @note: Fills rows [begin, end) of transposed matrix
+static void
+le_matrix_transpose_rows(void *data, size_t begin, size_t end)
 {
-    assert(a->device_type == LE_DEVICE_TYPE_CPU);
-    assert(a->shape->num_dimensions == 2);
+    const LeMatrixTransposeTask *task = data;
+    const LeTensor *a = task->a;
+    LeTensor *self = task->self;
+    unsigned width = self->shape->sizes[1];
 
-    unsigned x;
-    unsigned y;
-    LeTensor *self;
-    
-    self = malloc(sizeof(struct LeTensor));
-    self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = a->element_type;
-    self->shape = le_shape_new(2, a->shape->sizes[1], a->shape->sizes[0]);
-    self->stride = le_shape_get_size(self->shape, -1);
-    self->owns_data = true;
-    self->data = malloc(le_shape_get_elements_count(self->shape) * le_type_size(self->element_type));
-    
     switch (le_type_size(self->element_type))
     {
     case 1:
-        TRNASPOSE(uint8_t);
+        TRANSPOSE(uint8_t);
         break;
 
     case 2:
-        TRNASPOSE(uint16_t);
+        TRANSPOSE(uint16_t);
         break;
 
     case 4:
-        TRNASPOSE(uint32_t);
+        TRANSPOSE(uint32_t);
         break;
 
     case 8:
-        TRNASPOSE(uint64_t);
+        TRANSPOSE(uint64_t);
         break;
 
     default:
         break;
     }
+}
+
+#undef TRANSPOSE
+
+void
+le_matrix_transpose_into(LeTensor *destination, const LeTensor *a)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(a->shape->num_dimensions == 2);
+    le_matrix_check_destination(destination, a->element_type, a->shape->sizes[1], a->shape->sizes[0]);
+    assert(destination->data != a->data);
+
+    le_tensor_make_writable(destination);
+    LeMatrixTransposeTask task = { a, destination };
+    le_parallel_for(destination->shape->sizes[0], le_matrix_parallel_grain(destination->shape->sizes[1]),
+                    le_matrix_transpose_rows, &task);
+}
+
+LeTensor *
+le_matrix_new_transpose(LeTensor *a)
+{
+    assert(a->shape->num_dimensions == 2);
+
+    LeTensor *self = le_matrix_new_uninitialized(a->element_type, a->shape->sizes[1], a->shape->sizes[0]);
+    le_matrix_transpose_into(self, a);
     
     return self;
 }
 
-#undef TRANSPOSE
+void
+le_matrix_sum_into(LeTensor *destination, const LeTensor *a, unsigned dimension)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(a->element_type == LE_TYPE_FLOAT32);
+    assert(a->shape->num_dimensions == 2);
+    assert((dimension == 0) || (dimension == 1));
+    le_matrix_check_destination(destination, LE_TYPE_FLOAT32,
+                                (dimension == 0) ? 1 : a->shape->sizes[0],
+                                (dimension == 1) ? 1 : a->shape->sizes[1]);
 
+    le_tensor_reduce_into(destination, a, LE_REDUCE_OP_SUM, LE_REDUCE_AXIS(dimension));
+}
 
 LeTensor *
 le_matrix_new_sum(const LeTensor *a, unsigned dimension)
 {
-    /// @todo: Take stride into account
-    assert(a->device_type == LE_DEVICE_TYPE_CPU);
-        
     assert(a->shape->num_dimensions == 2);
     
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = LE_TYPE_FLOAT32;
-    self->shape = le_shape_new(2, a->shape->sizes[0], 1/*a->shape->sizes[1]*/);
-    self->stride = le_shape_get_size(self->shape, -1);
-    self->owns_data = true;
-    self->data = malloc(le_shape_get_elements_count(self->shape) * le_type_size(self->element_type));
-    
-    assert(/*(dimension == 0) || */(dimension == 1));
-    for (unsigned y = 0; y < a->shape->sizes[0]; y++)
-    {
-        ((float *)self->data)[y] = 0.0f;
-        for (unsigned x = 0; x < a->shape->sizes[1]; x++)
-        {
-            ((float *)self->data)[y] += ((float *)a->data)[y * a->shape->sizes[1] + x];
-        }
-    }
+    LeTensor *self = le_matrix_new_uninitialized(LE_TYPE_FLOAT32,
+                                                 (dimension == 0) ? 1 : a->shape->sizes[0],
+                                                 (dimension == 1) ? 1 : a->shape->sizes[1]);
+    le_matrix_sum_into(self, a, dimension);
 
     return self;
 }
@@ -518,7 +552,6 @@ le_matrix_new_sum(const LeTensor *a, unsigned dimension)
 LeTensor *
 le_matrix_new_one_hot(LeType type, const LeTensor *a, unsigned num_classes)
 {
-    /// @todo: Take stride into account
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(a->shape->num_dimensions == 2);
     assert(a->shape->sizes[0] == 1);
@@ -526,13 +559,15 @@ le_matrix_new_one_hot(LeType type, const LeTensor *a, unsigned num_classes)
     unsigned example, klass;
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = type;
-    self->shape = le_shape_new(2, num_classes, a->shape->sizes[1]);
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_init_shape(self, 2, (uint32_t[]){ num_classes, a->shape->sizes[1] });
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(le_shape_get_elements_count(self->shape) * le_type_size(self->element_type));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(le_tensor_get_data_size(self));
     
     for (example = 0; example < a->shape->sizes[1]; example++)
     {
@@ -578,6 +613,128 @@ le_matrix_new_one_hot(LeType type, const LeTensor *a, unsigned num_classes)
     return self;
 }
 
+void
+le_matrix_product_into(LeTensor *destination, const LeTensor *a, const LeTensor *b)
+{
+    le_matrix_product_full_into(destination, a, false, b, false);
+}
+
+/// @note: epilogue, if not NULL, is applied by built-in GEMM to tiles of destination as they are computed,
+/// and in separate pass after product of BLAS backend
+static void
+le_matrix_product_epilogue_into(LeTensor *destination, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b,
+                                const LeGemmEpilogue *epilogue)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(b->device_type == LE_DEVICE_TYPE_CPU);
+    assert(a->element_type == LE_TYPE_FLOAT32 || a->element_type == LE_TYPE_FLOAT16);
+    assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(a->shape->num_dimensions == 2);
+    assert(b->shape->num_dimensions == 2);
+
+    unsigned a_width = transpose_a ? a->shape->sizes[0] : a->shape->sizes[1];
+    unsigned a_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
+    unsigned b_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
+    unsigned b_height = transpose_b ? b->shape->sizes[1] : b->shape->sizes[0];
+
+    assert(a_width == b_height);
+    le_matrix_check_destination(destination, LE_TYPE_FLOAT32, a_height, b_width);
+    assert((destination->data != a->data) && (destination->data != b->data));
+    le_tensor_make_writable(destination);
+
+    /// @note: Views are passed to GEMM as is with their row stride or as transposed matrices.
+    /// Only views with gaps in both dimensions are copied.
+    bool layout_transpose;
+    size_t ld;
+    LeTensor *a_packed = NULL;
+    LeTensor *b_packed = NULL;
+    if (!le_matrix_get_gemm_layout(a, transpose_a, &layout_transpose, &ld))
+        a = a_packed = le_tensor_new_copy(a);
+    if (!le_matrix_get_gemm_layout(b, transpose_b, &layout_transpose, &ld))
+        b = b_packed = le_tensor_new_copy(b);
+
+#if defined(__APPLE__) || defined(HAVE_OPENBLAS)
+    /// @note: BLAS backends take single precision only, half precision A is widened first
+    if (a->element_type == LE_TYPE_FLOAT16)
+    {
+        LeTensor *a_single = le_tensor_new_cast(a, LE_TYPE_FLOAT32);
+        le_tensor_free(a_packed);
+        a = a_packed = a_single;
+    }
+#endif
+#ifdef __APPLE__
+    le_accelerate_matrix_product_into(destination, a, transpose_a, b, transpose_b);
+#elif defined(HAVE_OPENBLAS)
+    le_openblas_matrix_product_into(destination, a, transpose_a, b, transpose_b);
+#endif
+#if defined(__APPLE__) || defined(HAVE_OPENBLAS)
+    if (epilogue)
+    {
+        le_matrix_get_gemm_layout(destination, false, &layout_transpose, &ld);
+        le_gemm_apply_epilogue(epilogue, a_height, b_width, destination->data, ld);
+    }
+#else
+    bool layout_transpose_a, layout_transpose_b;
+    size_t lda, ldb, ldc;
+    le_matrix_get_gemm_layout(a, transpose_a, &layout_transpose_a, &lda);
+    le_matrix_get_gemm_layout(b, transpose_b, &layout_transpose_b, &ldb);
+    le_matrix_get_gemm_layout(destination, false, &layout_transpose, &ldc);
+    if (a->element_type == LE_TYPE_FLOAT16)
+        le_sgemm_a_f16(layout_transpose_a, layout_transpose_b, a_height, b_width, a_width,
+                       1.0f, a->data, lda, b->data, ldb,
+                       0.0f, epilogue, destination->data, ldc);
+    else
+        le_sgemm(layout_transpose_a, layout_transpose_b, a_height, b_width, a_width,
+                 1.0f, a->data, lda, b->data, ldb,
+                 0.0f, epilogue, destination->data, ldc);
+#endif
+
+    le_tensor_free(b_packed);
+    le_tensor_free(a_packed);
+}
+
+void
+le_matrix_product_full_into(LeTensor *destination, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+{
+    le_matrix_product_epilogue_into(destination, a, transpose_a, b, transpose_b, NULL);
+}
+
+void
+le_matrix_product_activation_into(LeTensor *destination, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b,
+                                  const LeTensor *bias, LeActivation activation)
+{
+    assert(activation != LE_ACTIVATION_SOFTMAX);
+
+    if ((bias == NULL) && (activation == LE_ACTIVATION_LINEAR))
+    {
+        le_matrix_product_epilogue_into(destination, a, transpose_a, b, transpose_b, NULL);
+        return;
+    }
+
+    LeTensor *bias_packed = NULL;
+    bool row_bias = false;
+    if (bias)
+    {
+        assert(bias->device_type == LE_DEVICE_TYPE_CPU);
+        assert(bias->shape->num_dimensions == 2);
+        unsigned height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
+        unsigned width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
+        row_bias = (bias->shape->sizes[0] == height) && (bias->shape->sizes[1] == 1);
+        assert(row_bias || ((bias->shape->sizes[0] == 1) && (bias->shape->sizes[1] == width)));
+        /// @note: GEMM reads bias as array, e.g. bias converted to half precision is widened first
+        bias = le_tensor_pack_f32(bias, &bias_packed);
+    }
+
+    LeGemmEpilogue epilogue = {
+        .row_bias = (bias && row_bias) ? bias->data : NULL,
+        .column_bias = (bias && !row_bias) ? bias->data : NULL,
+        .activation = activation
+    };
+    le_matrix_product_epilogue_into(destination, a, transpose_a, b, transpose_b, &epilogue);
+
+    le_tensor_free(bias_packed);
+}
+
 LeTensor *
 le_matrix_new_product(const LeTensor *a, const LeTensor *b)
 {
@@ -601,53 +758,17 @@ le_matrix_new_product_full(const LeTensor *a, bool transpose_a, const LeTensor *
 #endif
 
     case LE_DEVICE_TYPE_CPU:
-        /// @todo: Take stride into account
-#ifdef __APPLE__
-        return le_accelerate_matrix_new_product(a, transpose_a, b, transpose_b);
-#elif defined(HAVE_OPENBLAS)
-        return le_openblas_matrix_new_product(a, transpose_a, b, transpose_b);
-#else
-        assert(a->element_type == b->element_type);
-        assert(a->shape->num_dimensions == 2);
-        assert(b->shape->num_dimensions == 2);
         {
-            unsigned a_width = transpose_a ? a->shape->sizes[0] : a->shape->sizes[1];
-            unsigned a_height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
-            unsigned b_width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
-            unsigned b_height = transpose_b ? b->shape->sizes[1] : b->shape->sizes[0];
+            assert(a->shape->num_dimensions == 2);
+            assert(b->shape->num_dimensions == 2);
+            unsigned height = transpose_a ? a->shape->sizes[1] : a->shape->sizes[0];
+            unsigned width = transpose_b ? b->shape->sizes[0] : b->shape->sizes[1];
             
-            assert(a_width == b_height);
-                    
-            LeTensor *self = malloc(sizeof(struct LeTensor));
-            self->device_type = LE_DEVICE_TYPE_CPU;
-            self->element_type = a->element_type;
-            self->shape = le_shape_new(2, a_height, b_width);
-            self->stride = le_shape_get_size(self->shape, -1);
-            self->owns_data = true;
-            self->data = malloc(le_shape_get_elements_count(self->shape) * sizeof(float));
-            
-            for (unsigned y = 0; y < a_height; y++)
-            {
-                for (unsigned x = 0; x < b_width; x++)
-                {
-                    size_t self_index = y * self->stride + x;
-                    ((float *)self->data)[self_index] = 0.0f;
-                    for (unsigned i = 0; i < a_width; i++)
-                    {
-                        /// @note: Check indices
-                        size_t a_index = transpose_a ? i * a->stride + y : y * a->stride + i;
-                        float a_element = ((float *)a->data)[a_index];
-                        size_t b_index = transpose_b ? x * b->stride + i : i * b->stride + x;
-                        float b_element = ((float *)b->data)[b_index];
-                        float prod = a_element * b_element;
-                        ((float *)self->data)[self_index] += prod;
-                    }
-                }
-            }
+            LeTensor *self = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, height, width);
+            le_matrix_product_full_into(self, a, transpose_a, b, transpose_b);
             
             return self;
         }
-#endif
         
     default:
         assert(false);
@@ -657,6 +778,177 @@ le_matrix_new_product_full(const LeTensor *a, bool transpose_a, const LeTensor *
     return NULL;
 }
 
+/// @note: Batch size of rank 3 operand of batched product, rank 2 operand is single matrix
+static uint32_t
+le_tensor_get_batch_size(const LeTensor *tensor)
+{
+    return (tensor->shape->num_dimensions == 2) ? 1 : tensor->shape->sizes[0];
+}
+
+/// @note: View of matrix of operand used for given batch, single matrix is broadcast to every batch
+static LeTensor *
+le_tensor_view_init_batch(LeTensorView *view, const LeTensor *tensor, size_t batch)
+{
+    if (tensor->shape->num_dimensions == 2)
+        return le_tensor_view_init(view, tensor);
+    return le_tensor_view_init_pick(view, tensor, (tensor->shape->sizes[0] == 1) ? 0 : (uint32_t)batch);
+}
+
+#if defined(__APPLE__) || !defined(HAVE_OPENBLAS)
+typedef struct LeTensorBatchedProductTask
+{
+    LeTensor       *destination;
+    const LeTensor *a;
+    bool            transpose_a;
+    const LeTensor *b;
+    bool            transpose_b;
+} LeTensorBatchedProductTask;
+
+/// @note: Computes products of batches [begin, end)
+static void
+le_tensor_batched_product_range(void *data, size_t begin, size_t end)
+{
+    const LeTensorBatchedProductTask *task = data;
+
+    for (size_t batch = begin; batch < end; batch++)
+    {
+        LeTensorView a_view, b_view, destination_view;
+        le_matrix_product_full_into(le_tensor_view_init_pick(&destination_view, task->destination, (uint32_t)batch),
+                                    le_tensor_view_init_batch(&a_view, task->a, batch), task->transpose_a,
+                                    le_tensor_view_init_batch(&b_view, task->b, batch), task->transpose_b);
+    }
+}
+#endif
+
+void
+le_tensor_batched_product_into(LeTensor *destination, const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(b->device_type == LE_DEVICE_TYPE_CPU);
+    assert(a->shape->num_dimensions == 2 || a->shape->num_dimensions == 3);
+    assert(b->shape->num_dimensions == 2 || b->shape->num_dimensions == 3);
+
+    unsigned a_last = a->shape->num_dimensions - 1;
+    unsigned b_last = b->shape->num_dimensions - 1;
+    uint32_t a_batch_size = le_tensor_get_batch_size(a);
+    uint32_t b_batch_size = le_tensor_get_batch_size(b);
+    assert(a_batch_size == b_batch_size || a_batch_size == 1 || b_batch_size == 1);
+    uint32_t batch_size = (a_batch_size == 1) ? b_batch_size : a_batch_size;
+    uint32_t height = transpose_a ? a->shape->sizes[a_last] : a->shape->sizes[a_last - 1];
+    uint32_t width = transpose_b ? b->shape->sizes[b_last - 1] : b->shape->sizes[b_last];
+    uint32_t size = transpose_a ? a->shape->sizes[a_last - 1] : a->shape->sizes[a_last];
+    assert(size == (transpose_b ? b->shape->sizes[b_last] : b->shape->sizes[b_last - 1]));
+
+    assert(destination->device_type == LE_DEVICE_TYPE_CPU);
+    assert(destination->element_type == LE_TYPE_FLOAT32);
+    assert(destination->shape->num_dimensions == 3);
+    assert(destination->shape->sizes[0] == batch_size);
+    assert(destination->shape->sizes[1] == height);
+    assert(destination->shape->sizes[2] == width);
+    assert((destination->data != a->data) && (destination->data != b->data));
+    (void)size;
+
+    if (batch_size == 0)
+        return;
+
+    /// @note: Views of operands shared with their copies copy them. This is done here, once,
+    /// so that threads only read operands.
+    le_tensor_make_writable(destination);
+    LeTensorView view;
+    le_tensor_view_init_batch(&view, a, 0);
+    le_tensor_view_init_batch(&view, b, 0);
+
+#ifdef __APPLE__
+    LeTensorBatchedProductTask task = { destination, a, transpose_a, b, transpose_b };
+    le_tensor_batched_product_range(&task, 0, batch_size);
+#elif defined(HAVE_OPENBLAS)
+    /// @note: BLAS takes single precision matrices with common layout, half precision
+    /// and views with gaps in both dimensions are copied first
+    bool layout_transpose;
+    size_t ld;
+    LeTensor *a_packed = NULL;
+    LeTensor *b_packed = NULL;
+    if (a->element_type == LE_TYPE_FLOAT16)
+        a = a_packed = le_tensor_new_cast(a, LE_TYPE_FLOAT32);
+    if (!le_matrix_get_gemm_layout(le_tensor_view_init_batch(&view, a, 0), transpose_a, &layout_transpose, &ld))
+    {
+        LeTensor *a_copy = le_tensor_new_copy(a);
+        le_tensor_free(a_packed);
+        a = a_packed = a_copy;
+    }
+    if (!le_matrix_get_gemm_layout(le_tensor_view_init_batch(&view, b, 0), transpose_b, &layout_transpose, &ld))
+        b = b_packed = le_tensor_new_copy(b);
+    le_openblas_batched_product_into(destination, a, transpose_a, b, transpose_b);
+    le_tensor_free(b_packed);
+    le_tensor_free(a_packed);
+#else
+    LeTensorBatchedProductTask task = { destination, a, transpose_a, b, transpose_b };
+    /// @note: Few batches are multiplied one by one, each by all threads of GEMM.
+    /// Otherwise each thread multiplies its own batches and GEMM calls inside run serially.
+    if (batch_size < le_get_num_threads())
+        le_tensor_batched_product_range(&task, 0, batch_size);
+    else
+        le_parallel_for(batch_size, le_matrix_parallel_grain((size_t)height * width * size),
+                        le_tensor_batched_product_range, &task);
+#endif
+}
+
+LeTensor *
+le_tensor_new_batched_product(const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+{
+    assert(a->shape->num_dimensions == 2 || a->shape->num_dimensions == 3);
+    assert(b->shape->num_dimensions == 2 || b->shape->num_dimensions == 3);
+
+    unsigned a_last = a->shape->num_dimensions - 1;
+    unsigned b_last = b->shape->num_dimensions - 1;
+    uint32_t a_batch_size = le_tensor_get_batch_size(a);
+    uint32_t batch_size = (a_batch_size == 1) ? le_tensor_get_batch_size(b) : a_batch_size;
+    uint32_t height = transpose_a ? a->shape->sizes[a_last] : a->shape->sizes[a_last - 1];
+    uint32_t width = transpose_b ? b->shape->sizes[b_last - 1] : b->shape->sizes[b_last];
+
+    LeTensor *self = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(3, batch_size, height, width));
+    le_tensor_batched_product_into(self, a, transpose_a, b, transpose_b);
+
+    return self;
+}
+
+typedef struct LeMatrixConv2DTask
+{
+    const LeTensor *image;
+    const LeTensor *filter;
+    LeTensor       *self;
+} LeMatrixConv2DTask;
+
+/// @note: Computes output rows [begin, end) of 2D convolution. Each output row is accumulated
+/// from rows of image shifted by filter column and scaled by filter taps, so inner loop runs
+/// along contiguous rows in vector registers.
+static void
+le_matrix_conv2d_rows(void *data, size_t begin, size_t end)
+{
+    const LeMatrixConv2DTask *task = data;
+    const LeKernels *kernels = le_kernels_get();
+    unsigned fh = le_matrix_get_height(task->filter);
+    unsigned fw = le_matrix_get_width(task->filter);
+    unsigned width = le_matrix_get_width(task->self);
+    const float *image = task->image->data;
+    const float *filter = task->filter->data;
+
+    for (size_t oy = begin; oy < end; oy++)
+    {
+        float *row = (float *)task->self->data + oy * task->self->strides[0];
+        memset(row, 0, width * sizeof(float));
+        for (unsigned fy = 0; fy < fh; fy++)
+        {
+            const float *image_row = image + (oy + fy) * task->image->strides[0];
+            for (unsigned fx = 0; fx < fw; fx++)
+            {
+                /// @note: row += tap * image_row, with negated scale
+                kernels->sub_scaled_f32(row, -filter[fy * fw + fx], image_row + fx, width);
+            }
+        }
+    }
+}
+
 LeTensor *
 le_matrix_new_conv2d(const LeTensor *image, const LeTensor *filter)
 {
@@ -675,71 +967,79 @@ le_matrix_new_conv2d(const LeTensor *image, const LeTensor *filter)
     assert(height > 1);
     assert(width > 1);
 
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = image->element_type;
-    self->shape = le_shape_new(2, height, width);
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_init_shape(self, 2, (uint32_t[]){ height, width });
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(le_shape_get_elements_count(self->shape) * sizeof(float));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(le_tensor_get_data_size(self));
 
-    for (int32_t oy = 0; oy < height; oy++)
-    {
-        for (int32_t ox = 0; ox < width; ox++)
-        {
-            float value = 0.0f;
-            for (int32_t fy = 0; fy < fh; fy++)
-            {
-                for (int32_t fx = 0; fx < fw; fx++)
-                {
-                    value += le_matrix_at_f32(image, oy + fy, ox + fx) * le_matrix_at_f32(filter, fy, fx);
-                }
-            }
-            le_matrix_set(self, oy, ox, value);
-        }
-    }
+    /// @note: Rows of image and filter are read as arrays
+    LeTensor *image_packed = le_tensor_contiguous(image) ? NULL : le_tensor_new_cast(image, LE_TYPE_FLOAT32);
+    LeTensor *filter_packed = le_tensor_contiguous(filter) ? NULL : le_tensor_new_cast(filter, LE_TYPE_FLOAT32);
+    LeMatrixConv2DTask task = {
+        image_packed ? image_packed : image,
+        filter_packed ? filter_packed : filter,
+        self
+    };
+    le_parallel_for(height, le_matrix_parallel_grain((size_t)width * fh * fw), le_matrix_conv2d_rows, &task);
+    le_tensor_free(filter_packed);
+    le_tensor_free(image_packed);
     
     return self;
 }
 
+bool
+le_matrix_get_gemm_layout(const LeTensor *matrix, bool transpose, bool *layout_transpose, size_t *ld)
+{
+    assert(matrix->shape->num_dimensions == 2);
+
+    uint32_t height = matrix->shape->sizes[0];
+    uint32_t width = matrix->shape->sizes[1];
+    size_t row_stride = matrix->strides[0];
+    size_t column_stride = matrix->strides[1];
+
+    /// @note: Stride of dimension of size 1 is never used and may be arbitrary
+    if ((width <= 1 || column_stride == 1) && (height <= 1 || row_stride >= width))
+    {
+        *layout_transpose = transpose;
+        *ld = (height <= 1) ? (width ? width : 1) : row_stride;
+        return true;
+    }
+    if ((height <= 1 || row_stride == 1) && (width <= 1 || column_stride >= height))
+    {
+        *layout_transpose = !transpose;
+        *ld = (width <= 1) ? (height ? height : 1) : column_stride;
+        return true;
+    }
+    return false;
+}
+
 LeTensor *
 le_matrix_get_column(const LeTensor *matrix, unsigned x)
 {
-    /// @todo: Take stride into account
     assert(matrix->device_type == LE_DEVICE_TYPE_CPU);
     assert(matrix->shape->num_dimensions == 2);
     
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = matrix->element_type;
-    self->shape = le_shape_new(2, matrix->shape->sizes[0], 1);
-    self->stride = matrix->stride;
+    return le_tensor_slice(matrix, 1, x, 1);
+}
 
-    self->owns_data = false;
-    self->data = matrix->data + x * le_type_size(self->element_type);
-    
-    return self;
+LeTensor *
+le_matrix_view_init_column(LeTensorView *view, const LeTensor *matrix, unsigned x)
+{
+    assert(matrix->device_type == LE_DEVICE_TYPE_CPU);
+    assert(matrix->shape->num_dimensions == 2);
+
+    return le_tensor_view_init_slice(view, matrix, 1, x, 1);
 }
                   
 LeTensor *
 le_matrix_get_column_copy(const LeTensor *self, unsigned x)
 {
-    /// @todo: Take stride into account
-    assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->shape->num_dimensions == 2);
-    assert(self->element_type == LE_TYPE_FLOAT32);
-    /// @todo: Add dimension checks
-    
-    unsigned y;
-    unsigned height = le_matrix_get_height(self);
-    LeTensor *column = le_matrix_new_uninitialized(self->element_type, height, 1);
-    
-    for (y = 0; y < height; y++)
-    {
-        ((float *)column->data)[y] = ((float *)self->data)[y * self->stride + x];
-    }
-    
-    return column;
+    return le_matrix_get_columns_copy(self, x, 1);
 }
 
 LeTensor *
@@ -747,59 +1047,196 @@ le_matrix_get_columns_copy(const LeTensor *self, unsigned x, unsigned width)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
     assert(self->shape->num_dimensions == 2);
-    unsigned self_width = le_matrix_get_width(self);
-    assert(self_width >= x + width);
+    assert(le_matrix_get_width(self) >= x + width);
 
-    unsigned height = le_matrix_get_height(self);
-    const size_t element_size = le_type_size(self->element_type);
+    LeTensorView view;
+    return le_tensor_new_copy(le_tensor_view_init_slice(&view, self, 1, x, width));
+}
 
-    LeTensor *columns = le_matrix_new_uninitialized(self->element_type, height, width);
-    for (unsigned y = 0; y < height; y++)
+void
+le_matrix_load_row(const LeTensor *self, unsigned y, size_t x, size_t count, float *buffer)
+{
+    const float *row = (const float *)self->data + (size_t)y * self->strides[0] + x * self->strides[1];
+    if (self->strides[1] == 1)
     {
-        memcpy(
-            (char *)columns->data + y * width * element_size,
-            (char *)self->data + (x + y * self->stride) * element_size,
-            width * element_size
-        );
+        memcpy(buffer, row, count * sizeof(float));
+        return;
     }
-    
-    return columns;
+    for (size_t i = 0; i < count; i++)
+        buffer[i] = row[i * self->strides[1]];
+}
+
+void
+le_matrix_store_row(LeTensor *self, unsigned y, size_t x, size_t count, const float *buffer)
+{
+    float *row = (float *)self->data + (size_t)y * self->strides[0] + x * self->strides[1];
+    if (self->strides[1] == 1)
+    {
+        memcpy(row, buffer, count * sizeof(float));
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+        row[i * self->strides[1]] = buffer[i];
+}
+
+/// @note: Applies softmax or log-softmax to columns [begin, end). Columns are processed in blocks
+/// so every pass over classes runs vector kernels along rows.
+static void
+le_matrix_softmax_block(LeTensor *self, size_t begin, size_t end, bool log_softmax)
+{
+    const LeKernels *kernels = le_kernels_get();
+    unsigned num_classes = self->shape->sizes[0];
+    float max[LE_MATRIX_SOFTMAX_BLOCK];
+    float sum[LE_MATRIX_SOFTMAX_BLOCK];
+    float row[LE_MATRIX_SOFTMAX_BLOCK];
+
+    for (size_t x = begin; x < end; x += LE_MATRIX_SOFTMAX_BLOCK)
+    {
+        size_t count = end - x < LE_MATRIX_SOFTMAX_BLOCK ? end - x : LE_MATRIX_SOFTMAX_BLOCK;
+
+        le_matrix_load_row(self, 0, x, count, max);
+        for (unsigned klass = 1; klass < num_classes; klass++)
+        {
+            le_matrix_load_row(self, klass, x, count, row);
+            kernels->max_f32(max, row, count);
+        }
+
+        memset(sum, 0, count * sizeof(float));
+        for (unsigned klass = 0; klass < num_classes; klass++)
+        {
+            le_matrix_load_row(self, klass, x, count, row);
+            kernels->sub_f32(row, max, count);
+            /// @note: Log-softmax keeps shifted inputs, softmax keeps their exponents
+            if (log_softmax)
+                le_matrix_store_row(self, klass, x, count, row);
+            kernels->exp_f32(row, count);
+            kernels->add_f32(sum, row, count);
+            if (!log_softmax)
+                le_matrix_store_row(self, klass, x, count, row);
+        }
+
+        if (log_softmax)
+        {
+            kernels->log_f32(sum, count);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+                sum[i] = 1.0f / sum[i];
+        }
+        for (unsigned klass = 0; klass < num_classes; klass++)
+        {
+            le_matrix_load_row(self, klass, x, count, row);
+            if (log_softmax)
+                kernels->sub_f32(row, sum, count);
+            else
+                kernels->mul_f32(row, sum, count);
+            le_matrix_store_row(self, klass, x, count, row);
+        }
+    }
+}
+
+static void
+le_matrix_softmax_columns(void *data, size_t begin, size_t end)
+{
+    le_matrix_softmax_block(data, begin, end, false);
+}
+
+static void
+le_matrix_log_softmax_columns(void *data, size_t begin, size_t end)
+{
+    le_matrix_softmax_block(data, begin, end, true);
 }
 
 void
 le_matrix_apply_softmax(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    assert(self->element_type == LE_TYPE_FLOAT32);
     assert(self->shape->num_dimensions == 2);
 
-    /// @todo: Take stride into account
-    unsigned example, klass;
+    le_tensor_make_writable(self);
     unsigned num_classes = self->shape->sizes[0];
     unsigned num_examples = self->shape->sizes[1];
 
-    for (example = 0; example < num_examples; example++)
+    le_parallel_for(num_examples, le_matrix_parallel_grain(num_classes), le_matrix_softmax_columns, self);
+}
+
+void
+le_matrix_apply_log_softmax(LeTensor *self)
+{
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    assert(self->element_type == LE_TYPE_FLOAT32);
+    assert(self->shape->num_dimensions == 2);
+
+    le_tensor_make_writable(self);
+    unsigned num_classes = self->shape->sizes[0];
+    unsigned num_examples = self->shape->sizes[1];
+
+    le_parallel_for(num_examples, le_matrix_parallel_grain(num_classes), le_matrix_log_softmax_columns, self);
+}
+
+typedef struct LeMatrixSoftmaxGradientTask
+{
+    const LeTensor *softmax_output;
+    const LeTensor *output_gradient;
+    LeTensor       *input_gradient;
+} LeMatrixSoftmaxGradientTask;
+
+/// @note: Computes input gradient of columns [begin, end) in blocks, like softmax itself
+static void
+le_matrix_softmax_gradient_columns(void *data, size_t begin, size_t end)
+{
+    const LeMatrixSoftmaxGradientTask *task = data;
+    const LeKernels *kernels = le_kernels_get();
+    unsigned num_classes = task->softmax_output->shape->sizes[0];
+    float dot[LE_MATRIX_SOFTMAX_BLOCK];
+    float s[LE_MATRIX_SOFTMAX_BLOCK];
+    float g[LE_MATRIX_SOFTMAX_BLOCK];
+
+    for (size_t x = begin; x < end; x += LE_MATRIX_SOFTMAX_BLOCK)
     {
-        float max = -INFINITY;
-        for (klass = 0; klass < num_classes; klass++)
-        {
-            float value = le_matrix_at_f32(self, klass, example);
-            if (value > max)
-            {
-                max = value;
-            }
-        }
-        float sum = 0;
-        for (klass = 0; klass < num_classes; klass++)
+        size_t count = end - x < LE_MATRIX_SOFTMAX_BLOCK ? end - x : LE_MATRIX_SOFTMAX_BLOCK;
+
+        memset(dot, 0, count * sizeof(float));
+        for (unsigned klass = 0; klass < num_classes; klass++)
         {
-            float activation = expf(le_matrix_at_f32(self, klass, example) - max);
-            sum += activation;
-            le_matrix_set(self, klass, example, activation);
+            le_matrix_load_row(task->softmax_output, klass, x, count, s);
+            le_matrix_load_row(task->output_gradient, klass, x, count, g);
+            kernels->mul_add_f32(dot, s, g, count);
         }
-        for (klass = 0; klass < num_classes; klass++)
+
+        for (unsigned klass = 0; klass < num_classes; klass++)
         {
-            float activation = le_matrix_at_f32(self, klass, example);
-            activation /= sum;
-            le_matrix_set(self, klass, example, activation);
+            le_matrix_load_row(task->softmax_output, klass, x, count, s);
+            le_matrix_load_row(task->output_gradient, klass, x, count, g);
+            kernels->sub_f32(g, dot, count);
+            kernels->mul_f32(g, s, count);
+            le_matrix_store_row(task->input_gradient, klass, x, count, g);
         }
     }
 }
+
+LeTensor *
+le_matrix_new_softmax_gradient(const LeTensor *softmax_output, const LeTensor *output_gradient)
+{
+    assert(softmax_output->device_type == LE_DEVICE_TYPE_CPU);
+    assert(softmax_output->element_type == LE_TYPE_FLOAT32);
+    assert(softmax_output->shape->num_dimensions == 2);
+    assert(output_gradient->device_type == LE_DEVICE_TYPE_CPU);
+    assert(output_gradient->element_type == LE_TYPE_FLOAT32);
+    assert(le_shape_equal(softmax_output->shape, output_gradient->shape));
+
+    unsigned num_classes = softmax_output->shape->sizes[0];
+    unsigned num_examples = softmax_output->shape->sizes[1];
+    LeMatrixSoftmaxGradientTask task = {
+        .softmax_output = softmax_output,
+        .output_gradient = output_gradient,
+        .input_gradient = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, num_classes, num_examples)
+    };
+    /// @note: Each column reads both inputs twice
+    le_parallel_for(num_examples, le_matrix_parallel_grain(4 * (size_t)num_classes),
+                    le_matrix_softmax_gradient_columns, &task);
+
+    return task.input_gradient;
+}
@@ -9,6 +9,7 @@
 #include <le/lemacros.h>
 #include <le/math/lerand.h>
 #include "letensor.h"
+#include "leactivation.h"
 
 LE_BEGIN_DECLS
 
@@ -40,7 +41,7 @@ uint32_t           le_matrix_at_u32                        (const LeTensor *
                                                             unsigned                y,
                                                             unsigned                x);                             
 
-/// @note: Unlike le_tensor_add, supports horizontal broadcasting
+/// @note: Same as le_tensor_add, another is broadcast to size of matrix, e.g. column of biases
 void               le_matrix_add                           (LeTensor *              matrix,
                                                             const LeTensor *        another);
 
@@ -119,13 +120,24 @@ LeTensor *         le_matrix_new_rand_f32                  (LeDistribution
 
 LeTensor *         le_matrix_new_transpose                 (LeTensor *              a);
 
+/// @note: Destination of _into functions must be CPU matrix of result type and size.
+/// It must not share data with operands.
+void               le_matrix_transpose_into                (LeTensor *              destination,
+                                                            const LeTensor *        a);
+
+/// @note: Sums elements along given dimension, which is kept with size 1
 LeTensor *         le_matrix_new_sum                       (const LeTensor *        a,
                                                             unsigned                dimension);
 
+void               le_matrix_sum_into                      (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            unsigned                dimension);
+
 LeTensor *         le_matrix_new_one_hot                   (LeType                  type,
                                                             const LeTensor *        a,
                                                             unsigned                num_classes);
 
+/// @note: a may be of LE_TYPE_FLOAT16, e.g. converted weights, b and product are single precision
 LeTensor *         le_matrix_new_product                   (const LeTensor *        a,
                                                             const LeTensor *        b);
 
@@ -134,6 +146,41 @@ LeTensor *         le_matrix_new_product_full              (const LeTensor *
                                                             const LeTensor *        b,
                                                             bool                    transpose_b);
 
+void               le_matrix_product_into                  (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            const LeTensor *        b);
+
+void               le_matrix_product_full_into             (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            bool                    transpose_a,
+                                                            const LeTensor *        b,
+                                                            bool                    transpose_b);
+
+/// @note: Same as le_matrix_product_full_into followed by addition of bias and element-wise
+/// activation, which are applied to each tile of destination while it is still in cache.
+/// bias is column added to every column of product, e.g. of dense layer, or row added to every
+/// row. bias may be NULL, activation may not be LE_ACTIVATION_SOFTMAX.
+void               le_matrix_product_activation_into       (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            bool                    transpose_a,
+                                                            const LeTensor *        b,
+                                                            bool                    transpose_b,
+                                                            const LeTensor *        bias,
+                                                            LeActivation            activation);
+
+/// @note: Products of matrices of rank 3 tensors, (B, M, K) × (B, K, N) gives (B, M, N), where
+/// transposition applies to each matrix. Batch of size 1 and rank 2 operand are broadcast
+/// to batch of another operand. a may be of LE_TYPE_FLOAT16, b and product are single precision.
+LeTensor *         le_tensor_new_batched_product           (const LeTensor *        a,
+                                                            bool                    transpose_a,
+                                                            const LeTensor *        b,
+                                                            bool                    transpose_b);
+
+void               le_tensor_batched_product_into          (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            bool                    transpose_a,
+                                                            const LeTensor *        b,
+                                                            bool                    transpose_b);
                                             
 LeTensor *         le_matrix_new_conv2d                    (const LeTensor *        image,
                                                             const LeTensor *        filter);
@@ -150,6 +197,15 @@ LeTensor *         le_matrix_get_columns_copy              (const LeTensor *
 
 void               le_matrix_apply_softmax                 (LeTensor *              matrix);
 
+/// @note: Logarithm of softmax of each column, computed as x - max - log(Σ exp(x - max))
+/// so that it stays finite where softmax underflows
+void               le_matrix_apply_log_softmax             (LeTensor *              matrix);
+
+/// @note: Gradient of loss by inputs of softmax applied to columns, given softmax output s and
+/// gradient g of loss by it. Computed for each column as s ⊙ (g − ⟨s, g⟩), without Jacobians.
+LeTensor *         le_matrix_new_softmax_gradient          (const LeTensor *        softmax_output,
+                                                            const LeTensor *        output_gradient);
+
 LE_END_DECLS
 
 #endif
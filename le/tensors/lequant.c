@@ -0,0 +1,185 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "lequant.h"
+#include "letensor-imp.h"
+#include "lematrix.h"
+#include "lereduce.h"
+#include "legemm.h"
+#include "lekernels.h"
+#include <le/lemem.h>
+#include <assert.h>
+#include <math.h>
+
+/// @note: Columns of b quantized together while transposed, their rows of
+/// transposed b stay in cache while they are written
+#define LE_QUANT_TRANSPOSE_BLOCK 64
+
+LeQuantization
+le_quantization_from_range(float min, float max, int32_t q_min, int32_t q_max)
+{
+    assert(q_min < q_max);
+
+    min = fminf(min, 0.0f);
+    max = fmaxf(max, 0.0f);
+
+    LeQuantization quantization;
+    quantization.scale = (max - min) / (float)(q_max - q_min);
+    /// @note: All zeros or non-finite range, any scale represents zero exactly
+    if (!(quantization.scale > 0.0f) || !isfinite(quantization.scale))
+        quantization.scale = 1.0f;
+    long zero_point = q_min - lrintf(min / quantization.scale);
+    quantization.zero_point = (zero_point < q_min) ? q_min : (zero_point > q_max) ? q_max : (int32_t)zero_point;
+
+    return quantization;
+}
+
+static inline int32_t
+le_quantize(float value, float inverse_scale, int32_t zero_point, int32_t q_min, int32_t q_max)
+{
+    float q = nearbyintf(value * inverse_scale) + (float)zero_point;
+    return (q < (float)q_min) ? q_min : (q > (float)q_max) ? q_max : (int32_t)q;
+}
+
+LeTensor *
+le_matrix_new_quantized_rows(const LeTensor *matrix, LeTensor **scales, LeTensor **zero_points)
+{
+    assert(matrix);
+    assert(matrix->device_type == LE_DEVICE_TYPE_CPU);
+    assert(matrix->element_type == LE_TYPE_FLOAT32 || matrix->element_type == LE_TYPE_FLOAT16);
+    assert(matrix->shape->num_dimensions == 2);
+    assert(scales);
+    assert(zero_points);
+
+    unsigned height = le_matrix_get_height(matrix);
+    unsigned width = le_matrix_get_width(matrix);
+    LeTensor *self = le_matrix_new_uninitialized(LE_TYPE_INT8, height, width);
+    *scales = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, height, 1);
+    *zero_points = le_matrix_new_uninitialized(LE_TYPE_INT32, height, 1);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+        float min = INFINITY, max = -INFINITY;
+        for (unsigned x = 0; x < width; x++)
+        {
+            float value = le_matrix_at_f32(matrix, y, x);
+            min = fminf(min, value);
+            max = fmaxf(max, value);
+        }
+        LeQuantization quantization = le_quantization_from_range(min, max, INT8_MIN, INT8_MAX);
+        float inverse_scale = 1.0f / quantization.scale;
+        int8_t *row = (int8_t *)self->data + (size_t)y * width;
+        for (unsigned x = 0; x < width; x++)
+        {
+            row[x] = (int8_t)le_quantize(le_matrix_at_f32(matrix, y, x), inverse_scale,
+                                         quantization.zero_point, INT8_MIN, INT8_MAX);
+        }
+        ((float *)(*scales)->data)[y] = quantization.scale;
+        ((int32_t *)(*zero_points)->data)[y] = quantization.zero_point;
+    }
+
+    return self;
+}
+
+void
+le_matrix_quantized_product_into(LeTensor *destination, const LeTensor *a, const LeTensor *a_scales,
+                                 const LeTensor *a_zero_points, const LeTensor *b,
+                                 const LeQuantization *b_quantization, const LeTensor *bias, bool relu)
+{
+    assert(destination);
+    assert(a);
+    assert(a_scales);
+    assert(a_zero_points);
+    assert(b);
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(b->device_type == LE_DEVICE_TYPE_CPU);
+    assert(destination->device_type == LE_DEVICE_TYPE_CPU);
+    assert(a->element_type == LE_TYPE_INT8);
+    assert(a_scales->element_type == LE_TYPE_FLOAT32);
+    assert(a_zero_points->element_type == LE_TYPE_INT32);
+    assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(destination->element_type == LE_TYPE_FLOAT32);
+    assert(a->shape->num_dimensions == 2);
+    assert(b->shape->num_dimensions == 2);
+    assert(le_tensor_contiguous(a));
+    assert(le_tensor_contiguous(a_scales));
+    assert(le_tensor_contiguous(a_zero_points));
+    assert(le_tensor_contiguous(destination));
+
+    unsigned m = le_matrix_get_height(a);
+    unsigned k = le_matrix_get_width(a);
+    unsigned n = le_matrix_get_width(b);
+    assert(le_matrix_get_height(b) == k);
+    assert(le_matrix_get_height(destination) == m);
+    assert(le_matrix_get_width(destination) == n);
+    assert(le_shape_get_elements_count(a_scales->shape) == m);
+    assert(le_shape_get_elements_count(a_zero_points->shape) == m);
+    assert(bias == NULL || (bias->element_type == LE_TYPE_FLOAT32 && le_tensor_contiguous(bias) &&
+                            le_shape_get_elements_count(bias->shape) == m));
+
+    le_tensor_make_writable(destination);
+    LeTensor *b_copy = NULL;
+    if (!le_tensor_contiguous(b))
+        b = b_copy = le_tensor_new_copy(b);
+
+    LeQuantization quantization;
+    if (b_quantization)
+        quantization = *b_quantization;
+    else
+        quantization = le_quantization_from_range(le_tensor_reduce_f32(b, LE_REDUCE_OP_MIN),
+                                                  le_tensor_reduce_f32(b, LE_REDUCE_OP_MAX),
+                                                  0, UINT8_MAX);
+
+    /// @note: b is stored transposed, so that both operands of integer GEMM are read along k
+    uint8_t *b_quantized = le_arena_alloc((size_t)n * k);
+    int32_t *b_column_sums = le_arena_alloc(n * sizeof(int32_t));
+    const float *b_data = b->data;
+    const LeKernels *kernels = le_kernels_get();
+    float inverse_scale = 1.0f / quantization.scale;
+    uint8_t row[LE_QUANT_TRANSPOSE_BLOCK];
+    for (unsigned j0 = 0; j0 < n; j0 += LE_QUANT_TRANSPOSE_BLOCK)
+    {
+        unsigned width = (n - j0 < LE_QUANT_TRANSPOSE_BLOCK) ? n - j0 : LE_QUANT_TRANSPOSE_BLOCK;
+        int32_t *column_sums = b_column_sums + j0;
+        for (unsigned j = 0; j < width; j++)
+            column_sums[j] = 0;
+        for (unsigned p = 0; p < k; p++)
+        {
+            kernels->quantize_u8(row, b_data + (size_t)p * n + j0, inverse_scale, (float)quantization.zero_point, width);
+            for (unsigned j = 0; j < width; j++)
+            {
+                b_quantized[(size_t)(j0 + j) * k + p] = row[j];
+                column_sums[j] += row[j];
+            }
+        }
+    }
+
+    float *scales = le_arena_alloc(m * sizeof(float));
+    int32_t *a_row_sums = le_arena_alloc(m * sizeof(int32_t));
+    const int8_t *a_data = a->data;
+    for (unsigned i = 0; i < m; i++)
+    {
+        int32_t sum = 0;
+        for (unsigned p = 0; p < k; p++)
+            sum += a_data[(size_t)i * k + p];
+        a_row_sums[i] = sum;
+        scales[i] = ((const float *)a_scales->data)[i] * quantization.scale;
+    }
+
+    LeGemmQuantizedEpilogue epilogue = {
+        .scales = scales,
+        .a_zero_points = a_zero_points->data,
+        .a_row_sums = a_row_sums,
+        .b_zero_point = quantization.zero_point,
+        .b_column_sums = b_column_sums,
+        .bias = bias ? bias->data : NULL,
+        .relu = relu
+    };
+    le_gemm_u8s8(m, n, k, a_data, k, b_quantized, k, &epilogue, destination->data, n);
+
+    le_free(a_row_sums);
+    le_free(scales);
+    le_free(b_column_sums);
+    le_free(b_quantized);
+    le_tensor_free(b_copy);
+}
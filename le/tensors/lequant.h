@@ -0,0 +1,52 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Affine 8-bit quantization of matrices for integer inference */
+
+#ifndef __LEQUANT_H__
+#define __LEQUANT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <le/lemacros.h>
+#include "letensor.h"
+
+LE_BEGIN_DECLS
+
+/// @note: Integer q represents real value scale * (q - zero_point)
+typedef struct LeQuantization
+{
+    float   scale;
+    int32_t zero_point;
+} LeQuantization;
+
+/// @note: Maps [min, max] onto integers [q_min, q_max]. Range is extended to include zero,
+/// so that zero, e.g. output of ReLU, is represented exactly.
+LeQuantization     le_quantization_from_range              (float                   min,
+                                                            float                   max,
+                                                            int32_t                 q_min,
+                                                            int32_t                 q_max);
+
+/// @note: Quantizes every row of FLOAT32 or FLOAT16 matrix into LE_TYPE_INT8 with its own scale
+/// and zero point, which are returned as new height×1 matrices of LE_TYPE_FLOAT32 and LE_TYPE_INT32
+LeTensor *         le_matrix_new_quantized_rows            (const LeTensor *        matrix,
+                                                            LeTensor **             scales,
+                                                            LeTensor **             zero_points);
+
+/// @note: Destination = a * b + bias, clamped at zero if relu is set. a is LE_TYPE_INT8 matrix
+/// quantized by le_matrix_new_quantized_rows. FLOAT32 b is quantized to 8 bits with
+/// b_quantization, or with range of its own elements if b_quantization is NULL.
+/// Integer products are accumulated exactly and dequantized once per element of destination.
+/// bias is height×1 FLOAT32 matrix or NULL.
+void               le_matrix_quantized_product_into        (LeTensor *              destination,
+                                                            const LeTensor *        a,
+                                                            const LeTensor *        a_scales,
+                                                            const LeTensor *        a_zero_points,
+                                                            const LeTensor *        b,
+                                                            const LeQuantization *  b_quantization,
+                                                            const LeTensor *        bias,
+                                                            bool                    relu);
+
+LE_END_DECLS
+
+#endif
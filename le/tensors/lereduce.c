@@ -0,0 +1,594 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "lereduce.h"
+#include "letensor-imp.h"
+#include "lekernels.h"
+#include <le/leparallel.h>
+#include <le/lemem.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+
+/// @note: Reductions are split between threads in parts of at least this many elements
+#define LE_REDUCE_PARALLEL_GRAIN 32768
+
+/// @note: Elements are passed to kernels in blocks of this many elements. Sums of blocks
+/// are accumulated with compensation, so rounding error does not grow with number of elements.
+#define LE_REDUCE_BLOCK_SIZE 1024
+
+/// @note: Quantities gathered by single pass over elements
+enum
+{
+    LE_REDUCE_SUM     = 1 << 0,
+    LE_REDUCE_MOMENTS = 1 << 1,
+    LE_REDUCE_MAX     = 1 << 2,
+    LE_REDUCE_MIN     = 1 << 3,
+    LE_REDUCE_COUNTS  = 1 << 4
+};
+
+typedef struct LeReduceState
+{
+    size_t count;
+    /// @note: Neumaier compensated sum
+    float  sum;
+    float  compensation;
+    /// @note: Mean and sum of squared deviations from it, merged with Chan et al. formula
+    float  mean;
+    float  m2;
+    float  max;
+    float  min;
+    size_t argmax;
+    size_t argmin;
+    size_t nans;
+    size_t zeros;
+} LeReduceState;
+
+typedef struct LeReduction
+{
+    LeReduceOp     op;
+    unsigned       quantities;
+    /// @note: View of reduced tensor with kept dimensions first and reduced dimensions last
+    LeTensor      *view;
+    unsigned       outer_dimensions;
+    size_t         outer_count;
+    size_t         inner_count;
+    size_t         chunks_count;
+    LeReduceState *states;
+    /// @note: Either destination receives results or result receives state of single output
+    LeTensor      *destination;
+    LeReduceState *result;
+} LeReduction;
+
+static unsigned
+le_reduce_op_get_quantities(LeReduceOp op)
+{
+    switch (op)
+    {
+    case LE_REDUCE_OP_SUM:
+    case LE_REDUCE_OP_MEAN:
+        return LE_REDUCE_SUM;
+    case LE_REDUCE_OP_MAX:
+    case LE_REDUCE_OP_ARGMAX:
+        return LE_REDUCE_MAX;
+    case LE_REDUCE_OP_MIN:
+    case LE_REDUCE_OP_ARGMIN:
+        return LE_REDUCE_MIN;
+    case LE_REDUCE_OP_VARIANCE:
+        return LE_REDUCE_MOMENTS;
+    default:
+        assert(false);
+        return 0;
+    }
+}
+
+static bool
+le_reduce_axes_contain(uint32_t axes, unsigned dimension)
+{
+    return (dimension < 32) && (axes & LE_REDUCE_AXIS(dimension));
+}
+
+static size_t
+le_reduce_grain(size_t work_per_item)
+{
+    return work_per_item >= LE_REDUCE_PARALLEL_GRAIN ? 1 : LE_REDUCE_PARALLEL_GRAIN / (work_per_item ? work_per_item : 1);
+}
+
+static void
+le_reduce_state_add_compensated(LeReduceState *state, float value)
+{
+    float sum = state->sum + value;
+    if (fabsf(state->sum) >= fabsf(value))
+        state->compensation += (state->sum - sum) + value;
+    else
+        state->compensation += (value - sum) + state->sum;
+    state->sum = sum;
+}
+
+/// @note: Merges moments of count elements, must be called before state->count is updated
+static void
+le_reduce_state_merge_moments(LeReduceState *state, size_t count, float mean, float m2)
+{
+    size_t total = state->count + count;
+    float delta = mean - state->mean;
+    state->mean += delta * ((float)count / (float)total);
+    state->m2 += m2 + delta * delta * ((float)state->count * (float)count / (float)total);
+}
+
+static size_t
+le_reduce_find_f32(const float *values, size_t n, float value)
+{
+    size_t i = 0;
+    while ((i < n - 1) && (values[i] != value))
+        i++;
+    return i;
+}
+
+/// @note: Adds n values, first of which has index index among reduced elements.
+/// Values may point to scratch, which is overwritten when moments are computed.
+static void
+le_reduce_state_add_block(LeReduceState *state, unsigned quantities, const float *values, float *scratch,
+                          size_t n, size_t index)
+{
+    const LeKernels *kernels = le_kernels_get();
+
+    if (quantities & LE_REDUCE_MAX)
+    {
+        float max = kernels->reduce_max_f32(values, n);
+        if ((state->count == 0) || (max > state->max))
+        {
+            state->max = max;
+            state->argmax = index + le_reduce_find_f32(values, n, max);
+        }
+    }
+
+    if (quantities & LE_REDUCE_MIN)
+    {
+        float min = kernels->reduce_min_f32(values, n);
+        if ((state->count == 0) || (min < state->min))
+        {
+            state->min = min;
+            state->argmin = index + le_reduce_find_f32(values, n, min);
+        }
+    }
+
+    if (quantities & LE_REDUCE_COUNTS)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (isnan(values[i]))
+                state->nans++;
+            else if (values[i] == 0.0f)
+                state->zeros++;
+        }
+    }
+
+    if (quantities & (LE_REDUCE_SUM | LE_REDUCE_MOMENTS))
+    {
+        float sum = kernels->sum_f32(values, n);
+        if (quantities & LE_REDUCE_SUM)
+            le_reduce_state_add_compensated(state, sum);
+        if (quantities & LE_REDUCE_MOMENTS)
+        {
+            /// @note: Block is in cache, so its deviations are computed exactly from its own mean
+            float mean = sum / (float)n;
+            if (values != scratch)
+                memcpy(scratch, values, n * sizeof(float));
+            kernels->add_scalar_f32(scratch, -mean, n);
+            le_reduce_state_merge_moments(state, n, mean, kernels->dot_f32(scratch, scratch, n));
+        }
+    }
+
+    state->count += n;
+}
+
+static void
+le_reduce_state_merge(LeReduceState *state, const LeReduceState *other, unsigned quantities)
+{
+    if (other->count == 0)
+        return;
+
+    if (quantities & LE_REDUCE_SUM)
+    {
+        le_reduce_state_add_compensated(state, other->sum);
+        state->compensation += other->compensation;
+    }
+
+    if (quantities & LE_REDUCE_MOMENTS)
+        le_reduce_state_merge_moments(state, other->count, other->mean, other->m2);
+
+    if ((quantities & LE_REDUCE_MAX) && ((state->count == 0) || (other->max > state->max)))
+    {
+        state->max = other->max;
+        state->argmax = other->argmax;
+    }
+
+    if ((quantities & LE_REDUCE_MIN) && ((state->count == 0) || (other->min < state->min)))
+    {
+        state->min = other->min;
+        state->argmin = other->argmin;
+    }
+
+    state->nans += other->nans;
+    state->zeros += other->zeros;
+    state->count += other->count;
+}
+
+/// @note: Offset of index-th element of subspace formed by count dimensions of view starting from first
+static size_t
+le_reduction_offset(const LeTensor *view, unsigned first, unsigned count, size_t index)
+{
+    size_t offset = 0;
+    for (unsigned i = first + count; i > first; i--)
+    {
+        uint32_t size = view->shape->sizes[i - 1];
+        offset += (index % size) * view->strides[i - 1];
+        index /= size;
+    }
+    return offset;
+}
+
+/// @note: Reduces elements [begin, end) of given output. Rows of lowest reduced dimension
+/// are passed to kernels directly when packed and gathered into block otherwise.
+static void
+le_reduction_reduce_range(const LeReduction *self, size_t output, size_t begin, size_t end, LeReduceState *state)
+{
+    const LeTensor *view = self->view;
+    unsigned last = view->shape->num_dimensions - 1;
+    unsigned inner_dimensions = view->shape->num_dimensions - self->outer_dimensions;
+    uint32_t width = inner_dimensions ? view->shape->sizes[last] : 1;
+    size_t stride = inner_dimensions ? view->strides[last] : 1;
+    const float *data = (const float *)view->data + le_reduction_offset(view, 0, self->outer_dimensions, output);
+    float block[LE_REDUCE_BLOCK_SIZE];
+
+    memset(state, 0, sizeof(LeReduceState));
+
+    for (size_t i = begin; i < end; )
+    {
+        size_t row = i / width;
+        uint32_t x = i % width;
+        size_t n = width - x;
+        if (n > end - i)
+            n = end - i;
+        if (n > LE_REDUCE_BLOCK_SIZE)
+            n = LE_REDUCE_BLOCK_SIZE;
+
+        const float *values = data + (size_t)x * stride +
+            le_reduction_offset(view, self->outer_dimensions, inner_dimensions ? inner_dimensions - 1 : 0, row);
+        if (stride != 1)
+        {
+            for (size_t j = 0; j < n; j++)
+                block[j] = values[j * stride];
+            values = block;
+        }
+
+        le_reduce_state_add_block(state, self->quantities, values, block, n, i);
+        i += n;
+    }
+}
+
+static void
+le_reduction_store(const LeReduction *self, size_t output, const LeReduceState *state)
+{
+    if (self->result)
+    {
+        *self->result = *state;
+        return;
+    }
+
+    LeTensor *destination = self->destination;
+    size_t offset = le_tensor_offset(destination, output);
+
+    switch (self->op)
+    {
+    case LE_REDUCE_OP_SUM:
+        ((float *)destination->data)[offset] = state->sum + state->compensation;
+        break;
+    case LE_REDUCE_OP_MEAN:
+        ((float *)destination->data)[offset] = (state->sum + state->compensation) / (float)state->count;
+        break;
+    case LE_REDUCE_OP_MAX:
+        ((float *)destination->data)[offset] = state->max;
+        break;
+    case LE_REDUCE_OP_MIN:
+        ((float *)destination->data)[offset] = state->min;
+        break;
+    case LE_REDUCE_OP_ARGMAX:
+        ((uint32_t *)destination->data)[offset] = (uint32_t)state->argmax;
+        break;
+    case LE_REDUCE_OP_ARGMIN:
+        ((uint32_t *)destination->data)[offset] = (uint32_t)state->argmin;
+        break;
+    case LE_REDUCE_OP_VARIANCE:
+        ((float *)destination->data)[offset] = state->m2 / (float)state->count;
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
+static void
+le_reduction_run_outputs(void *data, size_t begin, size_t end)
+{
+    const LeReduction *self = data;
+
+    for (size_t output = begin; output < end; output++)
+    {
+        LeReduceState state;
+        le_reduction_reduce_range(self, output, 0, self->inner_count, &state);
+        le_reduction_store(self, output, &state);
+    }
+}
+
+/// @note: Each task reduces one chunk of elements of one output into own state
+static void
+le_reduction_run_chunks(void *data, size_t begin, size_t end)
+{
+    const LeReduction *self = data;
+
+    for (size_t task = begin; task < end; task++)
+    {
+        size_t output = task / self->chunks_count;
+        size_t chunk = task % self->chunks_count;
+        le_reduction_reduce_range(self, output,
+                                  self->inner_count * chunk / self->chunks_count,
+                                  self->inner_count * (chunk + 1) / self->chunks_count,
+                                  &self->states[task]);
+    }
+}
+
+/// @note: Reduces highest dimensions of packed tensor, which is matrix of inner_count rows
+/// and outer_count columns. Columns [begin, end) are accumulated row by row with element-wise
+/// kernels, so memory is read sequentially. Sums of groups of rows are added to total separately.
+static void
+le_reduction_run_columns(void *data, size_t begin, size_t end)
+{
+    const LeReduction *self = data;
+    const LeKernels *kernels = le_kernels_get();
+    size_t columns_count = self->outer_count;
+    size_t rows_count = self->inner_count;
+    LeTensor *destination = self->destination;
+    float total[LE_REDUCE_BLOCK_SIZE];
+    float partial[LE_REDUCE_BLOCK_SIZE];
+
+    for (size_t x = begin; x < end; x += LE_REDUCE_BLOCK_SIZE)
+    {
+        size_t n = end - x;
+        if (n > LE_REDUCE_BLOCK_SIZE)
+            n = LE_REDUCE_BLOCK_SIZE;
+
+        const float *column = (const float *)self->view->data + x;
+        memcpy(total, column, n * sizeof(float));
+
+        for (size_t y = 1; y < rows_count; )
+        {
+            size_t group_end = y + LE_REDUCE_BLOCK_SIZE;
+            if (group_end > rows_count)
+                group_end = rows_count;
+
+            switch (self->op)
+            {
+            case LE_REDUCE_OP_SUM:
+            case LE_REDUCE_OP_MEAN:
+                memcpy(partial, column + y * columns_count, n * sizeof(float));
+                for (size_t row = y + 1; row < group_end; row++)
+                    kernels->add_f32(partial, column + row * columns_count, n);
+                kernels->add_f32(total, partial, n);
+                break;
+            case LE_REDUCE_OP_MAX:
+                for (size_t row = y; row < group_end; row++)
+                    kernels->max_f32(total, column + row * columns_count, n);
+                break;
+            case LE_REDUCE_OP_MIN:
+                for (size_t row = y; row < group_end; row++)
+                    kernels->min_f32(total, column + row * columns_count, n);
+                break;
+            default:
+                assert(false);
+                break;
+            }
+
+            y = group_end;
+        }
+
+        if (self->op == LE_REDUCE_OP_MEAN)
+            kernels->mul_scalar_f32(total, 1.0f / (float)rows_count, n);
+
+        for (size_t i = 0; i < n; i++)
+            ((float *)destination->data)[le_tensor_offset(destination, x + i)] = total[i];
+    }
+}
+
+static void
+le_reduction_run(LeReduction *self, const LeTensor *tensor, uint32_t axes)
+{
+    assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
+    assert(tensor->element_type == LE_TYPE_FLOAT32);
+
+    unsigned num_dimensions = tensor->shape->num_dimensions;
+    unsigned *order = le_arena_alloc(num_dimensions * sizeof(unsigned));
+    unsigned reduced_dimensions = 0;
+    bool leading = true;
+
+    self->outer_dimensions = 0;
+    self->outer_count = 1;
+    self->inner_count = 1;
+    for (unsigned i = 0; i < num_dimensions; i++)
+    {
+        if (le_reduce_axes_contain(axes, i))
+        {
+            self->inner_count *= tensor->shape->sizes[i];
+            leading = leading && (reduced_dimensions == i);
+            reduced_dimensions++;
+        }
+        else
+        {
+            order[self->outer_dimensions++] = i;
+            self->outer_count *= tensor->shape->sizes[i];
+        }
+    }
+    for (unsigned i = 0, j = self->outer_dimensions; i < num_dimensions; i++)
+    {
+        if (le_reduce_axes_contain(axes, i))
+            order[j++] = i;
+    }
+
+    assert((self->inner_count > 0) || (self->quantities == LE_REDUCE_SUM));
+
+    self->view = le_tensor_permute(tensor, order);
+    le_free(order);
+
+    bool columns = (self->result == NULL) && leading && (reduced_dimensions > 0) &&
+        (self->outer_count >= 16) && (self->inner_count > 0) &&
+        (self->quantities & (LE_REDUCE_SUM | LE_REDUCE_MAX | LE_REDUCE_MIN)) &&
+        (self->op != LE_REDUCE_OP_ARGMAX) && (self->op != LE_REDUCE_OP_ARGMIN) &&
+        le_tensor_contiguous(tensor);
+
+    if (columns)
+    {
+        le_parallel_for(self->outer_count, le_reduce_grain(self->inner_count), le_reduction_run_columns, self);
+    }
+    else
+    {
+        /// @note: Elements of few outputs are split into chunks to keep all threads busy
+        self->chunks_count = 1;
+        unsigned threads_count = le_get_num_threads();
+        if ((self->outer_count < threads_count) && (self->inner_count >= 2 * LE_REDUCE_PARALLEL_GRAIN))
+        {
+            self->chunks_count = self->inner_count / LE_REDUCE_PARALLEL_GRAIN;
+            if (self->chunks_count > threads_count)
+                self->chunks_count = threads_count;
+        }
+
+        if (self->chunks_count == 1)
+        {
+            le_parallel_for(self->outer_count, le_reduce_grain(self->inner_count), le_reduction_run_outputs, self);
+        }
+        else
+        {
+            size_t tasks_count = self->outer_count * self->chunks_count;
+            self->states = le_alloc(tasks_count * sizeof(LeReduceState));
+            le_parallel_for(tasks_count, 1, le_reduction_run_chunks, self);
+            for (size_t output = 0; output < self->outer_count; output++)
+            {
+                LeReduceState *state = &self->states[output * self->chunks_count];
+                for (size_t chunk = 1; chunk < self->chunks_count; chunk++)
+                    le_reduce_state_merge(state, state + chunk, self->quantities);
+                le_reduction_store(self, output, state);
+            }
+            le_free(self->states);
+        }
+    }
+
+    le_tensor_free(self->view);
+}
+
+void
+le_tensor_reduce_into(LeTensor *destination, const LeTensor *tensor, LeReduceOp op, uint32_t axes)
+{
+    assert(destination);
+    assert(destination->device_type == LE_DEVICE_TYPE_CPU);
+    if ((op == LE_REDUCE_OP_ARGMAX) || (op == LE_REDUCE_OP_ARGMIN))
+        assert(destination->element_type == LE_TYPE_UINT32);
+    else
+        assert(destination->element_type == LE_TYPE_FLOAT32);
+
+    le_tensor_make_writable(destination);
+    LeReduction reduction = {
+        .op = op,
+        .quantities = le_reduce_op_get_quantities(op),
+        .destination = destination,
+        .result = NULL
+    };
+    le_reduction_run(&reduction, tensor, axes);
+    assert(le_shape_get_elements_count(destination->shape) == reduction.outer_count);
+}
+
+LeTensor *
+le_tensor_new_reduce(const LeTensor *tensor, LeReduceOp op, uint32_t axes, bool keep_dimensions)
+{
+    assert(tensor);
+
+    unsigned num_dimensions = 0;
+    for (unsigned i = 0; i < tensor->shape->num_dimensions; i++)
+    {
+        if (keep_dimensions || !le_reduce_axes_contain(axes, i))
+            num_dimensions++;
+    }
+
+    LeShape *shape = le_shape_new_uninitialized(num_dimensions);
+    for (unsigned i = 0, j = 0; i < tensor->shape->num_dimensions; i++)
+    {
+        bool reduced = le_reduce_axes_contain(axes, i);
+        if (!reduced)
+            shape->sizes[j++] = tensor->shape->sizes[i];
+        else if (keep_dimensions)
+            shape->sizes[j++] = 1;
+    }
+    le_shape_update(shape);
+
+    bool index = (op == LE_REDUCE_OP_ARGMAX) || (op == LE_REDUCE_OP_ARGMIN);
+    LeTensor *self = le_tensor_new_uninitialized(index ? LE_TYPE_UINT32 : LE_TYPE_FLOAT32, shape);
+    le_tensor_reduce_into(self, tensor, op, axes);
+
+    return self;
+}
+
+float
+le_tensor_reduce_f32(const LeTensor *tensor, LeReduceOp op)
+{
+    assert(op != LE_REDUCE_OP_ARGMAX);
+    assert(op != LE_REDUCE_OP_ARGMIN);
+
+    /// @note: Single element destination lives on stack
+    float value = 0.0f;
+    LeTensorView destination;
+    le_tensor_init_shape(&destination, 1, (uint32_t[]){ 1 });
+    le_tensor_init_strides(&destination);
+    destination.element_type = LE_TYPE_FLOAT32;
+    destination.owns_data = false;
+    destination.mapping = LE_TENSOR_MAPPING_NONE;
+    destination.device_type = LE_DEVICE_TYPE_CPU;
+    destination.data = &value;
+    destination.storage = NULL;
+    le_tensor_reduce_into(&destination, tensor, op, LE_REDUCE_ALL_AXES);
+
+    return value;
+}
+
+LeTensorStats
+le_tensor_get_stats(LeTensor *self)
+{
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+
+    LeTensorStats stats;
+    stats.deviation = 0.0f;
+    stats.mean = 0.0f;
+    stats.max = 0.0f;
+    stats.min = 0.0f;
+    stats.nans = 0;
+    stats.zeros = 0;
+
+    if (le_shape_get_elements_count(self->shape) == 0)
+        return stats;
+
+    /// @note: All statistics are gathered in single pass
+    LeReduceState state;
+    LeReduction reduction = {
+        .op = LE_REDUCE_OP_VARIANCE,
+        .quantities = LE_REDUCE_MOMENTS | LE_REDUCE_MAX | LE_REDUCE_MIN | LE_REDUCE_COUNTS,
+        .destination = NULL,
+        .result = &state
+    };
+    le_reduction_run(&reduction, self, LE_REDUCE_ALL_AXES);
+
+    stats.min = state.min;
+    stats.max = state.max;
+    stats.mean = state.mean;
+    stats.deviation = sqrtf(state.m2 / (float)state.count);
+    stats.nans = state.nans;
+    stats.zeros = state.zeros;
+
+    return stats;
+}
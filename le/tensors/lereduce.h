@@ -0,0 +1,54 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Reductions of tensors along any set of dimensions */
+
+#ifndef __LEREDUCE_H__
+#define __LEREDUCE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <le/lemacros.h>
+#include "letensor.h"
+
+LE_BEGIN_DECLS
+
+typedef enum LeReduceOp
+{
+    LE_REDUCE_OP_SUM,
+    LE_REDUCE_OP_MEAN,
+    LE_REDUCE_OP_MAX,
+    LE_REDUCE_OP_MIN,
+    /// @note: Index of first maximum among reduced elements, result is of LE_TYPE_UINT32
+    LE_REDUCE_OP_ARGMAX,
+    /// @note: Index of first minimum among reduced elements, result is of LE_TYPE_UINT32
+    LE_REDUCE_OP_ARGMIN,
+    /// @note: Population variance, computed in single pass
+    LE_REDUCE_OP_VARIANCE
+} LeReduceOp;
+
+/// @note: Bit i of axes bitmask selects dimension i to be reduced
+#define LE_REDUCE_AXIS(dimension) (1u << (dimension))
+#define LE_REDUCE_ALL_AXES UINT32_MAX
+
+/// @note: Reduces FLOAT32 tensor along dimensions selected by axes. Reduced dimensions are
+/// kept with size 1 if keep_dimensions is set and removed otherwise.
+/// Indices of ARGMAX and ARGMIN enumerate reduced elements in row-major order of reduced dimensions.
+LeTensor *         le_tensor_new_reduce                    (const LeTensor *        tensor,
+                                                            LeReduceOp              op,
+                                                            uint32_t                axes,
+                                                            bool                    keep_dimensions);
+
+/// @note: Destination must be CPU tensor of result type with one element per kept index
+void               le_tensor_reduce_into                   (LeTensor *              destination,
+                                                            const LeTensor *        tensor,
+                                                            LeReduceOp              op,
+                                                            uint32_t                axes);
+
+/// @note: Reduces all elements of tensor, op must not be ARGMAX or ARGMIN
+float              le_tensor_reduce_f32                    (const LeTensor *        tensor,
+                                                            LeReduceOp              op);
+
+LE_END_DECLS
+
+#endif
@@ -1,16 +1,19 @@
 #include "lescalar.h"
 #include <stdlib.h>
 #include "letensor-imp.h"
+#include <le/lemem.h>
 
 LeScalar *
 le_scalar_new_f32(float scalar)
 {
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->element_type = LE_TYPE_FLOAT32;
-    self->shape = le_shape_new(0);
-    self->stride = 0;
+    le_tensor_init_shape(self, 0, NULL);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(sizeof(float));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(sizeof(float));
     *((float *)self->data) = scalar;
     return self;
 }
@@ -18,12 +21,14 @@ le_scalar_new_f32(float scalar)
 LeScalar *
 le_scalar_new_f64(double scalar)
 {
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->element_type = LE_TYPE_FLOAT64;
-    self->shape = le_shape_new(0);
-    self->stride = 0;
+    le_tensor_init_shape(self, 0, NULL);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    self->data = malloc(sizeof(double));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(sizeof(double));
     *((double *)self->data) = scalar;
     return self;
 }
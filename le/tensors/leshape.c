@@ -1,9 +1,14 @@
 /* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
+#define DEFAULT_LOG_CATEGORY "shape"
+
 #include "leshape.h"
+#include <le/lemem.h>
+#include <le/lelog.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdarg.h>
 #include <assert.h>
@@ -24,6 +29,7 @@ le_shape_new(unsigned num_dimensions, ...)
     }
     
     va_end(args);
+    le_shape_update(self);
     
     return self;
 }
@@ -31,13 +37,50 @@ le_shape_new(unsigned num_dimensions, ...)
 LeShape *
 le_shape_new_uninitialized(unsigned num_dimensions)
 {
-    LeShape *self = malloc(sizeof(LeShape));
-    self->num_dimensions = num_dimensions;
-    self->sizes = malloc(num_dimensions * sizeof(uint32_t));
+    LeShape *self = le_alloc(sizeof(LeShape));
+    le_shape_init(self, num_dimensions, NULL);
     
     return self;
 }
 
+void
+le_shape_init(LeShape *self, unsigned num_dimensions, const uint32_t *sizes)
+{
+    assert(self);
+    self->num_dimensions = num_dimensions;
+    if (num_dimensions <= LE_SHAPE_INLINE_DIMENSIONS)
+        self->sizes = self->inline_sizes;
+    else
+        self->sizes = le_alloc(num_dimensions * sizeof(uint32_t));
+    if (sizes)
+        memcpy(self->sizes, sizes, num_dimensions * sizeof(uint32_t));
+    else
+        memset(self->sizes, 0, num_dimensions * sizeof(uint32_t));
+    le_shape_update(self);
+}
+
+void
+le_shape_clear(LeShape *self)
+{
+    if (self && self->sizes != self->inline_sizes)
+        le_free(self->sizes);
+}
+
+void
+le_shape_update(LeShape *self)
+{
+    assert(self);
+    size_t count = 1;
+    for (unsigned i = 0; i < self->num_dimensions; i++)
+    {
+        /// @note: Checked in release builds too, since wrapped count would allocate too few elements
+        if ((self->sizes[i] != 0) && (count > SIZE_MAX / self->sizes[i]))
+            LE_ERROR("Elements count of shape with %u dimensions does not fit into size_t", self->num_dimensions);
+        count *= self->sizes[i];
+    }
+    self->elements_count = count;
+}
+
 uint32_t *
 le_shape_get_data(LeShape *shape)
 {
@@ -59,29 +102,26 @@ le_shape_set_size(LeShape *shape, unsigned dimension, uint32_t size)
     assert(shape);
     assert(dimension < shape->num_dimensions);
     shape->sizes[dimension] = size;
+    le_shape_update(shape);
 }
 
+/// @note: Elements count is recomputed, so that sizes written directly into another are picked up
 LeShape *
 le_shape_copy(LeShape *another)
 {
     assert(another);
-    LeShape *self = malloc(sizeof(LeShape));
-    self->num_dimensions = another->num_dimensions;
-    size_t size = self->num_dimensions * sizeof(uint32_t);
-    self->sizes = malloc(size);
-    memcpy(self->sizes, another->sizes, size);
+    LeShape *self = le_alloc(sizeof(LeShape));
+    le_shape_init(self, another->num_dimensions, another->sizes);
     return self;
 }
 
 LeShape *
 le_shape_lower_dimension(LeShape *another)
 {
-    /// @todo: Add assertions
-    LeShape *self = malloc(sizeof(LeShape));
-    self->num_dimensions = another->num_dimensions - 1;
-    size_t size = self->num_dimensions * sizeof(uint32_t);
-    self->sizes = malloc(size);
-    memcpy(self->sizes, another->sizes + 1, size);
+    assert(another);
+    assert(another->num_dimensions > 0);
+    LeShape *self = le_alloc(sizeof(LeShape));
+    le_shape_init(self, another->num_dimensions - 1, another->sizes + 1);
     return self;
 }
 
@@ -90,8 +130,8 @@ le_shape_free(LeShape *self)
 {
     if (self)
     {
-        free(self->sizes);
-        free(self);
+        le_shape_clear(self);
+        le_free(self);
     }
 }
 
@@ -111,7 +151,7 @@ le_shape_to_cstr(LeShape *shape)
             int written = 0;
             if (shape->sizes[i])
             {
-                sprintf(ptr, "%d%n", shape->sizes[i], &written);
+                sprintf(ptr, "%u%n", shape->sizes[i], &written);
             }
             else
             {
@@ -134,31 +174,20 @@ le_shape_to_cstr(LeShape *shape)
     return buffer;
 }
 
-uint32_t
+size_t
 le_shape_get_elements_count(LeShape *shape)
 {
     assert(shape);
-    assert(shape->sizes);
-    
-    uint32_t count = 0;
-    if (shape)
-    {
-        count = 1;
-        for (unsigned i = 0; i < shape->num_dimensions; i++)
-        {
-            count *= shape->sizes[i];
-        }
-    }
-    return count;
+    return shape->elements_count;
 }
 
-uint32_t
+size_t
 le_shape_get_regions_count(LeShape *shape)
 {
     assert(shape);
     assert(shape->sizes);
     
-    uint32_t count = 0;
+    size_t count = 0;
     if (shape)
     {
         count = 1;
@@ -187,3 +216,30 @@ le_shape_equal(LeShape *a, LeShape *b)
     
     return true;
 }
+
+LeShape *
+le_shape_new_broadcast(LeShape *a, LeShape *b)
+{
+    assert(a);
+    assert(b);
+
+    unsigned num_dimensions = (a->num_dimensions > b->num_dimensions) ? a->num_dimensions : b->num_dimensions;
+    LeShape *self = le_shape_new_uninitialized(num_dimensions);
+
+    for (unsigned i = 1; i <= num_dimensions; i++)
+    {
+        uint32_t a_size = (i <= a->num_dimensions) ? a->sizes[a->num_dimensions - i] : 1;
+        uint32_t b_size = (i <= b->num_dimensions) ? b->sizes[b->num_dimensions - i] : 1;
+
+        if ((a_size != b_size) && (a_size != 1) && (b_size != 1))
+        {
+            le_shape_free(self);
+            return NULL;
+        }
+
+        self->sizes[num_dimensions - i] = (a_size == 1) ? b_size : a_size;
+    }
+    le_shape_update(self);
+
+    return self;
+}
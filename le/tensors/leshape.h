@@ -4,20 +4,43 @@
 #ifndef __LESHAPE_H__
 #define __LESHAPE_H__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <le/lemacros.h>
 
 LE_BEGIN_DECLS
 
+/// @note: Shapes of up to this many dimensions keep sizes inline, without separate allocation
+#define LE_SHAPE_INLINE_DIMENSIONS 6
+
 typedef struct LeShape
 {
     unsigned  num_dimensions;
+    /// @note: Points to inline_sizes when there are at most LE_SHAPE_INLINE_DIMENSIONS dimensions,
+    /// so shape must not be copied by value. Call le_shape_update after writing sizes directly.
     uint32_t *sizes;
+    /// @note: Product of sizes, cached. Sizes are 32-bit, their product is not.
+    size_t    elements_count;
+    uint32_t  inline_sizes[LE_SHAPE_INLINE_DIMENSIONS];
 } LeShape;
 
+/// @note: Sizes are set to zero
 LeShape *    le_shape_new_uninitialized  (unsigned  num_dimensions);
 
+/// @note: Initializes shape placed on stack or inside another structure, sizes are copied
+/// from array when it is not NULL and set to zero otherwise. Release with le_shape_clear.
+void         le_shape_init               (LeShape  *shape,
+                                          unsigned  num_dimensions,
+                                          const uint32_t *sizes);
+
+/// @note: Frees sizes of initialized shape if they are not inline
+void         le_shape_clear              (LeShape  *shape);
+
+/// @note: Updates cached elements count after sizes are written directly.
+/// Exits with error unless count fits into size_t.
+void         le_shape_update             (LeShape  *shape);
+
 LeShape *    le_shape_new                (unsigned  num_dimensions,
                                           ...);
 
@@ -38,14 +61,21 @@ void         le_shape_free               (LeShape  *shape);
 
 const char * le_shape_to_cstr            (LeShape  *shape);
 
-uint32_t     le_shape_get_elements_count (LeShape  *shape);
+size_t       le_shape_get_elements_count (LeShape  *shape);
 
 /// @todo: Come up with a better name
-uint32_t     le_shape_get_regions_count  (LeShape  *shape);
+size_t       le_shape_get_regions_count  (LeShape  *shape);
 
 bool         le_shape_equal              (LeShape  *a,
                                           LeShape  *b);
 
+/// @note: Shape of result of element-wise operation on tensors of shapes a and b.
+/// Dimensions are matched starting from the lowest one, missing dimensions are treated
+/// as dimensions of size 1 and size 1 is stretched to size of other dimension.
+/// Returns NULL if shapes are not compatible.
+LeShape *    le_shape_new_broadcast      (LeShape  *a,
+                                          LeShape  *b);
+
 LE_END_DECLS
 
 #endif
@@ -1,43 +1,150 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
 #include "letensor-cast.h"
+#include "lekernels.h"
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+/// @note: Scaled casts go through single precision blocks of this many elements
+#define LE_CAST_BLOCK_SIZE 256
+
+typedef void (*LeCastFunction)(void *destination, const void *source, size_t source_stride, size_t n);
+
+/// @note: Every source value is exactly representable in double precision
+#define LE_CAST_LOAD_INTEGER(value) ((double)(value))
+#define LE_CAST_LOAD_FLOAT(value) ((double)(value))
+#define LE_CAST_LOAD_HALF(value) ((double)le_f16_to_f32(value))
+
+/// @note: Bounds are integers, so clamping before rounding gives same result. Adding and subtracting
+/// 1.5 * 2^52 rounds values below 2^51 to nearest integer, ties to even, in current rounding mode.
+static inline double
+le_cast_saturate(double value, double min, double max)
+{
+    if (value != value)
+        return 0.0;
+    value = (value < min) ? min : (value > max) ? max : value;
+    return (value + 6755399441055744.0) - 6755399441055744.0;
+}
+
+#define LE_CAST_STORE_I8(value) ((int8_t)le_cast_saturate(value, INT8_MIN, INT8_MAX))
+#define LE_CAST_STORE_U8(value) ((uint8_t)le_cast_saturate(value, 0, UINT8_MAX))
+#define LE_CAST_STORE_I16(value) ((int16_t)le_cast_saturate(value, INT16_MIN, INT16_MAX))
+#define LE_CAST_STORE_U16(value) ((uint16_t)le_cast_saturate(value, 0, UINT16_MAX))
+#define LE_CAST_STORE_I32(value) ((int32_t)le_cast_saturate(value, INT32_MIN, INT32_MAX))
+#define LE_CAST_STORE_U32(value) ((uint32_t)le_cast_saturate(value, 0, UINT32_MAX))
+#define LE_CAST_STORE_F16(value) le_f32_to_f16((float)(value))
+#define LE_CAST_STORE_F32(value) ((float)(value))
+#define LE_CAST_STORE_F64(value) ((double)(value))
+
+/// @note: Calls X(destination, source) for every pair of types, each type described by
+/// name, C type, LeType and suffix of load or store macro
+#define LE_CAST_SOURCES(X, ...) \
+    X(__VA_ARGS__, i8, int8_t, LE_TYPE_INT8, INTEGER) \
+    X(__VA_ARGS__, u8, uint8_t, LE_TYPE_UINT8, INTEGER) \
+    X(__VA_ARGS__, i16, int16_t, LE_TYPE_INT16, INTEGER) \
+    X(__VA_ARGS__, u16, uint16_t, LE_TYPE_UINT16, INTEGER) \
+    X(__VA_ARGS__, i32, int32_t, LE_TYPE_INT32, INTEGER) \
+    X(__VA_ARGS__, u32, uint32_t, LE_TYPE_UINT32, INTEGER) \
+    X(__VA_ARGS__, f16, lehalf, LE_TYPE_FLOAT16, HALF) \
+    X(__VA_ARGS__, f32, float, LE_TYPE_FLOAT32, FLOAT) \
+    X(__VA_ARGS__, f64, double, LE_TYPE_FLOAT64, FLOAT)
+
+#define LE_CAST_PAIRS(X) \
+    LE_CAST_SOURCES(X, i8, int8_t, LE_TYPE_INT8, I8) \
+    LE_CAST_SOURCES(X, u8, uint8_t, LE_TYPE_UINT8, U8) \
+    LE_CAST_SOURCES(X, i16, int16_t, LE_TYPE_INT16, I16) \
+    LE_CAST_SOURCES(X, u16, uint16_t, LE_TYPE_UINT16, U16) \
+    LE_CAST_SOURCES(X, i32, int32_t, LE_TYPE_INT32, I32) \
+    LE_CAST_SOURCES(X, u32, uint32_t, LE_TYPE_UINT32, U32) \
+    LE_CAST_SOURCES(X, f16, lehalf, LE_TYPE_FLOAT16, F16) \
+    LE_CAST_SOURCES(X, f32, float, LE_TYPE_FLOAT32, F32) \
+    LE_CAST_SOURCES(X, f64, double, LE_TYPE_FLOAT64, F64)
 
-#define DEFINE_SIMPLE_CAST_FN(dst_type, dsttype_name, src_type, srctype_name) \
-void \
-dsttype_name ## _ ## srctype_name(void *dst, void *src, size_t index) \
+#define LE_CAST_DEFINE(dst_name, dst_type, dst_le_type, dst_store, src_name, src_type, src_le_type, src_load) \
+static void \
+le_cast_ ## dst_name ## _ ## src_name(void *destination, const void *source, size_t source_stride, size_t n) \
 { \
-    ((dst_type *)dst)[index] = ((src_type *)src)[index]; \
+    dst_type *d = destination; \
+    const src_type *s = source; \
+    for (size_t i = 0; i < n; i++) \
+        d[i] = LE_CAST_STORE_ ## dst_store(LE_CAST_LOAD_ ## src_load(s[i * source_stride])); \
 }
 
-DEFINE_SIMPLE_CAST_FN(float, f32, uint8_t, u8)
-DEFINE_SIMPLE_CAST_FN(uint32_t, u32, uint8_t, u8)
-DEFINE_SIMPLE_CAST_FN(uint8_t, u8, uint32_t, u32)
+#define LE_CAST_ENTRY(dst_name, dst_type, dst_le_type, dst_store, src_name, src_type, src_le_type, src_load) \
+    [dst_le_type][src_le_type] = le_cast_ ## dst_name ## _ ## src_name,
 
-bool le_cast_rawcpy[LE_TYPE_COUNT][LE_TYPE_COUNT] =
+LE_CAST_PAIRS(LE_CAST_DEFINE)
+
+static const LeCastFunction le_cast_fn[LE_TYPE_COUNT][LE_TYPE_COUNT] =
 {
-    /* to\from  void   i8     u8     i16    u16    i32    u32    f16    f32    f64 */
-    /* void */ {false, false, false, false, false, false, false, false, false, false},
-    /* i8   */ {false, true,  true,  false, false, false, false, false, false, false},
-    /* u8   */ {false, true,  true,  false, false, false, false, false, false, false},
-    /* i16  */ {false, false, false, true,  true,  false, false, false, false, false},
-    /* u16  */ {false, false, false, true,  true,  false, false, false, false, false},
-    /* i32  */ {false, false, false, false, false, true,  true,  false, false, false},
-    /* u32  */ {false, false, false, false, false, true,  true,  false, false, false},
-    /* f16  */ {false, false, false, false, false, false, false, true,  false, false},
-    /* f32  */ {false, false, false, false, false, false, false, false, true,  false},
-    /* f64  */ {false, false, false, false, false, false, false, false, false, true}
+    LE_CAST_PAIRS(LE_CAST_ENTRY)
 };
 
-LeCast le_cast_fn[LE_TYPE_COUNT][LE_TYPE_COUNT] =
+void
+le_cast(LeType destination_type, void *destination, LeType source_type, const void *source,
+        size_t source_stride, size_t n)
 {
-    /* to\from  void     i8       u8       i16      u16      i32      u32      f16      f32      f64 */
-    /* void */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* i8   */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* u8   */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    u8_u32,  NULL,    NULL,    NULL},
-    /* i16  */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* u16  */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* i32  */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* u32  */ {NULL,    NULL,    u32_u8,  NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* f16  */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* f32  */ {NULL,    NULL,    f32_u8,  NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL},
-    /* f64  */ {NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL,    NULL}
-};
+    assert(destination_type < LE_TYPE_COUNT && source_type < LE_TYPE_COUNT);
+    assert(le_cast_fn[destination_type][source_type]);
+
+    /// @note: Contiguous conversions of hot pairs use vectorized kernels
+    if (source_stride == 1)
+    {
+        if (destination_type == source_type)
+        {
+            memcpy(destination, source, n * le_type_size(source_type));
+            return;
+        }
+        const LeKernels *kernels = le_kernels_get();
+        if (destination_type == LE_TYPE_FLOAT32 && source_type == LE_TYPE_UINT8)
+        {
+            kernels->u8_to_f32(destination, source, 1.0f, 0.0f, n);
+            return;
+        }
+        if (destination_type == LE_TYPE_UINT8 && source_type == LE_TYPE_FLOAT32)
+        {
+            kernels->quantize_u8(destination, source, 1.0f, 0.0f, n);
+            return;
+        }
+        if (destination_type == LE_TYPE_FLOAT32 && source_type == LE_TYPE_FLOAT16)
+        {
+            kernels->f16_to_f32(destination, source, n);
+            return;
+        }
+        if (destination_type == LE_TYPE_FLOAT16 && source_type == LE_TYPE_FLOAT32)
+        {
+            kernels->f32_to_f16(destination, source, n);
+            return;
+        }
+    }
+
+    le_cast_fn[destination_type][source_type](destination, source, source_stride, n);
+}
+
+void
+le_cast_scaled(LeType destination_type, void *destination, LeType source_type, const void *source,
+               size_t source_stride, size_t n, float scale, float offset)
+{
+    const LeKernels *kernels = le_kernels_get();
+
+    if (destination_type == LE_TYPE_FLOAT32 && source_type == LE_TYPE_UINT8 && source_stride == 1)
+    {
+        kernels->u8_to_f32(destination, source, scale, offset, n);
+        return;
+    }
+
+    size_t destination_size = le_type_size(destination_type);
+    size_t source_size = le_type_size(source_type);
+    float block[LE_CAST_BLOCK_SIZE];
+    for (size_t x = 0; x < n; x += LE_CAST_BLOCK_SIZE)
+    {
+        size_t count = (n - x < LE_CAST_BLOCK_SIZE) ? n - x : LE_CAST_BLOCK_SIZE;
+        le_cast(LE_TYPE_FLOAT32, block, source_type, (const uint8_t *)source + x * source_stride * source_size,
+                source_stride, count);
+        kernels->mul_scalar_f32(block, scale, count);
+        kernels->add_scalar_f32(block, offset, count);
+        le_cast(destination_type, (uint8_t *)destination + x * destination_size, LE_TYPE_FLOAT32, block, 1, count);
+    }
+}
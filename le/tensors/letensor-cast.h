@@ -1,8 +1,37 @@
-#include <stdbool.h>
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Bulk conversion of arrays between element types */
+
+#ifndef __LETENSOR_CAST_H__
+#define __LETENSOR_CAST_H__
+
+#include <stddef.h>
+#include <le/lemacros.h>
 #include "letype.h"
 
-typedef void (*LeCast)(void *dst, void *src, size_t index);
+LE_BEGIN_DECLS
+
+/// @note: Converts n elements of source, read with stride in elements, into contiguous destination.
+/// Every pair of types except void is supported. Integers out of range of destination type saturate,
+/// floating point values converted to integers are rounded to nearest, ties to even, and NaN becomes zero.
+void               le_cast                                 (LeType                  destination_type,
+                                                            void *                  destination,
+                                                            LeType                  source_type,
+                                                            const void *            source,
+                                                            size_t                  source_stride,
+                                                            size_t                  n);
+
+/// @note: Same as le_cast of source[i] * scale + offset, computed in single precision
+void               le_cast_scaled                          (LeType                  destination_type,
+                                                            void *                  destination,
+                                                            LeType                  source_type,
+                                                            const void *            source,
+                                                            size_t                  source_stride,
+                                                            size_t                  n,
+                                                            float                   scale,
+                                                            float                   offset);
 
-extern bool le_cast_rawcpy[LE_TYPE_COUNT][LE_TYPE_COUNT];
+LE_END_DECLS
 
-extern LeCast le_cast_fn[LE_TYPE_COUNT][LE_TYPE_COUNT];
+#endif
@@ -4,21 +4,136 @@
 #ifndef __LETENSOR_IMP_H__
 #define __LETENSOR_IMP_H__
 
+#include <stddef.h>
 #include <stdbool.h>
 #include "letype.h"
 #include "leshape.h"
 #include "../../backends/ledevice.h"
 
+/// @note: How elements of tensor owning them are held
+typedef enum LeTensorMapping
+{
+    /// @note: Block of le_alloc or of device, which may be shared with copies of tensor
+    LE_TENSOR_MAPPING_NONE,
+    /// @note: Read-only mapping of file, see le_tensor_new_mmap
+    LE_TENSOR_MAPPING_READ_ONLY,
+    /// @note: Mapping of file with pages written by process copied privately
+    LE_TENSOR_MAPPING_COPY_ON_WRITE
+} LeTensorMapping;
+
 struct LeTensor
 {
-    LeType        element_type;
-    LeShape      *shape;
-    bool          owns_data;
-    /// @note: In dimension of lowest order
-    uint32_t      stride;
-    LeDeviceType  device_type;
-    void         *data;
+    LeType          element_type;
+    /// @note: Points to shape_storage, or to separately allocated shape owned by tensor
+    LeShape        *shape;
+    bool            owns_data;
+    LeTensorMapping mapping;
+    /// @note: Distance in elements between neighbouring elements of each dimension.
+    /// Views share data with another tensor and point data to their first element.
+    /// Points to strides_storage for shapes of up to LE_SHAPE_INLINE_DIMENSIONS dimensions.
+    size_t         *strides;
+    LeDeviceType    device_type;
+    void           *data;
+    /// @note: For views created by le_tensor_pick and other functions returning views, block of
+    /// elements viewed, which view keeps alive and marks as viewed, see le_mem_retain_view.
+    /// NULL for views placed by caller and for views of elements not allocated by le_alloc.
+    void           *storage;
+    /// @note: Inline storage, so that header of tensor is a single allocation
+    LeShape         shape_storage;
+    size_t          strides_storage[LE_SHAPE_INLINE_DIMENSIONS];
 };
 
-#endif
+/// @note: Tensor header placed on stack or inside another structure, describing data of another
+/// tensor without any allocation. Initialized views are used as LeTensor and are never freed.
+/// They point to own inline storage, so must not be copied by value. They are not counted as
+/// views of elements, so they are used only within one call while another is not copied.
+typedef struct LeTensor LeTensorView;
+
+/// @note: Sets shape of new tensor to copy of num_dimensions sizes, kept in inline storage
+void               le_tensor_init_shape                    (LeTensor *              tensor,
+                                                            unsigned                num_dimensions,
+                                                            const uint32_t *        sizes);
+
+/// @note: Same as le_tensor_init_shape with sizes of shape, which is freed
+void               le_tensor_take_shape                    (LeTensor *              tensor,
+                                                            LeShape *               shape);
+
+/// @note: Sets strides of densely packed row-major tensor of current shape
+void               le_tensor_init_strides                  (LeTensor *              tensor);
+
+/// @note: Size in bytes of densely packed elements of tensor, exits with error unless it fits into size_t
+size_t             le_tensor_get_data_size                 (const LeTensor *        tensor);
+
+/// @note: Gives tensor own copy of elements it shares with its copies, see le_tensor_new_copy,
+/// or of read-only mapped file. Called by every function before it writes elements of tensor.
+/// Own copy is taken by le_alloc, so it outlives scratch scopes. Asserts that view does not
+/// write elements shared with copies, since only tensor owning them can take own copy.
+void               le_tensor_make_writable                 (LeTensor *              tensor);
+
+/// @note: Unmaps elements of tensor created by le_tensor_new_mmap
+void               le_tensor_unmap                         (LeTensor *              tensor);
+
+/// @note: View of whole another tensor. Elements are not copied, callers writing through views
+/// placed by them make another writable first, see le_tensor_make_writable
+LeTensor *         le_tensor_view_init                     (LeTensorView *          view,
+                                                            const LeTensor *        another);
+
+/// @note: Same as le_tensor_pick, placed into view
+LeTensor *         le_tensor_view_init_pick                (LeTensorView *          view,
+                                                            const LeTensor *        another,
+                                                            uint32_t                index);
 
+/// @note: Same as le_tensor_slice, placed into view
+LeTensor *         le_tensor_view_init_slice               (LeTensorView *          view,
+                                                            const LeTensor *        another,
+                                                            unsigned                dimension,
+                                                            uint32_t                start,
+                                                            uint32_t                length);
+
+/// @note: Same as le_matrix_get_column, placed into view
+LeTensor *         le_matrix_view_init_column              (LeTensorView *          view,
+                                                            const LeTensor *        matrix,
+                                                            unsigned                x);
+
+/// @note: Densely packed single precision tensor, either tensor itself or its copy placed into packed.
+/// Packed is NULL when tensor is returned, caller frees it.
+const LeTensor *   le_tensor_pack_f32                      (const LeTensor *        tensor,
+                                                            LeTensor **             packed);
+
+/// @note: Offset in elements of element with given row-major logical index
+size_t             le_tensor_offset                        (const LeTensor *        tensor,
+                                                            size_t                  index);
+
+/// @note: Offset in elements of first element of given row of lowest dimension
+size_t             le_tensor_row_offset                    (const LeTensor *        tensor,
+                                                            size_t                  row);
+
+static inline size_t
+le_matrix_offset(const LeTensor *matrix, unsigned y, unsigned x)
+{
+    return (size_t)y * matrix->strides[0] + (size_t)x * matrix->strides[1];
+}
+
+/// @note: Describes 2D matrix as row-major storage accepted by GEMM: matrix is either
+/// stored as is with row stride ld, or transposed and then layout_transpose flips transpose.
+/// Returns false when neither dimension is packed and matrix has to be copied.
+bool               le_matrix_get_gemm_layout               (const LeTensor *        matrix,
+                                                            bool                    transpose,
+                                                            bool *                  layout_transpose,
+                                                            size_t *                ld);
+
+/// @note: Copies count elements of row y of single precision matrix starting at column x into buffer
+void               le_matrix_load_row                      (const LeTensor *        matrix,
+                                                            unsigned                y,
+                                                            size_t                  x,
+                                                            size_t                  count,
+                                                            float *                 buffer);
+
+/// @note: Copies count elements of buffer into row y of single precision matrix starting at column x
+void               le_matrix_store_row                     (LeTensor *              matrix,
+                                                            unsigned                y,
+                                                            size_t                  x,
+                                                            size_t                  count,
+                                                            const float *           buffer);
+
+#endif
@@ -0,0 +1,125 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/// @note: For madvise when compiled in strict C11 mode
+#define _DEFAULT_SOURCE
+
+#include "letensor-mmap.h"
+#include "letensor-imp.h"
+#include <le/lemem.h>
+#include <assert.h>
+#include <stdint.h>
+#if defined(__unix__) || defined(__APPLE__)
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   define LE_TENSOR_HAVE_MMAP 1
+#endif
+
+#ifdef LE_TENSOR_HAVE_MMAP
+static void
+le_tensor_advise(void *address, size_t length, LeMmapFlags flags)
+{
+#ifdef MADV_SEQUENTIAL
+    if (flags & LE_MMAP_SEQUENTIAL)
+        madvise(address, length, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_RANDOM
+    if (flags & LE_MMAP_RANDOM)
+        madvise(address, length, MADV_RANDOM);
+#endif
+#ifdef MADV_WILLNEED
+    if (flags & LE_MMAP_WILL_NEED)
+        madvise(address, length, MADV_WILLNEED);
+#endif
+}
+
+/// @note: Maps length bytes of file at offset, which need not be aligned to page.
+/// Returns address of byte at offset.
+static void *
+le_tensor_map_file(const char *path, size_t offset, size_t length, LeMmapFlags flags)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (offset > (size_t)st.st_size) || (length > (size_t)st.st_size - offset))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t head = offset % page_size;
+    bool copy_on_write = flags & LE_MMAP_COPY_ON_WRITE;
+    uint8_t *mapping = mmap(NULL, head + length, copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                            copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd, (off_t)(offset - head));
+    /// @note: Mapping keeps file open
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return NULL;
+
+    le_tensor_advise(mapping, head + length, flags);
+
+    return mapping + head;
+}
+#endif
+
+LeTensor *
+le_tensor_new_mmap(const char *path, size_t offset, LeType type, LeShape *shape, LeMmapFlags flags)
+{
+    assert(path);
+    assert(shape);
+    assert(type != LE_TYPE_VOID);
+    assert(offset % le_type_size(type) == 0);
+    assert(!((flags & LE_MMAP_SEQUENTIAL) && (flags & LE_MMAP_RANDOM)));
+
+    size_t elements_count = le_shape_get_elements_count(shape);
+    assert(elements_count <= SIZE_MAX / le_type_size(type));
+    size_t data_size = elements_count * le_type_size(type);
+    /// @note: Empty mapping is not allowed, empty tensor has nothing to read
+    if (data_size == 0)
+        return le_tensor_new_uninitialized(type, shape);
+
+#ifdef LE_TENSOR_HAVE_MMAP
+    void *data = le_tensor_map_file(path, offset, data_size, flags);
+#else
+    void *data = NULL;
+#endif
+    if (data == NULL)
+    {
+        le_shape_free(shape);
+        return NULL;
+    }
+
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
+    self->device_type = LE_DEVICE_TYPE_CPU;
+    self->element_type = type;
+    le_tensor_take_shape(self, shape);
+    le_tensor_init_strides(self);
+    self->owns_data = true;
+    self->mapping = (flags & LE_MMAP_COPY_ON_WRITE) ? LE_TENSOR_MAPPING_COPY_ON_WRITE : LE_TENSOR_MAPPING_READ_ONLY;
+    self->storage = NULL;
+    self->data = data;
+
+    return self;
+}
+
+void
+le_tensor_unmap(LeTensor *self)
+{
+    assert(self);
+    assert(self->owns_data);
+    assert(self->mapping != LE_TENSOR_MAPPING_NONE);
+
+#ifdef LE_TENSOR_HAVE_MMAP
+    /// @note: Mapping starts at page boundary, data is at same distance from it as offset in file
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t head = (uintptr_t)self->data % page_size;
+    size_t data_size = le_tensor_get_data_size(self);
+    munmap((uint8_t *)self->data - head, head + data_size);
+#endif
+    self->data = NULL;
+}
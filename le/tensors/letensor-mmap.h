@@ -0,0 +1,41 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+/* Tensors with elements mapped from files */
+
+#ifndef __LETENSOR_MMAP_H__
+#define __LETENSOR_MMAP_H__
+
+#include <stddef.h>
+#include <le/lemacros.h>
+#include "letensor.h"
+
+LE_BEGIN_DECLS
+
+typedef enum LeMmapFlags
+{
+    /// @note: Elements are read-only, their pages are shared with every process mapping same file.
+    /// First write through le_tensor functions copies elements into memory of process.
+    LE_MMAP_READ_ONLY = 0,
+    /// @note: Elements can be written, written pages are copied privately and file is not modified
+    LE_MMAP_COPY_ON_WRITE = 1 << 0,
+    /// @note: Access hints, pages are read ahead aggressively or not at all
+    LE_MMAP_SEQUENTIAL = 1 << 1,
+    LE_MMAP_RANDOM = 1 << 2,
+    /// @note: Pages are read into page cache in background right away
+    LE_MMAP_WILL_NEED = 1 << 3
+} LeMmapFlags;
+
+/// @note: CPU tensor of given type and shape, which is taken, with densely packed elements
+/// stored in file at offset. File is not read, its pages are loaded on first access and
+/// unmapped by le_tensor_free. Offset must be multiple of size of type. Returns NULL if file
+/// can not be mapped or is too short, or memory mapping is not supported on platform.
+LeTensor *         le_tensor_new_mmap                      (const char *            path,
+                                                            size_t                  offset,
+                                                            LeType                  type,
+                                                            LeShape *               shape,
+                                                            LeMmapFlags             flags);
+
+LE_END_DECLS
+
+#endif
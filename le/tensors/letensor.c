@@ -8,6 +8,10 @@
 #include "letensor.h"
 #include "letensor-imp.h"
 #include "letensor-cast.h"
+#include "lekernels.h"
+#include "lereduce.h"
+#include <le/leparallel.h>
+#include <le/lemem.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,83 +29,518 @@
 #   include "../backends/cuda/lecuda.h"
 #endif
 
+/// @note: Element-wise operations are split between threads in parts of at least this many elements
+#define LE_TENSOR_PARALLEL_GRAIN 32768
+
+/// @note: Rows of strided tensors are gathered into contiguous blocks of this many elements
+/// before being passed to kernels
+#define LE_TENSOR_BLOCK_SIZE 1024
+
+/// @note: Arguments of single element-wise kernel call, only one of kernel pointers is set.
+/// Operands are passed as raw pointers when all of them are contiguous and as tensors otherwise.
+/// Half precision operands are converted to single precision blocks, and back after writing kernels.
+typedef struct LeTensorKernelTask
+{
+    void  (*unary)         (float *a, size_t n);
+    void  (*with_scalar)   (float *a, float scalar, size_t n);
+    void  (*binary)        (float *a, const float *b, size_t n);
+    void  (*scaled)        (float *a, float scale, const float *b, size_t n);
+    float (*reduce)        (const float *a, size_t n);
+    float (*reduce_binary) (const float *a, const float *b, size_t n);
+    void           *a;
+    const void     *b;
+    LeType          a_type;
+    LeType          b_type;
+    float           scalar;
+    const LeTensor *a_tensor;
+    const LeTensor *b_tensor;
+} LeTensorKernelTask;
+
+static float
+le_tensor_kernel_task_apply(const LeTensorKernelTask *task, float *a, const float *b, size_t n)
+{
+    if (task->unary)
+        task->unary(a, n);
+    else if (task->with_scalar)
+        task->with_scalar(a, task->scalar, n);
+    else if (task->binary)
+        task->binary(a, b, n);
+    else if (task->scaled)
+        task->scaled(a, task->scalar, b, n);
+    else if (task->reduce_binary)
+        return task->reduce_binary(a, b, n);
+    else if (task->reduce)
+        return task->reduce(a, n);
+    return 0.0f;
+}
+
+static bool
+le_tensor_kernel_task_writes(const LeTensorKernelTask *task)
+{
+    return (task->reduce == NULL) && (task->reduce_binary == NULL);
+}
+
+/// @note: Returns n single precision values of strided array of given type. Contiguous
+/// single precision values are returned in place, others are gathered into block.
+static float *
+le_tensor_load_block(float *block, void *data, LeType type, size_t stride, size_t n)
+{
+    if (type == LE_TYPE_FLOAT16)
+    {
+        const lehalf *values = data;
+        if (stride == 1)
+        {
+            le_kernels_get()->f16_to_f32(block, values, n);
+        }
+        else for (size_t i = 0; i < n; i++)
+        {
+            block[i] = le_f16_to_f32(values[i * stride]);
+        }
+        return block;
+    }
+
+    float *values = data;
+    if (stride == 1)
+        return values;
+    for (size_t i = 0; i < n; i++)
+        block[i] = values[i * stride];
+    return block;
+}
+
+static void
+le_tensor_store_block(void *data, LeType type, size_t stride, const float *block, size_t n)
+{
+    if (type == LE_TYPE_FLOAT16)
+    {
+        lehalf *values = data;
+        if (stride == 1)
+        {
+            le_kernels_get()->f32_to_f16(values, block, n);
+        }
+        else for (size_t i = 0; i < n; i++)
+        {
+            values[i * stride] = le_f32_to_f16(block[i]);
+        }
+        return;
+    }
+
+    float *values = data;
+    for (size_t i = 0; i < n; i++)
+        values[i * stride] = block[i];
+}
+
+/// @note: Applies kernel to n elements of strided arrays a and b in blocks
+static float
+le_tensor_kernel_task_apply_span(const LeTensorKernelTask *task, void *a, size_t a_stride,
+                                 const void *b, size_t b_stride, size_t n)
+{
+    size_t a_size = le_type_size(task->a_type);
+    size_t b_size = le_type_size(task->b_type);
+    float a_block[LE_TENSOR_BLOCK_SIZE];
+    float b_block[LE_TENSOR_BLOCK_SIZE];
+    const float *b_values = NULL;
+    float result = 0.0f;
+
+    for (size_t x = 0; x < n; x += LE_TENSOR_BLOCK_SIZE)
+    {
+        size_t count = n - x;
+        if (count > LE_TENSOR_BLOCK_SIZE)
+            count = LE_TENSOR_BLOCK_SIZE;
+
+        void *a_data = (uint8_t *)a + x * a_stride * a_size;
+        float *a_values = le_tensor_load_block(a_block, a_data, task->a_type, a_stride, count);
+        /// @note: Broadcast row has same value in every block, it is filled once
+        if (b && (b_stride != 0 || x == 0))
+            b_values = le_tensor_load_block(b_block, (uint8_t *)b + x * b_stride * b_size, task->b_type, b_stride, count);
+
+        result += le_tensor_kernel_task_apply(task, a_values, b_values, count);
+
+        if (le_tensor_kernel_task_writes(task) && a_values == a_block)
+            le_tensor_store_block(a_data, task->a_type, a_stride, a_block, count);
+    }
+
+    return result;
+}
+
+static float
+le_tensor_kernel_task_reduce(void *data, size_t begin, size_t end)
+{
+    const LeTensorKernelTask *task = data;
+
+    if (task->a_type == LE_TYPE_FLOAT16 || task->b_type == LE_TYPE_FLOAT16)
+    {
+        const void *b = task->b ? (const uint8_t *)task->b + begin * le_type_size(task->b_type) : NULL;
+        return le_tensor_kernel_task_apply_span(task, (uint8_t *)task->a + begin * le_type_size(task->a_type), 1,
+                                                b, 1, end - begin);
+    }
+
+    return le_tensor_kernel_task_apply(task, (float *)task->a + begin,
+                                       task->b ? (const float *)task->b + begin : NULL, end - begin);
+}
+
+static void
+le_tensor_kernel_task_run(void *data, size_t begin, size_t end)
+{
+    le_tensor_kernel_task_reduce(data, begin, end);
+}
+
+/// @note: Applies kernel to rows [begin, end) of lowest dimension of strided operands
+static float
+le_tensor_kernel_task_reduce_rows(void *data, size_t begin, size_t end)
+{
+    const LeTensorKernelTask *task = data;
+    const LeTensor *a = task->a_tensor;
+    const LeTensor *b = task->b_tensor;
+    unsigned last = a->shape->num_dimensions - 1;
+    uint32_t width = a->shape->sizes[last];
+    size_t a_size = le_type_size(a->element_type);
+    size_t b_size = b ? le_type_size(b->element_type) : 0;
+    float result = 0.0f;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        uint8_t *a_row = (uint8_t *)a->data + le_tensor_row_offset(a, row) * a_size;
+        const uint8_t *b_row = b ? (const uint8_t *)b->data + le_tensor_row_offset(b, row) * b_size : NULL;
+        result += le_tensor_kernel_task_apply_span(task, a_row, a->strides[last],
+                                                   b_row, b ? b->strides[last] : 1, width);
+    }
+
+    return result;
+}
+
+static void
+le_tensor_kernel_task_run_rows(void *data, size_t begin, size_t end)
+{
+    le_tensor_kernel_task_reduce_rows(data, begin, end);
+}
+
+static size_t
+le_tensor_rows_grain(uint32_t width)
+{
+    return width >= LE_TENSOR_PARALLEL_GRAIN ? 1 : LE_TENSOR_PARALLEL_GRAIN / (width ? width : 1);
+}
+
+/// @note: Runs kernel over all elements of a and b, which have same shape, and returns sum
+/// of results of reduction kernels. Operands are single or half precision.
+static float
+le_tensor_parallel_task(LeTensorKernelTask *task, const LeTensor *a, const LeTensor *b)
+{
+    size_t elements_count = le_shape_get_elements_count(a->shape);
+
+    assert(a->element_type == LE_TYPE_FLOAT32 || a->element_type == LE_TYPE_FLOAT16);
+    assert(b == NULL || b->element_type == LE_TYPE_FLOAT32 || b->element_type == LE_TYPE_FLOAT16);
+    task->a_type = a->element_type;
+    task->b_type = b ? b->element_type : LE_TYPE_FLOAT32;
+
+    if (le_tensor_contiguous(a) && ((b == NULL) || le_tensor_contiguous(b)))
+    {
+        task->a = a->data;
+        task->b = b ? b->data : NULL;
+        if (!le_tensor_kernel_task_writes(task))
+            return le_parallel_sum_f32(elements_count, LE_TENSOR_PARALLEL_GRAIN, le_tensor_kernel_task_reduce, task);
+        le_parallel_for(elements_count, LE_TENSOR_PARALLEL_GRAIN, le_tensor_kernel_task_run, task);
+        return 0.0f;
+    }
+
+    uint32_t width = le_shape_get_size(a->shape, -1);
+    if (width == 0)
+        return 0.0f;
+
+    task->a_tensor = a;
+    task->b_tensor = b;
+    size_t rows_count = elements_count / width;
+    if (!le_tensor_kernel_task_writes(task))
+        return le_parallel_sum_f32(rows_count, le_tensor_rows_grain(width), le_tensor_kernel_task_reduce_rows, task);
+    le_parallel_for(rows_count, le_tensor_rows_grain(width), le_tensor_kernel_task_run_rows, task);
+    return 0.0f;
+}
+
+/// @note: Element-wise kernels compute in single precision and read or write half precision operands
+static bool
+le_tensor_is_single_or_half(const LeTensor *tensor)
+{
+    return tensor->element_type == LE_TYPE_FLOAT32 || tensor->element_type == LE_TYPE_FLOAT16;
+}
+
+static void
+le_tensor_parallel_unary(void (*kernel)(float *, size_t), LeTensor *a)
+{
+    LeTensorKernelTask task = { .unary = kernel };
+    le_tensor_parallel_task(&task, a, NULL);
+}
+
+static void
+le_tensor_parallel_with_scalar(void (*kernel)(float *, float, size_t), LeTensor *a, float scalar)
+{
+    LeTensorKernelTask task = { .with_scalar = kernel, .scalar = scalar };
+    le_tensor_parallel_task(&task, a, NULL);
+}
+
+static void
+le_tensor_parallel_binary(void (*kernel)(float *, const float *, size_t), LeTensor *a, const LeTensor *b)
+{
+    LeTensorKernelTask task = { .binary = kernel };
+    le_tensor_parallel_task(&task, a, b);
+}
+
+static void
+le_tensor_parallel_scaled(void (*kernel)(float *, float, const float *, size_t), LeTensor *a, float scale, const LeTensor *b)
+{
+    LeTensorKernelTask task = { .scaled = kernel, .scalar = scale };
+    le_tensor_parallel_task(&task, a, b);
+}
+
+static float
+le_tensor_parallel_reduce_binary(float (*kernel)(const float *, const float *, size_t), const LeTensor *a, const LeTensor *b)
+{
+    LeTensorKernelTask task = { .reduce_binary = kernel };
+    return le_tensor_parallel_task(&task, a, b);
+}
+
+void
+le_tensor_init_shape(LeTensor *self, unsigned num_dimensions, const uint32_t *sizes)
+{
+    le_shape_init(&self->shape_storage, num_dimensions, sizes);
+    self->shape = &self->shape_storage;
+}
+
+void
+le_tensor_take_shape(LeTensor *self, LeShape *shape)
+{
+    assert(shape);
+    /// @note: Shape with sizes allocated separately is kept as is
+    if (shape->num_dimensions > LE_SHAPE_INLINE_DIMENSIONS)
+    {
+        self->shape = shape;
+        le_shape_update(shape);
+        return;
+    }
+    le_tensor_init_shape(self, shape->num_dimensions, shape->sizes);
+    le_shape_free(shape);
+}
+
+/// @note: Points strides to inline storage when possible, values are set by caller
+static void
+le_tensor_alloc_strides(LeTensor *self)
+{
+    unsigned num_dimensions = self->shape->num_dimensions;
+    if (num_dimensions <= LE_SHAPE_INLINE_DIMENSIONS)
+        self->strides = self->strides_storage;
+    else
+        self->strides = le_alloc(num_dimensions * sizeof(size_t));
+}
+
+/// @note: Releases shape and strides, but not data and header
+static void
+le_tensor_clear_layout(LeTensor *self)
+{
+    if (self->shape == &self->shape_storage)
+        le_shape_clear(&self->shape_storage);
+    else
+        le_shape_free(self->shape);
+    self->shape = NULL;
+    if (self->strides != self->strides_storage)
+        le_free(self->strides);
+    self->strides = NULL;
+}
+
+void
+le_tensor_init_strides(LeTensor *self)
+{
+    unsigned num_dimensions = self->shape->num_dimensions;
+    le_tensor_alloc_strides(self);
+    size_t stride = 1;
+    for (unsigned i = num_dimensions; i > 0; i--)
+    {
+        self->strides[i - 1] = stride;
+        stride *= self->shape->sizes[i - 1];
+    }
+}
+
+/// @note: Offset of index split over dimensions [0, last). 32-bit division is several times
+/// faster than 64-bit one, so indices of tensors with fewer than 2^32 elements use it.
+static inline size_t
+le_tensor_index_offset(const LeTensor *self, unsigned last, size_t index)
+{
+    size_t offset = 0;
+    if (index <= UINT32_MAX)
+    {
+        uint32_t index32 = (uint32_t)index;
+        for (unsigned i = last; i > 0; i--)
+        {
+            uint32_t size = self->shape->sizes[i - 1];
+            offset += (size_t)(index32 % size) * self->strides[i - 1];
+            index32 /= size;
+        }
+        return offset;
+    }
+
+    for (unsigned i = last; i > 0; i--)
+    {
+        uint32_t size = self->shape->sizes[i - 1];
+        offset += (index % size) * self->strides[i - 1];
+        index /= size;
+    }
+    return offset;
+}
+
+size_t
+le_tensor_get_data_size(const LeTensor *self)
+{
+    size_t elements_count = le_shape_get_elements_count(self->shape);
+    size_t element_size = le_type_size(self->element_type);
+    if ((element_size != 0) && (elements_count > SIZE_MAX / element_size))
+        LE_ERROR("Size of %zu elements does not fit into size_t", elements_count);
+    return elements_count * element_size;
+}
+
+size_t
+le_tensor_offset(const LeTensor *self, size_t index)
+{
+    return le_tensor_index_offset(self, self->shape->num_dimensions, index);
+}
+
+size_t
+le_tensor_row_offset(const LeTensor *self, size_t row)
+{
+    return le_tensor_index_offset(self, self->shape->num_dimensions - 1, row);
+}
+
+/// @note: Frees or unmaps elements owned by tensor
+static void
+le_tensor_release_data(LeTensor *self)
+{
+    if (!self->owns_data)
+        return;
+
+    if (self->mapping != LE_TENSOR_MAPPING_NONE)
+    {
+        le_tensor_unmap(self);
+        return;
+    }
+
+    switch (self->device_type)
+    {
+    case LE_DEVICE_TYPE_CPU:
+        le_free(self->data);
+        break;
+
+#ifdef HAVE_METAL
+    case LE_DEVICE_TYPE_METAL:
+        le_metal_data_free(self->data);
+        break;
+#endif
+
+#ifdef HAVE_CUDA
+    case LE_DEVICE_TYPE_CUDA:
+        le_cuda_data_free(self->data);
+        break;
+#endif
+
+    default:
+        assert(false);
+        break;
+    }
+}
+
+/// @note: Copies elements of source into destination of same type and shape, any of them may be strided
+static void
+le_tensor_copy_elements(LeTensor *destination, const LeTensor *source)
+{
+    size_t element_size = le_type_size(source->element_type);
+    size_t elements_count = le_shape_get_elements_count(source->shape);
+
+    if (le_tensor_contiguous(destination) && le_tensor_contiguous(source))
+    {
+        memcpy(destination->data, source->data, elements_count * element_size);
+        return;
+    }
+
+    if (source->shape->num_dimensions == 0)
+        return;
+
+    unsigned last = source->shape->num_dimensions - 1;
+    uint32_t width = source->shape->sizes[last];
+    if (width == 0)
+        return;
+
+    size_t rows_count = elements_count / width;
+    size_t destination_stride = destination->strides[last];
+    size_t source_stride = source->strides[last];
+    for (size_t row = 0; row < rows_count; row++)
+    {
+        uint8_t *destination_row = (uint8_t *)destination->data + le_tensor_row_offset(destination, row) * element_size;
+        const uint8_t *source_row = (const uint8_t *)source->data + le_tensor_row_offset(source, row) * element_size;
+        if (destination_stride == 1 && source_stride == 1)
+        {
+            memcpy(destination_row, source_row, width * element_size);
+        }
+        else for (uint32_t x = 0; x < width; x++)
+        {
+            memcpy(destination_row + (size_t)x * destination_stride * element_size,
+                   source_row + (size_t)x * source_stride * element_size,
+                   element_size);
+        }
+    }
+}
+
 LeTensor *
 le_tensor_new_from_va_list(LeType element_type, unsigned num_dimensions, va_list dims_and_data)
 {
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = element_type;
         
-    self->shape = le_shape_new_uninitialized(num_dimensions);
+    le_tensor_init_shape(self, num_dimensions, NULL);
     for (unsigned i = 0; i < num_dimensions; i++)
     {
         int size = va_arg(dims_and_data, int);
-        le_shape_set_size(self->shape, i, size);
+        self->shape->sizes[i] = size;
     }
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_shape_update(self->shape);
+    le_tensor_init_strides(self);
     
     self->owns_data = true;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    self->data = malloc(elements_count * le_type_size(self->element_type));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
+    self->data = le_alloc(le_tensor_get_data_size(self));
 
-    if (self->element_type == LE_TYPE_FLOAT16)
-        LE_ERROR("F16 Tensor init from va_list not implemented");
-        
-    for (unsigned i = 0; i < elements_count; i++)
+    /// @note: Variadic arguments are promoted to int or double
+    switch (self->element_type)
     {
-        switch (self->element_type)
-        {
-        case LE_TYPE_INT8:
-            {
-                int8_t value = (int8_t)va_arg(dims_and_data, int);
-                ((int8_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_UINT8:
-            {
-                uint8_t value = (uint8_t)va_arg(dims_and_data, int);
-                ((uint8_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_INT16:
-            {
-                int16_t value = (int16_t)va_arg(dims_and_data, int);
-                ((int16_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_UINT16:
-            {
-                uint16_t value = (uint16_t)va_arg(dims_and_data, int);
-                ((uint16_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_INT32:
-            {
-                int32_t value = (int32_t)va_arg(dims_and_data, int);
-                ((int32_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_UINT32:
-            {
-                int32_t value = (int32_t)va_arg(dims_and_data, int);
-                ((int32_t *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_FLOAT32:
-            {
-                float value = (float)va_arg(dims_and_data, double);
-                ((float *)self->data)[i] = value;
-            }
-            break;
-        case LE_TYPE_FLOAT64:
-            {
-                double value = (double)va_arg(dims_and_data, double);
-                ((double *)self->data)[i] = value;
-            }
-            break;
-        default:
-            break;
-        }
+#define FILL_FROM_VA_LIST(T, P) for (size_t i = 0; i < elements_count; i++) ((T *)self->data)[i] = (T)va_arg(dims_and_data, P);
+    case LE_TYPE_INT8:
+        FILL_FROM_VA_LIST(int8_t, int)
+        break;
+    case LE_TYPE_UINT8:
+        FILL_FROM_VA_LIST(uint8_t, int)
+        break;
+    case LE_TYPE_INT16:
+        FILL_FROM_VA_LIST(int16_t, int)
+        break;
+    case LE_TYPE_UINT16:
+        FILL_FROM_VA_LIST(uint16_t, int)
+        break;
+    case LE_TYPE_INT32:
+        FILL_FROM_VA_LIST(int32_t, int)
+        break;
+    case LE_TYPE_UINT32:
+        FILL_FROM_VA_LIST(int32_t, int)
+        break;
+    case LE_TYPE_FLOAT16:
+        for (size_t i = 0; i < elements_count; i++)
+            ((lehalf *)self->data)[i] = le_f32_to_f16((float)va_arg(dims_and_data, double));
+        break;
+    case LE_TYPE_FLOAT32:
+        FILL_FROM_VA_LIST(float, double)
+        break;
+    case LE_TYPE_FLOAT64:
+        FILL_FROM_VA_LIST(double, double)
+        break;
+    default:
+        break;
+#undef FILL_FROM_VA_LIST
     }
 
     return self;
@@ -123,18 +562,20 @@ le_tensor_new(LeType element_type, unsigned num_dimensions, ...)
 LeTensor *
 le_tensor_new_rand_f32(LeShape *shape)
 {
-    unsigned i;
-    unsigned elements_count;
+    size_t i;
+    size_t elements_count;
     LeTensor *self;
     
-    self = malloc(sizeof(struct LeTensor));
+    self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = LE_TYPE_FLOAT32;
-    self->shape = shape;
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_take_shape(self, shape);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    elements_count = le_shape_get_elements_count(shape);
-    self->data = malloc(elements_count * sizeof(float));
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    elements_count = le_shape_get_elements_count(self->shape);
+    self->data = le_alloc(elements_count * sizeof(float));
     
     for (i = 0; i < elements_count; i++)
     {
@@ -147,15 +588,15 @@ le_tensor_new_rand_f32(LeShape *shape)
 LeTensor *
 le_tensor_new_uninitialized(LeType element_type, LeShape *shape)
 {
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = element_type;
-    self->shape = shape;
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_take_shape(self, shape);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    size_t element_size = le_type_size(element_type);
-    unsigned elements_count = le_shape_get_elements_count(shape);
-    self->data = malloc(element_size * elements_count);
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_alloc(le_tensor_get_data_size(self));
     return self;
 }
 
@@ -165,56 +606,54 @@ le_tensor_get_data(const LeTensor *self)
     return self->data;
 }
 
+void *
+le_tensor_get_data_mut(LeTensor *self)
+{
+    le_tensor_make_writable(self);
+    return self->data;
+}
+
 LeTensor *
 le_tensor_new_copy(const LeTensor *another)
 {
     assert(another);
     
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = another->device_type;
     self->element_type = another->element_type;
-    self->shape = le_shape_copy(another->shape);
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_init_shape(self, another->shape->num_dimensions, another->shape->sizes);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    size_t data_size = le_shape_get_elements_count(self->shape) * le_type_size(self->element_type);
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(self);
     switch (self->device_type)
     {
 #ifdef HAVE_METAL
     case LE_DEVICE_TYPE_METAL:
-        if (another->stride == le_shape_get_size(another->shape, -1))
-        {
-            self->data = le_metal_data_copy(another->data, data_size);
-        }
+        assert(le_tensor_contiguous(another));
+        self->data = le_metal_data_copy(another->data, data_size);
         break;
 #endif
 #ifdef HAVE_CUDA
     case LE_DEVICE_TYPE_CUDA:
-        if (another->stride == le_shape_get_size(another->shape, -1))
-        {
-            self->data = le_cuda_data_copy(another->data, data_size);
-        }
+        assert(le_tensor_contiguous(another));
+        self->data = le_cuda_data_copy(another->data, data_size);
         break;
 #endif
     case LE_DEVICE_TYPE_CPU:
+        /// @note: Contiguous tensor owning its elements shares them with copy until either
+        /// of them is written. Copy of view is always densely packed. Scratch elements are
+        /// released with scope and viewed elements may be written through views, so they
+        /// are never shared.
+        if (another->owns_data && (another->mapping == LE_TENSOR_MAPPING_NONE) && le_tensor_contiguous(another) &&
+            !le_mem_is_scratch(another->data) && !le_mem_has_views(another->data))
         {
-            self->data = malloc(data_size);
-            if (another->stride == le_shape_get_size(another->shape, -1))
-            {
-                memcpy(self->data, another->data, data_size);
-            }
-            else
-            {
-                unsigned regions_count = le_shape_get_regions_count(another->shape);
-                size_t region_size = self->stride * le_type_size(self->element_type);
-                size_t bytes_stride = another->stride * le_type_size(another->element_type);
-                for (unsigned i = 0; i < regions_count; i++)
-                {
-                    memcpy((uint8_t *)self->data + i * region_size,
-                        (uint8_t *)another->data + i * bytes_stride,
-                        region_size);
-                }
-            }
+            self->data = le_retain(another->data);
+            break;
         }
+        self->data = le_alloc(data_size);
+        le_tensor_copy_elements(self, another);
         break;
     default:
         assert(false);
@@ -225,148 +664,267 @@ le_tensor_new_copy(const LeTensor *another)
 }
 
 LeTensor *
-le_tensor_new_zeros(LeType element_type, LeShape *shape)
+le_tensor_new_scratch(LeType element_type, LeShape *shape)
 {
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = element_type;
-    self->shape = shape;
-    self->stride = le_shape_get_size(self->shape, -1);
+    le_tensor_take_shape(self, shape);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    size_t data_size = elements_count * le_type_size(self->element_type);
-    self->data = malloc(data_size);
-    for (unsigned i = 0; i < elements_count; i++)
-    {
-        switch (self->element_type)
-        {
-        case LE_TYPE_INT8:
-        case LE_TYPE_UINT8:
-            ((int8_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_INT16:
-        case LE_TYPE_UINT16:
-            ((int16_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_INT32:
-        case LE_TYPE_UINT32:
-            ((int32_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_FLOAT16:
-            ((uint16_t *)self->data)[i] = F16_0;
-            break;
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = 0.0f;
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = 0.0;
-            break;
-        default:
-            break;
-        }
-    }
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_arena_alloc(le_tensor_get_data_size(self));
     return self;
 }
 
 LeTensor *
-le_tensor_new_zeros_like(const LeTensor *another)
+le_tensor_new_scratch_copy(const LeTensor *another)
 {
     assert(another);
-    
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    assert(another->device_type == LE_DEVICE_TYPE_CPU);
+
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = another->element_type;
-    self->shape = le_shape_copy(another->shape);
-    self->stride = another->stride;
+    le_tensor_init_shape(self, another->shape->num_dimensions, another->shape->sizes);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    size_t data_size = elements_count * le_type_size(another->element_type);
-    self->data = malloc(data_size);
-    for (unsigned i = 0; i < elements_count; i++)
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    self->data = le_arena_alloc(le_tensor_get_data_size(self));
+    le_tensor_copy_elements(self, another);
+    return self;
+}
+
+void
+le_tensor_make_writable(LeTensor *self)
+{
+    assert(self);
+
+    /// @note: Views can not give another its own copy, elements they write must not be shared
+    if (!self->owns_data)
     {
-        switch (self->element_type)
-        {
-        case LE_TYPE_INT8:
-        case LE_TYPE_UINT8:
-            ((int8_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_INT16:
-        case LE_TYPE_UINT16:
-            ((int16_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_INT32:
-        case LE_TYPE_UINT32:
-            ((int32_t *)self->data)[i] = 0;
-            break;
-        case LE_TYPE_FLOAT16:
-            ((uint16_t *)self->data)[i] = F16_0;
-            break;
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = 0.0f;
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = 0.0;
-            break;
-        default:
-            break;
-        }
+        assert(!self->storage || !le_mem_is_shared(self->storage));
+        return;
     }
-    return self;
+    if (self->device_type != LE_DEVICE_TYPE_CPU)
+        return;
+
+    switch (self->mapping)
+    {
+    case LE_TENSOR_MAPPING_NONE:
+        if (!le_mem_is_shared(self->data))
+            return;
+        break;
+    case LE_TENSOR_MAPPING_READ_ONLY:
+        break;
+    default:
+        return;
+    }
+
+    /// @note: Shared and mapped elements are densely packed, see le_tensor_new_copy
+    size_t data_size = le_tensor_get_data_size(self);
+    void *data = le_alloc(data_size);
+    memcpy(data, self->data, data_size);
+    le_tensor_release_data(self);
+    self->data = data;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
 }
 
+/// @note: Writable views write into elements of another only, so elements another shares with its
+/// copies are copied first. Views of read-only mapped file are for reading, file is not copied.
+static void
+le_tensor_unshare(LeTensor *another)
+{
+    if (another->mapping == LE_TENSOR_MAPPING_NONE)
+        le_tensor_make_writable(another);
+}
 
 LeTensor *
-le_tensor_new_cast(LeTensor *another, LeType type)
+le_tensor_new_zeros(LeType element_type, LeShape *shape)
 {
-    assert(another->device_type == LE_DEVICE_TYPE_CPU);
-    assert(le_cast_rawcpy[type][another->element_type] || le_cast_fn[type][another->element_type]);
-    
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = type;
-    self->shape = le_shape_copy(another->shape);
-    self->stride = another->stride;
+    self->element_type = element_type;
+    le_tensor_take_shape(self, shape);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    size_t data_size = elements_count * le_type_size(self->element_type);
-    self->data = malloc(data_size);
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(self);
+    self->data = le_alloc(data_size);
+    /// @note: Zero of every supported type, including F16_0, is all bits cleared
+    memset(self->data, 0, data_size);
+    return self;
+}
+
+LeTensor *
+le_tensor_new_zeros_like(const LeTensor *another)
+{
+    assert(another);
     
-    if (le_cast_rawcpy[self->element_type][another->element_type])
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
+    self->device_type = LE_DEVICE_TYPE_CPU;
+    self->element_type = another->element_type;
+    le_tensor_init_shape(self, another->shape->num_dimensions, another->shape->sizes);
+    le_tensor_init_strides(self);
+    self->owns_data = true;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    size_t data_size = le_tensor_get_data_size(self);
+    self->data = le_alloc(data_size);
+    /// @note: Zero of every supported type, including F16_0, is all bits cleared
+    memset(self->data, 0, data_size);
+    return self;
+}
+
+
+/// @note: Arguments of bulk conversion of source into new contiguous tensor
+typedef struct LeTensorCastTask
+{
+    LeTensor       *destination;
+    const LeTensor *source;
+    bool            scaled;
+    float           scale;
+    float           offset;
+} LeTensorCastTask;
+
+static void
+le_tensor_cast_span(const LeTensorCastTask *task, void *destination, const void *source,
+                    size_t source_stride, size_t n)
+{
+    if (task->scaled)
+        le_cast_scaled(task->destination->element_type, destination, task->source->element_type, source,
+                       source_stride, n, task->scale, task->offset);
+    else
+        le_cast(task->destination->element_type, destination, task->source->element_type, source,
+                source_stride, n);
+}
+
+static void
+le_tensor_cast_task_run(void *data, size_t begin, size_t end)
+{
+    const LeTensorCastTask *task = data;
+    le_tensor_cast_span(task,
+                        (uint8_t *)task->destination->data + begin * le_type_size(task->destination->element_type),
+                        (const uint8_t *)task->source->data + begin * le_type_size(task->source->element_type),
+                        1, end - begin);
+}
+
+/// @note: Converts rows [begin, end) of lowest dimension of strided source
+static void
+le_tensor_cast_task_run_rows(void *data, size_t begin, size_t end)
+{
+    const LeTensorCastTask *task = data;
+    const LeTensor *source = task->source;
+    unsigned last = source->shape->num_dimensions - 1;
+    uint32_t width = source->shape->sizes[last];
+    size_t destination_size = le_type_size(task->destination->element_type);
+    size_t source_size = le_type_size(source->element_type);
+
+    for (size_t row = begin; row < end; row++)
     {
-        assert(le_type_size(self->element_type) == le_type_size(another->element_type));
-        memcpy(self->data, another->data, data_size);
+        le_tensor_cast_span(task, (uint8_t *)task->destination->data + row * width * destination_size,
+                            (const uint8_t *)source->data + le_tensor_row_offset(source, row) * source_size,
+                            source->strides[last], width);
     }
-    else
+}
+
+static LeTensor *
+le_tensor_new_cast_task(LeTensorCastTask *task, const LeTensor *another, LeType type)
+{
+    assert(another->device_type == LE_DEVICE_TYPE_CPU);
+    assert(type != LE_TYPE_VOID && another->element_type != LE_TYPE_VOID);
+
+    LeTensor *self = le_tensor_new_uninitialized(type, le_shape_copy(another->shape));
+    size_t elements_count = le_shape_get_elements_count(self->shape);
+    task->destination = self;
+    task->source = another;
+
+    if (le_tensor_contiguous(another))
     {
-        for (unsigned i = 0; i < elements_count; i++)
-        {
-            le_cast_fn[self->element_type][another->element_type](self->data, another->data, i);
-        }
-    } 
-    
+        le_parallel_for(elements_count, LE_TENSOR_PARALLEL_GRAIN, le_tensor_cast_task_run, task);
+        return self;
+    }
+
+    uint32_t width = le_shape_get_size(another->shape, -1);
+    if (width == 0)
+        return self;
+    le_parallel_for(elements_count / width, le_tensor_rows_grain(width), le_tensor_cast_task_run_rows, task);
     return self;
 }
 
+LeTensor *
+le_tensor_new_cast(const LeTensor *another, LeType type)
+{
+    LeTensorCastTask task = { .scaled = false };
+    return le_tensor_new_cast_task(&task, another, type);
+}
+
+LeTensor *
+le_tensor_new_cast_scaled(const LeTensor *another, LeType type, float scale, float offset)
+{
+    LeTensorCastTask task = { .scaled = true, .scale = scale, .offset = offset };
+    return le_tensor_new_cast_task(&task, another, type);
+}
+
+const LeTensor *
+le_tensor_pack_f32(const LeTensor *tensor, LeTensor **packed)
+{
+    assert(tensor);
+    assert(packed);
+
+    *packed = NULL;
+    if ((tensor->element_type != LE_TYPE_FLOAT32) || !le_tensor_contiguous(tensor))
+        tensor = *packed = le_tensor_new_cast(tensor, LE_TYPE_FLOAT32);
+    return tensor;
+}
+
+void
+le_tensor_convert(LeTensor *self, LeType type)
+{
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    assert(self->owns_data);
+
+    if (self->element_type == type)
+        return;
+
+    LeTensor *converted = le_tensor_new_cast(self, type);
+    le_tensor_release_data(self);
+    self->data = converted->data;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->element_type = type;
+    /// @note: Elements now belong to self, only header of converted is freed
+    le_tensor_clear_layout(converted);
+    le_free(converted);
+    /// @note: Strides are set in place, they may point to inline storage of tensor
+    if (self->strides != self->strides_storage)
+        le_free(self->strides);
+    le_tensor_init_strides(self);
+}
+
 LeTensor *
 le_tensor_new_equal_u8(LeType type, LeTensor *another, uint8_t scalar)
 {
     assert(another->device_type == LE_DEVICE_TYPE_CPU);
-    unsigned i;
+    size_t i;
     
-    LeTensor *self = malloc(sizeof(struct LeTensor));
+    LeTensor *self = le_alloc(sizeof(struct LeTensor));
     self->device_type = LE_DEVICE_TYPE_CPU;
     self->element_type = type;
-    self->shape = le_shape_copy(another->shape);
-    self->stride = another->stride;
+    le_tensor_init_shape(self, another->shape->num_dimensions, another->shape->sizes);
+    le_tensor_init_strides(self);
     self->owns_data = true;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    size_t data_size = elements_count * le_type_size(self->element_type);
-    self->data = malloc(data_size);
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->storage = NULL;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
+    self->data = le_alloc(le_tensor_get_data_size(self));
     
     /// @todo: Add support for types other than UINT8
     for (i = 0; i < elements_count; i++)
     {
-        bool equal = (((uint8_t *)another->data)[i] == scalar);
+        bool equal = (le_tensor_at_u8(another, i) == scalar);
         ((float *)self->data)[i] = equal ? 1.0f : 0.0f;
     }
     
@@ -376,13 +934,21 @@ le_tensor_new_equal_u8(LeType type, LeTensor *another, uint8_t scalar)
 bool
 le_tensor_contiguous(const LeTensor *tensor)
 {
-    return tensor->stride == le_shape_get_size(tensor->shape, -1);
+    /// @note: Strides of dimensions of size 1 do not affect addressing
+    size_t stride = 1;
+    for (unsigned i = tensor->shape->num_dimensions; i > 0; i--)
+    {
+        uint32_t size = tensor->shape->sizes[i - 1];
+        if (size != 1 && tensor->strides[i - 1] != stride)
+            return false;
+        stride *= size;
+    }
+    return true;
 }
 
 bool
 le_tensor_equal(const LeTensor *a, const LeTensor *b)
 {
-    /// @todo: Take stride into account
     if (a == b)
         return true;
     
@@ -398,7 +964,7 @@ le_tensor_equal(const LeTensor *a, const LeTensor *b)
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(b->device_type == LE_DEVICE_TYPE_CPU);
     
-    uint32_t elements_count = le_shape_get_elements_count(a->shape);
+    size_t elements_count = le_shape_get_elements_count(a->shape);
     if (le_tensor_contiguous(a) && le_tensor_contiguous(b))
     {
         if (memcmp(a->data, b->data, elements_count * le_type_size(a->element_type)))
@@ -409,7 +975,7 @@ le_tensor_equal(const LeTensor *a, const LeTensor *b)
     else
     {
         /// @todo: Optimize case when both tensors are not contiguous but share same region size
-        for (uint32_t i = 0; i < elements_count; i++)
+        for (size_t i = 0; i < elements_count; i++)
         {
             if (memcmp(le_tensor_at(a, i), le_tensor_at(b, i), le_type_size(a->element_type)))
             {
@@ -424,123 +990,290 @@ le_tensor_equal(const LeTensor *a, const LeTensor *b)
 bool     
 le_tensor_reshape(LeTensor *self, unsigned num_dimensions, ...)
 {
-    /// @todo: Take stride into account
     /// @todo: Add more assertions
+    /// @note: Views with gaps between elements can not be reshaped in place
+    if (!le_tensor_contiguous(self))
+        return false;
 
     va_list args;
     va_start(args, num_dimensions);
     
-    LeShape *new_shape = le_shape_new_uninitialized(num_dimensions);
+    LeShape new_shape;
+    le_shape_init(&new_shape, num_dimensions, NULL);
     for (unsigned i = 0; i < num_dimensions; i++)
     {
         int size = va_arg(args, int);
-        le_shape_set_size(new_shape, i, size);
+        new_shape.sizes[i] = size;
     }
+    le_shape_update(&new_shape);
 
     va_end(args);
     
-    if (le_shape_get_elements_count(new_shape) == le_shape_get_elements_count(self->shape))
+    bool same_count = le_shape_get_elements_count(&new_shape) == le_shape_get_elements_count(self->shape);
+    if (same_count)
     {
-        le_shape_free(self->shape);
-        self->shape = new_shape;
+        le_tensor_clear_layout(self);
+        le_tensor_init_shape(self, num_dimensions, new_shape.sizes);
+        le_tensor_init_strides(self);
+    }
+    le_shape_clear(&new_shape);
 
-        self->stride = le_shape_get_size(self->shape, -1);
+    return same_count;
+}
 
-        return true;
-    }
-    else
-    {
-        le_shape_free(self->shape);
+/// @note: Initializes header of view of another tensor with given shape, which shares data.
+/// Strides are set by caller.
+static LeTensor *
+le_tensor_init_view(LeTensor *self, const LeTensor *another, unsigned num_dimensions,
+                    const uint32_t *sizes, void *data)
+{
+    self->device_type = another->device_type;
+    self->element_type = another->element_type;
+    le_tensor_init_shape(self, num_dimensions, sizes);
+    le_tensor_alloc_strides(self);
+    self->owns_data = false;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    self->data = data;
+    self->storage = NULL;
+    return self;
+}
 
-        return false;
+/// @note: View allocated on heap keeps block of elements it views alive, so that copies of
+/// another do not share that block while view may write into it, see le_tensor_new_copy
+static LeTensor *
+le_tensor_new_view(const LeTensor *another, unsigned num_dimensions, const uint32_t *sizes, void *data)
+{
+    LeTensor *self = le_tensor_init_view(le_alloc(sizeof(struct LeTensor)), another, num_dimensions, sizes, data);
+    void *storage = NULL;
+    if (another->device_type == LE_DEVICE_TYPE_CPU)
+    {
+        if (!another->owns_data)
+            storage = another->storage;
+        else if (another->mapping == LE_TENSOR_MAPPING_NONE)
+            storage = another->data;
     }
+    self->storage = le_mem_retain_view(storage);
+    return self;
+}
+
+/// @note: Views placed by caller must not need any allocation
+static LeTensor *
+le_tensor_init_stack_view(LeTensorView *view, const LeTensor *another, unsigned num_dimensions,
+                          const uint32_t *sizes, void *data)
+{
+    assert(view);
+    assert(num_dimensions <= LE_SHAPE_INLINE_DIMENSIONS);
+    return le_tensor_init_view(view, another, num_dimensions, sizes, data);
+}
+
+static void
+le_tensor_init_pick(LeTensor *self, const LeTensor *another)
+{
+    for (unsigned i = 0; i < self->shape->num_dimensions; i++)
+        self->strides[i] = another->strides[i + 1];
+}
+
+static void *
+le_tensor_pick_data(const LeTensor *another, uint32_t index)
+{
+    assert(another->device_type == LE_DEVICE_TYPE_CPU);
+    assert(another->shape->num_dimensions > 0);
+    assert(index < another->shape->sizes[0]);
+
+    size_t offset = (size_t)index * another->strides[0] * le_type_size(another->element_type);
+    return (uint8_t *)another->data + offset;
+}
+
+static void *
+le_tensor_slice_data(const LeTensor *another, unsigned dimension, uint32_t start, uint32_t length)
+{
+    assert(dimension < another->shape->num_dimensions);
+    assert(start + length <= another->shape->sizes[dimension]);
+
+    size_t offset = (size_t)start * another->strides[dimension] * le_type_size(another->element_type);
+    return (uint8_t *)another->data + offset;
+}
+
+static void
+le_tensor_init_slice(LeTensor *self, const LeTensor *another, unsigned dimension, uint32_t length)
+{
+    memcpy(self->strides, another->strides, another->shape->num_dimensions * sizeof(size_t));
+    le_shape_set_size(self->shape, dimension, length);
 }
 
 LeTensor *
 le_tensor_pick(LeTensor *another, uint32_t index)
 {
-    /// @todo: Take stride into account
     if (!another)
         return NULL;
     
-    assert(another->device_type == LE_DEVICE_TYPE_CPU);
+    le_tensor_unshare(another);
+    void *data = le_tensor_pick_data(another, index);
+    LeTensor *self = le_tensor_new_view(another, another->shape->num_dimensions - 1, another->shape->sizes + 1, data);
+    le_tensor_init_pick(self, another);
     
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = another->element_type;
-    self->shape = le_shape_lower_dimension(another->shape);
-    self->stride = le_shape_get_size(self->shape, -1);
+    return self;
+}
 
-    size_t data_size = le_shape_get_elements_count(self->shape) * le_type_size(self->element_type);
-    self->owns_data = false;
-    self->data = another->data + index * data_size;
+LeTensor *
+le_tensor_pick_copy(const LeTensor *another, uint32_t index)
+{
+    if (!another)
+        return NULL;
     
+    /// @note: View is only read, so elements shared by another are not copied
+    LeTensorView view;
+    LeTensor *self = le_tensor_init_stack_view(&view, another, another->shape->num_dimensions - 1,
+                                               another->shape->sizes + 1, le_tensor_pick_data(another, index));
+    le_tensor_init_pick(self, another);
+    return le_tensor_new_copy(self);
+}
+
+LeTensor *
+le_tensor_transpose(const LeTensor *another)
+{
+    assert(another);
+    assert(another->shape->num_dimensions >= 2);
+
+    unsigned last = another->shape->num_dimensions - 1;
+    LeTensor *self = le_tensor_new_view(another, another->shape->num_dimensions, another->shape->sizes, another->data);
+    memcpy(self->strides, another->strides, another->shape->num_dimensions * sizeof(size_t));
+    self->shape->sizes[last - 1] = another->shape->sizes[last];
+    self->shape->sizes[last] = another->shape->sizes[last - 1];
+    self->strides[last - 1] = another->strides[last];
+    self->strides[last] = another->strides[last - 1];
+
+    return self;
+}
+
+LeTensor *
+le_tensor_permute(const LeTensor *another, const unsigned *order)
+{
+    assert(another);
+    assert(order);
+
+    unsigned num_dimensions = another->shape->num_dimensions;
+    LeTensor *self = le_tensor_new_view(another, num_dimensions, NULL, another->data);
+    for (unsigned i = 0; i < num_dimensions; i++)
+    {
+        assert(order[i] < num_dimensions);
+        self->shape->sizes[i] = another->shape->sizes[order[i]];
+        self->strides[i] = another->strides[order[i]];
+    }
+    le_shape_update(self->shape);
+
+    return self;
+}
+
+LeTensor *
+le_tensor_slice(const LeTensor *another, unsigned dimension, uint32_t start, uint32_t length)
+{
+    assert(another);
+
+    void *data = le_tensor_slice_data(another, dimension, start, length);
+    LeTensor *self = le_tensor_new_view(another, another->shape->num_dimensions, another->shape->sizes, data);
+    le_tensor_init_slice(self, another, dimension, length);
+
+    return self;
+}
+
+LeTensor *
+le_tensor_view_init(LeTensorView *view, const LeTensor *another)
+{
+    assert(another);
+
+    LeTensor *self = le_tensor_init_stack_view(view, another, another->shape->num_dimensions,
+                                               another->shape->sizes, another->data);
+    memcpy(self->strides, another->strides, another->shape->num_dimensions * sizeof(size_t));
+
+    return self;
+}
+
+LeTensor *
+le_tensor_view_init_pick(LeTensorView *view, const LeTensor *another, uint32_t index)
+{
+    assert(another);
+
+    void *data = le_tensor_pick_data(another, index);
+    LeTensor *self = le_tensor_init_stack_view(view, another, another->shape->num_dimensions - 1,
+                                               another->shape->sizes + 1, data);
+    le_tensor_init_pick(self, another);
+
     return self;
 }
 
 LeTensor *
-le_tensor_pick_copy(const LeTensor *another, uint32_t index)
+le_tensor_view_init_slice(LeTensorView *view, const LeTensor *another, unsigned dimension,
+                          uint32_t start, uint32_t length)
 {
-    /// @todo: Take stride into account
-    if (!another)
-        return NULL;
-    
-    assert(another->device_type == LE_DEVICE_TYPE_CPU);
-    
-    LeTensor *self = malloc(sizeof(struct LeTensor));
-    self->device_type = LE_DEVICE_TYPE_CPU;
-    self->element_type = another->element_type;
-    self->shape = le_shape_lower_dimension(another->shape);
-    self->stride = le_shape_get_size(self->shape, -1);
-    
-    size_t data_size = le_shape_get_elements_count(self->shape) * le_type_size(self->element_type);
-    self->owns_data = true;
-    self->data = malloc(data_size);
-    
-    memcpy(self->data, another->data + index * data_size, data_size);
-    
+    assert(another);
+
+    void *data = le_tensor_slice_data(another, dimension, start, length);
+    LeTensor *self = le_tensor_init_stack_view(view, another, another->shape->num_dimensions,
+                                               another->shape->sizes, data);
+    le_tensor_init_slice(self, another, dimension, length);
+
     return self;
 }
 
-static inline uint32_t
-virtual_index(uint32_t logical_index, uint32_t last_size, uint32_t stride)
+LeTensor *
+le_tensor_broadcast(const LeTensor *another, LeShape *shape)
 {
-    return (last_size == stride) ? logical_index : (logical_index / last_size * stride + logical_index % last_size);
+    assert(another);
+    assert(shape);
+    assert(shape->num_dimensions >= another->shape->num_dimensions);
+
+    unsigned missing_dimensions = shape->num_dimensions - another->shape->num_dimensions;
+    LeTensor *self = le_tensor_new_view(another, shape->num_dimensions, shape->sizes, another->data);
+    for (unsigned i = 0; i < shape->num_dimensions; i++)
+    {
+        if (i < missing_dimensions)
+        {
+            self->strides[i] = 0;
+            continue;
+        }
+
+        uint32_t size = another->shape->sizes[i - missing_dimensions];
+        assert((size == shape->sizes[i]) || (size == 1));
+        self->strides[i] = (size == shape->sizes[i]) ? another->strides[i - missing_dimensions] : 0;
+    }
+
+    return self;
 }
 
 void *
-le_tensor_at(const LeTensor *tensor, uint32_t index)
+le_tensor_at(const LeTensor *tensor, size_t index)
 {
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
     
-    return (uint8_t *)tensor->data + le_type_size(tensor->element_type) * virtual_index(index, le_shape_get_size(tensor->shape, -1), tensor->stride);
+    return (uint8_t *)tensor->data + le_type_size(tensor->element_type) * le_tensor_offset(tensor, index);
 }
 
 uint8_t
-le_tensor_at_u8(const LeTensor *tensor, uint32_t index)
+le_tensor_at_u8(const LeTensor *tensor, size_t index)
 {
     assert(tensor->element_type == LE_TYPE_UINT8);
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
 
-    return ((uint8_t *)tensor->data)[virtual_index(index, le_shape_get_size(tensor->shape, -1), tensor->stride)];
+    return ((uint8_t *)tensor->data)[le_tensor_offset(tensor, index)];
 }
 
 uint32_t
-le_tensor_at_u32(const LeTensor *tensor, uint32_t index)
+le_tensor_at_u32(const LeTensor *tensor, size_t index)
 {
     assert(tensor->element_type == LE_TYPE_UINT32);
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
 
-    return ((uint32_t *)tensor->data)[virtual_index(index, le_shape_get_size(tensor->shape, -1), tensor->stride)];
+    return ((uint32_t *)tensor->data)[le_tensor_offset(tensor, index)];
 }
 
 float
-le_tensor_at_f32(const LeTensor *tensor, uint32_t index)
+le_tensor_at_f32(const LeTensor *tensor, size_t index)
 {
     assert(tensor->element_type == LE_TYPE_FLOAT32);
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
     
-    return ((float *)tensor->data)[virtual_index(index, le_shape_get_size(tensor->shape, -1), tensor->stride)];
+    return ((float *)tensor->data)[le_tensor_offset(tensor, index)];
 }
 
 void
@@ -549,40 +1282,31 @@ le_tensor_assign(LeTensor *tensor, const LeTensor *another)
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
     assert(another->device_type == LE_DEVICE_TYPE_CPU);
     
-    if ((tensor->element_type == another->element_type)
-        && (tensor->stride == le_shape_get_size(tensor->shape, -1))
-        && (another->stride == le_shape_get_size(another->shape, -1))
-        && le_shape_equal(tensor->shape, another->shape))
-    {
-        size_t data_size = le_shape_get_elements_count(another->shape) * le_type_size(another->element_type);
-        memcpy(tensor->data, another->data, data_size);
-    }
-    else assert (false);
+    assert(tensor->element_type == another->element_type);
+    assert(le_shape_equal(tensor->shape, another->shape));
+
+    le_tensor_make_writable(tensor);
+    le_tensor_copy_elements(tensor, another);
 }
 
 void
-le_tensor_set_f32(LeTensor *tensor, uint32_t index, float value)
+le_tensor_set_f32(LeTensor *tensor, size_t index, float value)
 {
     assert(tensor->element_type == LE_TYPE_FLOAT32);
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
-    
-    ((float *)tensor->data)[virtual_index(index, le_shape_get_size(tensor->shape, -1), tensor->stride)] = value;
+
+    le_tensor_make_writable(tensor);
+    ((float *)tensor->data)[le_tensor_offset(tensor, index)] = value;
 }
 
 void
 le_matrix_empty(LeTensor *self)
 {
-    switch (self->device_type) {
-    case LE_DEVICE_TYPE_CPU:
-        free(self->data);
-        self->data = NULL;
-        break;
-    default:
-        assert(false);
-        break;
-    }
-    le_shape_free(self->shape);
-    self->shape = NULL;
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    le_tensor_release_data(self);
+    self->data = NULL;
+    self->mapping = LE_TENSOR_MAPPING_NONE;
+    le_tensor_clear_layout(self);
     self->element_type = LE_TYPE_VOID;
 }
 
@@ -610,6 +1334,9 @@ le_dot_product(const LeTensor *a, const LeTensor *b)
     assert(a->shape->sizes[0] == b->shape->sizes[0]);
     assert(a->shape->sizes[1] == 1);
     assert(b->shape->sizes[1] == 1);
+
+    if (le_tensor_contiguous(a) && le_tensor_contiguous(b))
+        return le_tensor_parallel_reduce_binary(le_kernels_get()->dot_f32, a, b);
     
     for (y = 0; y < a->shape->sizes[0]; y++)
     {
@@ -618,7 +1345,7 @@ le_dot_product(const LeTensor *a, const LeTensor *b)
             (supposed to be column vectors) is 1 */
         // result += ((float *)a->data)[y] * ((float *)b->data)[y];
         /** @note: Stride (separate from width) added */
-        result += ((float *)a->data)[y * a->stride] * ((float *)b->data)[y * b->stride];
+        result += ((float *)a->data)[y * a->strides[0]] * ((float *)b->data)[y * b->strides[0]];
     }
     
     return result;
@@ -646,7 +1373,7 @@ le_rbf(const LeTensor *a, const LeTensor *b, float sigma)
     
     for (unsigned y = 0; y < a->shape->sizes[0]; y++)
     {
-        float sub = ((float *)a->data)[y * a->stride] - ((float *)b->data)[y * b->stride];
+        float sub = ((float *)a->data)[y * a->strides[0]] - ((float *)b->data)[y * b->strides[0]];
         result += sub * sub;
     }
     
@@ -654,30 +1381,102 @@ le_rbf(const LeTensor *a, const LeTensor *b, float sigma)
 #endif
 }
 
+typedef void (*LeBinaryKernel)(float *a, const float *b, size_t n);
+
+static LeBinaryKernel
+le_binary_op_get_kernel(LeBinaryOp op)
+{
+    const LeKernels *kernels = le_kernels_get();
+
+    switch (op)
+    {
+    case LE_BINARY_OP_ADD:
+        return kernels->add_f32;
+    case LE_BINARY_OP_SUB:
+        return kernels->sub_f32;
+    case LE_BINARY_OP_MUL:
+        return kernels->mul_f32;
+    case LE_BINARY_OP_DIV:
+        return kernels->div_f32;
+    case LE_BINARY_OP_MAX:
+        return kernels->max_f32;
+    case LE_BINARY_OP_MIN:
+        return kernels->min_f32;
+    case LE_BINARY_OP_EQUAL:
+        return kernels->equal_f32;
+    case LE_BINARY_OP_GREATER:
+        return kernels->greater_f32;
+    case LE_BINARY_OP_LESS:
+        return kernels->less_f32;
+    default:
+        assert(false);
+        return NULL;
+    }
+}
+
+void
+le_tensor_apply_binary(LeTensor *a, LeBinaryOp op, const LeTensor *b)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(b->device_type == LE_DEVICE_TYPE_CPU);
+    assert(le_tensor_is_single_or_half(a));
+    assert(le_tensor_is_single_or_half(b));
+
+    le_tensor_make_writable(a);
+    if (le_shape_equal(a->shape, b->shape))
+    {
+        le_tensor_parallel_binary(le_binary_op_get_kernel(op), a, b);
+        return;
+    }
+
+    /// @note: Strided path reads stretched dimensions of b through zero strides,
+    /// rows of b which are not stretched are passed to kernels without copying
+    LeTensor *b_view = le_tensor_broadcast(b, a->shape);
+    le_tensor_parallel_binary(le_binary_op_get_kernel(op), a, b_view);
+    le_tensor_free(b_view);
+}
+
+LeTensor *
+le_tensor_new_binary(const LeTensor *a, LeBinaryOp op, const LeTensor *b)
+{
+    assert(a->device_type == LE_DEVICE_TYPE_CPU);
+    assert(le_tensor_is_single_or_half(a));
+
+    LeShape *shape = le_shape_new_broadcast(a->shape, b->shape);
+    assert(shape);
+
+    LeTensor *self = le_tensor_new_uninitialized(a->element_type, shape);
+    LeTensor *a_view = le_tensor_broadcast(a, self->shape);
+    le_tensor_copy_elements(self, a_view);
+    le_tensor_free(a_view);
+    le_tensor_apply_binary(self, op, b);
+
+    return self;
+}
+
 void
 le_tensor_add_tensor(LeTensor *a, const LeTensor *b)
 {
-    /// @todo: Take stride into account
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(b->device_type == LE_DEVICE_TYPE_CPU);
-    assert(a->element_type == b->element_type);
-    assert(le_shape_equal(a->shape, b->shape));
-    
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(a->shape);
+    assert(a->element_type == b->element_type ||
+           (le_tensor_is_single_or_half(a) && le_tensor_is_single_or_half(b)));
+
+    le_tensor_make_writable(a);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(a->shape);
     
     switch (a->element_type)
     {
+    case LE_TYPE_FLOAT16:
     case LE_TYPE_FLOAT32:
-        for (i = 0; i < elements_count; i++)
-        {
-            ((float *)a->data)[i] += ((float *)b->data)[i];
-        }
+        le_tensor_apply_binary(a, LE_BINARY_OP_ADD, b);
         break;
     case LE_TYPE_UINT32:
+        assert(le_shape_equal(a->shape, b->shape));
         for (i = 0; i < elements_count; i++)
         {
-            ((uint32_t *)a->data)[i] += ((uint32_t *)b->data)[i];
+            ((uint32_t *)a->data)[le_tensor_offset(a, i)] += ((uint32_t *)b->data)[le_tensor_offset(b, i)];
         }
         break;
     default:
@@ -690,96 +1489,69 @@ void
 le_tensor_sub_f32(LeTensor *self, float b)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32);
+    assert(le_tensor_is_single_or_half(self));
 
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)self->data)[i] -= b;
-    }
+    le_tensor_make_writable(self);
+    le_tensor_parallel_with_scalar(le_kernels_get()->add_scalar_f32, self, -b);
 }
 
 void
 le_tensor_sub_tensor(LeTensor *a, const LeTensor *b)
 {
-    /// @todo: Take stride into account
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(b->device_type == LE_DEVICE_TYPE_CPU);
-    assert(a->element_type == LE_TYPE_FLOAT32);
-    assert(b->element_type == LE_TYPE_FLOAT32);
-    assert(le_shape_equal(a->shape, b->shape));
+    assert(le_tensor_is_single_or_half(a));
+    assert(le_tensor_is_single_or_half(b));
     
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(a->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)a->data)[i] -= ((float *)b->data)[i];
-    }
+    le_tensor_apply_binary(a, LE_BINARY_OP_SUB, b);
 }
 
 void
 le_tensor_sub_scaled_f32(LeTensor *a, float scale, const LeTensor *b)
 {
-    /// @todo: Take stride into account
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(b->device_type == LE_DEVICE_TYPE_CPU);
+    assert(le_tensor_is_single_or_half(a));
+    assert(le_tensor_is_single_or_half(b));
     assert(le_shape_equal(a->shape, b->shape));
-    
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(a->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)a->data)[i] -= scale * ((float *)b->data)[i];
-    }
+
+    le_tensor_make_writable(a);
+    le_tensor_parallel_scaled(le_kernels_get()->sub_scaled_f32, a, scale, b);
 }
 
 void
 le_tensor_mul_f32(LeTensor *self, float b)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32);
+    assert(le_tensor_is_single_or_half(self));
 
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)self->data)[i] *= b;
-    }
+    le_tensor_make_writable(self);
+    le_tensor_parallel_with_scalar(le_kernels_get()->mul_scalar_f32, self, b);
 }
 
 void        
 le_tensor_mul_tensor(LeTensor *self, const LeTensor *b)
 {
-    assert(self->element_type == LE_TYPE_FLOAT32);
-    assert(b->element_type == LE_TYPE_FLOAT32);
-    assert(le_shape_equal(self->shape, b->shape));
+    assert(le_tensor_is_single_or_half(self));
+    assert(le_tensor_is_single_or_half(b));
 
-    /// @todo: Take stride into account
+    le_tensor_make_writable(self);
     switch (self->device_type)
     {
 #ifdef HAVE_METAL
     case LE_DEVICE_TYPE_METAL:
+        assert(le_shape_equal(self->shape, b->shape));
         le_metal_tensor_mul_tensor(self, b);
         break;
 #endif
 #ifdef HAVE_CUDA
     case LE_DEVICE_TYPE_CUDA:
+        assert(le_shape_equal(self->shape, b->shape));
         le_cuda_tensor_mul_tensor(self, b);
         break;
 #endif
     case LE_DEVICE_TYPE_CPU:
-        for (unsigned i = 0, elements_count = le_shape_get_elements_count(self->shape);
-             i < elements_count; i++)
-        {
-            ((float *)self->data)[i] *= ((float *)b->data)[i];
-        }
+        le_tensor_apply_binary(self, LE_BINARY_OP_MUL, b);
         break;
     default:
         assert(false);
@@ -793,13 +1565,13 @@ le_tensor_div_u32(LeTensor *self, uint32_t b)
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
     assert(self->element_type == LE_TYPE_UINT32);
 
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
     for (i = 0; i < elements_count; i++)
     {
-        ((uint32_t *)self->data)[i] /= b;
+        ((uint32_t *)self->data)[le_tensor_offset(self, i)] /= b;
     }
 
 }
@@ -808,15 +1580,10 @@ void
 le_tensor_add_f32(LeTensor *self, float b)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32);
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)self->data)[i] += b;
-    }
+    assert(le_tensor_is_single_or_half(self));
+
+    le_tensor_make_writable(self);
+    le_tensor_parallel_with_scalar(le_kernels_get()->add_scalar_f32, self, b);
 }
 
 float
@@ -824,16 +1591,7 @@ le_tensor_sum_f32(const LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
     assert(self->element_type == LE_TYPE_FLOAT32);
-    /// @todo: Take stride into account
-    float sum = 0.0;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (unsigned i = 0; i < elements_count; i++)
-    {
-        sum += ((float *)self->data)[i];
-    }
-    
-    return sum;
+    return le_tensor_reduce_f32(self, LE_REDUCE_OP_SUM);
 }
 
 float
@@ -841,66 +1599,35 @@ le_tensor_sad_f32(const LeTensor *a, const LeTensor *b)
 {
     assert(a->device_type == LE_DEVICE_TYPE_CPU);
     assert(b->device_type == LE_DEVICE_TYPE_CPU);
-    assert(a->element_type == LE_TYPE_FLOAT32);
-    assert(b->element_type == LE_TYPE_FLOAT32);
+    assert(le_tensor_is_single_or_half(a));
+    assert(le_tensor_is_single_or_half(b));
     assert(le_shape_equal(a->shape, b->shape));
 
-    float sad = 0.0;
-    unsigned elements_count = le_shape_get_elements_count(a->shape);
-    
-    /// @note: SSE2 and ARM NEON provide instructions for this
-    for (unsigned i = 0; i < elements_count; i++)
-    {
-        sad += fabs(le_tensor_at_f32(a, i) - le_tensor_at_f32(b, i));
-    }
-    
-    return sad;
-
+    return le_tensor_parallel_reduce_binary(le_kernels_get()->sad_f32, a, b);
 }
 
 float
 le_tensor_l2_f32(const LeTensor *tensor)
 {
     assert(tensor->device_type == LE_DEVICE_TYPE_CPU);
-    assert(tensor->element_type == LE_TYPE_FLOAT32);
-
-    float l2 = 0.0;
-    unsigned elements_count = le_shape_get_elements_count(tensor->shape);
-    /// @todo: Speed up this
-    for (unsigned i = 0; i < elements_count; i++)
-    {
-        float v = le_tensor_at_f32(tensor, i);
-        l2 += v * v;
-    }
-    l2 = sqrtf(l2);
-    
-    return l2;
-}
+    assert(le_tensor_is_single_or_half(tensor));
 
-#ifndef __APPLE__
-static float
-le_sigmoid(const float a)
-{
-    return 1.0 / (1.0 + expf(-a));
+    return sqrtf(le_tensor_parallel_reduce_binary(le_kernels_get()->dot_f32, tensor, tensor));
 }
-#endif
 
 void
 le_tensor_apply_sigmoid(LeTensor *self)
 {
-    /// @todo: Take stride into account
+    le_tensor_make_writable(self);
+
     switch (self->device_type) {
     case LE_DEVICE_TYPE_CPU:
 #ifdef __APPLE__
-        return le_accelerate_tensor_apply_sigmoid(self);
-#else
-        assert(self->element_type == LE_TYPE_FLOAT32);
-        unsigned elements_count = le_shape_get_elements_count(self->shape);
-        for (unsigned i = 0; i < elements_count; i++)
-        {
-            ((float *)self->data)[i] = le_sigmoid(((float *)self->data)[i]);
-        }
+        if (le_tensor_contiguous(self) && self->element_type == LE_TYPE_FLOAT32)
+            return le_accelerate_tensor_apply_sigmoid(self);
 #endif
+        assert(le_tensor_is_single_or_half(self));
+        le_tensor_parallel_unary(le_kernels_get()->sigmoid_f32, self);
         break;
 #ifdef HAVE_CUDA
     case LE_DEVICE_TYPE_CUDA:
@@ -921,19 +1648,16 @@ le_tensor_apply_sigmoid(LeTensor *self)
 void
 le_tensor_apply_sigmoid_prime(LeTensor *self)
 {
+    le_tensor_make_writable(self);
+
     switch (self->device_type) {
     case LE_DEVICE_TYPE_CPU:
 #ifdef __APPLE__
-        return le_accelerate_tensor_apply_sigmoid_prime(self);
-#else
-        assert(self->element_type == LE_TYPE_FLOAT32);
-        unsigned elements_count = le_shape_get_elements_count(self->shape);        
-        for (unsigned i = 0; i < elements_count; i++)
-        {
-            float sigmoid = le_sigmoid(((float *)self->data)[i]);
-            ((float *)self->data)[i] = sigmoid * (1.0f - sigmoid);
-        }
+        if (le_tensor_contiguous(self) && self->element_type == LE_TYPE_FLOAT32)
+            return le_accelerate_tensor_apply_sigmoid_prime(self);
 #endif
+        assert(le_tensor_is_single_or_half(self));
+        le_tensor_parallel_unary(le_kernels_get()->sigmoid_prime_f32, self);
         break;
 #ifdef HAVE_CUDA
     case LE_DEVICE_TYPE_CUDA:
@@ -955,50 +1679,79 @@ void
 le_tensor_apply_tanh(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64);
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_unary(le_kernels_get()->tanh_f32, self);
+        break;
+    case LE_TYPE_FLOAT64:
+        for (i = 0; i < elements_count; i++)
         {
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = tanhf(((float *)self->data)[i]);
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = tanh(((double *)self->data)[i]);
-            break;
-        default:
-            return;
+            double *x = (double *)self->data + le_tensor_offset(self, i);
+            *x = tanh(*x);
         }
+        break;
+    default:
+        return;
     }
 }
 
+void
+le_tensor_apply_exp(LeTensor *self)
+{
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    assert(le_tensor_is_single_or_half(self));
+
+    le_tensor_make_writable(self);
+    le_tensor_parallel_unary(le_kernels_get()->exp_f32, self);
+}
+
+void
+le_tensor_apply_log(LeTensor *self)
+{
+    assert(self->device_type == LE_DEVICE_TYPE_CPU);
+    assert(le_tensor_is_single_or_half(self));
+
+    le_tensor_make_writable(self);
+    le_tensor_parallel_unary(le_kernels_get()->log_f32, self);
+}
+
 void
 le_tensor_apply_sqr(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64);
 
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_unary(le_kernels_get()->sqr_f32, self);
+        break;
+    case LE_TYPE_FLOAT64:
+        for (i = 0; i < elements_count; i++)
         {
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = ((float *)self->data)[i] * ((float *)self->data)[i];
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = ((double *)self->data)[i] * ((double *)self->data)[i];
-            break;
-        default:
-            return;
+            double *x = (double *)self->data + le_tensor_offset(self, i);
+            *x = *x * *x;
         }
+        break;
+    default:
+        return;
     }
 }
 
@@ -1006,25 +1759,29 @@ void
 le_tensor_apply_1_minus(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64);
 
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_unary(le_kernels_get()->one_minus_f32, self);
+        break;
+    case LE_TYPE_FLOAT64:
+        for (i = 0; i < elements_count; i++)
         {
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = 1.0f - ((float *)self->data)[i];
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = 1.0f - ((double *)self->data)[i];
-            break;
-        default:
-            return;
+            double *x = (double *)self->data + le_tensor_offset(self, i);
+            *x = 1.0 - *x;
         }
+        break;
+    default:
+        return;
     }
 }
 
@@ -1032,31 +1789,29 @@ void
 le_tensor_apply_x_minus_sqr_x(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64);
 
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_unary(le_kernels_get()->x_minus_sqr_x_f32, self);
+        break;
+    case LE_TYPE_FLOAT64:
+        for (i = 0; i < elements_count; i++)
         {
-        case LE_TYPE_FLOAT32:
-            {
-                float x = ((float *)self->data)[i];
-                ((float *)self->data)[i] = x * (1 - x);
-            }
-            break;
-        case LE_TYPE_FLOAT64:
-            {
-                double x = ((double *)self->data)[i];
-                ((double *)self->data)[i] = x * (1 - x);
-            }
-            break;
-        default:
-            return;
+            double *x = (double *)self->data + le_tensor_offset(self, i);
+            *x = *x * (1 - *x);
         }
+        break;
+    default:
+        return;
     }
 }
 
@@ -1064,26 +1819,29 @@ void
 le_tensor_apply_gt_f32(LeTensor *self, float scalar)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64);
+
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_with_scalar(le_kernels_get()->gt_f32, self, scalar);
+        break;
+    case LE_TYPE_FLOAT64:
+        for (i = 0; i < elements_count; i++)
         {
-        case LE_TYPE_FLOAT32:
-            ((float *)self->data)[i] = ((float *)self->data)[i] > scalar ? 1.0f : 0.0f;
-            break;
-        case LE_TYPE_FLOAT64:
-            ((double *)self->data)[i] = ((double *)self->data)[i] > scalar ? 1.0 : 0.0;
-            break;
-        default:
-            return;
+            double *x = (double *)self->data + le_tensor_offset(self, i);
+            *x = *x > scalar ? 1.0 : 0.0;
         }
+        break;
+    default:
+        return;
     }
 }
 
@@ -1091,58 +1849,50 @@ void
 le_tensor_apply_sgn(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    assert(self->element_type == LE_TYPE_FLOAT32);
+    assert(le_tensor_is_single_or_half(self));
 
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    
-    for (i = 0; i < elements_count; i++)
-    {
-        ((float *)self->data)[i] = ((float *)self->data)[i] > 0.0f ? 1.0f : -1.0f;
-    }
+    le_tensor_make_writable(self);
+    le_tensor_parallel_unary(le_kernels_get()->sgn_f32, self);
 }
 
 void
 le_tensor_apply_relu(LeTensor *self)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    /// @note: Not implemented for half precision floating point values (float16)
     /// @note: There is no sense in applying ReLU to Tensors of unsigned integers.
-    assert(self->element_type == LE_TYPE_FLOAT32 ||
+    assert(self->element_type == LE_TYPE_FLOAT16 ||
+           self->element_type == LE_TYPE_FLOAT32 ||
            self->element_type == LE_TYPE_FLOAT64 ||
            self->element_type == LE_TYPE_INT8 ||
            self->element_type == LE_TYPE_INT16 ||
            self->element_type == LE_TYPE_INT32);
 
-    /// @todo: Take stride into account
-    unsigned i;
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
+    le_tensor_make_writable(self);
+    size_t i;
+    size_t elements_count = le_shape_get_elements_count(self->shape);
     
-    for (i = 0; i < elements_count; i++)
+    switch (self->element_type)
     {
-        switch (self->element_type)
-        {
-#define APPLY_RELU(T) { T value = ((T *)self->data)[i]; ((T *)self->data)[i] = value > 0 ? value : 0;  }
-        case LE_TYPE_FLOAT32:
-            APPLY_RELU(float)
-            break;
-        case LE_TYPE_FLOAT64:
-            APPLY_RELU(double)
-            break;
-        case LE_TYPE_INT8:
-            APPLY_RELU(int8_t)
-            break;
-        case LE_TYPE_INT16:
-            APPLY_RELU(int16_t)
-            break;
-        case LE_TYPE_INT32:
-            APPLY_RELU(int32_t)
-            break;
-        default:
-            return;
+#define APPLY_RELU(T) for (i = 0; i < elements_count; i++) { T *value = (T *)self->data + le_tensor_offset(self, i); *value = *value > 0 ? *value : 0; }
+    case LE_TYPE_FLOAT16:
+    case LE_TYPE_FLOAT32:
+        le_tensor_parallel_unary(le_kernels_get()->relu_f32, self);
+        break;
+    case LE_TYPE_FLOAT64:
+        APPLY_RELU(double)
+        break;
+    case LE_TYPE_INT8:
+        APPLY_RELU(int8_t)
+        break;
+    case LE_TYPE_INT16:
+        APPLY_RELU(int16_t)
+        break;
+    case LE_TYPE_INT32:
+        APPLY_RELU(int32_t)
+        break;
+    default:
+        return;
 #undef APPLY_RELU
-        }
     }
 }
 
@@ -1182,22 +1932,25 @@ le_tensor_to_cstr(const LeTensor *self)
             switch (self->element_type)
             {
                 case LE_TYPE_UINT8:
-                    sprintf(ptr, "%u%n", (unsigned)((uint8_t *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%u%n", (unsigned)((uint8_t *)self->data)[le_matrix_offset(self, y, x)], &written);
                     break;
                 case LE_TYPE_INT8:
-                    sprintf(ptr, "%d%n", (int)((int8_t *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%d%n", (int)((int8_t *)self->data)[le_matrix_offset(self, y, x)], &written);
                     break;
                 case LE_TYPE_INT16:
-                    sprintf(ptr, "%d%n", (int)((int16_t *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%d%n", (int)((int16_t *)self->data)[le_matrix_offset(self, y, x)], &written);
                     break;
                 case LE_TYPE_INT32:
-                    sprintf(ptr, "%d%n", (int)((int32_t *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%d%n", (int)((int32_t *)self->data)[le_matrix_offset(self, y, x)], &written);
+                    break;
+                case LE_TYPE_FLOAT16:
+                    sprintf(ptr, "%f%n", le_f16_to_f32(((lehalf *)self->data)[le_matrix_offset(self, y, x)]), &written);
                     break;
                 case LE_TYPE_FLOAT32:
-                    sprintf(ptr, "%f%n", ((float *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%f%n", ((float *)self->data)[le_matrix_offset(self, y, x)], &written);
                     break;
                 case LE_TYPE_FLOAT64:
-                    sprintf(ptr, "%lf%n", ((double *)self->data)[y * self->shape->sizes[1] + x], &written);
+                    sprintf(ptr, "%lf%n", ((double *)self->data)[le_matrix_offset(self, y, x)], &written);
                     break;
                 case LE_TYPE_VOID:
                 default:
@@ -1242,7 +1995,6 @@ void
 le_tensor_print(const LeTensor *self, FILE *stream)
 {
     assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    /// @todo: Take stride into account
     if (self->shape->num_dimensions != 2)
     {
         fprintf(stream, "<%dD tensor>\n", self->shape->num_dimensions);
@@ -1256,7 +2008,7 @@ le_tensor_print(const LeTensor *self, FILE *stream)
     {
         for (x = 0; x < self->shape->sizes[1]; x++)
         {
-            fprintf(stream, "%1.3f", ((float *)self->data)[y * self->stride + x]);
+            fprintf(stream, "%1.3f", ((float *)self->data)[le_matrix_offset(self, y, x)]);
             if (x < self->shape->sizes[1] - 1)
             {
                 fprintf(stream, " ");
@@ -1276,80 +2028,10 @@ le_tensor_free(LeTensor *self)
     if (self == NULL)
         return;
 
-    if (self->owns_data)
-    {
-        switch (self->device_type)
-        {
-        case LE_DEVICE_TYPE_CPU:
-            free(self->data);
-            break;
-
-#ifdef HAVE_METAL
-        case LE_DEVICE_TYPE_METAL:
-            le_metal_data_free(self->data);
-            break;
-#endif
-            
-#ifdef HAVE_CUDA
-        case LE_DEVICE_TYPE_CUDA:
-            le_cuda_data_free(self->data);
-            break;
-#endif
-            
-        default:
-            assert(false);
-            break;
-        }
-    }
-    
-    le_shape_free(self->shape);
-    free(self);
+    le_tensor_release_data(self);
+    if (!self->owns_data)
+        le_mem_release_view(self->storage);
+    le_tensor_clear_layout(self);
+    le_free(self);
 }
 
-LeTensorStats
-le_tensor_get_stats(LeTensor *self)
-{
-    assert(self->device_type == LE_DEVICE_TYPE_CPU);
-    
-    LeTensorStats stats;
-    stats.deviation = 0.0f;
-    stats.mean = 0.0f;
-    stats.max = 0.0f;
-    stats.min = 0.0f;
-    stats.nans = 0;
-    stats.zeros = 0;
-
-    /// @todo: Take stride into account
-    unsigned elements_count = le_shape_get_elements_count(self->shape);
-    uint32_t last_size = le_shape_get_size(self->shape, -1);
-
-    if (elements_count >= 1)
-    {
-        float value = ((float *)self->data)[virtual_index(0, last_size, self->stride)];
-        stats.max = value;
-        stats.min = value;
-        stats.mean = value;
-        for (unsigned i = 1; i < elements_count; i++)
-        {
-            float value = ((float *)self->data)[virtual_index(i, last_size, self->stride)];
-            if (value > stats.max)
-                stats.max = value;
-            if (value < stats.min)
-                stats.min = value; 
-            stats.mean += value;
-        }
-        stats.mean /= elements_count;
-        for (unsigned i = 1; i < elements_count; i++)
-        {
-            float value = ((float *)self->data)[virtual_index(i, last_size, self->stride)];
-            stats.deviation += fabs(value - stats.mean);
-            if (isnan(value))
-                stats.nans++;
-            if (value == 0)
-                stats.zeros = 0;
-        }
-        stats.deviation /= elements_count;
-    }
-
-    return stats;
-}
@@ -29,10 +29,25 @@ LeTensor *         le_tensor_new_from_va_list              (LeType
 LeTensor *         le_tensor_new_uninitialized             (LeType                  element_type,
                                                             LeShape *               shape);
 
+/// @note: Elements for reading, they may be shared with copies of tensor, so must not be written
 void *             le_tensor_get_data                      (const LeTensor *        another);
 
+/// @note: Elements for writing, those shared with copies of tensor are copied first.
+/// Pointers returned before by le_tensor_get_data may become invalid.
+void *             le_tensor_get_data_mut                  (LeTensor *              another);
+
+/// @note: Copy of contiguous tensor shares its elements until either of them is written,
+/// first write copies elements. Elements of tensor with live views are copied at once.
 LeTensor *         le_tensor_new_copy                      (const LeTensor *        another);
 
+/// @note: Same as le_tensor_new_uninitialized, elements are taken by le_arena_alloc.
+/// For temporaries freed before end of scratch scope, takes ownership of shape.
+LeTensor *         le_tensor_new_scratch                   (LeType                  element_type,
+                                                            LeShape *               shape);
+
+/// @note: Densely packed copy of another with elements taken by le_arena_alloc, see le_tensor_new_scratch
+LeTensor *         le_tensor_new_scratch_copy              (const LeTensor *        another);
+
 LeTensor *         le_tensor_new_zeros                     (LeType                  element_type,
                                                             LeShape *               shape);
 
@@ -41,7 +56,21 @@ LeTensor *         le_tensor_new_zeros_like                (const LeTensor *
 /// @note: Takes ownership of shape
 LeTensor *         le_tensor_new_rand_f32                  (LeShape *               shape);
 
-LeTensor *         le_tensor_new_cast                      (LeTensor *              tensor,
+/// @note: Converts elements of any, possibly strided, tensor into new contiguous tensor of given type.
+/// Values out of range of integer type saturate, floating point values are rounded to nearest integer.
+LeTensor *         le_tensor_new_cast                      (const LeTensor *        tensor,
+                                                            LeType                  type);
+
+/// @note: Same as le_tensor_new_cast of tensor * scale + offset, e.g. bytes of image
+/// scaled to [0, 1] with scale 1/255, computed in single precision
+LeTensor *         le_tensor_new_cast_scaled               (const LeTensor *        tensor,
+                                                            LeType                  type,
+                                                            float                   scale,
+                                                            float                   offset);
+
+/// @note: Replaces elements of CPU tensor owning its data with elements cast to type, in place.
+/// Pointers to tensor stay valid, strides become densely packed.
+void               le_tensor_convert                       (LeTensor *              tensor,
                                                             LeType                  type);
 
 bool               le_tensor_contiguous                    (const LeTensor *        tensor);
@@ -53,36 +82,59 @@ bool               le_tensor_reshape                       (LeTensor *
                                                             unsigned                num_dimensions,
                                                             ...);
 
+/// @note: View of index-th subtensor along highest dimension. Views do not copy elements,
+/// they share data of another tensor with own shape and strides and must be freed before it.
+/// Elements which another shares with its copies are copied first, so views can be written.
+/// Views returned by functions taking const another share its elements as they are, so they are
+/// written only when another does not share elements with its copies, see le_tensor_get_data_mut.
 LeTensor *         le_tensor_pick                          (LeTensor *              another,
                                                             uint32_t                index);
 
 LeTensor *         le_tensor_pick_copy                     (const LeTensor *        another,
                                                             uint32_t                index);
 
+/// @note: View with two lowest dimensions swapped
+LeTensor *         le_tensor_transpose                     (const LeTensor *        another);
+
+/// @note: View with dimensions reordered, i-th dimension of view is order[i]-th dimension of another
+LeTensor *         le_tensor_permute                       (const LeTensor *        another,
+                                                            const unsigned *        order);
+
+/// @note: View of length elements of given dimension starting from start
+LeTensor *         le_tensor_slice                         (const LeTensor *        another,
+                                                            unsigned                dimension,
+                                                            uint32_t                start,
+                                                            uint32_t                length);
+
+/// @note: View of another stretched to shape by NumPy rules, see le_shape_new_broadcast.
+/// Stretched dimensions have zero stride, so elements are not copied.
+LeTensor *         le_tensor_broadcast                     (const LeTensor *        another,
+                                                            LeShape *               shape);
+
 void *             le_tensor_at                            (const LeTensor *        another,
-                                                            uint32_t                index);
+                                                            size_t                  index);
 
 uint8_t            le_tensor_at_u8                         (const LeTensor *        tensor,
-                                                            uint32_t                index);
+                                                            size_t                  index);
 
 uint32_t           le_tensor_at_u32                        (const LeTensor *        tensor,
-                                                            uint32_t                index);
+                                                            size_t                  index);
 
 float              le_tensor_at_f32                        (const LeTensor *        tensor,
-                                                            uint32_t                index);
+                                                            size_t                  index);
 
 void               le_tensor_assign                        (LeTensor *              tensor,
                                                             const LeTensor *        another);
 
 void               le_tensor_set_f32                       (LeTensor *              tensor,
-                                                            uint32_t                index,
+                                                            size_t                  index,
                                                             float                   value);
 
 /// @note: a = a + b
 void               le_tensor_add_f32                       (LeTensor *              a,
                                                             float                   b);
 
-/// @note: a = a + b
+/// @note: a = a + b, b is broadcast to shape of a
 void               le_tensor_add_tensor                    (LeTensor *              a,
                                                             const LeTensor *        b);
 
@@ -97,7 +149,7 @@ void               le_tensor_add_tensor                    (LeTensor *
 void               le_tensor_sub_f32                       (LeTensor *              a,
                                                             float                   b);
 
-/// @note: a = a - b
+/// @note: a = a - b, b is broadcast to shape of a
 void               le_tensor_sub_tensor                    (LeTensor *              a,
                                                             const LeTensor *        b);
 
@@ -122,7 +174,7 @@ void               le_tensor_sub_scaled_f32                (LeTensor *
 void               le_tensor_mul_f32                       (LeTensor *              a,
                                                             float                   b);
 
-/// @note: a = a * b
+/// @note: a = a * b, b is broadcast to shape of a
 void               le_tensor_mul_tensor                    (LeTensor *              a,
                                                             const LeTensor *        b);
 
@@ -133,6 +185,30 @@ void               le_tensor_mul_tensor                    (LeTensor *
    const LeTensor *: le_tensor_mul_tensor \
 )(a, b)
 
+/// @note: Element-wise binary operations, comparisons give 1 if true and 0 otherwise
+typedef enum LeBinaryOp
+{
+    LE_BINARY_OP_ADD,
+    LE_BINARY_OP_SUB,
+    LE_BINARY_OP_MUL,
+    LE_BINARY_OP_DIV,
+    LE_BINARY_OP_MAX,
+    LE_BINARY_OP_MIN,
+    LE_BINARY_OP_EQUAL,
+    LE_BINARY_OP_GREATER,
+    LE_BINARY_OP_LESS
+} LeBinaryOp;
+
+/// @note: a = a op b, b is broadcast to shape of a
+void               le_tensor_apply_binary                  (LeTensor *              a,
+                                                            LeBinaryOp              op,
+                                                            const LeTensor *        b);
+
+/// @note: Returns a op b, both operands are broadcast to common shape
+LeTensor *         le_tensor_new_binary                    (const LeTensor *        a,
+                                                            LeBinaryOp              op,
+                                                            const LeTensor *        b);
+
 void               le_tensor_div_u32                       (LeTensor *              a,
                                                             uint32_t                b);
 
@@ -149,6 +225,11 @@ void               le_tensor_apply_sigmoid_prime           (LeTensor *
 
 void               le_tensor_apply_tanh                    (LeTensor *              tensor);
 
+/// @note: Accuracy of exp, log, tanh and sigmoid follows le_set_math_accuracy
+void               le_tensor_apply_exp                     (LeTensor *              tensor);
+
+void               le_tensor_apply_log                     (LeTensor *              tensor);
+
 void               le_tensor_apply_sqr                     (LeTensor *              tensor);
 
 void               le_tensor_apply_1_minus                 (LeTensor *              tensor);
@@ -190,11 +271,13 @@ typedef struct LeTensorStats
    float min;
    float max;
    float mean;
+   /// @note: Standard deviation
    float deviation;
    unsigned nans;
    unsigned zeros;
 } LeTensorStats;
 
+/// @note: Gathers all statistics in single pass, see lereduce.h
 LeTensorStats      le_tensor_get_stats                     (LeTensor *              tensor);
 
 LeTensor *         le_tensor_new_equal_u8                  (LeType                  type,
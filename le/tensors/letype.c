@@ -2,6 +2,7 @@
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
 #include "letype.h"
+#include <string.h>
 
 size_t
 le_type_size(LeType type)
@@ -53,3 +54,66 @@ le_type_name(LeType type)
         return "void";
     }
 }
+
+lehalf
+le_f32_to_f16(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (bits >> 16) & 0x8000;
+    uint32_t magnitude = bits & 0x7fffffff;
+
+    /// Infinity stays infinity, NaN keeps upper bits of payload and becomes quiet
+    if (magnitude >= 0x7f800000)
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x0200 | ((magnitude >> 13) & 0x03ff) : 0);
+    /// Everything from 65520 up rounds to infinity
+    if (magnitude >= 0x477ff000)
+        return sign | 0x7c00;
+    /// Below 2^-14 result is denormal. Adding 0.5 aligns 2^-24 to last bit of significand
+    /// so addition itself rounds to nearest even.
+    if (magnitude < 0x38800000)
+    {
+        float aligned;
+        memcpy(&aligned, &magnitude, sizeof(aligned));
+        aligned += 0.5f;
+        memcpy(&bits, &aligned, sizeof(bits));
+        return sign | (uint16_t)(bits - 0x3f000000);
+    }
+
+    /// Exponent is rebiased from 127 to 15, carry from rounding may reach exponent
+    uint32_t rebiased = magnitude - (112u << 23);
+    uint32_t half = rebiased >> 13;
+    uint32_t remainder = rebiased & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        half++;
+    return sign | (uint16_t)half;
+}
+
+float
+le_f16_to_f32(lehalf value)
+{
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x03ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent == 0)
+    {
+        /// Zero and denormals are exact multiples of 2^-24
+        float magnitude = (float)mantissa * 5.9604644775390625e-8f;
+        memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+    }
+    else
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
@@ -34,6 +34,11 @@ size_t             le_type_size                            (LeType
 
 const char *       le_type_name                            (LeType                  type);
 
+/// @note: Rounds to nearest even, values beyond half precision range become infinities
+lehalf             le_f32_to_f16                           (float                   value);
+
+float              le_f16_to_f32                           (lehalf                  value);
+
 LE_END_DECLS
 
 #endif
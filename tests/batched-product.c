@@ -0,0 +1,109 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define BATCH 7
+#define M 13
+#define K 9
+#define N 21
+
+static LeTensor *
+le_test_new_rand(unsigned batch, unsigned height, unsigned width)
+{
+    LeTensor *self = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(3, batch, height, width));
+    for (unsigned i = 0; i < batch * height * width; i++)
+        ((float *)self->data)[i] = (float)rand() / RAND_MAX - 0.5f;
+    return self;
+}
+
+/// @note: Matrix of operand for given batch, batch of size 1 and rank 2 operand are broadcast
+static LeTensor *
+le_test_batch(const LeTensor *tensor, unsigned batch)
+{
+    if (tensor->shape->num_dimensions == 2)
+        return le_tensor_new_copy(tensor);
+    return le_tensor_pick_copy(tensor, (tensor->shape->sizes[0] == 1) ? 0 : batch);
+}
+
+static void
+le_test_check(const LeTensor *a, bool transpose_a, const LeTensor *b, bool transpose_b)
+{
+    LeTensor *product = le_tensor_new_batched_product(a, transpose_a, b, transpose_b);
+    assert(product->shape->num_dimensions == 3);
+
+    for (unsigned batch = 0; batch < product->shape->sizes[0]; batch++)
+    {
+        LeTensor *a_matrix = le_test_batch(a, batch);
+        LeTensor *b_matrix = le_test_batch(b, batch);
+        LeTensor *expected = le_matrix_new_product_full(a_matrix, transpose_a, b_matrix, transpose_b);
+        LeTensor *actual = le_tensor_pick_copy(product, batch);
+        assert(le_shape_equal(actual->shape, expected->shape));
+        for (unsigned i = 0; i < le_shape_get_elements_count(expected->shape); i++)
+            assert(fabsf(le_tensor_at_f32(actual, i) - le_tensor_at_f32(expected, i)) < 1e-4f);
+        le_tensor_free(actual);
+        le_tensor_free(expected);
+        le_tensor_free(b_matrix);
+        le_tensor_free(a_matrix);
+    }
+
+    le_tensor_free(product);
+}
+
+static void
+le_test_batched_products(void)
+{
+    LeTensor *a = le_test_new_rand(BATCH, M, K);
+    LeTensor *a_transposed = le_test_new_rand(BATCH, K, M);
+    LeTensor *b = le_test_new_rand(BATCH, K, N);
+    LeTensor *b_transposed = le_test_new_rand(BATCH, N, K);
+
+    /// Every combination of transposed operands
+    le_test_check(a, false, b, false);
+    le_test_check(a_transposed, true, b, false);
+    le_test_check(a, false, b_transposed, true);
+    le_test_check(a_transposed, true, b_transposed, true);
+
+    /// Single matrix is broadcast to every batch of another operand
+    LeTensor *a_single = le_test_new_rand(1, M, K);
+    le_test_check(a_single, false, b, false);
+    LeTensor *b_matrix = le_tensor_pick_copy(b, 3);
+    le_test_check(a, false, b_matrix, false);
+    LeTensor *product = le_tensor_new_batched_product(a_single, false, b_matrix, false);
+    assert(product->shape->sizes[0] == 1);
+    le_tensor_free(product);
+
+    /// Operands may be views with dimensions reordered
+    LeTensor *b_permuted = le_tensor_permute(b_transposed, (unsigned[]){ 0, 2, 1 });
+    le_test_check(a, false, b_permuted, false);
+    LeTensor *a_permuted = le_tensor_permute(a_transposed, (unsigned[]){ 0, 2, 1 });
+    LeTensor *b_interleaved = le_test_new_rand(K, BATCH, N);
+    LeTensor *b_columns = le_tensor_permute(b_interleaved, (unsigned[]){ 1, 0, 2 });
+    le_test_check(a_permuted, false, b_columns, false);
+
+    le_tensor_free(b_columns);
+    le_tensor_free(b_interleaved);
+    le_tensor_free(a_permuted);
+    le_tensor_free(b_permuted);
+    le_tensor_free(b_matrix);
+    le_tensor_free(a_single);
+    le_tensor_free(b_transposed);
+    le_tensor_free(b);
+    le_tensor_free(a_transposed);
+    le_tensor_free(a);
+}
+
+int
+main()
+{
+    le_set_num_threads(1);
+    le_test_batched_products();
+    le_set_num_threads(4);
+    le_test_batched_products();
+
+    return EXIT_SUCCESS;
+}
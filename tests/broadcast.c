@@ -0,0 +1,111 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <le/le.h>
+
+int
+main()
+{
+    /// Compatible shapes are aligned from lowest dimension
+    LeShape *a_shape = le_shape_new(3, 2, 1, 4);
+    LeShape *b_shape = le_shape_new(2, 3, 1);
+    LeShape *shape = le_shape_new_broadcast(a_shape, b_shape);
+    LeShape *expected_shape = le_shape_new(3, 2, 3, 4);
+    assert(le_shape_equal(shape, expected_shape));
+    le_shape_free(expected_shape);
+    le_shape_free(shape);
+    LeShape *incompatible_shape = le_shape_new(2, 3, 2);
+    assert(le_shape_new_broadcast(a_shape, incompatible_shape) == NULL);
+    le_shape_free(incompatible_shape);
+
+    /// Broadcast view reads same elements through zero strides
+    LeTensor *row = le_tensor_new(LE_TYPE_FLOAT32, 1, 4,
+        1.0, 2.0, 3.0, 4.0
+    );
+    LeTensor *column = le_tensor_new(LE_TYPE_FLOAT32, 2, 3, 1,
+        10.0,
+        20.0,
+        30.0
+    );
+    LeShape *view_shape = le_shape_new(3, 2, 3, 4);
+    LeTensor *row_view = le_tensor_broadcast(row, view_shape);
+    assert(le_tensor_get_data(row_view) == le_tensor_get_data(row));
+    assert(!le_tensor_contiguous(row_view));
+    for (unsigned i = 0; i < 24; i++)
+        assert(le_tensor_at_f32(row_view, i) == (float)(i % 4 + 1));
+    le_tensor_free(row_view);
+    le_shape_free(view_shape);
+
+    /// Result of out-of-place operation has common shape
+    LeTensor *sum = le_tensor_new_binary(column, LE_BINARY_OP_ADD, row);
+    LeTensor *expected = le_tensor_new(LE_TYPE_FLOAT32, 2, 3, 4,
+        11.0, 12.0, 13.0, 14.0,
+        21.0, 22.0, 23.0, 24.0,
+        31.0, 32.0, 33.0, 34.0
+    );
+    assert(le_tensor_equal(sum, expected));
+
+    /// In-place operations broadcast second operand
+    le_tensor_sub(sum, column);
+    for (unsigned y = 0; y < 3; y++)
+        for (unsigned x = 0; x < 4; x++)
+            assert(le_matrix_at_f32(sum, y, x) == (float)(x + 1));
+    le_tensor_mul(sum, row);
+    for (unsigned y = 0; y < 3; y++)
+        for (unsigned x = 0; x < 4; x++)
+            assert(le_matrix_at_f32(sum, y, x) == (float)((x + 1) * (x + 1)));
+    le_tensor_apply_binary(sum, LE_BINARY_OP_DIV, row);
+    le_tensor_apply_binary(expected, LE_BINARY_OP_MIN, row);
+    assert(le_tensor_equal(sum, expected));
+    le_matrix_add(expected, column);
+    le_tensor_apply_binary(expected, LE_BINARY_OP_MAX, column);
+    for (unsigned y = 0; y < 3; y++)
+        for (unsigned x = 0; x < 4; x++)
+            assert(le_matrix_at_f32(expected, y, x) == (float)((y + 1) * 10 + x + 1));
+    le_tensor_free(expected);
+    le_tensor_free(sum);
+
+    /// Comparisons give ones and zeros
+    LeTensor *scalar = le_tensor_new(LE_TYPE_FLOAT32, 1, 1,
+        2.0
+    );
+    LeTensor *greater = le_tensor_new_binary(row, LE_BINARY_OP_GREATER, scalar);
+    LeTensor *less = le_tensor_new_binary(row, LE_BINARY_OP_LESS, scalar);
+    LeTensor *equal = le_tensor_new_binary(scalar, LE_BINARY_OP_EQUAL, row);
+    for (unsigned x = 0; x < 4; x++)
+    {
+        assert(le_tensor_at_f32(greater, x) == (x > 1 ? 1.0f : 0.0f));
+        assert(le_tensor_at_f32(less, x) == (x < 1 ? 1.0f : 0.0f));
+        assert(le_tensor_at_f32(equal, x) == (x == 1 ? 1.0f : 0.0f));
+    }
+    le_tensor_free(equal);
+    le_tensor_free(less);
+    le_tensor_free(greater);
+    le_tensor_free(scalar);
+
+    /// Rows longer than one block and stretched middle dimension of 3D tensor
+    LeShape *long_shape = le_shape_new(3, 3, 2, 2500);
+    LeTensor *cube = le_tensor_new_zeros(LE_TYPE_FLOAT32, long_shape);
+    LeTensor *plane = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(3, 3, 1, 2500));
+    LeTensor *bias = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(3, 3, 2, 1));
+    for (unsigned i = 0; i < 3 * 2500; i++)
+        le_tensor_set_f32(plane, i, (float)(i % 2500));
+    for (unsigned i = 0; i < 3 * 2; i++)
+        le_tensor_set_f32(bias, i, (float)(i * 10000));
+    le_tensor_add(cube, plane);
+    le_tensor_add(cube, bias);
+    for (unsigned i = 0; i < 3 * 2 * 2500; i++)
+        assert(le_tensor_at_f32(cube, i) == (float)((i / 2500) * 10000 + i % 2500));
+    le_tensor_free(bias);
+    le_tensor_free(plane);
+    le_tensor_free(cube);
+
+    le_tensor_free(column);
+    le_tensor_free(row);
+    le_shape_free(b_shape);
+    le_shape_free(a_shape);
+
+    return EXIT_SUCCESS;
+}
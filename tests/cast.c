@@ -0,0 +1,123 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+static const double samples[] = {
+    0.0, 1.0, -1.0, 2.5, -2.5, 3.5, 0.49, 127.0, 128.0, -128.0, -129.0, 255.0, 255.5, 256.0,
+    32767.0, -32769.0, 65535.7, 2147483647.0, -2147483649.0, 3e9, -3e9, 1e20, INFINITY, -INFINITY, NAN
+};
+
+#define SAMPLES_COUNT (sizeof(samples) / sizeof(samples[0]))
+
+/// @note: Value of type closest to value, following rules of le_cast
+static double
+le_test_expected(LeType type, double value)
+{
+    double min, max;
+    switch (type)
+    {
+    case LE_TYPE_INT8: min = INT8_MIN; max = INT8_MAX; break;
+    case LE_TYPE_UINT8: min = 0; max = UINT8_MAX; break;
+    case LE_TYPE_INT16: min = INT16_MIN; max = INT16_MAX; break;
+    case LE_TYPE_UINT16: min = 0; max = UINT16_MAX; break;
+    case LE_TYPE_INT32: min = INT32_MIN; max = INT32_MAX; break;
+    case LE_TYPE_UINT32: min = 0; max = UINT32_MAX; break;
+    case LE_TYPE_FLOAT16: return le_f16_to_f32(le_f32_to_f16((float)value));
+    case LE_TYPE_FLOAT32: return (float)value;
+    default: return value;
+    }
+    if (isnan(value))
+        return 0.0;
+    return nearbyint(fmin(fmax(value, min), max));
+}
+
+static bool
+le_test_same(double a, double b)
+{
+    return a == b || (isnan(a) && isnan(b));
+}
+
+/// @note: Every pair of types, checked through conversion to double precision which is exact for all of them
+static void
+le_test_all_pairs(void)
+{
+    LeTensor *values = le_tensor_new_uninitialized(LE_TYPE_FLOAT64, le_shape_new(1, (unsigned)SAMPLES_COUNT));
+    for (unsigned i = 0; i < SAMPLES_COUNT; i++)
+        ((double *)values->data)[i] = samples[i];
+
+    for (LeType source_type = LE_TYPE_INT8; source_type < LE_TYPE_COUNT; source_type++)
+    {
+        LeTensor *source = le_tensor_new_cast(values, source_type);
+        for (LeType destination_type = LE_TYPE_INT8; destination_type < LE_TYPE_COUNT; destination_type++)
+        {
+            LeTensor *destination = le_tensor_new_cast(source, destination_type);
+            assert(destination->element_type == destination_type);
+            LeTensor *result = le_tensor_new_cast(destination, LE_TYPE_FLOAT64);
+            for (unsigned i = 0; i < SAMPLES_COUNT; i++)
+            {
+                double expected = le_test_expected(destination_type, le_test_expected(source_type, samples[i]));
+                assert(le_test_same(((double *)result->data)[i], expected));
+            }
+            le_tensor_free(result);
+            le_tensor_free(destination);
+        }
+        le_tensor_free(source);
+    }
+
+    le_tensor_free(values);
+}
+
+int
+main()
+{
+    le_test_all_pairs();
+
+    /// Large buffer is converted in parallel parts by vectorized kernel
+    unsigned height = 300, width = 784;
+    LeTensor *images = le_tensor_new_uninitialized(LE_TYPE_UINT8, le_shape_new(2, height, width));
+    for (unsigned i = 0; i < height * width; i++)
+        ((uint8_t *)images->data)[i] = (uint8_t)(i * 7 % 256);
+    LeTensor *scaled = le_tensor_new_cast_scaled(images, LE_TYPE_FLOAT32, 1.0f / 255.0f, 0.0f);
+    for (unsigned i = 0; i < height * width; i++)
+        assert(le_tensor_at_f32(scaled, i) == (float)le_tensor_at_u8(images, i) * (1.0f / 255.0f));
+
+    /// Strided source gives same elements as its contiguous copy
+    LeTensor *transposed = le_tensor_transpose(images);
+    LeTensor *transposed_copy = le_tensor_new_copy(transposed);
+    LeTensor *cast = le_tensor_new_cast(transposed, LE_TYPE_FLOAT32);
+    LeTensor *cast_copy = le_tensor_new_cast(transposed_copy, LE_TYPE_FLOAT32);
+    assert(le_tensor_contiguous(cast));
+    assert(le_tensor_equal(cast, cast_copy));
+    le_tensor_free(cast);
+    le_tensor_free(cast_copy);
+    cast = le_tensor_new_cast_scaled(transposed, LE_TYPE_FLOAT32, 2.0f / 255.0f, -1.0f);
+    cast_copy = le_tensor_new_cast_scaled(transposed_copy, LE_TYPE_FLOAT32, 2.0f / 255.0f, -1.0f);
+    assert(le_tensor_equal(cast, cast_copy));
+    le_tensor_free(cast);
+    le_tensor_free(cast_copy);
+
+    /// Scaled values saturate at bounds of integer type
+    cast = le_tensor_new_cast_scaled(transposed, LE_TYPE_INT8, 1.0f, -128.0f);
+    cast_copy = le_tensor_new_cast_scaled(scaled, LE_TYPE_UINT8, 300.0f, 0.5f);
+    for (unsigned i = 0; i < height * width; i++)
+    {
+        assert(((int8_t *)cast->data)[i] == (int8_t)(le_tensor_at_u8(transposed_copy, i) - 128));
+        float expected = nearbyintf(le_tensor_at_f32(scaled, i) * 300.0f + 0.5f);
+        assert(le_tensor_at_u8(cast_copy, i) == (uint8_t)fminf(expected, 255.0f));
+    }
+    le_tensor_free(cast);
+    le_tensor_free(cast_copy);
+
+    le_tensor_free(transposed_copy);
+    le_tensor_free(transposed);
+    le_tensor_free(scaled);
+    le_tensor_free(images);
+
+    return EXIT_SUCCESS;
+}
@@ -9,8 +9,18 @@ int
 main(int argc, char *argv[])
 {
     LeSequential *nn = le_sequential_new();
-    le_sequential_add(nn, LE_LAYER(le_conv2d_new("C1", 3, 1, 1, 0, 1)));
-    le_sequential_free(nn);
+    LeConv2D *conv = le_conv2d_new("C1", 3, 1, 1, 0, 1);
+    le_sequential_add(nn, LE_LAYER(conv));
+
+    /// Sobel filter detecting horizontal edges, filters are stored as (height, width, channels, filters)
+    LeTensor *sobel = le_tensor_new(LE_TYPE_FLOAT32, 4, 3, 3, 1, 1,
+        1.0, 2.0, 1.0,
+        0.0, 0.0, 0.0,
+        -1.0, -2.0, -1.0
+    );
+    le_tensor_assign(conv->w, sobel);
+    le_tensor_free(sobel);
+    le_tensor_mul(conv->b, 0.0f);
 
     LeTensor *input = le_tensor_new(LE_TYPE_FLOAT32, 4, 1, 6, 6, 1,
         1.0, 1.0, 1.0, 0.0, 0.0, 0.0,
@@ -29,9 +39,19 @@ main(int argc, char *argv[])
     LeTensor *output = le_model_predict(LE_MODEL(nn), input);
     LeShape *expected_shape = le_shape_new(4, 1, 4, 4, 1);
     assert(le_shape_equal(output->shape, expected_shape));
+    assert(le_tensor_equal(output, expected_output));
+
+    /// Bias is added to every output position
+    le_tensor_add(conv->b, 0.5f);
+    le_model_predict_into(LE_MODEL(nn), output, input);
+    le_tensor_add(expected_output, 0.5f);
+    assert(le_tensor_equal(output, expected_output));
+
     le_shape_free(expected_shape);
     le_tensor_free(output);
+    le_tensor_free(expected_output);
     le_tensor_free(input);
+    le_sequential_free(nn);
 
     return EXIT_SUCCESS;
 }
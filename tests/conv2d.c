@@ -0,0 +1,194 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define BATCH 3
+#define HEIGHT 9
+#define WIDTH 8
+#define CHANNELS 2
+#define FILTERS 4
+#define EPSILON 1e-2f
+
+/// @note: Direct convolution of NHWC input with (height, width, channels, filters) filters,
+/// or with (height, width, 1, channels) filters of depthwise layer
+static float
+le_test_conv_at(const LeConv2D *conv, const LeTensor *input, unsigned n, unsigned oy, unsigned ox, unsigned f)
+{
+    unsigned filter = conv->w->shape->sizes[0];
+    unsigned channels = input->shape->sizes[3];
+    unsigned filters = conv->w->shape->sizes[3];
+    float sum = le_tensor_at_f32(conv->b, f);
+    for (unsigned ky = 0; ky < filter; ky++)
+    {
+        for (unsigned kx = 0; kx < filter; kx++)
+        {
+            int iy = (int)(oy * conv->stride + ky) - (int)conv->padding;
+            int ix = (int)(ox * conv->stride + kx) - (int)conv->padding;
+            if ((iy < 0) || (iy >= HEIGHT) || (ix < 0) || (ix >= WIDTH))
+                continue;
+            if (conv->depthwise)
+            {
+                float x = le_tensor_at_f32(input, ((n * HEIGHT + iy) * WIDTH + ix) * channels + f);
+                sum += x * le_tensor_at_f32(conv->w, (ky * filter + kx) * filters + f);
+                continue;
+            }
+            for (unsigned c = 0; c < channels; c++)
+            {
+                float x = le_tensor_at_f32(input, ((n * HEIGHT + iy) * WIDTH + ix) * channels + c);
+                float w = le_tensor_at_f32(conv->w, ((ky * filter + kx) * channels + c) * filters + f);
+                sum += x * w;
+            }
+        }
+    }
+    return sum;
+}
+
+/// @note: Sum of outputs weighted by r, its gradient with respect to outputs is r
+static float
+le_test_cost(LeConv2D *conv, LeTensor *input, const LeTensor *r)
+{
+    LeTensor *output = le_layer_forward_prop(LE_LAYER(conv), input);
+    le_tensor_mul(output, r);
+    float cost = le_tensor_reduce_f32(output, LE_REDUCE_OP_SUM);
+    le_tensor_free(output);
+    return cost;
+}
+
+/// @note: Derivative of cost by element of tensor, estimated by central difference
+static float
+le_test_estimate(LeConv2D *conv, LeTensor *input, const LeTensor *r, LeTensor *tensor, size_t index)
+{
+    float value = le_tensor_at_f32(tensor, index);
+    le_tensor_set_f32(tensor, index, value + EPSILON);
+    float cost_plus = le_test_cost(conv, input, r);
+    le_tensor_set_f32(tensor, index, value - EPSILON);
+    float cost_minus = le_test_cost(conv, input, r);
+    le_tensor_set_f32(tensor, index, value);
+    return (cost_plus - cost_minus) / (2.0f * EPSILON);
+}
+
+static void
+le_test_layer(LeConv2D *conv, unsigned channels)
+{
+    unsigned filter = conv->w->shape->sizes[0];
+    unsigned filters = conv->w->shape->sizes[3];
+    unsigned padding = conv->padding;
+    unsigned stride = conv->stride;
+    le_tensor_add(conv->b, 0.25f);
+    LeTensor *input = le_tensor_new_rand_f32(le_shape_new(4, BATCH, HEIGHT, WIDTH, channels));
+
+    /// Forward pass matches direct convolution
+    LeTensor *output = le_layer_forward_prop(LE_LAYER(conv), input);
+    unsigned output_h = (HEIGHT + 2 * padding - filter) / stride + 1;
+    unsigned output_w = (WIDTH + 2 * padding - filter) / stride + 1;
+    LeShape *expected_shape = le_shape_new(4, BATCH, output_h, output_w, filters);
+    assert(le_shape_equal(output->shape, expected_shape));
+    le_shape_free(expected_shape);
+    for (unsigned n = 0; n < BATCH; n++)
+        for (unsigned oy = 0; oy < output_h; oy++)
+            for (unsigned ox = 0; ox < output_w; ox++)
+                for (unsigned f = 0; f < filters; f++)
+                {
+                    size_t index = ((n * output_h + oy) * output_w + ox) * filters + f;
+                    /// @note: Winograd transforms lose some precision
+                    assert(fabsf(le_tensor_at_f32(output, index) - le_test_conv_at(conv, input, n, oy, ox, f)) < 1e-3f);
+                }
+
+    /// Backward pass matches numerical derivatives, gradients of parameters are averaged over batch
+    LeTensor *r = le_tensor_new_rand_f32(le_shape_copy(output->shape));
+    LeList *gradients = NULL;
+    LeTensor *input_gradient = le_layer_backward_prop(LE_LAYER(conv), input, output, r, &gradients);
+    assert(le_shape_equal(input_gradient->shape, input->shape));
+    LeTensor *db = LE_TENSOR(gradients->data);
+    LeTensor *dw = LE_TENSOR(gradients->next->data);
+    assert(le_shape_equal(db->shape, conv->b->shape));
+    assert(le_shape_equal(dw->shape, conv->w->shape));
+    for (size_t i = 0; i < le_shape_get_elements_count(input->shape); i += 5)
+        assert(fabsf(le_tensor_at_f32(input_gradient, i) - le_test_estimate(conv, input, r, input, i)) < 1e-2f);
+    for (size_t i = 0; i < le_shape_get_elements_count(conv->w->shape); i++)
+        assert(fabsf(BATCH * le_tensor_at_f32(dw, i) - le_test_estimate(conv, input, r, conv->w, i)) < 5e-2f);
+    for (size_t i = 0; i < filters; i++)
+        assert(fabsf(BATCH * le_tensor_at_f32(db, i) - le_test_estimate(conv, input, r, conv->b, i)) < 5e-2f);
+
+    le_list_free(gradients, LE_FUNCTION(le_tensor_free));
+    le_tensor_free(input_gradient);
+    le_tensor_free(r);
+    le_tensor_free(output);
+    le_tensor_free(input);
+}
+
+static void
+le_test_conv(unsigned filter, unsigned padding, unsigned stride, LeConv2DAlgorithm algorithm)
+{
+    LeConv2D *conv = le_conv2d_new("C", filter, CHANNELS, FILTERS, padding, stride);
+    le_conv2d_set_algorithm(conv, algorithm);
+    le_test_layer(conv, CHANNELS);
+}
+
+static void
+le_test_depthwise(unsigned padding, unsigned stride)
+{
+    LeConv2D *conv = le_conv2d_new_depthwise("D", 3, FILTERS, padding, stride);
+    le_test_layer(conv, FILTERS);
+}
+
+/// @note: Selection depends on filters and input, and is kept while input shape stays the same
+static void
+le_test_selection(void)
+{
+    LeShape *small = le_shape_new(4, BATCH, HEIGHT, WIDTH, 32);
+    LeShape *large = le_shape_new(4, BATCH, 32, 32, 32);
+    LeShape *few_channels = le_shape_new(4, BATCH, HEIGHT, WIDTH, 2);
+
+    LeConv2D *conv = le_conv2d_new("C", 3, 32, 32, 1, 1);
+    assert(le_conv2d_get_algorithm(conv, small) == LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3);
+    LeShape *smaller = le_shape_new(4, BATCH, 4, 4, 32);
+    assert(le_conv2d_get_algorithm(conv, smaller) == LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3);
+    assert(le_conv2d_get_algorithm(conv, smaller) == LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3);
+    assert(le_conv2d_get_algorithm(conv, large) == LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3);
+    le_conv2d_set_algorithm(conv, LE_CONV2D_ALGORITHM_IM2COL);
+    assert(le_conv2d_get_algorithm(conv, large) == LE_CONV2D_ALGORITHM_IM2COL);
+    le_shape_free(smaller);
+
+    conv = le_conv2d_new("C", 3, 2, 4, 1, 1);
+    assert(le_conv2d_get_algorithm(conv, few_channels) == LE_CONV2D_ALGORITHM_IM2COL);
+    conv = le_conv2d_new("C", 3, 32, 32, 1, 2);
+    assert(le_conv2d_get_algorithm(conv, large) == LE_CONV2D_ALGORITHM_IM2COL);
+    conv = le_conv2d_new("C", 1, 32, 8, 0, 1);
+    assert(le_conv2d_get_algorithm(conv, large) == LE_CONV2D_ALGORITHM_POINTWISE);
+    conv = le_conv2d_new_depthwise("D", 3, 32, 1, 1);
+    assert(le_conv2d_get_algorithm(conv, large) == LE_CONV2D_ALGORITHM_DEPTHWISE);
+
+    le_shape_free(few_channels);
+    le_shape_free(large);
+    le_shape_free(small);
+}
+
+int
+main()
+{
+    le_test_conv(3, 0, 1, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(3, 1, 1, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(3, 1, 2, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(3, 2, 3, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(1, 0, 1, LE_CONV2D_ALGORITHM_POINTWISE);
+    le_test_conv(1, 1, 2, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(3, 0, 1, LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3);
+    le_test_conv(3, 1, 1, LE_CONV2D_ALGORITHM_WINOGRAD_2X2_3X3);
+    le_test_conv(3, 0, 1, LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3);
+    le_test_conv(3, 2, 1, LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3);
+    le_test_depthwise(1, 1);
+    le_test_depthwise(0, 2);
+    le_test_selection();
+    le_set_num_threads(4);
+    le_test_conv(3, 1, 2, LE_CONV2D_ALGORITHM_AUTO);
+    le_test_conv(3, 1, 1, LE_CONV2D_ALGORITHM_WINOGRAD_4X4_3X3);
+    le_test_depthwise(1, 1);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <le/le.h>
+#include <le/lemem.h>
+#include <le/tensors/letensor-imp.h>
+
+#define TRAINING_STEPS 5
+
+static LeOptimizer *
+le_test_optimizer(bool stochastic, LeSequential *nn, LeTensor *x, LeTensor *y)
+{
+    if (stochastic)
+        return LE_OPTIMIZER(le_sgd_new(LE_MODEL(nn), x, y, 4, 0.5f, 0.9f));
+    return LE_OPTIMIZER(le_bgd_new(LE_MODEL(nn), x, y, 0.5f));
+}
+
+static void
+le_test_optimizer_free(bool stochastic, LeOptimizer *optimizer)
+{
+    if (stochastic)
+        le_sgd_free(LE_SGD(optimizer));
+    else
+        le_bgd_free(LE_BGD(optimizer));
+}
+
+/// @note: Private copies of parameters written by step are made outside of its scratch scope,
+/// so parameters shared with copies taken before training are trained same as unshared ones
+static void
+le_test_training(bool stochastic)
+{
+    LeTensor *x = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, 8, 16);
+    LeTensor *y = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, 2, 16);
+    LeSequential *nn = le_sequential_new();
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("D", 8, 2)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A", LE_ACTIVATION_SIGMOID)));
+    le_sequential_set_loss(nn, LE_LOSS_MSE);
+    LeList *parameters = le_model_get_parameters(LE_MODEL(nn));
+
+    LeList *initial = NULL, *snapshots = NULL, *trained = NULL;
+    for (LeList *p = parameters; p; p = p->next)
+    {
+        LeTensor *copy = le_tensor_new_copy(LE_TENSOR(p->data));
+        le_tensor_make_writable(copy);
+        initial = le_list_append(initial, copy);
+        snapshots = le_list_append(snapshots, le_tensor_new_copy(LE_TENSOR(p->data)));
+    }
+
+    LeOptimizer *optimizer = le_test_optimizer(stochastic, nn, x, y);
+    for (unsigned i = 0; i < TRAINING_STEPS; i++)
+        le_optimizer_step(optimizer);
+    le_test_optimizer_free(stochastic, optimizer);
+    for (LeList *p = parameters, *s = snapshots, *i = initial; p; p = p->next, s = s->next, i = i->next)
+    {
+        assert(le_tensor_equal(LE_TENSOR(s->data), LE_TENSOR(i->data)));
+        LeTensor *copy = le_tensor_new_copy(LE_TENSOR(p->data));
+        le_tensor_make_writable(copy);
+        trained = le_list_append(trained, copy);
+        le_tensor_assign(LE_TENSOR(p->data), LE_TENSOR(i->data));
+    }
+
+    /// Same training without snapshots
+    optimizer = le_test_optimizer(stochastic, nn, x, y);
+    for (unsigned i = 0; i < TRAINING_STEPS; i++)
+        le_optimizer_step(optimizer);
+    le_test_optimizer_free(stochastic, optimizer);
+    for (LeList *p = parameters, *t = trained; p; p = p->next, t = t->next)
+        assert(le_tensor_equal(LE_TENSOR(p->data), LE_TENSOR(t->data)));
+
+    le_list_free(trained, LE_FUNCTION(le_tensor_free));
+    le_list_free(snapshots, LE_FUNCTION(le_tensor_free));
+    le_list_free(initial, LE_FUNCTION(le_tensor_free));
+    le_sequential_free(nn);
+    le_tensor_free(y);
+    le_tensor_free(x);
+}
+
+int
+main()
+{
+    /// Blocks are released when last reference is dropped
+    size_t initial = le_mem_get_stats().bytes_in_use;
+    void *block = le_alloc(100);
+    assert(!le_mem_is_shared(block));
+    void *retained = le_retain(block);
+    assert(retained == block);
+    (void)retained;
+    assert(le_mem_is_shared(block));
+    le_free(block);
+    assert(!le_mem_is_shared(block));
+    le_free(block);
+    assert(le_mem_get_stats().bytes_in_use == initial);
+
+    LeTensor *a = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, 64, 64);
+    LeTensor *original = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, 64, 64);
+    le_tensor_assign(original, a);
+
+    /// Copy takes no memory for elements until written
+    size_t before_copy = le_mem_get_stats().bytes_in_use;
+    LeTensor *b = le_tensor_new_copy(a);
+    assert(b->data == a->data);
+    assert(le_mem_get_stats().bytes_in_use - before_copy < 64 * 64 * sizeof(float));
+    assert(le_tensor_equal(a, b));
+
+    /// First write gives written tensor its own elements
+    le_tensor_mul_f32(b, 2.0f);
+    assert(b->data != a->data);
+    assert(le_tensor_equal(a, original));
+    assert(le_matrix_at_f32(b, 3, 5) == 2.0f * le_matrix_at_f32(a, 3, 5));
+    void *b_data = b->data;
+    le_tensor_add_f32(b, 1.0f);
+    assert(b->data == b_data);
+    le_tensor_free(b);
+
+    /// Original may be written or freed first
+    b = le_tensor_new_copy(a);
+    LeTensor *c = le_tensor_new_copy(b);
+    le_tensor_apply_sigmoid(a);
+    assert(le_tensor_equal(b, original));
+    assert(le_tensor_equal(c, original));
+    le_tensor_free(b);
+    le_matrix_set_f32(c, 0, 0, -1.0f);
+    assert(le_matrix_at_f32(original, 0, 0) != -1.0f);
+    le_tensor_free(c);
+
+    /// Views of copy write into copy only
+    le_tensor_assign(a, original);
+    b = le_tensor_new_copy(a);
+    LeTensor *row = le_tensor_pick(b, 7);
+    le_tensor_mul_f32(row, 0.0f);
+    le_tensor_free(row);
+    assert(le_matrix_at_f32(b, 7, 9) == 0.0f);
+    assert(le_tensor_equal(a, original));
+    le_tensor_free(b);
+
+    /// Copy taken while views of tensor are alive does not see writes through them
+    le_tensor_assign(a, original);
+    row = le_tensor_pick(a, 0);
+    LeTensor *column = le_tensor_transpose(a);
+    b = le_tensor_new_copy(a);
+    assert(b->data != a->data);
+    le_tensor_mul_f32(row, 10.0f);
+    assert(le_tensor_equal(b, original));
+    assert(le_matrix_at_f32(a, 0, 3) == 10.0f * le_matrix_at_f32(original, 0, 3));
+    le_tensor_free(b);
+    le_tensor_free(row);
+    /// View of view keeps same elements viewed
+    LeTensor *column_row = le_tensor_pick(column, 2);
+    le_tensor_free(column);
+    b = le_tensor_new_copy(a);
+    assert(b->data != a->data);
+    le_tensor_free(b);
+    le_tensor_free(column_row);
+    /// Without views copy shares elements again, and write through new view of copy
+    /// does not leak into original
+    b = le_tensor_new_copy(a);
+    assert(b->data == a->data);
+    row = le_tensor_pick(b, 1);
+    le_tensor_mul_f32(row, 0.0f);
+    assert(le_matrix_at_f32(a, 1, 1) == le_matrix_at_f32(original, 1, 1));
+    le_tensor_free(row);
+    le_tensor_free(b);
+
+    /// View keeps viewed elements alive after tensor is freed
+    b = le_tensor_new_copy(original);
+    le_tensor_make_writable(b);
+    row = le_tensor_pick(b, 5);
+    le_tensor_free(b);
+    assert(le_tensor_at_f32(row, 7) == le_matrix_at_f32(original, 5, 7));
+    le_tensor_free(row);
+
+    /// Conversion of tensor leaves its views and elements they view intact
+    b = le_tensor_new_copy(original);
+    le_tensor_make_writable(b);
+    row = le_tensor_pick(b, 5);
+    column = le_tensor_transpose(b);
+    le_tensor_free(column);
+    le_tensor_convert(b, LE_TYPE_FLOAT64);
+    assert(le_mem_has_views(row->storage));
+    assert(le_tensor_at_f32(row, 7) == le_matrix_at_f32(original, 5, 7));
+    le_tensor_free(b);
+    assert(le_tensor_at_f32(row, 7) == le_matrix_at_f32(original, 5, 7));
+    le_tensor_free(row);
+
+    /// Reductions and views of const copy read shared elements without copying them
+    le_tensor_assign(a, original);
+    b = le_tensor_new_copy(a);
+    assert(le_tensor_sum_f32(b) == le_tensor_sum_f32(original));
+    column = le_tensor_transpose(b);
+    assert((b->data == a->data) && (column->data == a->data));
+    assert(le_matrix_at_f32(column, 3, 2) == le_matrix_at_f32(original, 2, 3));
+    le_tensor_free(column);
+    assert(le_mem_is_shared(a->data));
+    le_tensor_free(b);
+
+    /// Results written into destination do not leak into its copies
+    le_tensor_assign(a, original);
+    b = le_tensor_new_copy(a);
+    le_matrix_product_into(b, original, original);
+    assert(le_tensor_equal(a, original));
+    le_tensor_free(b);
+
+    le_tensor_free(original);
+    le_tensor_free(a);
+    assert(le_mem_get_stats().bytes_in_use == initial);
+
+    le_test_training(true);
+    le_test_training(false);
+
+    return EXIT_SUCCESS;
+}
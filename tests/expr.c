@@ -0,0 +1,94 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+
+/// @note: Not multiple of evaluation block size
+#define HEIGHT 37
+#define WIDTH 101
+
+static void
+le_test_ensure_close(const LeTensor *a, const LeTensor *b)
+{
+    assert(le_matrix_get_height(a) == le_matrix_get_height(b));
+    assert(le_matrix_get_width(a) == le_matrix_get_width(b));
+    for (unsigned y = 0; y < le_matrix_get_height(a); y++)
+    {
+        for (unsigned x = 0; x < le_matrix_get_width(a); x++)
+        {
+            assert(fabsf(le_matrix_at_f32(a, y, x) - le_matrix_at_f32(b, y, x)) < 1e-6f);
+        }
+    }
+}
+
+int
+main()
+{
+    const float rate = 0.9f;
+    const float learning_rate = 0.01f;
+
+    LeTensor *parameter = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, HEIGHT, WIDTH);
+    LeTensor *gradient = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, HEIGHT, WIDTH);
+    LeTensor *momentum = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, HEIGHT, WIDTH);
+
+    /// Momentum update done pass by pass
+    LeTensor *expected_parameter = le_tensor_new_copy(parameter);
+    LeTensor *expected_momentum = le_tensor_new_copy(momentum);
+    LeTensor *scaled_gradient = le_tensor_new_copy(gradient);
+    le_tensor_mul(expected_momentum, rate);
+    le_tensor_mul(scaled_gradient, 1.0f - rate);
+    le_tensor_add(expected_momentum, scaled_gradient);
+    le_tensor_sub_scaled(expected_parameter, learning_rate, expected_momentum);
+
+    LeExpr *expr = le_expr_new(momentum);
+    le_expr_mul_scalar(expr, rate);
+    le_expr_add_scaled(expr, 1.0f - rate, gradient);
+    le_expr_store(expr, momentum);
+    le_expr_mul_scalar(expr, -learning_rate);
+    le_expr_add_tensor(expr, parameter);
+    le_expr_store(expr, parameter);
+    le_expr_evaluate(expr);
+    le_expr_free(expr);
+
+    le_test_ensure_close(momentum, expected_momentum);
+    le_test_ensure_close(parameter, expected_parameter);
+
+    /// Functions and tensor operations
+    LeTensor *expected = le_tensor_new_copy(gradient);
+    le_tensor_sub(expected, parameter);
+    le_tensor_apply_sigmoid(expected);
+    le_tensor_apply_x_minus_sqr_x(expected);
+    le_tensor_mul(expected, momentum);
+    le_tensor_add(expected, 0.5f);
+    le_tensor_apply_sqr(expected);
+    le_tensor_apply_1_minus(expected);
+
+    LeTensor *result = le_matrix_new_zeros(LE_TYPE_FLOAT32, HEIGHT, WIDTH);
+    expr = le_expr_new(gradient);
+    le_expr_sub_tensor(expr, parameter);
+    le_expr_apply(expr, LE_EXPR_FUNCTION_SIGMOID);
+    le_expr_apply(expr, LE_EXPR_FUNCTION_X_MINUS_SQR_X);
+    le_expr_mul_tensor(expr, momentum);
+    le_expr_add_scalar(expr, 0.5f);
+    le_expr_apply(expr, LE_EXPR_FUNCTION_SQR);
+    le_expr_apply(expr, LE_EXPR_FUNCTION_1_MINUS);
+    le_expr_store(expr, result);
+    le_expr_evaluate(expr);
+    le_expr_free(expr);
+
+    le_test_ensure_close(result, expected);
+
+    le_tensor_free(result);
+    le_tensor_free(expected);
+    le_tensor_free(scaled_gradient);
+    le_tensor_free(expected_momentum);
+    le_tensor_free(expected_parameter);
+    le_tensor_free(momentum);
+    le_tensor_free(gradient);
+    le_tensor_free(parameter);
+
+    return EXIT_SUCCESS;
+}
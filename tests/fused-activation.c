@@ -0,0 +1,133 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+
+/// @note: Edge tiles in both dimensions and more than one block along k
+#define M 37
+#define K 300
+#define N 45
+
+static void
+le_test_apply(LeTensor *tensor, LeActivation activation)
+{
+    switch (activation)
+    {
+    case LE_ACTIVATION_SIGMOID:
+        le_tensor_apply_sigmoid(tensor);
+        break;
+    case LE_ACTIVATION_TANH:
+        le_tensor_apply_tanh(tensor);
+        break;
+    case LE_ACTIVATION_RELU:
+        le_tensor_apply_relu(tensor);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+le_test_check(const LeTensor *a, bool transpose_a, const LeTensor *b, const LeTensor *bias, LeActivation activation)
+{
+    LeTensor *expected = le_matrix_new_product_full(a, transpose_a, b, false);
+    if (bias)
+        le_matrix_add(expected, bias);
+    le_test_apply(expected, activation);
+
+    LeTensor *actual = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, M, N);
+    le_matrix_product_activation_into(actual, a, transpose_a, b, false, bias, activation);
+    assert(le_tensor_sad_f32(actual, expected) / (M * N) < 1e-5f);
+
+    le_tensor_free(actual);
+    le_tensor_free(expected);
+}
+
+static void
+le_test_products(void)
+{
+    static const LeActivation activations[] = {
+        LE_ACTIVATION_LINEAR, LE_ACTIVATION_SIGMOID, LE_ACTIVATION_TANH, LE_ACTIVATION_RELU
+    };
+
+    LeTensor *a = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, M, K);
+    le_tensor_sub_f32(a, 0.5f);
+    LeTensor *a_transposed = le_matrix_new_transpose(a);
+    LeTensor *b = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, K, N);
+    le_tensor_sub_f32(b, 0.5f);
+    LeTensor *bias = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, M, 1);
+    le_tensor_sub_f32(bias, 0.5f);
+    LeTensor *bias_half = le_tensor_new_cast(bias, LE_TYPE_FLOAT16);
+    LeTensor *row_bias = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, 1, N);
+
+    for (unsigned i = 0; i < sizeof(activations) / sizeof(activations[0]); i++)
+    {
+        le_test_check(a, false, b, bias, activations[i]);
+        le_test_check(a, false, b, NULL, activations[i]);
+        le_test_check(a_transposed, true, b, bias, activations[i]);
+        le_test_check(a, false, b, bias_half, activations[i]);
+        le_test_check(a, false, b, row_bias, activations[i]);
+    }
+
+    le_tensor_free(row_bias);
+    le_tensor_free(bias_half);
+    le_tensor_free(bias);
+    le_tensor_free(b);
+    le_tensor_free(a_transposed);
+    le_tensor_free(a);
+}
+
+/// @note: Dense layers followed by activation layers give same predictions when activations
+/// are fused into them as when layers run one by one
+static void
+le_test_sequential(void)
+{
+    LeLayer *layers[] = {
+        LE_LAYER(le_dense_layer_new("FC1", K, M)),
+        LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_RELU)),
+        LE_LAYER(le_dense_layer_new("FC2", M, 20)),
+        LE_LAYER(le_activation_layer_new("A2", LE_ACTIVATION_SIGMOID)),
+        LE_LAYER(le_dense_layer_new("FC3", 20, 10)),
+        LE_LAYER(le_activation_layer_new("A3", LE_ACTIVATION_TANH))
+    };
+    LeSequential *nn = le_sequential_new();
+    LeTensor *x = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, K, N);
+    LeTensor *expected = le_tensor_new_copy(x);
+    for (unsigned i = 0; i < sizeof(layers) / sizeof(layers[0]); i++)
+    {
+        le_sequential_add(nn, layers[i]);
+        LeTensor *output = le_layer_forward_prop(layers[i], expected);
+        le_tensor_free(expected);
+        expected = output;
+    }
+
+    LeTensor *prediction = le_model_predict(LE_MODEL(nn), x);
+    assert(le_tensor_sad_f32(prediction, expected) / (10 * N) < 1e-5f);
+    le_tensor_mul(prediction, 0.0f);
+    le_model_predict_into(LE_MODEL(nn), prediction, x);
+    assert(le_tensor_sad_f32(prediction, expected) / (10 * N) < 1e-5f);
+    le_tensor_mul(prediction, 0.0f);
+    le_model_predict_into(LE_MODEL(nn), prediction, x);
+    assert(le_tensor_sad_f32(prediction, expected) / (10 * N) < 1e-5f);
+
+    le_tensor_free(prediction);
+    le_tensor_free(expected);
+    le_tensor_free(x);
+    le_sequential_free(nn);
+}
+
+int
+main()
+{
+    le_set_num_threads(1);
+    le_test_products();
+    le_test_sequential();
+    le_set_num_threads(4);
+    le_test_products();
+    le_test_sequential();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/lekernels.h>
+#include <le/tensors/letensor-imp.h>
+
+static const unsigned feature_sets[] = {
+    0,
+    LE_CPU_FEATURE_SSE4_2,
+    LE_CPU_FEATURE_SSE4_2 | LE_CPU_FEATURE_AVX2 | LE_CPU_FEATURE_F16C,
+    LE_CPU_FEATURE_SSE4_2 | LE_CPU_FEATURE_AVX2 | LE_CPU_FEATURE_F16C | LE_CPU_FEATURE_AVX512F
+};
+
+static bool
+le_test_half_is_nan(lehalf value)
+{
+    return (value & 0x7c00) == 0x7c00 && (value & 0x03ff) != 0;
+}
+
+/// @note: Every half precision value survives round trip, bulk kernels match scalar conversion
+static void
+le_test_conversions(void)
+{
+    enum { COUNT = 1 << 16 };
+    static lehalf halves[COUNT], converted_halves[COUNT];
+    static float floats[COUNT], converted_floats[COUNT];
+    for (unsigned i = 0; i < COUNT; i++)
+    {
+        halves[i] = (lehalf)i;
+        floats[i] = le_f16_to_f32(halves[i]);
+        assert(le_test_half_is_nan(halves[i]) ? isnan(floats[i]) : le_f32_to_f16(floats[i]) == halves[i]);
+    }
+
+    assert(le_f32_to_f16(1.0f) == F16_1);
+    assert(le_f32_to_f16(65504.0f) == 0x7bff);
+    assert(le_f32_to_f16(65519.0f) == 0x7bff);
+    assert(le_f32_to_f16(65520.0f) == 0x7c00);
+    assert(le_f32_to_f16(-1e10f) == 0xfc00);
+    /// 1 + 2^-11 is halfway between 1 and next half, ties go to even
+    assert(le_f32_to_f16(1.00048828125f) == F16_1);
+    assert(le_f32_to_f16(1.00146484375f) == F16_1 + 2);
+    assert(le_f32_to_f16(5.9604644775390625e-8f) == 1);
+    assert(le_f32_to_f16(2.98023223876953125e-8f) == 0);
+
+    unsigned host_features = le_cpu_get_features();
+    for (unsigned f = 0; f < sizeof(feature_sets) / sizeof(feature_sets[0]); f++)
+    {
+        if ((feature_sets[f] & host_features) != feature_sets[f])
+            continue;
+        const LeKernels *kernels = le_kernels_get_for_features(feature_sets[f], LE_MATH_ACCURACY_FAITHFUL);
+
+        kernels->f16_to_f32(converted_floats, halves, COUNT - 3);
+        for (unsigned i = 0; i < COUNT - 3; i++)
+            assert(memcmp(&converted_floats[i], &floats[i], sizeof(float)) == 0 || isnan(floats[i]));
+
+        /// Single precision values between and around half precision ones, including halfway points
+        for (unsigned i = 0; i < COUNT; i++)
+        {
+            uint32_t bits = ((uint32_t)(i & 0x7fff) << 14) | ((i & 0x8000) ? 0x80000000u : 0u) | 0x1000;
+            memcpy(&floats[i], &bits, sizeof(bits));
+        }
+        kernels->f32_to_f16(converted_halves, floats, COUNT - 5);
+        for (unsigned i = 0; i < COUNT - 5; i++)
+            assert(converted_halves[i] == le_f32_to_f16(floats[i]) || isnan(floats[i]));
+        for (unsigned i = 0; i < COUNT; i++)
+            floats[i] = le_f16_to_f32(halves[i]);
+    }
+}
+
+int
+main()
+{
+    le_test_conversions();
+
+    /// Element-wise operations compute in single precision and round results to half precision
+    LeTensor *a = le_tensor_new(LE_TYPE_FLOAT16, 2, 2, 3,
+        1.0, -2.0, 0.5,
+        3.0, 0.25, -4.0
+    );
+    LeTensor *b = le_tensor_new(LE_TYPE_FLOAT32, 2, 2, 1,
+        0.5,
+        -1.0
+    );
+    le_tensor_add(a, b);
+    le_tensor_mul(a, 2.0f);
+    LeTensor *expected = le_tensor_new(LE_TYPE_FLOAT16, 2, 2, 3,
+        3.0, -3.0, 2.0,
+        4.0, -1.5, -10.0
+    );
+    assert(le_tensor_equal(a, expected));
+    le_tensor_free(expected);
+    le_tensor_apply_relu(a);
+    LeTensor *single = le_tensor_new_cast(a, LE_TYPE_FLOAT32);
+    assert(le_matrix_at_f32(single, 0, 1) == 0.0f);
+    assert(le_matrix_at_f32(single, 1, 0) == 4.0f);
+    LeTensor *half = le_tensor_new_cast(single, LE_TYPE_FLOAT16);
+    assert(le_tensor_equal(half, a));
+    le_tensor_free(half);
+    le_tensor_free(single);
+
+    /// Strided half precision view
+    LeTensor *a_t = le_tensor_transpose(a);
+    le_tensor_apply_sigmoid(a_t);
+    assert(le_f16_to_f32(((lehalf *)a->data)[1]) == 0.5f);
+    assert(fabsf(le_f16_to_f32(((lehalf *)a->data)[3]) - 1.0f / (1.0f + expf(-4.0f))) < 1e-3f);
+    le_tensor_free(a_t);
+    le_tensor_free(b);
+    le_tensor_free(a);
+
+    /// Half precision weights, single precision input and accumulation
+    unsigned height = 37, width = 300, examples = 19;
+    LeTensor *w = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, height, width));
+    LeTensor *x = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, width, examples));
+    for (unsigned i = 0; i < height * width; i++)
+        le_tensor_set_f32(w, i, (float)((int)(i * 7 % 13) - 6) * 0.125f);
+    for (unsigned i = 0; i < width * examples; i++)
+        le_tensor_set_f32(x, i, (float)((int)(i * 5 % 11) - 5) * 0.1f);
+    LeTensor *product = le_matrix_new_product(w, x);
+    le_tensor_convert(w, LE_TYPE_FLOAT16);
+    assert(w->element_type == LE_TYPE_FLOAT16);
+    LeTensor *half_product = le_matrix_new_product(w, x);
+    LeTensor *w_t = le_matrix_new_transpose(w);
+    LeTensor *half_product_t = le_matrix_new_product_full(w_t, true, x, false);
+    for (unsigned i = 0; i < height * examples; i++)
+    {
+        assert(fabsf(le_tensor_at_f32(half_product, i) - le_tensor_at_f32(product, i)) < 1e-4f);
+        assert(le_tensor_at_f32(half_product_t, i) == le_tensor_at_f32(half_product, i));
+    }
+    le_tensor_free(half_product_t);
+    le_tensor_free(w_t);
+    le_tensor_free(half_product);
+    le_tensor_free(product);
+    le_tensor_free(x);
+    le_tensor_free(w);
+
+    /// Model converted for inference predicts almost the same
+    LeSequential *nn = le_sequential_new();
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("FC1", 4, 8)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_TANH)));
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("FC2", 8, 3)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A2", LE_ACTIVATION_SOFTMAX)));
+    LeTensor *input = le_tensor_new(LE_TYPE_FLOAT32, 2, 4, 2,
+        0.1, -0.3,
+        0.7, 0.2,
+        -0.5, 0.9,
+        0.3, -0.8
+    );
+    LeTensor *prediction = le_sequential_predict(nn, input);
+    le_sequential_convert_parameters(nn, LE_TYPE_FLOAT16);
+    LeTensor *half_prediction = le_sequential_predict(nn, input);
+    assert(half_prediction->element_type == LE_TYPE_FLOAT32);
+    for (unsigned i = 0; i < 3 * 2; i++)
+        assert(fabsf(le_tensor_at_f32(half_prediction, i) - le_tensor_at_f32(prediction, i)) < 1e-2f);
+    le_tensor_free(half_prediction);
+    le_tensor_free(prediction);
+    le_tensor_free(input);
+    le_sequential_free(nn);
+
+    return EXIT_SUCCESS;
+}
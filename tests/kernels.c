@@ -0,0 +1,295 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <float.h>
+#include <le/le.h>
+#include <le/tensors/lekernels.h>
+
+/// @note: Odd length exercises both vector body and scalar tail of every variant
+#define LENGTH 67
+
+static const unsigned feature_sets[] = {
+    0,
+    LE_CPU_FEATURE_SSE4_2,
+    LE_CPU_FEATURE_SSE4_2 | LE_CPU_FEATURE_AVX2 | LE_CPU_FEATURE_F16C,
+    LE_CPU_FEATURE_SSE4_2 | LE_CPU_FEATURE_AVX2 | LE_CPU_FEATURE_F16C | LE_CPU_FEATURE_AVX512F
+};
+
+static void
+le_test_fill(float *a, float *b)
+{
+    for (unsigned i = 0; i < LENGTH; i++)
+    {
+        a[i] = (float)((int)(i * 37 % 23) - 11) * 0.25f;
+        b[i] = (float)((int)(i * 11 % 19) - 9) * 0.5f;
+    }
+}
+
+static void
+le_test_compare(const char *variant, const char *kernel, const float *expected, const float *actual)
+{
+    for (unsigned i = 0; i < LENGTH; i++)
+    {
+        if (expected[i] != actual[i])
+        {
+            fprintf(stderr, "%s %s mismatch at %u: %f != %f\n", variant, kernel, i, expected[i], actual[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void
+le_test_kernels(const LeKernels *reference, const LeKernels *kernels)
+{
+    float a[LENGTH], b[LENGTH], expected[LENGTH];
+
+/// @note: Runs same call with reference and tested kernels, k and x name kernels and output
+#define CHECK(kernel, call) \
+    { const LeKernels *k = reference; float *x = expected; le_test_fill(x, b); call; } \
+    { const LeKernels *k = kernels; float *x = a; le_test_fill(x, b); call; } \
+    le_test_compare(kernels->name, #kernel, expected, a);
+
+    CHECK(add_f32, k->add_f32(x, b, LENGTH))
+    CHECK(sub_f32, k->sub_f32(x, b, LENGTH))
+    CHECK(mul_f32, k->mul_f32(x, b, LENGTH))
+    CHECK(div_f32, k->div_f32(x, b, LENGTH))
+    CHECK(max_f32, k->max_f32(x, b, LENGTH))
+    CHECK(min_f32, k->min_f32(x, b, LENGTH))
+    CHECK(equal_f32, k->equal_f32(x, b, LENGTH))
+    CHECK(greater_f32, k->greater_f32(x, b, LENGTH))
+    CHECK(less_f32, k->less_f32(x, b, LENGTH))
+    CHECK(sub_scaled_f32, k->sub_scaled_f32(x, 0.125f, b, LENGTH))
+    CHECK(mul_add_f32, k->mul_add_f32(x, b, b, LENGTH))
+    CHECK(max_index_f32, { float index[LENGTH] = { 0 }; k->max_index_f32(x, index, b, 3.0f, LENGTH); })
+    /// Indices, x is reused as index array, filled same as values
+    CHECK(max_index_f32, { float values[LENGTH]; le_test_fill(values, b); k->max_index_f32(values, x, b, 3.0f, LENGTH); })
+    CHECK(add_scalar_f32, k->add_scalar_f32(x, 1.5f, LENGTH))
+    CHECK(mul_scalar_f32, k->mul_scalar_f32(x, -3.0f, LENGTH))
+    CHECK(sqr_f32, k->sqr_f32(x, LENGTH))
+    CHECK(one_minus_f32, k->one_minus_f32(x, LENGTH))
+    CHECK(x_minus_sqr_x_f32, k->x_minus_sqr_x_f32(x, LENGTH))
+    CHECK(gt_f32, k->gt_f32(x, 0.5f, LENGTH))
+    CHECK(sgn_f32, k->sgn_f32(x, LENGTH))
+    CHECK(relu_f32, k->relu_f32(x, LENGTH))
+
+#undef CHECK
+
+    le_test_fill(a, b);
+    assert(fabsf(reference->sum_f32(a, LENGTH) - kernels->sum_f32(a, LENGTH)) < 1e-4f);
+    assert(reference->reduce_max_f32(a, LENGTH) == kernels->reduce_max_f32(a, LENGTH));
+    assert(reference->reduce_min_f32(b, LENGTH) == kernels->reduce_min_f32(b, LENGTH));
+    assert(reference->reduce_max_f32(a, 3) == kernels->reduce_max_f32(a, 3));
+    assert(fabsf(reference->dot_f32(a, b, LENGTH) - kernels->dot_f32(a, b, LENGTH)) < 1e-4f);
+    assert(fabsf(reference->sad_f32(a, b, LENGTH) - kernels->sad_f32(a, b, LENGTH)) < 1e-4f);
+
+    /// Halfway points round to even, values out of range saturate
+    uint8_t expected_u8[LENGTH], actual_u8[LENGTH];
+    reference->quantize_u8(expected_u8, a, 50.0f, 128.0f, LENGTH);
+    kernels->quantize_u8(actual_u8, a, 50.0f, 128.0f, LENGTH);
+    assert(memcmp(expected_u8, actual_u8, LENGTH) == 0);
+    kernels->quantize_u8(actual_u8, a, 2.0f, 3.0f, LENGTH);
+    for (unsigned i = 0; i < LENGTH; i++)
+        assert(actual_u8[i] == (uint8_t)fmaxf(nearbyintf(a[i] * 2.0f) + 3.0f, 0.0f));
+
+    reference->u8_to_f32(expected, expected_u8, 0.25f, -1.0f, LENGTH);
+    kernels->u8_to_f32(a, expected_u8, 0.25f, -1.0f, LENGTH);
+    le_test_compare(kernels->name, "u8_to_f32", expected, a);
+}
+
+typedef double (*LeTestFunction)(double x);
+
+static double
+le_test_sigmoid(double x)
+{
+    return 1.0 / (1.0 + exp(-x));
+}
+
+static double
+le_test_sigmoid_prime(double x)
+{
+    double e = exp(-fabs(x));
+    return e / ((1.0 + e) * (1.0 + e));
+}
+
+/// @note: Compares kernel against double precision libm over [from, to], tolerance is
+/// relative error in units of FLT_EPSILON. Results below FLT_MIN are not checked.
+static void
+le_test_math(const LeKernels *kernels, const char *kernel, void (*function)(float *a, size_t n),
+             LeTestFunction reference, float from, float to, double tolerance)
+{
+    enum { COUNT = 20011 };
+    static float a[COUNT];
+    for (unsigned i = 0; i < COUNT; i++)
+        a[i] = from + (to - from) * ((float)i / (COUNT - 1));
+    function(a, COUNT);
+    double max_error = 0.0;
+    for (unsigned i = 0; i < COUNT; i++)
+    {
+        float x = from + (to - from) * ((float)i / (COUNT - 1));
+        double expected = reference(x);
+        if (fabs(expected) < FLT_MIN)
+            continue;
+        double error = fabs(a[i] - expected) / fabs(expected) / FLT_EPSILON;
+        if (error > max_error)
+            max_error = error;
+    }
+    if (max_error > tolerance)
+    {
+        fprintf(stderr, "%s %s error %f eps exceeds %f\n", kernels->name, kernel, max_error, tolerance);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void
+le_test_transcendental(const LeKernels *kernels, double tolerance)
+{
+    le_test_math(kernels, "exp_f32", kernels->exp_f32, exp, -87.0f, 88.0f, tolerance);
+    le_test_math(kernels, "exp_f32", kernels->exp_f32, exp, -1.0f, 1.0f, tolerance);
+    le_test_math(kernels, "log_f32", kernels->log_f32, log, 1e-30f, 1e30f, tolerance);
+    le_test_math(kernels, "log_f32", kernels->log_f32, log, 0.25f, 4.0f, tolerance);
+    le_test_math(kernels, "tanh_f32", kernels->tanh_f32, tanh, -10.0f, 10.0f, tolerance);
+    le_test_math(kernels, "tanh_f32", kernels->tanh_f32, tanh, -1.0f, 1.0f, tolerance);
+    le_test_math(kernels, "sigmoid_f32", kernels->sigmoid_f32, le_test_sigmoid, -80.0f, 80.0f, tolerance);
+    le_test_math(kernels, "sigmoid_prime_f32", kernels->sigmoid_prime_f32, le_test_sigmoid_prime, -40.0f, 40.0f, tolerance);
+
+    float special[] = { 0.0f, -1.0f, INFINITY, -INFINITY, NAN, 1e-40f };
+    kernels->log_f32(special, 6);
+    assert(special[0] == -INFINITY);
+    assert(isnan(special[1]));
+    assert(special[2] == INFINITY);
+    assert(isnan(special[3]));
+    assert(isnan(special[4]));
+    assert(fabs(special[5] - log(1e-40)) < 1e-3);
+    float exp_special[] = { INFINITY, -INFINITY, NAN, 100.0f, -100.0f, 0.0f };
+    kernels->exp_f32(exp_special, 6);
+    assert(exp_special[0] == INFINITY);
+    assert(exp_special[1] == 0.0f);
+    assert(isnan(exp_special[2]));
+    assert(exp_special[3] == INFINITY);
+    assert(exp_special[4] < 1e-43f);
+    assert(exp_special[5] == 1.0f);
+    float saturated[] = { 100.0f, -100.0f, NAN };
+    kernels->tanh_f32(saturated, 3);
+    assert(saturated[0] == 1.0f && saturated[1] == -1.0f && isnan(saturated[2]));
+}
+
+/// @note: Softmax of strided matrix and cross-entropy loss against double precision loops
+static void
+le_test_softmax(void)
+{
+    unsigned num_classes = 10, num_examples = 300;
+    LeTensor *transposed = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, num_examples, num_classes));
+    LeTensor *y = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(2, num_classes, num_examples));
+    for (unsigned i = 0; i < num_examples * num_classes; i++)
+        le_tensor_set_f32(transposed, i, (float)((int)(i * 37 % 41) - 20) * 0.5f);
+    for (unsigned x = 0; x < num_examples; x++)
+        le_matrix_set(y, x % num_classes, x, 1.0f);
+    LeTensor *h = le_tensor_transpose(transposed);
+    le_matrix_apply_softmax(h);
+    double expected_loss = 0.0;
+    for (unsigned x = 0; x < num_examples; x++)
+    {
+        double max = -INFINITY, sum = 0.0;
+        for (unsigned klass = 0; klass < num_classes; klass++)
+        {
+            double value = (double)((int)((x * num_classes + klass) * 37 % 41) - 20) * 0.5;
+            max = value > max ? value : max;
+        }
+        for (unsigned klass = 0; klass < num_classes; klass++)
+            sum += exp((double)((int)((x * num_classes + klass) * 37 % 41) - 20) * 0.5 - max);
+        for (unsigned klass = 0; klass < num_classes; klass++)
+        {
+            double expected = exp((double)((int)((x * num_classes + klass) * 37 % 41) - 20) * 0.5 - max) / sum;
+            assert(fabs(le_matrix_at_f32(h, klass, x) - expected) <= 1e-4 * expected + 1e-30);
+            if (klass == x % num_classes)
+                expected_loss -= log(expected > 1e-5 ? expected : 1e-5);
+        }
+    }
+    assert(fabs(le_cross_entropy_loss(h, y) - expected_loss / num_examples) < 1e-4 * expected_loss / num_examples);
+    le_tensor_free(h);
+    le_tensor_free(y);
+    le_tensor_free(transposed);
+}
+
+/// @note: Softmax gradient of strided output gradient against product of explicit Jacobians.
+/// Backward pass of softmax activation layer gives same gradient, with and without cached output.
+static void
+le_test_softmax_gradient(void)
+{
+    unsigned num_classes = 37, num_examples = 300;
+    LeTensor *s = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, num_classes, num_examples));
+    LeTensor *transposed = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, num_examples, num_classes));
+    for (unsigned i = 0; i < num_examples * num_classes; i++)
+    {
+        le_tensor_set_f32(s, i, (float)((int)(i * 37 % 41) - 20) * 0.25f);
+        le_tensor_set_f32(transposed, i, (float)((int)(i * 11 % 19) - 9) * 0.5f);
+    }
+    le_matrix_apply_softmax(s);
+    LeTensor *g = le_tensor_transpose(transposed);
+    LeTensor *input_gradient = le_matrix_new_softmax_gradient(s, g);
+    for (unsigned x = 0; x < num_examples; x++)
+    {
+        for (unsigned i = 0; i < num_classes; i++)
+        {
+            double si = le_matrix_at_f32(s, i, x);
+            double expected = 0.0;
+            for (unsigned j = 0; j < num_classes; j++)
+            {
+                double sj = le_matrix_at_f32(s, j, x);
+                expected += ((i == j) ? si * (1.0 - si) : -si * sj) * le_matrix_at_f32(g, j, x);
+            }
+            assert(fabs(le_matrix_at_f32(input_gradient, i, x) - expected) < 1e-5);
+        }
+    }
+
+    LeLayer *softmax = LE_LAYER(le_activation_layer_new("S", LE_ACTIVATION_SOFTMAX));
+    LeTensor *input = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, num_classes, num_examples));
+    for (unsigned i = 0; i < num_examples * num_classes; i++)
+        le_tensor_set_f32(input, i, (float)((int)(i * 37 % 41) - 20) * 0.25f);
+    LeTensor *cached_output_gradient = le_layer_backward_prop(softmax, input, s, g, NULL);
+    LeTensor *computed_output_gradient = le_layer_backward_prop(softmax, input, NULL, g, NULL);
+    for (unsigned i = 0; i < num_examples * num_classes; i++)
+    {
+        assert(fabsf(le_tensor_at_f32(cached_output_gradient, i) - le_tensor_at_f32(input_gradient, i)) < 1e-6f);
+        assert(fabsf(le_tensor_at_f32(computed_output_gradient, i) - le_tensor_at_f32(input_gradient, i)) < 1e-6f);
+    }
+    le_tensor_free(computed_output_gradient);
+    le_tensor_free(cached_output_gradient);
+    le_tensor_free(input);
+    le_tensor_free(input_gradient);
+    le_tensor_free(g);
+    le_tensor_free(transposed);
+    le_tensor_free(s);
+}
+
+int
+main()
+{
+    unsigned host_features = le_cpu_get_features();
+    const LeKernels *reference = le_kernels_get_for_features(0, LE_MATH_ACCURACY_FAITHFUL);
+
+    for (unsigned i = 0; i < sizeof(feature_sets) / sizeof(feature_sets[0]); i++)
+    {
+        if ((feature_sets[i] & host_features) != feature_sets[i])
+            continue;
+
+        le_test_kernels(reference, le_kernels_get_for_features(feature_sets[i], LE_MATH_ACCURACY_FAITHFUL));
+        le_test_transcendental(le_kernels_get_for_features(feature_sets[i], LE_MATH_ACCURACY_FAITHFUL), 4.0);
+        le_test_transcendental(le_kernels_get_for_features(feature_sets[i], LE_MATH_ACCURACY_FAST), 2e-4 / FLT_EPSILON);
+    }
+
+    assert(le_kernels_get() == le_kernels_get_for_features(host_features, LE_MATH_ACCURACY_FAITHFUL));
+    le_test_softmax();
+    le_test_softmax_gradient();
+    le_set_math_accuracy(LE_MATH_ACCURACY_FAST);
+    assert(le_kernels_get() == le_kernels_get_for_features(host_features, LE_MATH_ACCURACY_FAST));
+    le_test_softmax();
+    le_set_math_accuracy(LE_MATH_ACCURACY_FAITHFUL);
+
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include <assert.h>
+#include <math.h>
 #include <le/le.h>
 
 int
@@ -31,6 +32,46 @@ le_test_ensure_matrix_size(LeTensor *a, unsigned height, unsigned width)
 
 #define MAX_DIMENSION 4
 
+/// @note: Sizes chosen to cover partial micro-tiles and several blocks along inner dimension
+static const unsigned gemm_sizes[][3] = {
+    { 1, 1, 1 },
+    { 7, 5, 3 },
+    { 37, 53, 300 },
+    { 150, 33, 17 }
+};
+
+static float
+le_test_product_max_error(unsigned m, unsigned n, unsigned k, bool transpose_a, bool transpose_b)
+{
+    LeTensor *a = transpose_a ? le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, k, m) :
+                                le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, m, k);
+    LeTensor *b = transpose_b ? le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, n, k) :
+                                le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, k, n);
+    LeTensor *c = le_matrix_new_product_full(a, transpose_a, b, transpose_b);
+    assert(le_test_ensure_matrix_size(c, m, n));
+    float max_error = 0.0f;
+    for (unsigned y = 0; y < m; y++)
+    {
+        for (unsigned x = 0; x < n; x++)
+        {
+            float expected = 0.0f;
+            for (unsigned i = 0; i < k; i++)
+            {
+                float a_element = transpose_a ? le_matrix_at_f32(a, i, y) : le_matrix_at_f32(a, y, i);
+                float b_element = transpose_b ? le_matrix_at_f32(b, x, i) : le_matrix_at_f32(b, i, x);
+                expected += a_element * b_element;
+            }
+            float error = fabsf(le_matrix_at_f32(c, y, x) - expected) / k;
+            if (error > max_error)
+                max_error = error;
+        }
+    }
+    le_tensor_free(c);
+    le_tensor_free(b);
+    le_tensor_free(a);
+    return max_error;
+}
+
 int
 main()
 {
@@ -148,9 +189,39 @@ main()
     d = le_matrix_new_product_full(a, false, b, true);
     printf ("sad afbt %f\n", le_tensor_sad_f32(c, d));
     assert(le_tensor_sad_f32(c, d) < 1e-3f);
+    /// Destination-passing variants write same results into existing matrices
+    le_tensor_mul(d, 0.0f);
+    le_matrix_product_full_into(d, a, false, b, true);
+    assert(le_tensor_sad_f32(c, d) < 1e-3f);
+    at = le_matrix_new_transpose(a);
+    le_matrix_transpose_into(at, a);
+    le_matrix_transpose_into(bt, b);
+    le_matrix_product_into(d, a, bt);
+    assert(le_tensor_sad_f32(c, d) < 1e-3f);
+    LeTensor *sum = le_matrix_new_sum(a, 1);
+    LeTensor *sum_into = le_matrix_new_zeros(LE_TYPE_FLOAT32, 10, 1);
+    le_matrix_sum_into(sum_into, a, 1);
+    assert(le_tensor_equal(sum, sum_into));
+    le_tensor_free(sum_into);
+    le_tensor_free(sum);
+    le_tensor_free(at);
+    le_tensor_free(d);
+    le_tensor_free(c);
     le_tensor_free(bt);
     le_tensor_free(b);
     le_tensor_free(a);
+
+    for (unsigned i = 0; i < sizeof(gemm_sizes) / sizeof(gemm_sizes[0]); i++)
+    {
+        for (unsigned transpose = 0; transpose < 4; transpose++)
+        {
+            float error = le_test_product_max_error(gemm_sizes[i][0], gemm_sizes[i][1], gemm_sizes[i][2],
+                                              transpose & 1, transpose & 2);
+            printf("%ux%ux%u transpose %u error %g\n",
+                   gemm_sizes[i][0], gemm_sizes[i][1], gemm_sizes[i][2], transpose, error);
+            assert(error < 1e-5f);
+        }
+    }
     
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,123 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+/// @note: Covers small, power of two spaced, huge page and uncached blocks
+static const size_t sizes[] = { 0, 1, 63, 64, 65, 1000, 1025, 4096, 100000, 3 << 20, (256 << 20) + 1 };
+
+#define SIZES_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+int
+main()
+{
+    LeMemStats initial = le_mem_get_stats();
+    void *blocks[SIZES_COUNT];
+
+    for (unsigned i = 0; i < SIZES_COUNT; i++)
+    {
+        blocks[i] = le_alloc(sizes[i]);
+        assert(blocks[i]);
+        assert((uintptr_t)blocks[i] % LE_MEM_ALIGNMENT == 0);
+        if (sizes[i] > 0)
+        {
+            memset(blocks[i], 0xAB, sizes[i]);
+            assert(((uint8_t *)blocks[i])[sizes[i] - 1] == 0xAB);
+        }
+    }
+
+    LeMemStats stats = le_mem_get_stats();
+    assert(stats.bytes_in_use > initial.bytes_in_use);
+    assert(stats.peak_bytes_in_use >= stats.bytes_in_use);
+
+    for (unsigned i = 0; i < SIZES_COUNT; i++)
+        le_free(blocks[i]);
+
+    stats = le_mem_get_stats();
+    assert(stats.bytes_in_use == initial.bytes_in_use);
+
+    /// Freed blocks are reused
+    for (unsigned i = 0; i < SIZES_COUNT - 1; i++)
+    {
+        void *block = le_alloc(sizes[i]);
+        le_free(block);
+    }
+    LeMemStats reused = le_mem_get_stats();
+    assert(reused.cache_hits >= stats.cache_hits + SIZES_COUNT - 1);
+    assert(reused.cache_hit_rate > 0.0f);
+
+    /// Tensors are allocated from pool too
+    LeTensor *tensor = le_matrix_new_zeros(LE_TYPE_FLOAT32, 3, 5);
+    assert((uintptr_t)le_tensor_get_data(tensor) % LE_MEM_ALIGNMENT == 0);
+    assert(le_mem_get_stats().bytes_in_use > reused.bytes_in_use);
+    le_tensor_free(tensor);
+    assert(le_mem_get_stats().bytes_in_use == reused.bytes_in_use);
+
+    /// Scratch blocks do not touch pool. After first scope arena is merged into single chunk
+    /// and next scopes get same memory.
+    void *second_scope_block = NULL;
+    for (unsigned scope = 0; scope < 3; scope++)
+    {
+        LeMemStats before = le_mem_get_stats();
+
+        le_arena_push();
+        void *block = le_arena_alloc(100);
+        assert((uintptr_t)block % LE_MEM_ALIGNMENT == 0);
+        assert(le_mem_is_scratch(block));
+        if (scope == 1)
+            second_scope_block = block;
+        else if (scope == 2)
+            assert(block == second_scope_block);
+
+        le_arena_push();
+        void *large = le_arena_alloc(3 << 20);
+        memset(large, 0, 3 << 20);
+        le_arena_pop();
+
+        /// Most recent block is given back
+        void *other = le_arena_alloc(10);
+        le_free(other);
+        assert(le_arena_alloc(10) == other);
+        le_free(block);
+        le_arena_pop();
+
+        LeMemStats after = le_mem_get_stats();
+        assert(after.cache_hits == before.cache_hits);
+        assert(after.cache_misses == before.cache_misses);
+        assert(after.bytes_in_use == before.bytes_in_use);
+    }
+
+    /// le_alloc inside scope is not scratch, block survives scope and following scratch blocks
+    le_arena_push();
+    char *persistent = le_alloc(256);
+    memset(persistent, 0x5A, 256);
+    assert(!le_mem_is_scratch(persistent));
+    LeTensor *scratch = le_tensor_new_scratch(LE_TYPE_FLOAT32, le_shape_new(1, 64));
+    assert(le_mem_is_scratch(scratch->data));
+    /// Copy of scratch tensor does not share its elements
+    LeTensor *copy = le_tensor_new_copy(scratch);
+    assert(!le_mem_is_scratch(copy->data));
+    le_tensor_free(scratch);
+    le_arena_pop();
+    le_arena_push();
+    memset(le_arena_alloc(256), 0, 256);
+    le_arena_pop();
+    for (unsigned i = 0; i < 256; i++)
+        assert(persistent[i] == 0x5A);
+    le_tensor_free(copy);
+    le_free(persistent);
+
+    /// Outside of scopes scratch blocks come from pool
+    void *unscoped = le_arena_alloc(100);
+    assert(!le_mem_is_scratch(unscoped));
+    le_free(unscoped);
+
+    le_mem_trim();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include "test-config.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define MMAP_FILENAME TEST_DIR "/test.mmap"
+
+/// @note: Elements follow header of 16 bytes, like in IDX files
+#define HEADER_SIZE 16
+#define HEIGHT 300
+#define WIDTH 40
+
+static float
+le_test_value(unsigned i)
+{
+    return (float)i * 0.5f - 100.0f;
+}
+
+static void
+le_test_check_file(void)
+{
+    LeTensor *mapped = le_tensor_new_mmap(MMAP_FILENAME, HEADER_SIZE, LE_TYPE_FLOAT32,
+                                          le_shape_new(2, HEIGHT, WIDTH), LE_MMAP_SEQUENTIAL);
+    assert(mapped);
+    for (unsigned i = 0; i < HEIGHT * WIDTH; i++)
+        assert(le_tensor_at_f32(mapped, i) == le_test_value(i));
+    le_tensor_free(mapped);
+}
+
+int
+main()
+{
+    FILE *file = fopen(MMAP_FILENAME, "wb");
+    assert(file);
+    uint8_t header[HEADER_SIZE] = { 0 };
+    fwrite(header, 1, HEADER_SIZE, file);
+    for (unsigned i = 0; i < HEIGHT * WIDTH; i++)
+    {
+        float value = le_test_value(i);
+        fwrite(&value, sizeof(float), 1, file);
+    }
+    fclose(file);
+
+    /// Elements are read from file in place
+    LeTensor *mapped = le_tensor_new_mmap(MMAP_FILENAME, HEADER_SIZE, LE_TYPE_FLOAT32,
+                                          le_shape_new(2, HEIGHT, WIDTH), LE_MMAP_RANDOM | LE_MMAP_WILL_NEED);
+    assert(mapped);
+    assert(mapped->owns_data);
+    assert(le_matrix_at_f32(mapped, 7, 3) == le_test_value(7 * WIDTH + 3));
+
+    /// Views and copies of read-only mapping read file
+    LeTensor *rows = le_tensor_slice(mapped, 0, 10, 20);
+    assert(le_matrix_at_f32(rows, 0, 0) == le_test_value(10 * WIDTH));
+    le_tensor_free(rows);
+    assert(mapped->mapping == LE_TENSOR_MAPPING_READ_ONLY);
+    LeTensor *copy = le_tensor_new_copy(mapped);
+    assert(le_tensor_equal(copy, mapped));
+    assert(le_tensor_reduce_f32(mapped, LE_REDUCE_OP_MAX) == le_test_value(HEIGHT * WIDTH - 1));
+
+    /// Writing read-only mapping copies elements into memory, file stays same
+    le_tensor_mul_f32(mapped, 2.0f);
+    assert(mapped->mapping == LE_TENSOR_MAPPING_NONE);
+    assert(le_matrix_at_f32(mapped, 7, 3) == 2.0f * le_test_value(7 * WIDTH + 3));
+    le_tensor_free(mapped);
+    le_test_check_file();
+
+    /// Expression storing into read-only mapping it reads copies elements before evaluation
+    mapped = le_tensor_new_mmap(MMAP_FILENAME, HEADER_SIZE, LE_TYPE_FLOAT32,
+                                le_shape_new(2, HEIGHT, WIDTH), LE_MMAP_READ_ONLY);
+    assert(mapped);
+    LeExpr *expr = le_expr_new(mapped);
+    le_expr_add_scalar(expr, 1.0f);
+    le_expr_store(expr, mapped);
+    le_expr_evaluate(expr);
+    le_expr_free(expr);
+    assert(mapped->mapping == LE_TENSOR_MAPPING_NONE);
+    for (unsigned i = 0; i < HEIGHT * WIDTH; i++)
+        assert(le_tensor_at_f32(mapped, i) == le_test_value(i) + 1.0f);
+    le_tensor_free(mapped);
+    le_test_check_file();
+
+    /// Written pages of copy-on-write mapping are private
+    mapped = le_tensor_new_mmap(MMAP_FILENAME, HEADER_SIZE, LE_TYPE_FLOAT32,
+                                le_shape_new(2, HEIGHT, WIDTH), LE_MMAP_COPY_ON_WRITE);
+    assert(mapped);
+    le_tensor_add_f32(mapped, 1.0f);
+    assert(mapped->mapping == LE_TENSOR_MAPPING_COPY_ON_WRITE);
+    for (unsigned i = 0; i < HEIGHT * WIDTH; i++)
+        assert(le_tensor_at_f32(mapped, i) == le_test_value(i) + 1.0f);
+    le_tensor_convert(mapped, LE_TYPE_FLOAT16);
+    assert(mapped->mapping == LE_TENSOR_MAPPING_NONE);
+    le_tensor_free(mapped);
+    le_test_check_file();
+
+    /// Elements past end of file or missing file are not mapped
+    assert(le_tensor_new_mmap(MMAP_FILENAME, HEADER_SIZE + sizeof(float), LE_TYPE_FLOAT32,
+                              le_shape_new(2, HEIGHT, WIDTH), LE_MMAP_READ_ONLY) == NULL);
+    assert(le_tensor_new_mmap(TEST_DIR "/missing.mmap", 0, LE_TYPE_UINT8,
+                              le_shape_new(1, 1), LE_MMAP_READ_ONLY) == NULL);
+
+    le_tensor_free(copy);
+    remove(MMAP_FILENAME);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+
+#define COUNT 100003
+#define SIZE 200
+
+static void
+le_test_mark(void *data, size_t begin, size_t end)
+{
+    unsigned char *visited = data;
+    for (size_t i = begin; i < end; i++)
+        visited[i]++;
+}
+
+static float
+le_test_count(void *data, size_t begin, size_t end)
+{
+    (void)data;
+    return (float)(end - begin);
+}
+
+static void
+le_test_nested(void *data, size_t begin, size_t end)
+{
+    unsigned char *visited = data;
+    for (size_t i = begin; i < end; i++)
+        le_parallel_for(1, 1, le_test_mark, visited + i);
+}
+
+static void
+le_test_ranges(void)
+{
+    unsigned char *visited = calloc(COUNT, 1);
+
+    le_parallel_for(COUNT, 1, le_test_mark, visited);
+    le_parallel_for(COUNT, 1000, le_test_nested, visited);
+    for (unsigned i = 0; i < COUNT; i++)
+        assert(visited[i] == 2);
+
+    assert(le_parallel_sum_f32(COUNT, 1, le_test_count, NULL) == (float)COUNT);
+    free(visited);
+}
+
+static LeTensor *
+le_test_product(const LeTensor *a, const LeTensor *b, unsigned num_threads)
+{
+    le_set_num_threads(num_threads);
+    assert(le_get_num_threads() == num_threads);
+    return le_matrix_new_product_full(a, false, b, true);
+}
+
+int
+main()
+{
+    le_set_num_threads(4);
+    le_test_ranges();
+
+    LeTensor *a = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, SIZE, SIZE + 1);
+    LeTensor *b = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, SIZE + 2, SIZE + 1);
+    LeTensor *serial = le_test_product(a, b, 1);
+    LeTensor *parallel = le_test_product(a, b, 3);
+    assert(le_tensor_equal(serial, parallel));
+    le_tensor_free(parallel);
+    le_tensor_free(serial);
+
+    LeTensor *at = le_matrix_new_transpose(a);
+    for (unsigned y = 0; y < SIZE; y++)
+        for (unsigned x = 0; x < SIZE + 1; x++)
+            assert(le_matrix_at_f32(a, y, x) == le_matrix_at_f32(at, x, y));
+    le_tensor_free(at);
+
+    LeTensor *large = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, SIZE, COUNT / SIZE);
+    le_set_num_threads(1);
+    float serial_sum = le_tensor_sum_f32(large);
+    le_set_num_threads(5);
+    assert(fabsf(le_tensor_sum_f32(large) - serial_sum) < 1e-3f * serial_sum);
+    le_tensor_free(large);
+
+    le_tensor_free(b);
+    le_tensor_free(a);
+
+    return EXIT_SUCCESS;
+}
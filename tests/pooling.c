@@ -0,0 +1,195 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+#define BATCH 3
+#define HEIGHT 9
+#define WIDTH 8
+/// @note: Odd number of channels exercises both vector body and scalar tail of kernels
+#define CHANNELS 19
+
+typedef struct LeTestWindow
+{
+    unsigned window_size;
+    unsigned stride;
+    unsigned padding;
+} LeTestWindow;
+
+/// @note: Offset of input element under tap of window of output, -1 for padding
+static int
+le_test_pixel(const LeTestWindow *window, unsigned n, unsigned oy, unsigned ox, unsigned ky, unsigned kx, unsigned c)
+{
+    int iy = (int)(oy * window->stride + ky) - (int)window->padding;
+    int ix = (int)(ox * window->stride + kx) - (int)window->padding;
+    if ((iy < 0) || (iy >= HEIGHT) || (ix < 0) || (ix >= WIDTH))
+        return -1;
+    return ((n * HEIGHT + iy) * WIDTH + ix) * CHANNELS + c;
+}
+
+/// @note: Reference pooling, output gradient of each output element goes to input gradient
+static void
+le_test_pool(const LeTestWindow *window, bool max, const LeTensor *input, const LeTensor *output_gradient,
+             LeTensor *output, LeTensor *input_gradient)
+{
+    unsigned output_h = output->shape->sizes[1];
+    unsigned output_w = output->shape->sizes[2];
+    size_t index = 0;
+    for (unsigned n = 0; n < BATCH; n++)
+        for (unsigned oy = 0; oy < output_h; oy++)
+            for (unsigned ox = 0; ox < output_w; ox++)
+                for (unsigned c = 0; c < CHANNELS; c++, index++)
+                {
+                    int argmax = -1;
+                    unsigned count = 0;
+                    float sum = 0.0f;
+                    for (unsigned ky = 0; ky < window->window_size; ky++)
+                        for (unsigned kx = 0; kx < window->window_size; kx++)
+                        {
+                            int pixel = le_test_pixel(window, n, oy, ox, ky, kx, c);
+                            if (pixel < 0)
+                                continue;
+                            float x = le_tensor_at_f32(input, pixel);
+                            if ((argmax < 0) || (le_tensor_at_f32(input, argmax) < x))
+                                argmax = pixel;
+                            sum += x;
+                            count++;
+                        }
+                    float dy = le_tensor_at_f32(output_gradient, index);
+                    if (max)
+                    {
+                        le_tensor_set_f32(output, index, le_tensor_at_f32(input, argmax));
+                        le_tensor_set_f32(input_gradient, argmax, le_tensor_at_f32(input_gradient, argmax) + dy);
+                        continue;
+                    }
+                    le_tensor_set_f32(output, index, sum / count);
+                    for (unsigned ky = 0; ky < window->window_size; ky++)
+                        for (unsigned kx = 0; kx < window->window_size; kx++)
+                        {
+                            int pixel = le_test_pixel(window, n, oy, ox, ky, kx, c);
+                            if (pixel >= 0)
+                                le_tensor_set_f32(input_gradient, pixel, le_tensor_at_f32(input_gradient, pixel) + dy / count);
+                        }
+                }
+}
+
+static void
+le_test_equal(const LeTensor *expected, const LeTensor *actual)
+{
+    assert(le_shape_equal(expected->shape, actual->shape));
+    for (size_t i = 0; i < le_shape_get_elements_count(expected->shape); i++)
+        assert(fabsf(le_tensor_at_f32(expected, i) - le_tensor_at_f32(actual, i)) < 1e-5f);
+}
+
+static void
+le_test_layer(const LeTestWindow *window, bool max)
+{
+    LeLayer *layer = max ?
+        LE_LAYER(le_maxpool_layer_new("P", window->window_size, window->stride, window->padding)) :
+        LE_LAYER(le_avgpool_layer_new("P", window->window_size, window->stride, window->padding));
+    LeTensor *input = le_tensor_new_rand_f32(le_shape_new(4, BATCH, HEIGHT, WIDTH, CHANNELS));
+    LeTensor *other_input = le_tensor_new_rand_f32(le_shape_new(4, BATCH, HEIGHT, WIDTH, CHANNELS));
+
+    unsigned output_h = (HEIGHT + 2 * window->padding - window->window_size) / window->stride + 1;
+    unsigned output_w = (WIDTH + 2 * window->padding - window->window_size) / window->stride + 1;
+    LeTensor *output_gradient = le_tensor_new_rand_f32(le_shape_new(4, BATCH, output_h, output_w, CHANNELS));
+    LeTensor *expected_output = le_tensor_new_zeros_like(output_gradient);
+    LeTensor *expected_gradient = le_tensor_new_zeros_like(input);
+    le_test_pool(window, max, input, output_gradient, expected_output, expected_gradient);
+
+    /// Forward pass matches reference, with and without preallocated output
+    LeTensor *output = le_layer_forward_prop(layer, input);
+    le_test_equal(expected_output, output);
+    LeTensor *output_into = le_tensor_new_zeros_like(output);
+    le_layer_forward_prop_into(layer, output_into, input);
+    le_test_equal(expected_output, output_into);
+
+    /// Backward pass right after forward pass uses cached argmax
+    LeTensor *input_gradient = le_layer_backward_prop(layer, input, output, output_gradient, NULL);
+    le_test_equal(expected_gradient, input_gradient);
+    le_tensor_free(input_gradient);
+
+    /// Without cached output windows are rescanned
+    input_gradient = le_layer_backward_prop(layer, input, NULL, output_gradient, NULL);
+    le_test_equal(expected_gradient, input_gradient);
+    le_tensor_free(input_gradient);
+
+    /// Argmax cached for another input is not used
+    le_tensor_free(le_layer_forward_prop(layer, other_input));
+    input_gradient = le_layer_backward_prop(layer, input, output, output_gradient, NULL);
+    le_test_equal(expected_gradient, input_gradient);
+    le_tensor_free(input_gradient);
+
+    le_tensor_free(output_into);
+    le_tensor_free(output);
+    le_tensor_free(expected_gradient);
+    le_tensor_free(expected_output);
+    le_tensor_free(output_gradient);
+    le_tensor_free(other_input);
+    le_tensor_free(input);
+}
+
+/// @note: Each step runs in own scratch scope, scratch blocks of second step take memory
+/// of first one, so output and argmax cached by layer must not be scratch
+static void
+le_test_scopes(const LeTestWindow *window)
+{
+    LeLayer *layer = LE_LAYER(le_maxpool_layer_new("P", window->window_size, window->stride, window->padding));
+    LeTensor *input = le_tensor_new_rand_f32(le_shape_new(4, BATCH, HEIGHT, WIDTH, CHANNELS));
+    unsigned output_h = (HEIGHT + 2 * window->padding - window->window_size) / window->stride + 1;
+    unsigned output_w = (WIDTH + 2 * window->padding - window->window_size) / window->stride + 1;
+    LeTensor *output_gradient = le_tensor_new_rand_f32(le_shape_new(4, BATCH, output_h, output_w, CHANNELS));
+    LeTensor *expected_output = le_tensor_new_zeros_like(output_gradient);
+    LeTensor *expected_gradient = le_tensor_new_zeros_like(input);
+    le_test_pool(window, true, input, output_gradient, expected_output, expected_gradient);
+
+    for (unsigned step = 0; step < 2; step++)
+    {
+        le_arena_push();
+        LeTensor *output = le_layer_forward_prop(layer, input);
+        /// Scratch temporaries of step written between forward and backward pass
+        size_t scratch_size = le_shape_get_elements_count(output->shape) * sizeof(float);
+        memset(le_arena_alloc(scratch_size), 0xFF, scratch_size);
+        le_test_equal(expected_output, output);
+        assert(!le_mem_is_scratch(output->data));
+        assert(!le_mem_is_scratch(LE_MAXPOOL_LAYER(layer)->argmax->data));
+        LeTensor *input_gradient = le_layer_backward_prop(layer, input, output, output_gradient, NULL);
+        le_test_equal(expected_gradient, input_gradient);
+        le_tensor_free(input_gradient);
+        le_tensor_free(output);
+        le_arena_pop();
+    }
+
+    le_tensor_free(expected_gradient);
+    le_tensor_free(expected_output);
+    le_tensor_free(output_gradient);
+    le_tensor_free(input);
+}
+
+static const LeTestWindow windows[] = {
+    { 2, 2, 0 },
+    { 3, 2, 1 },
+    { 3, 1, 1 },
+    { 3, 3, 2 }
+};
+
+int
+main()
+{
+    for (unsigned i = 0; i < sizeof(windows) / sizeof(windows[0]); i++)
+    {
+        le_test_layer(&windows[i], true);
+        le_test_layer(&windows[i], false);
+    }
+    le_test_scopes(&windows[1]);
+    le_set_num_threads(4);
+    le_test_layer(&windows[1], true);
+    le_test_layer(&windows[1], false);
+
+    return EXIT_SUCCESS;
+}
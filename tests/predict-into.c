@@ -0,0 +1,59 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+
+#define INPUTS 6
+#define HIDDEN 9
+#define CLASSES 4
+#define EXAMPLES 17
+
+int
+main()
+{
+    LeSequential *nn = le_sequential_new();
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("FC1", INPUTS, HIDDEN)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_TANH)));
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("FC2", HIDDEN, CLASSES)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A2", LE_ACTIVATION_SOFTMAX)));
+
+    LeTensor *x = le_matrix_new_rand_f32(LE_DISTRIBUTION_UNIFORM, INPUTS, EXAMPLES);
+    LeTensor *expected = le_model_predict(LE_MODEL(nn), x);
+    LeTensor *prediction = le_matrix_new_zeros(LE_TYPE_FLOAT32, CLASSES, EXAMPLES);
+
+    /// First call allocates buffers of intermediate layers
+    le_model_predict_into(LE_MODEL(nn), prediction, x);
+    assert(le_tensor_sad_f32(prediction, expected) < 1e-5f);
+
+    /// Steady state does not request memory from system, only GEMM packing buffers
+    /// are taken from allocator cache
+    LeMemStats before = le_mem_get_stats();
+    for (unsigned i = 0; i < 10; i++)
+    {
+        le_tensor_mul(prediction, 0.0f);
+        le_model_predict_into(LE_MODEL(nn), prediction, x);
+        assert(le_tensor_sad_f32(prediction, expected) < 1e-5f);
+    }
+    LeMemStats after = le_mem_get_stats();
+    assert(after.cache_misses == before.cache_misses);
+    assert(after.bytes_in_use == before.bytes_in_use);
+
+    /// Other input shape replaces buffers
+    LeTensor *column = le_matrix_get_column_copy(x, 3);
+    LeTensor *column_prediction = le_matrix_new_zeros(LE_TYPE_FLOAT32, CLASSES, 1);
+    le_model_predict_into(LE_MODEL(nn), column_prediction, column);
+    for (unsigned y = 0; y < CLASSES; y++)
+        assert(fabsf(le_matrix_at_f32(column_prediction, y, 0) - le_matrix_at_f32(expected, y, 3)) < 1e-5f);
+
+    le_tensor_free(column_prediction);
+    le_tensor_free(column);
+    le_tensor_free(prediction);
+    le_tensor_free(expected);
+    le_tensor_free(x);
+    le_sequential_free(nn);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/legemm.h>
+#include <le/tensors/letensor-imp.h>
+
+static const unsigned feature_sets[] = {
+    0,
+    LE_CPU_FEATURE_AVX2,
+    LE_CPU_FEATURE_AVX2 | LE_CPU_FEATURE_AVX512F | LE_CPU_FEATURE_AVX512VNNI
+};
+
+/// @note: Integer GEMM of every implementation supported by host matches straightforward loops
+static void
+le_test_gemm_u8s8(void)
+{
+    /// Sizes leave tails in every dimension of every micro-kernel
+    enum { M = 37, N = 19, K = 300 };
+    static int8_t a[M * K];
+    static uint8_t b[N * K];
+    int32_t a_zero_points[M], a_row_sums[M], b_column_sums[N];
+    float scales[M], bias[M];
+    for (unsigned i = 0; i < M * K; i++)
+        a[i] = (int8_t)((int)(i * 37 % 256) - 128);
+    for (unsigned i = 0; i < N * K; i++)
+        b[i] = (uint8_t)(i * 101 % 256);
+    for (unsigned i = 0; i < M; i++)
+    {
+        a_zero_points[i] = (int32_t)(i * 11 % 21) - 10;
+        scales[i] = 1e-5f * (float)(i + 1);
+        bias[i] = (float)((int)i - 18) * 0.5f;
+        a_row_sums[i] = 0;
+        for (unsigned p = 0; p < K; p++)
+            a_row_sums[i] += a[i * K + p];
+    }
+    for (unsigned j = 0; j < N; j++)
+    {
+        b_column_sums[j] = 0;
+        for (unsigned p = 0; p < K; p++)
+            b_column_sums[j] += b[j * K + p];
+    }
+    LeGemmQuantizedEpilogue epilogue = {
+        .scales = scales,
+        .a_zero_points = a_zero_points,
+        .a_row_sums = a_row_sums,
+        .b_zero_point = 77,
+        .b_column_sums = b_column_sums,
+        .bias = bias,
+        .relu = true
+    };
+
+    float expected[M * N], c[M * N], first[M * N];
+    for (unsigned i = 0; i < M; i++)
+    {
+        for (unsigned j = 0; j < N; j++)
+        {
+            int64_t sum = 0;
+            for (unsigned p = 0; p < K; p++)
+                sum += (int64_t)(a[i * K + p] - a_zero_points[i]) * (b[j * K + p] - epilogue.b_zero_point);
+            double value = (double)scales[i] * (double)sum + bias[i];
+            expected[i * N + j] = (value < 0.0) ? 0.0f : (float)value;
+        }
+    }
+
+    unsigned host_features = le_cpu_get_features();
+    for (unsigned f = 0; f < sizeof(feature_sets) / sizeof(feature_sets[0]); f++)
+    {
+        if ((feature_sets[f] & host_features) != feature_sets[f])
+            continue;
+        le_gemm_u8s8_for_features(feature_sets[f], M, N, K, a, K, b, K, &epilogue, c, N);
+        for (unsigned i = 0; i < M * N; i++)
+        {
+            assert(fabsf(c[i] - expected[i]) <= 1e-5f * (1.0f + fabsf(expected[i])));
+            /// Integer sums are exact, so all implementations give same results
+            assert(f == 0 ? true : c[i] == first[i]);
+            first[i] = c[i];
+        }
+    }
+}
+
+int
+main()
+{
+    /// Zero is represented exactly
+    LeQuantization quantization = le_quantization_from_range(-1.0f, 3.0f, 0, 255);
+    assert(fabsf(quantization.scale - 4.0f / 255.0f) < 1e-7f);
+    assert(quantization.zero_point == 64);
+    quantization = le_quantization_from_range(0.5f, 2.0f, -128, 127);
+    assert(quantization.zero_point == -128);
+    quantization = le_quantization_from_range(0.0f, 0.0f, 0, 255);
+    assert(quantization.scale == 1.0f && quantization.zero_point == 0);
+
+    le_test_gemm_u8s8();
+
+    /// Every row gets own scale and zero point
+    unsigned height = 24, width = 150, examples = 33;
+    LeTensor *w = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, height, width));
+    LeTensor *x = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, width, examples));
+    LeTensor *bias = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(2, height, 1));
+    for (unsigned i = 0; i < height * width; i++)
+        le_tensor_set_f32(w, i, (float)((int)(i * 7 % 13) - 4) * 0.01f * (float)(i / width + 1));
+    for (unsigned i = 0; i < width * examples; i++)
+        le_tensor_set_f32(x, i, (float)((int)(i * 5 % 11) - 3) * 0.1f);
+    for (unsigned i = 0; i < height; i++)
+        le_tensor_set_f32(bias, i, (float)((int)i - 12) * 0.05f);
+    LeTensor *w_scales = NULL, *w_zero_points = NULL;
+    LeTensor *w_quantized = le_matrix_new_quantized_rows(w, &w_scales, &w_zero_points);
+    assert(w_quantized->element_type == LE_TYPE_INT8);
+    for (unsigned y = 0; y < height; y++)
+    {
+        float scale = le_matrix_at_f32(w_scales, y, 0);
+        int32_t zero_point = le_matrix_at_i32(w_zero_points, y, 0);
+        assert(fabsf(scale - 0.12f * (float)(y + 1) / 255.0f) < 1e-6f);
+        for (unsigned x_index = 0; x_index < width; x_index++)
+        {
+            float dequantized = scale * (float)(le_matrix_at_i8(w_quantized, y, x_index) - zero_point);
+            assert(fabsf(dequantized - le_matrix_at_f32(w, y, x_index)) <= 0.5001f * scale);
+        }
+    }
+
+    /// Quantized product with fused bias and ReLU is close to single precision one
+    LeTensor *product = le_matrix_new_product(w, x);
+    le_matrix_add(product, bias);
+    le_tensor_apply_relu(product);
+    LeTensor *quantized_product = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, height, examples);
+    le_matrix_quantized_product_into(quantized_product, w_quantized, w_scales, w_zero_points, x, NULL, bias, true);
+    for (unsigned i = 0; i < height * examples; i++)
+    {
+        assert(le_tensor_at_f32(quantized_product, i) >= 0.0f);
+        /// Rounding errors grow with scale of row
+        assert(fabsf(le_tensor_at_f32(quantized_product, i) - le_tensor_at_f32(product, i)) < 0.01f * (float)(i / examples + 1));
+    }
+
+    /// Strided b and fixed quantization covering its range give same result
+    LeTensor *x_t = le_matrix_new_transpose(x);
+    LeTensor *x_view = le_tensor_transpose(x_t);
+    LeQuantization x_quantization = le_quantization_from_range(le_tensor_reduce_f32(x, LE_REDUCE_OP_MIN),
+                                                               le_tensor_reduce_f32(x, LE_REDUCE_OP_MAX), 0, 255);
+    LeTensor *view_product = le_matrix_new_uninitialized(LE_TYPE_FLOAT32, height, examples);
+    le_matrix_quantized_product_into(view_product, w_quantized, w_scales, w_zero_points, x_view, &x_quantization, bias, true);
+    assert(le_tensor_equal(view_product, quantized_product));
+    le_tensor_free(view_product);
+    le_tensor_free(x_view);
+    le_tensor_free(x_t);
+
+    le_tensor_free(quantized_product);
+    le_tensor_free(product);
+    le_tensor_free(w_zero_points);
+    le_tensor_free(w_scales);
+    le_tensor_free(w_quantized);
+    le_tensor_free(bias);
+    le_tensor_free(w);
+
+    /// Quantized model predicts almost the same, dynamically and with calibration
+    for (unsigned calibrate = 0; calibrate < 2; calibrate++)
+    {
+        LeSequential *nn = le_sequential_new();
+        LeDenseLayer *fc1 = le_dense_layer_new("FC1", width, 64);
+        LeDenseLayer *fc2 = le_dense_layer_new("FC2", 64, 10);
+        le_sequential_add(nn, LE_LAYER(fc1));
+        le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A1", LE_ACTIVATION_RELU)));
+        le_sequential_add(nn, LE_LAYER(fc2));
+        le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A2", LE_ACTIVATION_SOFTMAX)));
+        LeTensor *prediction = le_sequential_predict(nn, x);
+        le_sequential_quantize(nn, calibrate ? x : NULL);
+        assert(fc1->w->element_type == LE_TYPE_INT8);
+        assert(fc2->w->element_type == LE_TYPE_INT8);
+        assert(fc1->relu && !fc2->relu);
+        assert(calibrate ? fc1->x_quantization.scale > 0.0f : fc1->x_quantization.scale == 0.0f);
+        LeTensor *quantized_prediction = le_sequential_predict(nn, x);
+        LeTensor *prediction_into = le_tensor_new_zeros_like(quantized_prediction);
+        le_sequential_predict_into(nn, prediction_into, x);
+        assert(le_tensor_equal(prediction_into, quantized_prediction));
+        for (unsigned i = 0; i < 10 * examples; i++)
+            assert(fabsf(le_tensor_at_f32(quantized_prediction, i) - le_tensor_at_f32(prediction, i)) < 1e-2f);
+        le_tensor_free(prediction_into);
+        le_tensor_free(quantized_prediction);
+        le_tensor_free(prediction);
+        le_sequential_free(nn);
+    }
+    le_tensor_free(x);
+
+    return EXIT_SUCCESS;
+}
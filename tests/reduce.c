@@ -0,0 +1,200 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+/// @note: Value of element of 3D test tensor, distinct for every index
+static float
+le_test_value(unsigned z, unsigned y, unsigned x)
+{
+    return (float)((int)((z * 7 + y * 13 + x * 5) % 17) - 8);
+}
+
+static LeTensor *
+le_test_tensor_new(unsigned depth, unsigned height, unsigned width)
+{
+    LeTensor *self = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(3, depth, height, width));
+    for (unsigned z = 0; z < depth; z++)
+        for (unsigned y = 0; y < height; y++)
+            for (unsigned x = 0; x < width; x++)
+                le_tensor_set_f32(self, (z * height + y) * width + x, le_test_value(z, y, x));
+    return self;
+}
+
+/// @note: Checks every op reducing single dimension of tensor against straightforward loops
+static void
+le_test_reduce_dimension(const LeTensor *tensor, unsigned depth, unsigned height, unsigned width, unsigned dimension)
+{
+    unsigned sizes[3] = { depth, height, width };
+    unsigned length = sizes[dimension];
+    LeTensor *sum = le_tensor_new_reduce(tensor, LE_REDUCE_OP_SUM, LE_REDUCE_AXIS(dimension), true);
+    LeTensor *mean = le_tensor_new_reduce(tensor, LE_REDUCE_OP_MEAN, LE_REDUCE_AXIS(dimension), true);
+    LeTensor *max = le_tensor_new_reduce(tensor, LE_REDUCE_OP_MAX, LE_REDUCE_AXIS(dimension), true);
+    LeTensor *min = le_tensor_new_reduce(tensor, LE_REDUCE_OP_MIN, LE_REDUCE_AXIS(dimension), false);
+    LeTensor *argmax = le_tensor_new_reduce(tensor, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(dimension), false);
+    LeTensor *argmin = le_tensor_new_reduce(tensor, LE_REDUCE_OP_ARGMIN, LE_REDUCE_AXIS(dimension), false);
+    LeTensor *variance = le_tensor_new_reduce(tensor, LE_REDUCE_OP_VARIANCE, LE_REDUCE_AXIS(dimension), false);
+    assert(le_shape_get_size(sum->shape, dimension) == 1);
+    assert(min->shape->num_dimensions == 2);
+
+    unsigned outputs_count = depth * height * width / length;
+    for (unsigned output = 0; output < outputs_count; output++)
+    {
+        double expected_sum = 0.0, expected_sqr_sum = 0.0;
+        float expected_max = -INFINITY, expected_min = INFINITY;
+        unsigned expected_argmax = 0, expected_argmin = 0;
+        for (unsigned i = 0; i < length; i++)
+        {
+            unsigned index[3];
+            unsigned rest = output;
+            for (int d = 2; d >= 0; d--)
+            {
+                if ((unsigned)d == dimension)
+                {
+                    index[d] = i;
+                    continue;
+                }
+                index[d] = rest % sizes[d];
+                rest /= sizes[d];
+            }
+            float value = le_test_value(index[0], index[1], index[2]);
+            expected_sum += value;
+            expected_sqr_sum += (double)value * value;
+            if (value > expected_max)
+            {
+                expected_max = value;
+                expected_argmax = i;
+            }
+            if (value < expected_min)
+            {
+                expected_min = value;
+                expected_argmin = i;
+            }
+        }
+        double expected_mean = expected_sum / length;
+        double expected_variance = expected_sqr_sum / length - expected_mean * expected_mean;
+
+        assert(le_tensor_at_f32(sum, output) == (float)expected_sum);
+        assert(fabs(le_tensor_at_f32(mean, output) - expected_mean) < 1e-5);
+        assert(le_tensor_at_f32(max, output) == expected_max);
+        assert(le_tensor_at_f32(min, output) == expected_min);
+        assert(le_tensor_at_u32(argmax, output) == expected_argmax);
+        assert(le_tensor_at_u32(argmin, output) == expected_argmin);
+        assert(fabs(le_tensor_at_f32(variance, output) - expected_variance) < 1e-3 * (1.0 + expected_variance));
+    }
+
+    le_tensor_free(variance);
+    le_tensor_free(argmin);
+    le_tensor_free(argmax);
+    le_tensor_free(min);
+    le_tensor_free(max);
+    le_tensor_free(mean);
+    le_tensor_free(sum);
+}
+
+int
+main()
+{
+    /// Leading, middle and lowest dimensions, blocks longer than one kernel call
+    LeTensor *tensor = le_test_tensor_new(1500, 3, 40);
+    for (unsigned dimension = 0; dimension < 3; dimension++)
+        le_test_reduce_dimension(tensor, 1500, 3, 40, dimension);
+    le_tensor_free(tensor);
+    tensor = le_test_tensor_new(3, 5, 2500);
+    for (unsigned dimension = 0; dimension < 3; dimension++)
+        le_test_reduce_dimension(tensor, 3, 5, 2500, dimension);
+
+    /// Several dimensions at once, strided input
+    LeTensor *outer = le_tensor_new_reduce(tensor, LE_REDUCE_OP_SUM, LE_REDUCE_AXIS(0) | LE_REDUCE_AXIS(2), false);
+    assert(outer->shape->num_dimensions == 1);
+    LeTensor *transposed = le_tensor_transpose(tensor);
+    LeTensor *transposed_outer = le_tensor_new_reduce(transposed, LE_REDUCE_OP_SUM, LE_REDUCE_AXIS(0) | LE_REDUCE_AXIS(1), false);
+    assert(le_tensor_equal(outer, transposed_outer));
+    for (unsigned y = 0; y < 5; y++)
+    {
+        double expected = 0.0;
+        for (unsigned z = 0; z < 3; z++)
+            for (unsigned x = 0; x < 2500; x++)
+                expected += le_test_value(z, y, x);
+        assert(le_tensor_at_f32(outer, y) == (float)expected);
+    }
+    LeTensor *argmax = le_tensor_new_reduce(transposed, LE_REDUCE_OP_ARGMAX, LE_REDUCE_AXIS(1) | LE_REDUCE_AXIS(2), true);
+    for (unsigned z = 0; z < 3; z++)
+    {
+        unsigned expected = 0;
+        for (unsigned i = 1; i < 2500 * 5; i++)
+            if (le_test_value(z, i % 5, i / 5) > le_test_value(z, expected % 5, expected / 5))
+                expected = i;
+        assert(le_tensor_at_u32(argmax, z) == expected);
+    }
+    le_tensor_free(argmax);
+    le_tensor_free(transposed_outer);
+    le_tensor_free(transposed);
+    le_tensor_free(outer);
+    le_tensor_free(tensor);
+
+    /// Matrix sums along both dimensions
+    LeTensor *matrix = le_tensor_new(LE_TYPE_FLOAT32, 2, 2, 3,
+        1.0, 2.0, 3.0,
+        4.0, 5.0, 6.0
+    );
+    LeTensor *rows_sum = le_matrix_new_sum(matrix, 1);
+    LeTensor *columns_sum = le_matrix_new_sum(matrix, 0);
+    assert(le_matrix_get_height(rows_sum) == 2 && le_matrix_get_width(rows_sum) == 1);
+    assert(le_matrix_at_f32(rows_sum, 1, 0) == 15.0f);
+    assert(le_matrix_get_height(columns_sum) == 1 && le_matrix_get_width(columns_sum) == 3);
+    assert(le_matrix_at_f32(columns_sum, 0, 2) == 9.0f);
+    le_tensor_free(columns_sum);
+    le_tensor_free(rows_sum);
+    le_tensor_free(matrix);
+
+    /// Sum of many elements stays accurate and threads split single output
+    le_set_num_threads(4);
+    unsigned count = 1 << 22;
+    LeTensor *large = le_tensor_new_uninitialized(LE_TYPE_FLOAT32, le_shape_new(1, count));
+    float *data = le_tensor_get_data_mut(large);
+    for (unsigned i = 0; i < count; i++)
+        data[i] = 0.1f + (float)(i % 3);
+    double expected_sum = 0.0;
+    for (unsigned i = 0; i < count; i++)
+        expected_sum += data[i];
+    double expected_mean = expected_sum / count;
+    assert(fabs(le_tensor_sum_f32(large) - expected_sum) < 1e-6 * expected_sum);
+    assert(fabs(le_tensor_reduce_f32(large, LE_REDUCE_OP_MEAN) - expected_mean) < 1e-6 * expected_mean);
+    double expected_variance = 0.0;
+    for (unsigned i = 0; i < count; i++)
+        expected_variance += (data[i] - expected_mean) * (data[i] - expected_mean);
+    expected_variance /= count;
+    assert(fabs(le_tensor_reduce_f32(large, LE_REDUCE_OP_VARIANCE) - expected_variance) < 1e-5 * expected_variance);
+    data[count - 7] = 100.0f;
+    data[count - 3] = 100.0f;
+    data[12345] = -5.0f;
+    LeTensor *index = le_tensor_new_reduce(large, LE_REDUCE_OP_ARGMAX, LE_REDUCE_ALL_AXES, false);
+    assert(index->shape->num_dimensions == 0);
+    assert(le_tensor_at_u32(index, 0) == count - 7);
+    le_tensor_free(index);
+    index = le_tensor_new_reduce(large, LE_REDUCE_OP_ARGMIN, LE_REDUCE_ALL_AXES, false);
+    assert(le_tensor_at_u32(index, 0) == 12345);
+    le_tensor_free(index);
+
+    data[0] = 0.0f;
+    data[1] = NAN;
+    LeTensorStats stats = le_tensor_get_stats(large);
+    assert(stats.nans == 1);
+    assert(stats.zeros == 1);
+    data[1] = 0.0f;
+    stats = le_tensor_get_stats(large);
+    assert(stats.max == 100.0f);
+    assert(stats.min == -5.0f);
+    assert(stats.zeros == 2);
+    assert(fabsf(stats.mean - le_tensor_reduce_f32(large, LE_REDUCE_OP_MEAN)) < 1e-5f);
+    assert(fabsf(stats.deviation * stats.deviation - le_tensor_reduce_f32(large, LE_REDUCE_OP_VARIANCE)) < 1e-3f);
+    le_tensor_free(large);
+    le_set_num_threads(0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+/// @note: Whether function exits with failure, also in release builds, run in child process
+static bool
+le_test_exits_with_failure(void (*function)(void))
+{
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0)
+    {
+        function();
+        _exit(EXIT_SUCCESS);
+    }
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    return WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_FAILURE);
+}
+
+static void
+le_test_oversized_shape(void)
+{
+    le_shape_free(le_shape_new(3, UINT32_MAX, UINT32_MAX, 2));
+}
+
+static void
+le_test_oversized_tensor(void)
+{
+    le_tensor_free(le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(2, UINT32_MAX, UINT32_MAX)));
+}
+
+int
+main()
+{
+    /// Cached elements count follows every change of sizes
+    LeShape *shape = le_shape_new(3, 2, 3, 4);
+    assert(le_shape_get_elements_count(shape) == 24);
+    le_shape_set_size(shape, 1, 5);
+    assert(le_shape_get_elements_count(shape) == 40);
+    LeShape *copy = le_shape_copy(shape);
+    assert(le_shape_equal(shape, copy));
+    assert(le_shape_get_elements_count(copy) == 40);
+    le_shape_free(copy);
+    le_shape_free(shape);
+
+    LeTensor *tensor = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(3, 2, 3, 4));
+    for (unsigned i = 0; i < 24; i++)
+        ((float *)tensor->data)[i] = (float)i;
+    bool reshaped = le_tensor_reshape(tensor, 2, 6, 4);
+    assert(reshaped);
+    (void)reshaped;
+    assert(le_shape_get_elements_count(tensor->shape) == 24);
+    assert(le_tensor_at_f32(tensor, 23) == 23.0f);
+
+    /// Views placed on stack are same as allocated views
+    LeTensorView view;
+    LeTensor *picked = le_tensor_pick(tensor, 4);
+    assert(le_tensor_equal(le_tensor_view_init_pick(&view, tensor, 4), picked));
+    le_tensor_free(picked);
+    LeTensor *sliced = le_tensor_slice(tensor, 1, 1, 2);
+    assert(le_tensor_equal(le_tensor_view_init_slice(&view, tensor, 1, 1, 2), sliced));
+    assert(le_shape_get_elements_count(view.shape) == 12);
+    le_tensor_free(sliced);
+    LeTensor *column = le_matrix_get_column(tensor, 3);
+    assert(le_tensor_equal(le_matrix_view_init_column(&view, tensor, 3), column));
+    le_tensor_free(column);
+
+    LeTensor *permuted = le_tensor_permute(tensor, (unsigned[]){ 1, 0 });
+    assert(le_shape_get_elements_count(permuted->shape) == 24);
+    assert(le_matrix_at_f32(permuted, 3, 5) == 23.0f);
+    le_tensor_free(permuted);
+    le_tensor_free(tensor);
+
+    /// Shapes with more dimensions than inline storage holds
+    tensor = le_tensor_new_zeros(LE_TYPE_FLOAT32, le_shape_new(8, 1, 2, 1, 2, 1, 2, 1, 3));
+    assert(tensor->shape->num_dimensions == 8);
+    assert(le_shape_get_elements_count(tensor->shape) == 24);
+    ((float *)tensor->data)[23] = 1.0f;
+    LeTensor *tensor_copy = le_tensor_new_copy(tensor);
+    assert(le_tensor_equal(tensor, tensor_copy));
+    le_tensor_free(tensor_copy);
+    permuted = le_tensor_permute(tensor, (unsigned[]){ 7, 6, 5, 4, 3, 2, 1, 0 });
+    assert(le_shape_get_elements_count(permuted->shape) == 24);
+    le_tensor_free(permuted);
+    le_tensor_free(tensor);
+
+    /// Counts, strides and offsets of tensors with more than 2^32 elements do not overflow
+    shape = le_shape_new(3, 3, 65536, 65536);
+    assert(le_shape_get_elements_count(shape) == 3 * ((size_t)1 << 32));
+    assert(le_shape_get_regions_count(shape) == 3 * (size_t)65536);
+    le_shape_free(shape);
+    LeTensorView huge = { .element_type = LE_TYPE_FLOAT32 };
+    le_tensor_init_shape(&huge, 3, (uint32_t[]){ 3, 65536, 65536 });
+    le_tensor_init_strides(&huge);
+    assert(huge.strides[0] == ((size_t)1 << 32));
+    assert(le_tensor_get_data_size(&huge) == 12 * ((size_t)1 << 32));
+    assert(le_tensor_offset(&huge, ((size_t)2 << 32) + 5) == ((size_t)2 << 32) + 5);
+    le_shape_clear(huge.shape);
+
+    /// Broadcast view reads same few elements at any index
+    tensor = le_tensor_new(LE_TYPE_FLOAT32, 2, 1, 3,
+        1.0, 2.0, 3.0
+    );
+    LeTensor *broadcast = le_tensor_broadcast(tensor, le_shape_new(3, 65536, 65536, 3));
+    assert(le_tensor_at_f32(broadcast, ((size_t)2 << 32) + 4) == 1.0f);
+    assert(le_tensor_at_f32(broadcast, 7) == 2.0f);
+    le_tensor_free(broadcast);
+    le_tensor_free(tensor);
+
+    /// Shapes with elements count or size in bytes which does not fit into size_t are rejected
+    assert(le_test_exits_with_failure(le_test_oversized_shape));
+    assert(le_test_exits_with_failure(le_test_oversized_tensor));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+/* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
+   Released under the MIT license. See LICENSE file in the project root for full license information. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <le/le.h>
+#include <le/tensors/letensor-imp.h>
+
+/// @note: More classes than LE_LOSS_BLOCK and odd counts exercise block borders and scalar tails
+#define CLASSES 300
+#define EXAMPLES 37
+#define FEATURES 5
+
+static void
+le_test_equal(const LeTensor *expected, const LeTensor *actual, float tolerance)
+{
+    assert(le_shape_equal(expected->shape, actual->shape));
+    for (size_t i = 0; i < le_shape_get_elements_count(expected->shape); i++)
+        assert(fabsf(le_tensor_at_f32(expected, i) - le_tensor_at_f32(actual, i)) <= tolerance);
+}
+
+/// @note: One-hot labels, classes × examples
+static LeTensor *
+le_test_labels(unsigned classes, unsigned examples)
+{
+    LeTensor *labels = le_matrix_new_zeros(LE_TYPE_FLOAT32, classes, examples);
+    for (unsigned i = 0; i < examples; i++)
+        le_matrix_set(labels, rand() % classes, i, 1.0f);
+    return labels;
+}
+
+static void
+le_test_log_softmax(void)
+{
+    /// @note: Transposed view has columns with stride, logits are scaled so that softmax underflows
+    LeTensor *storage = le_tensor_new_rand_f32(le_shape_new(2, EXAMPLES, CLASSES));
+    le_tensor_mul(storage, 100.0f);
+    LeTensor *logits = le_tensor_transpose(storage);
+
+    LeTensor *expected = le_tensor_new_copy(logits);
+    le_matrix_apply_softmax(expected);
+    LeTensor *actual = le_tensor_new_copy(logits);
+    le_matrix_apply_log_softmax(actual);
+    for (size_t i = 0; i < le_shape_get_elements_count(actual->shape); i++)
+    {
+        float log_softmax = le_tensor_at_f32(actual, i);
+        assert(isfinite(log_softmax) && (log_softmax <= 1e-6f));
+        assert(fabsf(expf(log_softmax) - le_tensor_at_f32(expected, i)) < 1e-5f);
+    }
+
+    /// @note: In place on view, result is written into elements of storage it views
+    le_matrix_apply_log_softmax(logits);
+    le_test_equal(actual, logits, 1e-6f);
+    LeTensor *storage_transposed = le_tensor_transpose(storage);
+    le_test_equal(actual, storage_transposed, 1e-6f);
+
+    le_tensor_free(storage_transposed);
+    le_tensor_free(actual);
+    le_tensor_free(expected);
+    le_tensor_free(logits);
+    le_tensor_free(storage);
+}
+
+/// @note: Exact reference, le_cross_entropy_loss clamps probabilities of softmax
+static float
+le_test_softmax_cross_entropy(const LeTensor *logits, const LeTensor *labels)
+{
+    unsigned classes = logits->shape->sizes[0];
+    unsigned examples = logits->shape->sizes[1];
+    double loss = 0.0;
+    for (unsigned i = 0; i < examples; i++)
+    {
+        double max = le_matrix_at_f32(logits, 0, i);
+        for (unsigned j = 1; j < classes; j++)
+            max = fmax(max, le_matrix_at_f32(logits, j, i));
+        double sum = 0.0;
+        for (unsigned j = 0; j < classes; j++)
+            sum += exp(le_matrix_at_f32(logits, j, i) - max);
+        for (unsigned j = 0; j < classes; j++)
+            loss -= le_matrix_at_f32(labels, j, i) * (le_matrix_at_f32(logits, j, i) - max - log(sum));
+    }
+    return (float)(loss / examples);
+}
+
+static void
+le_test_loss(unsigned classes, unsigned examples)
+{
+    LeTensor *logits = le_tensor_new_rand_f32(le_shape_new(2, classes, examples));
+    le_tensor_mul(logits, 10.0f);
+    LeTensor *labels = le_test_labels(classes, examples);
+
+    float expected_loss = le_test_softmax_cross_entropy(logits, labels);
+    LeTensor *expected_gradient = le_tensor_new_copy(logits);
+    le_matrix_apply_softmax(expected_gradient);
+    le_tensor_sub_tensor(expected_gradient, labels);
+
+    float loss = le_apply_softmax_cross_entropy_loss_derivative(logits, labels);
+    assert(fabsf(loss - expected_loss) <= 1e-4f * fabsf(expected_loss));
+    le_test_equal(expected_gradient, logits, 1e-5f);
+
+    le_tensor_free(expected_gradient);
+    le_tensor_free(labels);
+    le_tensor_free(logits);
+}
+
+/// @note: Loss reported with gradients equals cost of model and gradients match numerical estimate
+static void
+le_test_sequential(LeActivation activation, LeLoss loss, unsigned outputs)
+{
+    LeTensor *x = le_tensor_new_rand_f32(le_shape_new(2, FEATURES, EXAMPLES));
+    LeTensor *y = le_test_labels(outputs, EXAMPLES);
+
+    LeSequential *nn = le_sequential_new();
+    le_sequential_add(nn, LE_LAYER(le_dense_layer_new("D", FEATURES, outputs)));
+    le_sequential_add(nn, LE_LAYER(le_activation_layer_new("A", activation)));
+    le_sequential_set_loss(nn, loss);
+
+    float cost = le_sequential_compute_cost(nn, x, y);
+    float j = NAN;
+    LeList *gradients = le_model_get_gradients_with_loss(LE_MODEL(nn), x, y, &j);
+    assert(fabsf(j - cost) <= 1e-4f * fabsf(cost));
+
+    LeList *estimates = le_sequential_estimate_gradients(nn, x, y, 1e-3f);
+    for (LeList *gradient = gradients, *estimate = estimates;
+         gradient || estimate;
+         gradient = gradient->next, estimate = estimate->next)
+    {
+        assert(gradient && estimate);
+        le_test_equal(LE_TENSOR(estimate->data), LE_TENSOR(gradient->data), 1e-2f);
+    }
+    le_list_free(estimates, LE_FUNCTION(le_tensor_free));
+    le_list_free(gradients, LE_FUNCTION(le_tensor_free));
+
+    /// @note: Optimizer keeps loss of batch before its step
+    LeBGD *optimizer = le_bgd_new(LE_MODEL(nn), x, y, 0.1f);
+    assert(isnan(LE_OPTIMIZER(optimizer)->loss));
+    le_optimizer_step(LE_OPTIMIZER(optimizer));
+    assert(fabsf(LE_OPTIMIZER(optimizer)->loss - cost) <= 1e-4f * fabsf(cost));
+    le_bgd_free(optimizer);
+
+    le_sequential_free(nn);
+    le_tensor_free(y);
+    le_tensor_free(x);
+}
+
+int
+main()
+{
+    le_test_log_softmax();
+    le_test_loss(CLASSES, EXAMPLES);
+    le_test_loss(3, 1);
+    le_test_sequential(LE_ACTIVATION_SOFTMAX, LE_LOSS_CROSS_ENTROPY, 4);
+    le_test_sequential(LE_ACTIVATION_SIGMOID, LE_LOSS_LOGISTIC, 1);
+
+    le_set_num_threads(4);
+    le_test_log_softmax();
+    le_test_loss(CLASSES, EXAMPLES);
+    le_test_sequential(LE_ACTIVATION_SOFTMAX, LE_LOSS_CROSS_ENTROPY, 4);
+
+    return EXIT_SUCCESS;
+}
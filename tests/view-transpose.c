@@ -1,9 +1,9 @@
-
 /* Copyright (c) Kyrylo Polezhaiev and contributors. All rights reserved.
    Released under the MIT license. See LICENSE file in the project root for full license information. */
 
 #include <stdlib.h>
 #include <assert.h>
+#include <math.h>
 #include <le/le.h>
 
 int
@@ -13,7 +13,7 @@ main()
     1.0, 2.0, 3.0,
     4.0, 5.0, 6.0,
     7.0, 8.0, 9.0,
-    1.0, 2.0, 3.0,
+    1.0, 2.0, 3.0
   );
   LeTensor *a_t = le_tensor_new (LE_TYPE_FLOAT32, 2, 3, 4,
     1.0, 4.0, 7.0, 1.0,
@@ -26,15 +26,89 @@ main()
     0.0, 7.0, 8.0, 9.0, 0.0,
     0.0, 1.0, 2.0, 3.0, 0.0
   );
-  LeTensor *a_as_view = le_matrix_get_columns_copy (greater_a, 1, 3);
+  LeTensor *a_as_copy = le_matrix_get_columns_copy (greater_a, 1, 3);
+  assert (le_tensor_equal (a, a_as_copy));
+  assert (le_tensor_contiguous (a_as_copy));
+
+  /* Slice and transpose share memory of greater_a */
+  LeTensor *a_as_view = le_tensor_slice (greater_a, 1, 1, 3);
+  assert (le_tensor_get_data (a_as_view) == (float *)le_tensor_get_data (greater_a) + 1);
+  assert (!le_tensor_contiguous (a_as_view));
   assert (le_tensor_equal (a, a_as_view));
-  LeTensor *a_as_view_t = le_matrix_new_transpose (a_as_view);
+  LeTensor *a_as_view_t = le_tensor_transpose (a_as_view);
+  assert (le_tensor_get_data (a_as_view_t) == le_tensor_get_data (a_as_view));
   LeTensor *a_t_computed = le_matrix_new_transpose (a);
   assert (le_tensor_equal (a_as_view_t, a_t));
   assert (le_tensor_equal (a_as_view_t, a_t_computed));
-  le_tensor_free (a_as_view_t);
+  LeTensor *a_t_copy = le_tensor_new_copy (a_as_view_t);
+  assert (le_tensor_contiguous (a_t_copy));
+  assert (le_tensor_equal (a_t_copy, a_t));
+
+  /* GEMM reads views through leading dimension */
+  LeTensor *expected = le_matrix_new_product (a_t, a);
+  LeTensor *product = le_matrix_new_product (a_as_view_t, a_as_view);
+  assert (le_tensor_equal (product, expected));
+  le_tensor_free (product);
+  product = le_matrix_new_product_full (a_as_view, true, a_as_view_t, true);
+  assert (le_tensor_equal (product, expected));
+  le_tensor_free (product);
+  le_tensor_free (expected);
+
+  /* Element-wise kernels touch only elements of view */
+  le_tensor_mul_f32 (a_as_view_t, 2.0f);
+  assert (le_matrix_at_f32 (greater_a, 1, 2) == 10.0f);
+  assert (le_matrix_at_f32 (greater_a, 1, 0) == 0.0f);
+  assert (le_matrix_at_f32 (greater_a, 1, 4) == 0.0f);
+  assert (le_tensor_sum_f32 (a_as_view) == 2.0f * le_tensor_sum_f32 (a));
+  assert (le_tensor_sum_f32 (greater_a) == 2.0f * le_tensor_sum_f32 (a));
+  le_tensor_sub_tensor (a_as_view_t, a_t);
+  assert (le_tensor_equal (a_as_view_t, a_t));
+  assert (fabsf (le_tensor_l2_f32 (a_as_view) - le_tensor_l2_f32 (a)) < 1e-5f);
+
+  /* Views of views */
+  LeTensor *row = le_tensor_pick (a_as_view_t, 1);
+  assert (le_tensor_at_f32 (row, 0) == 2.0f);
+  assert (le_tensor_at_f32 (row, 3) == 2.0f);
+  le_tensor_free (row);
+
+  LeTensor *cube = le_tensor_new (LE_TYPE_FLOAT32, 3, 2, 3, 4,
+    0.0, 1.0, 2.0, 3.0,
+    4.0, 5.0, 6.0, 7.0,
+    8.0, 9.0, 10.0, 11.0,
+    12.0, 13.0, 14.0, 15.0,
+    16.0, 17.0, 18.0, 19.0,
+    20.0, 21.0, 22.0, 23.0
+  );
+  unsigned order[] = { 2, 0, 1 };
+  LeTensor *permuted = le_tensor_permute (cube, order);
+  assert (le_tensor_get_data (permuted) == le_tensor_get_data (cube));
+  LeTensor *permuted_copy = le_tensor_new_copy (permuted);
+  for (unsigned x = 0; x < 4; x++)
+    for (unsigned z = 0; z < 2; z++)
+      for (unsigned y = 0; y < 3; y++)
+        assert (le_tensor_at_f32 (permuted_copy, (x * 2 + z) * 3 + y) == (float)(z * 12 + y * 4 + x));
+  assert (le_tensor_equal (permuted, permuted_copy));
+  /* Neither dimension of this view is packed, GEMM gets a copy */
+  LeTensor *strided = le_tensor_pick (permuted, 1);
+  LeTensor *strided_copy = le_tensor_new_copy (strided);
+  LeTensor *strided_t = le_matrix_new_transpose (strided_copy);
+  expected = le_matrix_new_product (strided_copy, strided_t);
+  product = le_matrix_new_product_full (strided, false, strided, true);
+  assert (le_tensor_equal (product, expected));
+  le_tensor_free (product);
+  le_tensor_free (expected);
+  le_tensor_free (strided_t);
+  le_tensor_free (strided_copy);
+  le_tensor_free (strided);
+  le_tensor_free (permuted_copy);
+  le_tensor_free (permuted);
+  le_tensor_free (cube);
+
+  le_tensor_free (a_t_copy);
   le_tensor_free (a_t_computed);
+  le_tensor_free (a_as_view_t);
   le_tensor_free (a_as_view);
+  le_tensor_free (a_as_copy);
   le_tensor_free (greater_a);
   le_tensor_free (a_t);
   le_tensor_free (a);